@@ -52,7 +52,7 @@ tools = get_cpp(src_dir + os.sep + 'tstools')
 plugins = get_cpp(src_dir + os.sep + 'tsplugins')
 
 # "Other" MSBuild projects (ie. not tools, not plugins).
-others = ['config', 'utests-tsduckdll', 'utests-tsducklib', 'tscoredll', 'tscorelib', 'tsduckdll', 'tsducklib', 'tsp_static', 'tsprofiling', 'tsmux', 'tsnet', 'tszlib', 'setpath']
+others = ['config', 'utests-tsduckdll', 'utests-tsducklib', 'tscoredll', 'tscorelib', 'tsduckdll', 'tsducklib', 'tsp_static', 'tsprofiling', 'tscryptobench', 'tsmux', 'tsnet', 'tszlib', 'setpath']
 
 # MSBuild / Visual Studio solution description.
 cxx_project_guid = '8BC9CEB8-8B4A-11D0-8D11-00A0C91BC942'
@@ -71,6 +71,7 @@ ms_deps = {
     'utests-tsducklib': {'deps': ['tsducklib']},
     'tsp_static': {'deps': ['tsducklib']},
     'tsprofiling': {'deps': ['tsduckdll']},
+    'tscryptobench': {'deps': ['tsduckdll']},
     'tsmux': {'deps': ['tsduckdll'] + plugins},
     'tsnet': {'deps': ['tscoredll']},
     'tszlib': {'deps': ['tscoredll']},
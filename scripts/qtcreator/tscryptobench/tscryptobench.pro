@@ -0,0 +1,3 @@
+CONFIG += util
+TARGET = tscryptobench
+include(../tsduck.pri)
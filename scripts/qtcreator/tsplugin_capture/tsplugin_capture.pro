@@ -0,0 +1,4 @@
+# Automatically generated file, see build-project-files.py
+CONFIG += tsplugin
+TARGET = tsplugin_capture
+include(../tsduck.pri)
@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Template lock-free ring buffer for one producer thread and one consumer thread.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Template lock-free ring buffer for one producer thread and one consumer thread.
+    //! @ingroup libtscore thread
+    //!
+    //! The ring is a fixed array of pre-allocated elements. The producer thread fills the
+    //! next free element in place and then publishes it. The consumer thread reads the
+    //! oldest published element in place and then releases it. The elements are never
+    //! copied by the ring and no lock is used. The producer and the consumer only exchange
+    //! two atomic indexes.
+    //!
+    //! The ring does not provide any way to wait for free space or for published elements.
+    //! When necessary, the application shall use its own synchronization mechanism. The
+    //! publication of an element by publish() and the check for a published element by
+    //! usedElement() are sequentially consistent. Therefore, a consumer can set an atomic
+    //! "waiting" flag, check the ring again and sleep, while the producer publishes and then
+    //! checks the "waiting" flag to wake up the consumer, without losing a wake-up.
+    //!
+    //! Only one thread can use the producer methods and only one thread can use the consumer
+    //! methods at the same time. The other methods are not thread-safe and shall be called
+    //! only when neither the producer nor the consumer use the ring.
+    //!
+    //! @tparam T The type of the elements. It must be default-constructible. Each element is
+    //! reused in place and keeps the state that the producer left during the previous cycle
+    //! (for instance, the allocated capacity of a container).
+    //!
+    template <typename T>
+    class LockFreeRing
+    {
+        TS_NOCOPY(LockFreeRing);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] capacity Maximum number of elements in the ring.
+        //! This value is rounded up to the next power of 2.
+        //!
+        LockFreeRing(size_t capacity = 0) { resize(capacity); }
+
+        //!
+        //! Change the capacity of the ring. The ring is emptied.
+        //! Not thread-safe.
+        //! @param [in] capacity Maximum number of elements in the ring.
+        //! This value is rounded up to the next power of 2.
+        //!
+        void resize(size_t capacity);
+
+        //!
+        //! Get the capacity of the ring.
+        //! @return The maximum number of elements in the ring.
+        //!
+        size_t capacity() const { return _elements.size(); }
+
+        //!
+        //! Get the number of published elements in the ring.
+        //! When called by the producer or the consumer, this is an approximate value since
+        //! the other side may modify the ring at the same time.
+        //! @return The number of published elements in the ring.
+        //!
+        size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+
+        //!
+        //! Check if the ring is empty.
+        //! @return True if the ring contains no published element.
+        //!
+        bool empty() const { return size() == 0; }
+
+        //!
+        //! Drop all elements in the ring. Not thread-safe.
+        //!
+        void clear() { _head = 0; _tail = 0; }
+
+        //!
+        //! Producer: get the next free element.
+        //! @return The address of the next free element or a null pointer if the ring is full.
+        //! The element can be modified in place by the producer. It is not visible by the
+        //! consumer until publish() is called.
+        //!
+        T* freeElement();
+
+        //!
+        //! Producer: publish the element which was returned by the last call to freeElement().
+        //!
+        void publish() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst); }
+
+        //!
+        //! Producer: copy an element in the ring and publish it.
+        //! @param [in] value The value to copy.
+        //! @return True on success, false if the ring is full.
+        //!
+        bool push(const T& value);
+
+        //!
+        //! Consumer: get the oldest published element.
+        //! @return The address of the oldest published element or a null pointer if the ring is empty.
+        //! The element remains in the ring until release() is called.
+        //!
+        T* usedElement();
+
+        //!
+        //! Consumer: release the element which was returned by the last call to usedElement().
+        //! The element becomes free for the producer.
+        //!
+        void release() { _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        //!
+        //! Consumer: copy the oldest published element and release it.
+        //! @param [out] value The returned value.
+        //! @return True on success, false if the ring is empty.
+        //!
+        bool pop(T& value);
+
+    private:
+        // The two indexes are in distinct cache lines to avoid false sharing between the two threads.
+        // They are free-running counters, the index in the array is counter modulo capacity.
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+        std::vector<T> _elements {};
+        size_t _mask = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head {0};  // Next element to consume, modified by consumer only.
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail {0};  // Next element to produce, modified by producer only.
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+template <typename T>
+void ts::LockFreeRing<T>::resize(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    _elements.resize(capacity == 0 ? 0 : size);
+    _mask = size - 1;
+    clear();
+}
+
+template <typename T>
+T* ts::LockFreeRing<T>::freeElement()
+{
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    return tail - _head.load(std::memory_order_acquire) >= _elements.size() ? nullptr : &_elements[tail & _mask];
+}
+
+template <typename T>
+T* ts::LockFreeRing<T>::usedElement()
+{
+    const size_t head = _head.load(std::memory_order_relaxed);
+    return head == _tail.load(std::memory_order_seq_cst) ? nullptr : &_elements[head & _mask];
+}
+
+template <typename T>
+bool ts::LockFreeRing<T>::push(const T& value)
+{
+    T* elem = freeElement();
+    if (elem != nullptr) {
+        *elem = value;
+        publish();
+    }
+    return elem != nullptr;
+}
+
+template <typename T>
+bool ts::LockFreeRing<T>::pop(T& value)
+{
+    T* elem = usedElement();
+    if (elem != nullptr) {
+        value = *elem;
+        release();
+    }
+    return elem != nullptr;
+}
@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  Bucket layout, with SUB = 2^precision:
+//  - Absolute values in the range 0 to 2*SUB-1 use one bucket per value.
+//  - Above, for each power of two, the range [2^n, 2^(n+1)[ is split into
+//    SUB buckets of equal width 2^shift, with shift = n - precision.
+//  - The index of value v is shift * SUB + (v >> shift). Indexes are
+//    contiguous and monotonic in v.
+//
+//----------------------------------------------------------------------------
+
+#include "tsLogHistogram.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::LogHistogram::LogHistogram(size_t precision, size_t max_bits) :
+    _precision(std::clamp<size_t>(precision, 1, 16)),
+    _max_bits(std::clamp<size_t>(max_bits, _precision + 2, 63)),
+    _max_abs((uint64_t(1) << _max_bits) - 1),
+    _neg(bucketIndex(_max_abs) + 1, 0),
+    _pos(_neg.size(), 0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the content of the histogram.
+//----------------------------------------------------------------------------
+
+void ts::LogHistogram::reset()
+{
+    _count = 0;
+    _min = _max = _sum = 0;
+    std::fill(_neg.begin(), _neg.end(), 0);
+    std::fill(_pos.begin(), _pos.end(), 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the bucket index for an absolute value.
+//----------------------------------------------------------------------------
+
+size_t ts::LogHistogram::bucketIndex(uint64_t value) const
+{
+    const uint64_t sub = uint64_t(1) << _precision;
+    if (value < 2 * sub) {
+        return size_t(value);
+    }
+    else {
+        const size_t shift = size_t(std::bit_width(value)) - _precision - 1;
+        return size_t(shift * sub + (value >> shift));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the middle value of a bucket.
+//----------------------------------------------------------------------------
+
+uint64_t ts::LogHistogram::bucketValue(size_t index) const
+{
+    const uint64_t sub = uint64_t(1) << _precision;
+    if (index < 2 * sub) {
+        return uint64_t(index);
+    }
+    else {
+        const size_t shift = size_t(index / sub) - 1;
+        const uint64_t low = (index - shift * sub) << shift;
+        return low + ((uint64_t(1) << shift) >> 1);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Record one or more samples.
+//----------------------------------------------------------------------------
+
+void ts::LogHistogram::feed(int64_t value, uint64_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    else if (_count == 0) {
+        _min = _max = value;
+    }
+    else {
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+    }
+    _count += count;
+    _sum += value * int64_t(count);
+
+    // Absolute value, without overflow on INT64_MIN, clamped to the max value.
+    const uint64_t abs = std::min(value < 0 ? uint64_t(0) - uint64_t(value) : uint64_t(value), _max_abs);
+    (value < 0 ? _neg : _pos)[bucketIndex(abs)] += count;
+}
+
+
+//----------------------------------------------------------------------------
+// Merge another histogram into this one.
+//----------------------------------------------------------------------------
+
+bool ts::LogHistogram::merge(const LogHistogram& other)
+{
+    if (other._precision != _precision || other._max_bits != _max_bits) {
+        return false;
+    }
+    if (other._count > 0) {
+        _min = _count == 0 ? other._min : std::min(_min, other._min);
+        _max = _count == 0 ? other._max : std::max(_max, other._max);
+        _count += other._count;
+        _sum += other._sum;
+        for (size_t i = 0; i < _pos.size(); ++i) {
+            _neg[i] += other._neg[i];
+            _pos[i] += other._pos[i];
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get a percentile value.
+//----------------------------------------------------------------------------
+
+int64_t ts::LogHistogram::percentile(double percent) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+
+    // Rank of the requested sample, in the range 1 to _count.
+    const uint64_t rank = std::clamp<uint64_t>(uint64_t(std::ceil(std::clamp(percent, 0.0, 100.0) * double(_count) / 100.0)), 1, _count);
+
+    // Samples are sorted from the most negative value to the most positive.
+    uint64_t seen = 0;
+    int64_t value = _max;
+    bool found = false;
+    for (size_t i = _neg.size(); !found && i > 0; --i) {
+        seen += _neg[i - 1];
+        if (seen >= rank) {
+            value = -int64_t(bucketValue(i - 1));
+            found = true;
+        }
+    }
+    for (size_t i = 0; !found && i < _pos.size(); ++i) {
+        seen += _pos[i];
+        if (seen >= rank) {
+            value = int64_t(bucketValue(i));
+            found = true;
+        }
+    }
+    return std::clamp(value, _min, _max);
+}
+
+
+//----------------------------------------------------------------------------
+// Format a one-line summary of the histogram.
+//----------------------------------------------------------------------------
+
+ts::UString ts::LogHistogram::summary(int64_t divisor) const
+{
+    divisor = std::max<int64_t>(1, divisor);
+    return UString::Format(u"samples: %'d, min: %'d, max: %'d, mean: %.2f, p50: %'d, p99: %'d, p99.9: %'d",
+                           _count, _min / divisor, _max / divisor, mean() / double(divisor),
+                           percentile(50.0) / divisor, percentile(99.0) / divisor, percentile(99.9) / divisor);
+}
@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Constant-memory histogram of signed integer values with logarithmic buckets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+
+namespace ts {
+    //!
+    //! Constant-memory histogram of signed integer values with logarithmic buckets.
+    //! @ingroup libtscore cpp
+    //!
+    //! This is a streaming histogram in the style of "HDR histograms". Each power
+    //! of two is split in 2^precision linear sub-buckets. The relative error on a
+    //! reported value is consequently bounded by 2^-precision, whatever the magnitude
+    //! of the value. Small values (below 2^(precision+1)) are recorded exactly.
+    //!
+    //! The memory size is fixed at construction and does not depend on the number
+    //! of samples. Recording a value is a constant-time operation without allocation.
+    //! It is therefore suitable to characterize large numbers of samples, typically
+    //! at transport stream packet rate, and later extract percentiles.
+    //!
+    //! Negative and positive values are recorded in two distinct sets of buckets.
+    //! Absolute values larger than 2^max_bits - 1 are clamped.
+    //!
+    class TSCOREDLL LogHistogram
+    {
+    public:
+        //!
+        //! Default number of precision bits.
+        //! With 5 bits, the relative error is less than 3.2%.
+        //!
+        static constexpr size_t DEFAULT_PRECISION = 5;
+        //!
+        //! Default maximum size in bits of the absolute values.
+        //! With 40 bits, the maximum value is one hour in PCR units (27 MHz).
+        //!
+        static constexpr size_t DEFAULT_MAX_BITS = 40;
+
+        //!
+        //! Constructor.
+        //! @param [in] precision Number of precision bits, ie. log2 of the number of linear
+        //! sub-buckets in each power of two. Must be in the range 1 to 16.
+        //! @param [in] max_bits Maximum size in bits of the absolute value of samples.
+        //! Must be in the range @a precision + 2 to 63.
+        //!
+        LogHistogram(size_t precision = DEFAULT_PRECISION, size_t max_bits = DEFAULT_MAX_BITS);
+
+        //!
+        //! Reset the content of the histogram. The memory is kept allocated.
+        //!
+        void reset();
+
+        //!
+        //! Record one or more samples with the same value.
+        //! @param [in] value Sample value.
+        //! @param [in] count Number of samples with that value.
+        //!
+        void feed(int64_t value, uint64_t count = 1);
+
+        //!
+        //! Merge another histogram into this one.
+        //! @param [in] other Another histogram. Must have the same geometry as this one.
+        //! Ignored otherwise.
+        //! @return True on success, false if the two histograms have different geometries.
+        //!
+        bool merge(const LogHistogram& other);
+
+        //!
+        //! Get the number of recorded samples.
+        //! @return The number of recorded samples.
+        //!
+        uint64_t count() const { return _count; }
+
+        //!
+        //! Get the minimum recorded value.
+        //! @return The minimum recorded value or zero if there is no sample.
+        //!
+        int64_t minimum() const { return _min; }
+
+        //!
+        //! Get the maximum recorded value.
+        //! @return The maximum recorded value or zero if there is no sample.
+        //!
+        int64_t maximum() const { return _max; }
+
+        //!
+        //! Get the mean value of all recorded samples.
+        //! @return The mean value or zero if there is no sample.
+        //!
+        double mean() const { return _count == 0 ? 0.0 : double(_sum) / double(_count); }
+
+        //!
+        //! Get a percentile value.
+        //! @param [in] percent The requested percentile, in the range 0.0 to 100.0.
+        //! For instance, 50.0 returns the median value and 99.9 returns the value
+        //! under which 99.9% of the samples fall.
+        //! @return The approximate percentile value (the middle of the corresponding bucket,
+        //! bounded by the minimum and maximum values), or zero if there is no sample.
+        //!
+        int64_t percentile(double percent) const;
+
+        //!
+        //! Format a one-line summary of the histogram.
+        //! The line contains the number of samples, minimum, maximum, mean, p50, p99 and p99.9 values.
+        //! @param [in] divisor All values are divided by this value before display. Typically used
+        //! to display PCR units (27 MHz) as micro-seconds with @a divisor set to 27.
+        //! @return A summary string.
+        //!
+        UString summary(int64_t divisor = 1) const;
+
+    private:
+        size_t   _precision;      // Number of precision bits.
+        size_t   _max_bits;       // Max number of significant bits in an absolute value.
+        uint64_t _max_abs;        // Max absolute value (clamped above).
+        uint64_t _count = 0;      // Number of samples.
+        int64_t  _min = 0;        // Minimum value.
+        int64_t  _max = 0;        // Maximum value.
+        int64_t  _sum = 0;        // Sum of values (for mean).
+        std::vector<uint64_t> _neg {};  // Buckets for negative values, indexed by absolute value.
+        std::vector<uint64_t> _pos {};  // Buckets for positive or zero values.
+
+        // Compute the bucket index for an absolute value.
+        size_t bucketIndex(uint64_t value) const;
+
+        // Compute the middle value of a bucket.
+        uint64_t bucketValue(size_t index) const;
+    };
+}
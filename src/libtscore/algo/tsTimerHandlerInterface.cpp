@@ -0,0 +1,13 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTimerHandlerInterface.h"
+
+ts::TimerHandlerInterface::~TimerHandlerInterface()
+{
+}
@@ -0,0 +1,38 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Expiration handler interface for timers in a timer wheel.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+
+    class TimerWheel;
+
+    //!
+    //! Expiration handler interface for timers in a timer wheel.
+    //! @ingroup libtscore thread
+    //!
+    class TSCOREDLL TimerHandlerInterface
+    {
+        TS_INTERFACE(TimerHandlerInterface);
+    public:
+        //!
+        //! Handle the expiration of a timer.
+        //! The handler is executed in the context of the internal thread of the timer wheel.
+        //! It must be short and must not block since all timers of the wheel are serviced by the same thread.
+        //! @param [in,out] wheel The timer wheel which triggered the timer.
+        //! @param [in] timer_id The identifier of the expired timer, as returned by TimerWheel::startTimer().
+        //!
+        virtual void handleTimer(TimerWheel& wheel, uint64_t timer_id) = 0;
+    };
+}
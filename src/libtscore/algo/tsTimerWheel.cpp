@@ -0,0 +1,310 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTimerWheel.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::TimerWheel::TimerWheel(cn::milliseconds resolution, Report& log) :
+    _log(log),
+    _resolution(std::max(resolution, cn::milliseconds(1))),
+    _origin(monotonic_time::clock::now())
+{
+}
+
+ts::TimerWheel::~TimerWheel()
+{
+    // Terminate the thread and wait for actual thread termination.
+    // Does nothing if the thread has not been started.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _terminate = true;
+        _wakeup.notify_all();
+    }
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Get a process-wide timer wheel.
+//----------------------------------------------------------------------------
+
+ts::TimerWheel& ts::TimerWheel::Shared()
+{
+    static TimerWheel wheel;
+    return wheel;
+}
+
+
+//----------------------------------------------------------------------------
+// Convert between time and ticks.
+//----------------------------------------------------------------------------
+
+uint64_t ts::TimerWheel::timeToTick(monotonic_time time, bool round_up) const
+{
+    if (time <= _origin) {
+        return 0;
+    }
+    const auto res = cn::duration_cast<cn::nanoseconds>(_resolution).count();
+    const auto elapsed = cn::duration_cast<cn::nanoseconds>(time - _origin).count();
+    return uint64_t((round_up ? elapsed + res - 1 : elapsed) / res);
+}
+
+ts::monotonic_time ts::TimerWheel::tickToTime(uint64_t tick) const
+{
+    return _origin + _resolution * tick;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a timer in the appropriate slot. Must be called with mutex held.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::insert(Timer& timer)
+{
+    // Late timers are placed in the next slot to process.
+    // Timers which are too far in the future are placed in the last slot of the highest level.
+    // They will be reinserted later, when their slot is moved to the lower levels.
+    uint64_t expire = std::max(timer.expire, _tick);
+    if (expire - _tick > MAX_DELTA) {
+        expire = _tick + MAX_DELTA;
+    }
+    const uint64_t delta = expire - _tick;
+
+    // Find the level which covers this delta.
+    size_t level = 0;
+    while (level + 1 < LEVEL_COUNT && delta >= (uint64_t(1) << (LEVEL_BITS * (level + 1)))) {
+        level++;
+    }
+
+    TimerList& slot(_wheel[level][size_t(expire >> (LEVEL_BITS * level)) & LEVEL_MASK]);
+    timer.position = slot.insert(slot.end(), &timer);
+    timer.slot = &slot;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a timer from its slot. Must be called with mutex held.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::unlink(Timer& timer)
+{
+    if (timer.slot != nullptr) {
+        timer.slot->erase(timer.position);
+        timer.slot = nullptr;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Move the timers of a slot of a higher level to the lower levels.
+//----------------------------------------------------------------------------
+
+size_t ts::TimerWheel::cascade(size_t level)
+{
+    const size_t index = size_t(_tick >> (LEVEL_BITS * level)) & LEVEL_MASK;
+    TimerList list;
+    list.swap(_wheel[level][index]);
+    for (Timer* timer : list) {
+        insert(*timer);
+    }
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Process one tick, collect the identifiers of expired timers.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::processTick(std::vector<uint64_t>& expired)
+{
+    // At the beginning of each round of the first level, move timers from the higher levels.
+    const size_t index = size_t(_tick) & LEVEL_MASK;
+    if (index == 0) {
+        for (size_t level = 1; level < LEVEL_COUNT && cascade(level) == 0; ++level) {
+        }
+    }
+
+    // Extract the expired timers. Periodic timers are immediately reinserted for their next expiration.
+    TimerList list;
+    list.swap(_wheel[0][index]);
+    const uint64_t now = _tick++;
+    for (Timer* timer : list) {
+        timer->slot = nullptr;
+        expired.push_back(timer->id);
+        if (timer->period > 0) {
+            // Skip missed periods, if any, to avoid a burst of expirations.
+            timer->expire += timer->period;
+            if (timer->expire <= now) {
+                timer->expire += ((now - timer->expire) / timer->period + 1) * timer->period;
+            }
+            insert(*timer);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the next tick to process. Must be called with mutex held.
+//----------------------------------------------------------------------------
+
+uint64_t ts::TimerWheel::nextWakeupTick() const
+{
+    // The search is bounded. Without expired timer in a reasonable time, the thread is awakened
+    // anyway and processes all intermediate ticks at once, which is cheap for empty slots.
+    const uint64_t last = _tick + LEVEL_SLOTS * LEVEL_SLOTS;
+    for (uint64_t tick = _tick; tick < last; ++tick) {
+        const size_t index = size_t(tick) & LEVEL_MASK;
+        if (!_wheel[0][index].empty()) {
+            return tick;
+        }
+        // At the beginning of a round of the first level, check if timers must be moved from the higher levels.
+        if (index == 0) {
+            for (size_t level = 1; level < LEVEL_COUNT; ++level) {
+                const size_t lindex = size_t(tick >> (LEVEL_BITS * level)) & LEVEL_MASK;
+                if (!_wheel[level][lindex].empty()) {
+                    return tick;
+                }
+                if (lindex != 0) {
+                    break;
+                }
+            }
+        }
+    }
+    return last;
+}
+
+
+//----------------------------------------------------------------------------
+// Start a new timer.
+//----------------------------------------------------------------------------
+
+uint64_t ts::TimerWheel::startTimer(TimerHandlerInterface* handler, cn::milliseconds delay, cn::milliseconds period)
+{
+    if (handler == nullptr) {
+        return INVALID_TIMER;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const monotonic_time now = monotonic_time::clock::now();
+
+    // When the wheel is idle, the thread does not process ticks. Resynchronize with the current time.
+    if (_timers.empty()) {
+        _tick = std::max(_tick, timeToTick(now, false));
+    }
+
+    const uint64_t id = _next_id++;
+    Timer& timer(_timers[id]);
+    timer.id = id;
+    timer.handler = handler;
+    timer.expire = timeToTick(now + std::max(delay, cn::milliseconds::zero()), true);
+    if (period > cn::milliseconds::zero()) {
+        timer.period = std::max<uint64_t>(1, uint64_t((period + _resolution - cn::milliseconds(1)) / _resolution));
+    }
+    insert(timer);
+
+    if (_started) {
+        _wakeup.notify_all();
+    }
+    else {
+        _started = true;
+        Thread::start();
+    }
+    return id;
+}
+
+
+//----------------------------------------------------------------------------
+// Cancel a timer.
+//----------------------------------------------------------------------------
+
+bool ts::TimerWheel::cancelTimer(uint64_t timer_id)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    const auto it = _timers.find(timer_id);
+    const bool found = it != _timers.end();
+    if (found) {
+        unlink(it->second);
+        _timers.erase(it);
+    }
+
+    // Wait for the completion of the handler of this timer, if currently executing.
+    if (timer_id != INVALID_TIMER && _running_id == timer_id && !isCurrentThread()) {
+        _handler_done.wait(lock, [this, timer_id]() { return _running_id != timer_id; });
+    }
+    return found;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of active timers.
+//----------------------------------------------------------------------------
+
+size_t ts::TimerWheel::timerCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _timers.size();
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the context of the internal thread.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::main()
+{
+    _log.debug(u"timer wheel thread started, resolution: %s", _resolution);
+
+    std::vector<uint64_t> expired;
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_terminate) {
+
+        // Process all elapsed ticks.
+        const uint64_t now = timeToTick(monotonic_time::clock::now(), false);
+        while (_tick <= now) {
+            processTick(expired);
+        }
+
+        // Invoke the handlers of expired timers. No longer under mutex protection to avoid deadlocks in handlers.
+        for (size_t i = 0; !_terminate && i < expired.size(); ++i) {
+            const auto it = _timers.find(expired[i]);
+            if (it == _timers.end()) {
+                continue; // canceled in the meantime
+            }
+            TimerHandlerInterface* const handler = it->second.handler;
+            if (it->second.period == 0) {
+                _timers.erase(it);
+            }
+            _running_id = expired[i];
+            lock.unlock();
+            handler->handleTimer(*this, expired[i]);
+            lock.lock();
+            _running_id = INVALID_TIMER;
+            _handler_done.notify_all();
+        }
+        if (!expired.empty()) {
+            // Time has elapsed in the handlers, recheck the ticks.
+            expired.clear();
+            continue;
+        }
+
+        // Wait until the next non-empty slot or until the timers change.
+        if (_timers.empty()) {
+            _wakeup.wait(lock);
+        }
+        else {
+            _wakeup.wait_until(lock, tickToTime(nextWakeupTick()));
+        }
+    }
+
+    _log.debug(u"timer wheel thread completed");
+}
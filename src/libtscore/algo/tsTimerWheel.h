@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Hierarchical timer wheel with a dedicated thread.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTimerHandlerInterface.h"
+#include "tsNullReport.h"
+#include "tsThread.h"
+
+namespace ts {
+    //!
+    //! Hierarchical timer wheel with a dedicated thread.
+    //! @ingroup libtscore thread
+    //!
+    //! A timer wheel manages a large number of one-shot or periodic timers. When a timer
+    //! expires, a handler is invoked in the context of the internal thread of the wheel.
+    //! Components which need periodic processing can register a timer instead of checking
+    //! the system clock on each data unit (packet, message, etc.)
+    //!
+    //! The time is divided in ticks of fixed duration (the resolution of the wheel).
+    //! The timers are stored in several levels of slots, each level covering a time range
+    //! which is 64 times larger than the previous one. Starting and canceling a timer are
+    //! O(1) operations. The timers of a higher level are moved to the lower levels as the
+    //! time progresses. The internal thread is awakened only when a slot contains expired
+    //! timers or when timers must be moved between levels.
+    //!
+    //! The internal thread is started when the first timer is started and terminated in the
+    //! destructor. A process-wide instance is available using Shared().
+    //!
+    class TSCOREDLL TimerWheel : private Thread
+    {
+        TS_NOCOPY(TimerWheel);
+    public:
+        //!
+        //! Default resolution of a timer wheel.
+        //!
+        static constexpr cn::milliseconds DEFAULT_RESOLUTION = cn::milliseconds(1);
+
+        //!
+        //! Value of an invalid timer identifier.
+        //!
+        static constexpr uint64_t INVALID_TIMER = 0;
+
+        //!
+        //! Constructor.
+        //! @param [in] resolution Duration of a tick in the timer wheel. All expiration
+        //! times are rounded up to the next tick.
+        //! @param [in,out] log Log report for debug messages.
+        //!
+        TimerWheel(cn::milliseconds resolution = DEFAULT_RESOLUTION, Report& log = NULLREP);
+
+        //!
+        //! Destructor.
+        //! All timers are canceled and the internal thread is terminated.
+        //!
+        virtual ~TimerWheel() override;
+
+        //!
+        //! Get a process-wide timer wheel, with the default resolution.
+        //! The instance is created on first use.
+        //! @return A reference to the process-wide timer wheel.
+        //!
+        static TimerWheel& Shared();
+
+        //!
+        //! Start a new timer.
+        //! @param [in] handler The handler to call when the timer expires. Must not be null.
+        //! @param [in] delay Delay before the first expiration of the timer.
+        //! @param [in] period If non zero, the timer is periodic and automatically restarted
+        //! with this period after each expiration. The expiration times do not drift, they remain
+        //! multiples of the period after the first expiration, even if a handler is late.
+        //! @return The identifier of the new timer or INVALID_TIMER on error.
+        //!
+        uint64_t startTimer(TimerHandlerInterface* handler, cn::milliseconds delay, cn::milliseconds period = cn::milliseconds::zero());
+
+        //!
+        //! Cancel a timer.
+        //! If the handler of the timer is currently executing in the internal thread, wait for the completion
+        //! of the handler, unless cancelTimer() is called from the handler itself. Therefore, after returning
+        //! from cancelTimer(), the handler is no longer used by the timer wheel and can be safely deallocated.
+        //! @param [in] timer_id Identifier of the timer to cancel, as returned by startTimer().
+        //! @return True if the timer was active and canceled, false if it did not exist or already expired.
+        //!
+        bool cancelTimer(uint64_t timer_id);
+
+        //!
+        //! Get the number of active timers.
+        //! @return The number of active timers.
+        //!
+        size_t timerCount() const;
+
+        //!
+        //! Get the resolution of the timer wheel.
+        //! @return The duration of a tick in the timer wheel.
+        //!
+        cn::milliseconds resolution() const { return _resolution; }
+
+    private:
+        // Number of levels and slots per level in the wheel.
+        static constexpr size_t LEVEL_BITS = 6;
+        static constexpr size_t LEVEL_SLOTS = size_t(1) << LEVEL_BITS;
+        static constexpr size_t LEVEL_MASK = LEVEL_SLOTS - 1;
+        static constexpr size_t LEVEL_COUNT = 4;
+        static constexpr uint64_t MAX_DELTA = (uint64_t(1) << (LEVEL_BITS * LEVEL_COUNT)) - 1;
+
+        // Description of a timer.
+        class Timer;
+        using TimerList = std::list<Timer*>;
+        class Timer
+        {
+        public:
+            uint64_t               id = INVALID_TIMER;   // Timer identifier.
+            TimerHandlerInterface* handler = nullptr;    // Expiration handler.
+            uint64_t               expire = 0;           // Expiration tick.
+            uint64_t               period = 0;           // Period in ticks, zero for one-shot timers.
+            TimerList*             slot = nullptr;       // Slot containing the timer.
+            TimerList::iterator    position {};          // Position in the slot.
+        };
+
+        Report&                   _log;                         // For debug messages.
+        const cn::milliseconds    _resolution;                  // Duration of a tick.
+        const monotonic_time      _origin;                      // Time of tick zero.
+        mutable std::mutex        _mutex {};                    // Protect all the following fields.
+        std::condition_variable   _wakeup {};                   // Signaled when the timers changed.
+        std::condition_variable   _handler_done {};             // Signaled when a handler completed.
+        bool                      _terminate = false;           // Terminate the thread.
+        bool                      _started = false;             // The thread is started.
+        uint64_t                  _next_id = 1;                 // Next timer identifier.
+        uint64_t                  _tick = 0;                    // Next tick to process.
+        uint64_t                  _running_id = INVALID_TIMER;  // Timer whose handler is currently executing.
+        std::map<uint64_t, Timer> _timers {};                   // All active timers, indexed by id.
+        std::array<std::array<TimerList, LEVEL_SLOTS>, LEVEL_COUNT> _wheel {};  // All levels of slots.
+
+        // Convert between time and ticks.
+        uint64_t timeToTick(monotonic_time time, bool round_up) const;
+        monotonic_time tickToTime(uint64_t tick) const;
+
+        // Insert a timer in the appropriate slot. Must be called with mutex held.
+        void insert(Timer& timer);
+
+        // Remove a timer from its slot. Must be called with mutex held.
+        void unlink(Timer& timer);
+
+        // Move the timers of a slot of a higher level to the lower levels. Must be called with mutex held.
+        // Return the index of the slot in the level.
+        size_t cascade(size_t level);
+
+        // Process one tick, collect the identifiers of expired timers. Must be called with mutex held.
+        void processTick(std::vector<uint64_t>& expired);
+
+        // Compute the next tick to process. Must be called with mutex held.
+        uint64_t nextWakeupTick() const;
+
+        // Implementation of Thread.
+        virtual void main() override;
+    };
+}
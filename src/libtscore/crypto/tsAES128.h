@@ -43,6 +43,7 @@ namespace ts {
         virtual void getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const override;
 #elif !defined(TS_NO_OPENSSL)
         virtual const EVP_CIPHER* getAlgorithm() const override;
+        virtual const EVP_CIPHER* getNativeAlgorithm(NativeMode mode) const override;
 #endif
     };
 
@@ -56,9 +57,12 @@ namespace ts {
         TS_NOCOPY(ECB);
     public:
         ECB();
+        virtual bool hasContextInPlace() const override;
     protected:
         static const BlockCipherProperties& Properties();
         ECB(const BlockCipherProperties& props);
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
 #if defined(TS_WINDOWS)
         virtual void getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const override;
 #elif !defined(TS_NO_OPENSSL)
@@ -72,9 +76,12 @@ namespace ts {
         TS_NOCOPY(CBC);
     public:
         CBC();
+        virtual bool hasContextInPlace() const override;
     protected:
         static const BlockCipherProperties& Properties();
         CBC(const BlockCipherProperties& props);
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
 #if defined(TS_WINDOWS)
         virtual void getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const override;
 #elif !defined(TS_NO_OPENSSL)
@@ -65,6 +65,20 @@ const EVP_CIPHER* ts::AES256::getAlgorithm() const
     return fetch.algorithm();
 }
 
+const EVP_CIPHER* ts::AES256::getNativeAlgorithm(NativeMode mode) const
+{
+    // Thread-safe init-safe static data pattern:
+    static const FetchCipherAlgorithm fetch_ecb("AES-256-ECB");
+    static const FetchCipherAlgorithm fetch_cbc("AES-256-CBC");
+    static const FetchCipherAlgorithm fetch_ctr("AES-256-CTR");
+    switch (mode) {
+        case NativeMode::ECB: return fetch_ecb.algorithm();
+        case NativeMode::CBC: return fetch_cbc.algorithm();
+        case NativeMode::CTR: return fetch_ctr.algorithm();
+        default: return nullptr;
+    }
+}
+
 #endif
 
 
@@ -92,6 +106,21 @@ ts::ECB<ts::AES256>::ECB(const BlockCipherProperties& props) : AES256(props)
     canProcessInPlace(true);
 }
 
+bool ts::ECB<ts::AES256>::hasContextInPlace() const
+{
+    return nativeAvailable(NativeMode::ECB);
+}
+
+bool ts::ECB<ts::AES256>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceECB(context, true, messages, sizes, count);
+}
+
+bool ts::ECB<ts::AES256>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceECB(context, false, messages, sizes, count);
+}
+
 #if defined(TS_WINDOWS)
 
 void ts::ECB<ts::AES256>::getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const
@@ -137,6 +166,21 @@ ts::CBC<ts::AES256>::CBC(const BlockCipherProperties& props) : AES256(props)
     canProcessInPlace(true);
 }
 
+bool ts::CBC<ts::AES256>::hasContextInPlace() const
+{
+    return nativeAvailable(NativeMode::ECB);
+}
+
+bool ts::CBC<ts::AES256>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceCBC(context, true, messages, sizes, count);
+}
+
+bool ts::CBC<ts::AES256>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceCBC(context, false, messages, sizes, count);
+}
+
 #if defined(TS_WINDOWS)
 
 void ts::CBC<ts::AES256>::getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const
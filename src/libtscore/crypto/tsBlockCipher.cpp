@@ -10,6 +10,7 @@
 #include "tsBlockCipherAlertInterface.h"
 #include "tsInitCryptoLibrary.h"
 #include "tsFatal.h"
+#include "tsMemory.h"
 
 
 //----------------------------------------------------------------------------
@@ -42,14 +43,7 @@ ts::BlockCipher::~BlockCipher()
 
 #elif !defined(TS_NO_OPENSSL)
 
-    if (_encrypt != nullptr) {
-        EVP_CIPHER_CTX_free(_encrypt);
-        _encrypt = nullptr;
-    }
-    if (_decrypt != nullptr) {
-        EVP_CIPHER_CTX_free(_decrypt);
-        _decrypt = nullptr;
-    }
+    _context.clear();
     _algo = nullptr;
 
 #endif
@@ -116,9 +110,27 @@ const EVP_CIPHER* ts::BlockCipher::getAlgorithm() const
     return nullptr;
 }
 
+const EVP_CIPHER* ts::BlockCipher::getNativeAlgorithm(NativeMode) const
+{
+    return nullptr;
+}
+
 #endif
 
 
+//----------------------------------------------------------------------------
+// Allocate a unique identity for a newly scheduled key.
+//----------------------------------------------------------------------------
+
+uint64_t ts::BlockCipher::NewKeyId()
+{
+    // Start at 1, zero means no key. Identities are unique among all instances,
+    // because a context can be used with several block ciphers.
+    static std::atomic<uint64_t> last_id {0};
+    return ++last_id;
+}
+
+
 //----------------------------------------------------------------------------
 // Schedule a new key.
 //----------------------------------------------------------------------------
@@ -148,6 +160,7 @@ bool ts::BlockCipher::setKey(const void* key, size_t key_length, const void* iv,
 #endif
         }
         _key_set = setKeyImpl();
+        _key_id = _key_set ? NewKeyId() : 0;
         return _key_set;
     }
     else {
@@ -177,6 +190,7 @@ bool ts::BlockCipher::setIV(const void* iv, size_t iv_length)
     else {
         // A key was already set, set it again, in case IV is used here.
         _key_set = setKeyImpl();
+        _key_id = _key_set ? NewKeyId() : 0;
         return _key_set;
     }
 }
@@ -186,10 +200,15 @@ bool ts::BlockCipher::setIV(const void* iv, size_t iv_length)
 // Check if encryption or decryption is allowed. Increment counters.
 //----------------------------------------------------------------------------
 
-bool ts::BlockCipher::allowEncrypt()
+bool ts::BlockCipher::keyReady() const
 {
     // Check that a key and IV were successfully set.
-    if (!_key_set || _current_iv.size() < properties.min_iv_size || _current_iv.size() > properties.max_iv_size) {
+    return _key_set && _current_iv.size() >= properties.min_iv_size && _current_iv.size() <= properties.max_iv_size;
+}
+
+bool ts::BlockCipher::allowEncrypt()
+{
+    if (!keyReady()) {
         return false;
     }
 
@@ -214,8 +233,7 @@ bool ts::BlockCipher::allowEncrypt()
 
 bool ts::BlockCipher::allowDecrypt()
 {
-    // Check that a key and IV were successfully set.
-    if (!_key_set || _current_iv.size() < properties.min_iv_size || _current_iv.size() > properties.max_iv_size) {
+    if (!keyReady()) {
         return false;
     }
 
@@ -335,16 +353,9 @@ bool ts::BlockCipher::setKeyImpl()
     // decrypt. We delay the initialization until necessary to avoid useless init when
     // the application uses only one operation, encrypt or decrypt. At that time, we
     // will use the key data from _current_key.
-
-    // Terminate previous key contexts if not yet done.
-    if (_encrypt != nullptr) {
-        EVP_CIPHER_CTX_free(_encrypt);
-        _encrypt = nullptr;
-    }
-    if (_decrypt != nullptr) {
-        EVP_CIPHER_CTX_free(_decrypt);
-        _decrypt = nullptr;
-    }
+    //
+    // The contexts are not freed here. They are kept in _context and the new key is
+    // scheduled in an existing context when it is first used (see keyedContext()).
 
     return true;
 
@@ -399,24 +410,14 @@ bool ts::BlockCipher::encryptImpl(const void* plain, size_t plain_length, void*
         return false;
     }
 
-    // Initialize key encryption context the first time.
-    if (_encrypt == nullptr) {
-        if ((_encrypt = EVP_CIPHER_CTX_new()) == nullptr) {
-            PrintCryptographicLibraryErrors();
-            return false;
-        }
-        if (EVP_EncryptInit_ex(_encrypt, _algo, nullptr, _current_key.data(), nullptr) <= 0 ||
-            EVP_CIPHER_CTX_set_padding(_encrypt, 0) <= 0)
-        {
-            EVP_CIPHER_CTX_free(_encrypt);
-            _encrypt = nullptr;
-            PrintCryptographicLibraryErrors();
-            return false;
-        }
+    // Get the encryption context with the current key.
+    EVP_CIPHER_CTX* ctx = keyedContext(_context, SlotIndex(true), _algo, true);
+    if (ctx == nullptr) {
+        return false;
     }
 
     // Set the IV before each encryption.
-    if (!_current_iv.empty() && EVP_EncryptInit_ex(_encrypt, nullptr, nullptr, nullptr, _current_iv.data()) <= 0) {
+    if (!_current_iv.empty() && EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, _current_iv.data()) <= 0) {
         return false;
     }
     // Perform complete encryption.
@@ -424,8 +425,8 @@ bool ts::BlockCipher::encryptImpl(const void* plain, size_t plain_length, void*
     unsigned char* output = reinterpret_cast<unsigned char*>(cipher);
     int output_len = 0;
     int final_len = 0;
-    if (EVP_EncryptUpdate(_encrypt, output, &output_len, input, int(plain_length)) <= 0 ||
-        EVP_EncryptFinal_ex(_encrypt, output + output_len, &final_len) <= 0)
+    if (EVP_EncryptUpdate(ctx, output, &output_len, input, int(plain_length)) <= 0 ||
+        EVP_EncryptFinal_ex(ctx, output + output_len, &final_len) <= 0)
     {
         PrintCryptographicLibraryErrors();
         return false;
@@ -481,24 +482,14 @@ bool ts::BlockCipher::decryptImpl(const void* cipher, size_t cipher_length, void
         return false;
     }
 
-    // Initialize key decryption context the first time.
-    if (_decrypt == nullptr) {
-        if ((_decrypt = EVP_CIPHER_CTX_new()) == nullptr) {
-            PrintCryptographicLibraryErrors();
-            return false;
-        }
-        if (EVP_DecryptInit_ex(_decrypt, _algo, nullptr, _current_key.data(), nullptr) <= 0 ||
-            EVP_CIPHER_CTX_set_padding(_decrypt, 0) <= 0)
-        {
-            EVP_CIPHER_CTX_free(_decrypt);
-            _decrypt = nullptr;
-            PrintCryptographicLibraryErrors();
-            return false;
-        }
+    // Get the decryption context with the current key.
+    EVP_CIPHER_CTX* ctx = keyedContext(_context, SlotIndex(false), _algo, false);
+    if (ctx == nullptr) {
+        return false;
     }
 
     // Set the IV before each decryption.
-    if (!_current_iv.empty() && EVP_DecryptInit_ex(_decrypt, nullptr, nullptr, nullptr, _current_iv.data()) <= 0) {
+    if (!_current_iv.empty() && EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, _current_iv.data()) <= 0) {
         return false;
     }
     // Perform complete decryption.
@@ -506,8 +497,8 @@ bool ts::BlockCipher::decryptImpl(const void* cipher, size_t cipher_length, void
     unsigned char* output = reinterpret_cast<unsigned char*>(plain);
     int output_len = 0;
     int final_len = 0;
-    if (EVP_DecryptUpdate(_decrypt, output, &output_len, input, int(cipher_length)) <= 0 ||
-        EVP_DecryptFinal_ex(_decrypt, output + output_len, &final_len) <= 0)
+    if (EVP_DecryptUpdate(ctx, output, &output_len, input, int(cipher_length)) <= 0 ||
+        EVP_DecryptFinal_ex(ctx, output + output_len, &final_len) <= 0)
     {
         PrintCryptographicLibraryErrors();
         return false;
@@ -529,3 +520,340 @@ bool ts::BlockCipher::decryptImpl(const void* cipher, size_t cipher_length, void
 
 #endif
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt / decrypt several independent messages in place.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptInPlace(void* const messages[], const size_t sizes[], size_t count)
+{
+    // Each message counts as one encryption for the key usage limitations.
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowEncrypt()) {
+            return false;
+        }
+    }
+    return count == 0 || encryptInPlaceImpl(messages, sizes, count);
+}
+
+bool ts::BlockCipher::decryptInPlace(void* const messages[], const size_t sizes[], size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowDecrypt()) {
+            return false;
+        }
+    }
+    return count == 0 || decryptInPlaceImpl(messages, sizes, count);
+}
+
+bool ts::BlockCipher::encryptInPlace(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return keyReady() && hasContextInPlace() && (count == 0 || contextEncryptInPlaceImpl(context, messages, sizes, count));
+}
+
+bool ts::BlockCipher::decryptInPlace(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return keyReady() && hasContextInPlace() && (count == 0 || contextDecryptInPlaceImpl(context, messages, sizes, count));
+}
+
+// Default implementation: multi-message operations with a context are not supported.
+bool ts::BlockCipher::hasContextInPlace() const
+{
+    return false;
+}
+
+bool ts::BlockCipher::contextEncryptInPlaceImpl(BlockCipherContext&, void* const[], const size_t[], size_t) const
+{
+    return false;
+}
+
+bool ts::BlockCipher::contextDecryptInPlaceImpl(BlockCipherContext&, void* const[], const size_t[], size_t) const
+{
+    return false;
+}
+
+bool ts::BlockCipher::encryptInPlaceImpl(void* const messages[], const size_t sizes[], size_t count)
+{
+    // Use the multi-message implementation of the subclass with the context of this object.
+    if (hasContextInPlace()) {
+        return contextEncryptInPlaceImpl(_context, messages, sizes, count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (_can_process_in_place) {
+            if (!encryptImpl(messages[i], sizes[i], messages[i], sizes[i], nullptr)) {
+                return false;
+            }
+        }
+        else {
+            const ByteBlock plain(messages[i], sizes[i]);
+            if (!encryptImpl(plain.data(), plain.size(), messages[i], sizes[i], nullptr)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool ts::BlockCipher::decryptInPlaceImpl(void* const messages[], const size_t sizes[], size_t count)
+{
+    if (hasContextInPlace()) {
+        return contextDecryptInPlaceImpl(_context, messages, sizes, count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (_can_process_in_place) {
+            if (!decryptImpl(messages[i], sizes[i], messages[i], sizes[i], nullptr)) {
+                return false;
+            }
+        }
+        else {
+            const ByteBlock cipher(messages[i], sizes[i]);
+            if (!decryptImpl(cipher.data(), cipher.size(), messages[i], sizes[i], nullptr)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt the complete blocks of several messages in CBC mode, interleaved.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::interleavedEncryptCBC(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count, const void* iv) const
+{
+    const size_t bsize = properties.block_size;
+    if (!nativeAvailable(NativeMode::ECB) || bsize == 0) {
+        return false;
+    }
+    ByteBlock& lanes_buf(context._work);
+    lanes_buf.resize(MAX_LANES * bsize);
+    std::array<uint8_t*, MAX_LANES> msg {};
+    std::array<size_t, MAX_LANES> blocks {};
+
+    // Process messages by groups of MAX_LANES.
+    for (size_t base = 0; base < count; base += MAX_LANES) {
+        const size_t width = std::min(MAX_LANES, count - base);
+        size_t max_blocks = 0;
+        for (size_t i = 0; i < width; ++i) {
+            msg[i] = reinterpret_cast<uint8_t*>(messages[base + i]);
+            blocks[i] = sizes[base + i] / bsize;
+            max_blocks = std::max(max_blocks, blocks[i]);
+        }
+        // At each step, encrypt the block of same index in all messages which are long enough.
+        for (size_t blk = 0; blk < max_blocks; ++blk) {
+            const size_t offset = blk * bsize;
+            size_t lanes = 0;
+            for (size_t i = 0; i < width; ++i) {
+                if (blk < blocks[i]) {
+                    // lane = previous-cipher XOR plain-text
+                    MemXor(lanes_buf.data() + lanes++ * bsize, blk == 0 ? iv : msg[i] + offset - bsize, msg[i] + offset, bsize);
+                }
+            }
+            if (!nativeEncrypt(context, NativeMode::ECB, nullptr, lanes_buf.data(), lanes * bsize, lanes_buf.data())) {
+                return false;
+            }
+            lanes = 0;
+            for (size_t i = 0; i < width; ++i) {
+                if (blk < blocks[i]) {
+                    MemCopy(msg[i] + offset, lanes_buf.data() + lanes++ * bsize, bsize);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt the complete blocks of several independent messages in CBC mode.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::interleavedDecryptCBC(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count, const void* iv) const
+{
+    const size_t bsize = properties.block_size;
+    if (!nativeAvailable(NativeMode::ECB) || bsize == 0) {
+        return false;
+    }
+
+    // Gather all complete blocks of all messages.
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += sizes[i] - sizes[i] % bsize;
+    }
+    if (total == 0) {
+        return true;
+    }
+    ByteBlock& lanes_buf(context._work);
+    lanes_buf.resize(total);
+    uint8_t* lane = lanes_buf.data();
+    for (size_t i = 0; i < count; ++i) {
+        const size_t len = sizes[i] - sizes[i] % bsize;
+        MemCopy(lane, messages[i], len);
+        lane += len;
+    }
+
+    // Decrypt all blocks at once.
+    if (!nativeDecrypt(context, NativeMode::ECB, nullptr, lanes_buf.data(), total, lanes_buf.data())) {
+        return false;
+    }
+
+    // plain-text = previous-cipher XOR decrypted-block. Process the blocks of each message
+    // backward so that the previous cipher block is still in the message.
+    lane = lanes_buf.data();
+    for (size_t i = 0; i < count; ++i) {
+        const size_t len = sizes[i] - sizes[i] % bsize;
+        uint8_t* msg = reinterpret_cast<uint8_t*>(messages[i]);
+        for (size_t offset = len; offset > 0; ) {
+            offset -= bsize;
+            MemXor(msg + offset, offset == 0 ? iv : msg + offset - bsize, lane + offset, bsize);
+        }
+        lane += len;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Multi-message implementations with a context of ECB and CBC modes.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::inPlaceECB(BlockCipherContext& context, bool encrypt, void* const messages[], const size_t sizes[], size_t count) const
+{
+    // No residue processing in ECB mode.
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] % properties.block_size != 0 || !contextProcess(context, NativeMode::ECB, encrypt, nullptr, messages[i], sizes[i], messages[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::BlockCipher::inPlaceCBC(BlockCipherContext& context, bool encrypt, void* const messages[], const size_t sizes[], size_t count) const
+{
+    // No residue processing in CBC mode.
+    const size_t bsize = properties.block_size;
+    if (currentIV().size() != bsize) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] % bsize != 0) {
+            return false;
+        }
+    }
+    return encrypt ?
+        interleavedEncryptCBC(context, messages, sizes, count, currentIV().data()) :
+        interleavedDecryptCBC(context, messages, sizes, count, currentIV().data());
+}
+
+
+//----------------------------------------------------------------------------
+// Process a message using a native chaining mode.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::nativeEncrypt(NativeMode mode, const void* iv, const void* plain, size_t length, void* cipher)
+{
+    return contextProcess(_context, mode, true, iv, plain, length, cipher);
+}
+
+bool ts::BlockCipher::nativeDecrypt(NativeMode mode, const void* iv, const void* cipher, size_t length, void* plain)
+{
+    return contextProcess(_context, mode, false, iv, cipher, length, plain);
+}
+
+bool ts::BlockCipher::nativeAvailable([[maybe_unused]] NativeMode mode) const
+{
+#if !defined(TS_WINDOWS) && !defined(TS_NO_OPENSSL)
+    return getNativeAlgorithm(mode) != nullptr;
+#else
+    return false;
+#endif
+}
+
+bool ts::BlockCipher::contextProcess([[maybe_unused]] BlockCipherContext& context,
+                                     [[maybe_unused]] NativeMode mode,
+                                     [[maybe_unused]] bool encrypt,
+                                     [[maybe_unused]] const void* iv,
+                                     [[maybe_unused]] const void* input,
+                                     [[maybe_unused]] size_t length,
+                                     [[maybe_unused]] void* output) const
+{
+#if !defined(TS_WINDOWS) && !defined(TS_NO_OPENSSL)
+
+    if (!_key_set || _key_id == 0 || size_t(mode) >= NATIVE_MODE_COUNT || (mode != NativeMode::CTR && length % properties.block_size != 0)) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+
+    // OpenSSL refuses partially overlapping buffers, let the caller use its own implementation.
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(input);
+    uint8_t* out = reinterpret_cast<uint8_t*>(output);
+    if (in != out && in < out + length && out < in + length) {
+        return false;
+    }
+
+    // Get the context of the native mode with the current key.
+    const EVP_CIPHER* algo = getNativeAlgorithm(mode);
+    EVP_CIPHER_CTX* ctx = algo == nullptr ? nullptr : keyedContext(context, SlotIndex(mode, encrypt), algo, encrypt);
+    if (ctx == nullptr) {
+        return false;
+    }
+
+    // Set the IV before each operation (-1 means keep encrypt or decrypt direction).
+    // Without padding, all data are produced by the update operation, no need to finalize.
+    int output_len = 0;
+    if ((mode != NativeMode::ECB && EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, reinterpret_cast<const unsigned char*>(iv), -1) <= 0) ||
+        EVP_CipherUpdate(ctx, out, &output_len, in, int(length)) <= 0)
+    {
+        PrintCryptographicLibraryErrors();
+        return false;
+    }
+    if (size_t(output_len) != length) {
+        TS_FATAL("Invalid output size in OpenSSL native chaining mode");
+    }
+    return true;
+
+#else
+
+    // Native chaining modes are not used with Windows BCrypt or without cryptographic library.
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Get an OpenSSL context in a slot, with the current key scheduled.
+//----------------------------------------------------------------------------
+
+#if !defined(TS_WINDOWS) && !defined(TS_NO_OPENSSL)
+
+EVP_CIPHER_CTX* ts::BlockCipher::keyedContext(BlockCipherContext& context, size_t slot, const EVP_CIPHER* algo, bool encrypt) const
+{
+    assert(slot < context._slots.size());
+    BlockCipherContext::Slot& sl(context._slots[slot]);
+
+    // Allocate the OpenSSL context the first time only. It is reused for all subsequent keys.
+    if (sl.ctx == nullptr && (sl.ctx = EVP_CIPHER_CTX_new()) == nullptr) {
+        PrintCryptographicLibraryErrors();
+        return nullptr;
+    }
+
+    // Schedule the key when the context was last used with another key (possibly from another block cipher).
+    if (sl.key_id != _key_id) {
+        if (EVP_CipherInit_ex(sl.ctx, algo, nullptr, _current_key.data(), nullptr, encrypt ? 1 : 0) <= 0 ||
+            EVP_CIPHER_CTX_set_padding(sl.ctx, 0) <= 0)
+        {
+            sl.key_id = 0;
+            PrintCryptographicLibraryErrors();
+            return nullptr;
+        }
+        sl.key_id = _key_id;
+    }
+    return sl.ctx;
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include "tsByteBlock.h"
 #include "tsCryptoLibrary.h"
 #include "tsBlockCipherProperties.h"
+#include "tsBlockCipherContext.h"
 
 namespace ts {
 
@@ -202,6 +203,141 @@ namespace ts {
         //!
         bool decrypt(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length = nullptr);
 
+        //!
+        //! Encrypt several independent messages in place, typically the payloads of TS packets.
+        //! Each message is encrypted separately, using the current key and IV, exactly as if encrypt()
+        //! was called on each of them. Some chaining modes process all messages together, in interleaved
+        //! lanes, which is much faster than encrypting them one by one.
+        //! @param [in] messages Array of @a count message addresses. Each message is encrypted in place.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        bool encryptInPlace(void* const messages[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt several independent messages in place, typically the payloads of TS packets.
+        //! Each message is decrypted separately, using the current key and IV, exactly as if decrypt()
+        //! was called on each of them.
+        //! @param [in] messages Array of @a count message addresses. Each message is decrypted in place.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        bool decryptInPlace(void* const messages[], const size_t sizes[], size_t count);
+
+        //!
+        //! Check if the ECB and CBC methods using a caller-provided context are available.
+        //! They use the native chaining modes of the system cryptographic library on the base
+        //! algorithm of this block cipher (for instance AES or DES), not the chaining mode of this object.
+        //! @return True if encryptECB(), decryptECB(), encryptCBC() and decryptCBC() are available.
+        //! @see BlockCipherContext
+        //!
+        bool hasContextModes() const { return nativeAvailable(NativeMode::ECB) && nativeAvailable(NativeMode::CBC); }
+
+        //!
+        //! Encrypt complete blocks in ECB mode with the current key, using a caller-provided context.
+        //! This method does not modify this object. It can be concurrently called by several threads,
+        //! each thread using its own context. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] plain Address of plain text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple of the block size.
+        //! @param [out] cipher Address of buffer for cipher text. Can be identical to @a plain.
+        //! @return True on success, false on error or if hasContextModes() is false.
+        //! @see BlockCipherContext
+        //!
+        bool encryptECB(BlockCipherContext& context, const void* plain, size_t length, void* cipher) const
+        {
+            return nativeEncrypt(context, NativeMode::ECB, nullptr, plain, length, cipher);
+        }
+
+        //!
+        //! Decrypt complete blocks in ECB mode with the current key, using a caller-provided context.
+        //! This method does not modify this object. It can be concurrently called by several threads,
+        //! each thread using its own context. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple of the block size.
+        //! @param [out] plain Address of buffer for plain text. Can be identical to @a cipher.
+        //! @return True on success, false on error or if hasContextModes() is false.
+        //! @see BlockCipherContext
+        //!
+        bool decryptECB(BlockCipherContext& context, const void* cipher, size_t length, void* plain) const
+        {
+            return nativeDecrypt(context, NativeMode::ECB, nullptr, cipher, length, plain);
+        }
+
+        //!
+        //! Encrypt complete blocks in CBC mode with the current key, using a caller-provided context.
+        //! This method does not modify this object. It can be concurrently called by several threads,
+        //! each thread using its own context. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] iv Address of the IV, the size of which is the block size. The current IV of this object is ignored.
+        //! @param [in] plain Address of plain text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple of the block size.
+        //! @param [out] cipher Address of buffer for cipher text. Can be identical to @a plain.
+        //! @return True on success, false on error or if hasContextModes() is false.
+        //! @see BlockCipherContext
+        //!
+        bool encryptCBC(BlockCipherContext& context, const void* iv, const void* plain, size_t length, void* cipher) const
+        {
+            return nativeEncrypt(context, NativeMode::CBC, iv, plain, length, cipher);
+        }
+
+        //!
+        //! Decrypt complete blocks in CBC mode with the current key, using a caller-provided context.
+        //! This method does not modify this object. It can be concurrently called by several threads,
+        //! each thread using its own context. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] iv Address of the IV, the size of which is the block size. The current IV of this object is ignored.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple of the block size.
+        //! @param [out] plain Address of buffer for plain text. Can be identical to @a cipher.
+        //! @return True on success, false on error or if hasContextModes() is false.
+        //! @see BlockCipherContext
+        //!
+        bool decryptCBC(BlockCipherContext& context, const void* iv, const void* cipher, size_t length, void* plain) const
+        {
+            return nativeDecrypt(context, NativeMode::CBC, iv, cipher, length, plain);
+        }
+
+        //!
+        //! Check if the multi-message methods using a caller-provided context are available.
+        //! This depends on the chaining mode of this object and on the native chaining modes
+        //! of the system cryptographic library.
+        //! @return True if encryptInPlace() and decryptInPlace() with a BlockCipherContext are available.
+        //! @see BlockCipherContext
+        //!
+        virtual bool hasContextInPlace() const;
+
+        //!
+        //! Encrypt several independent messages in place, using a caller-provided context.
+        //! The result is identical to encryptInPlace() without context, using the current key and IV.
+        //! This method does not modify this object. It can be concurrently called by several threads,
+        //! each thread using its own context. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] messages Array of @a count message addresses. Each message is encrypted in place.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error or if hasContextInPlace() is false.
+        //! @see BlockCipherContext
+        //!
+        bool encryptInPlace(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const;
+
+        //!
+        //! Decrypt several independent messages in place, using a caller-provided context.
+        //! The result is identical to decryptInPlace() without context, using the current key and IV.
+        //! This method does not modify this object. It can be concurrently called by several threads,
+        //! each thread using its own context. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] messages Array of @a count message addresses. Each message is decrypted in place.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error or if hasContextInPlace() is false.
+        //! @see BlockCipherContext
+        //!
+        bool decryptInPlace(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const;
+
         //!
         //! Get the number of times the current key was used for encryption.
         //! @return The number of times the current key was used for encryption.
@@ -313,6 +449,52 @@ namespace ts {
         //!
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length);
 
+        //!
+        //! Encrypt several independent messages in place (implementation of algorithm-specific part).
+        //! The default implementation uses the context version with the context of this object when
+        //! hasContextInPlace() is true. Otherwise, it calls encryptImpl() on each message.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptInPlaceImpl(void* const messages[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt several independent messages in place (implementation of algorithm-specific part).
+        //! The default implementation uses the context version with the context of this object when
+        //! hasContextInPlace() is true. Otherwise, it calls decryptImpl() on each message.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptInPlaceImpl(void* const messages[], const size_t sizes[], size_t count);
+
+        //!
+        //! Encrypt several independent messages in place using a caller-provided context (implementation of algorithm-specific part).
+        //! Must be implemented by the subclass when hasContextInPlace() returns true. The key and IV are already
+        //! checked. The implementation shall not modify this object, only the context.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error. The default implementation returns false.
+        //!
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const;
+
+        //!
+        //! Decrypt several independent messages in place using a caller-provided context (implementation of algorithm-specific part).
+        //! Must be implemented by the subclass when hasContextInPlace() returns true. The key and IV are already
+        //! checked. The implementation shall not modify this object, only the context.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error. The default implementation returns false.
+        //!
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const;
+
         //!
         //! Inform the superclass that the subclass can encrypt and decrypt in place (identical in/out buffers).
         //! Typically called by a subclass in constructor.
@@ -320,6 +502,158 @@ namespace ts {
         //!
         void canProcessInPlace(bool can_do) { _can_process_in_place = can_do; }
 
+        //!
+        //! Chaining modes which can be natively implemented by the system cryptographic library.
+        //! The generic chaining mode templates (CBC, CTR, CTS, etc.) use them on the whole
+        //! message when available, instead of invoking the underlying block cipher once per block.
+        //!
+        enum class NativeMode {
+            ECB,  //!< Electronic Code Book.
+            CBC,  //!< Cipher Block Chaining.
+            CTR,  //!< Counter mode, the complete block is used as counter.
+        };
+
+        //!
+        //! Encrypt a message using a native chaining mode of the system cryptographic library.
+        //! The key is the current one. The current IV is ignored, the IV to use is a parameter.
+        //! @param [in] mode Native chaining mode to use.
+        //! @param [in] iv Address of the IV, the size of which is the block size. Ignored with ECB.
+        //! @param [in] plain Address of plain text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple
+        //! of the block size, except with CTR.
+        //! @param [out] cipher Address of buffer for cipher text. Can be identical to @a plain.
+        //! @return True on success, false if the native mode is not available or on error.
+        //! In case of error, the caller shall revert to its own implementation of the chaining mode.
+        //!
+        bool nativeEncrypt(NativeMode mode, const void* iv, const void* plain, size_t length, void* cipher);
+
+        //!
+        //! Decrypt a message using a native chaining mode of the system cryptographic library.
+        //! The key is the current one. The current IV is ignored, the IV to use is a parameter.
+        //! @param [in] mode Native chaining mode to use.
+        //! @param [in] iv Address of the IV, the size of which is the block size. Ignored with ECB.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple
+        //! of the block size, except with CTR.
+        //! @param [out] plain Address of buffer for plain text. Can be identical to @a cipher.
+        //! @return True on success, false if the native mode is not available or on error.
+        //! In case of error, the caller shall revert to its own implementation of the chaining mode.
+        //!
+        bool nativeDecrypt(NativeMode mode, const void* iv, const void* cipher, size_t length, void* plain);
+
+        //!
+        //! Encrypt a message using a native chaining mode of the system cryptographic library and a caller-provided context.
+        //! This method does not modify this object. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] mode Native chaining mode to use.
+        //! @param [in] iv Address of the IV, the size of which is the block size. Ignored with ECB.
+        //! @param [in] plain Address of plain text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple
+        //! of the block size, except with CTR.
+        //! @param [out] cipher Address of buffer for cipher text. Can be identical to @a plain.
+        //! @return True on success, false if the native mode is not available or on error.
+        //!
+        bool nativeEncrypt(BlockCipherContext& context, NativeMode mode, const void* iv, const void* plain, size_t length, void* cipher) const
+        {
+            return contextProcess(context, mode, true, iv, plain, length, cipher);
+        }
+
+        //!
+        //! Decrypt a message using a native chaining mode of the system cryptographic library and a caller-provided context.
+        //! This method does not modify this object. The key usage limitations are not checked.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] mode Native chaining mode to use.
+        //! @param [in] iv Address of the IV, the size of which is the block size. Ignored with ECB.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [in] length Length in bytes of the plain text and the cipher text. Must be a multiple
+        //! of the block size, except with CTR.
+        //! @param [out] plain Address of buffer for plain text. Can be identical to @a cipher.
+        //! @return True on success, false if the native mode is not available or on error.
+        //!
+        bool nativeDecrypt(BlockCipherContext& context, NativeMode mode, const void* iv, const void* cipher, size_t length, void* plain) const
+        {
+            return contextProcess(context, mode, false, iv, cipher, length, plain);
+        }
+
+        //!
+        //! Check if a native chaining mode of the system cryptographic library is available with this cipher.
+        //! @param [in] mode Native chaining mode to check.
+        //! @return True if @a mode is natively available.
+        //!
+        bool nativeAvailable(NativeMode mode) const;
+
+        //!
+        //! Maximum number of messages which are processed together by interleavedEncryptCBC().
+        //!
+        static constexpr size_t MAX_LANES = 32;
+
+        //!
+        //! Get the working buffer of a cipher context.
+        //! A subclass can use it in its implementation of multi-message operations with a context.
+        //! The buffer is also used by interleavedEncryptCBC() and interleavedDecryptCBC().
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @return A reference to the working buffer of @a context.
+        //!
+        static ByteBlock& ContextWork(BlockCipherContext& context) { return context._work; }
+
+        //!
+        //! Encrypt the complete blocks of several independent messages in place in CBC mode, in interleaved lanes.
+        //! The CBC chain of each message is sequential but the chains of distinct messages are independent.
+        //! The block of same index in up to MAX_LANES messages are encrypted together, in one call
+        //! to the native ECB mode, which keeps the pipeline of the cryptographic engine full.
+        //! The residue after the last complete block of each message is left unmodified.
+        //! This method does not modify this object.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @param [in] iv Address of the IV of each message, the size of which is the block size.
+        //! @return True on success, false if the native ECB mode is not available or on error.
+        //! The messages are unmodified when the native ECB mode is not available.
+        //!
+        bool interleavedEncryptCBC(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count, const void* iv) const;
+
+        //!
+        //! Decrypt the complete blocks of several independent messages in place in CBC mode.
+        //! Unlike encryption, CBC decryption has no dependency between blocks. The complete blocks
+        //! of all messages are decrypted together, in one call to the native ECB mode, and then
+        //! combined with the previous cipher blocks.
+        //! The residue after the last complete block of each message is left unmodified.
+        //! This method does not modify this object.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @param [in] iv Address of the IV of each message, the size of which is the block size.
+        //! @return True on success, false if the native ECB mode is not available or on error.
+        //! The messages are unmodified when the native ECB mode is not available.
+        //!
+        bool interleavedDecryptCBC(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count, const void* iv) const;
+
+        //!
+        //! Encrypt or decrypt several independent messages in place in ECB mode, using the native ECB mode.
+        //! This is the multi-message implementation with a context of the ECB chaining modes.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] encrypt True to encrypt, false to decrypt.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes. Must be multiples of the block size.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        bool inPlaceECB(BlockCipherContext& context, bool encrypt, void* const messages[], const size_t sizes[], size_t count) const;
+
+        //!
+        //! Encrypt or decrypt several independent messages in place in CBC mode with the current IV, in interleaved lanes.
+        //! This is the multi-message implementation with a context of the CBC chaining modes.
+        //! @param [in,out] context Cipher context of the calling thread.
+        //! @param [in] encrypt True to encrypt, false to decrypt.
+        //! @param [in] messages Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes. Must be multiples of the block size.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        bool inPlaceCBC(BlockCipherContext& context, bool encrypt, void* const messages[], const size_t sizes[], size_t count) const;
+
 #if defined(TS_WINDOWS) || defined(DOXYGEN)
         //!
         //! Get the algorithm handle and subobject size, when the subclass uses Microsoft BCrypt library.
@@ -336,6 +670,14 @@ namespace ts {
         //! @return EVP cipher.
         //!
         virtual const EVP_CIPHER* getAlgorithm() const;
+
+        //!
+        //! Get the EVP for a native chaining mode of the cipher algorithm, when the subclass uses OpenSSL.
+        //! The default implementation returns a null pointer, meaning that no native mode is available.
+        //! @param [in] mode Native chaining mode.
+        //! @return EVP cipher or a null pointer if the mode is not natively available.
+        //!
+        virtual const EVP_CIPHER* getNativeAlgorithm(NativeMode mode) const;
 #endif
 
     protected:
@@ -352,11 +694,22 @@ namespace ts {
         ByteBlock _current_key {};                    // Current unscheduled key.
         ByteBlock _current_iv {};                     // Current initialization vector.
         BlockCipherAlertInterface* _alert = nullptr;  // Alert handler.
+        BlockCipherContext _context {};               // Context of this object for its own operations, kept when the key changes.
 
         // Check if encryption or decryption is allowed. Increment counters when allowed.
         bool allowEncrypt();
         bool allowDecrypt();
 
+        // Check if a key and a valid IV are set, without checking or updating the usage counters.
+        bool keyReady() const;
+
+        // Process a message using a native chaining mode and a cipher context.
+        bool contextProcess(BlockCipherContext& context, NativeMode mode, bool encrypt, const void* iv, const void* input, size_t length, void* output) const;
+
+        // Each successfully scheduled key gets a unique identity, to know when contexts must be updated.
+        uint64_t _key_id = 0;
+        static uint64_t NewKeyId();
+
         // System-specific cryptographic library.
 #if defined(TS_WINDOWS)
         ::BCRYPT_ALG_HANDLE _algo = nullptr;
@@ -366,8 +719,16 @@ namespace ts {
         bool _ignore_iv = false;
 #elif !defined(TS_NO_OPENSSL)
         const EVP_CIPHER* _algo = nullptr;
-        EVP_CIPHER_CTX* _encrypt = nullptr;
-        EVP_CIPHER_CTX* _decrypt = nullptr;
+
+        // Index of a slot in a BlockCipherContext. The base algorithm uses slots 0 (decrypt) and 1 (encrypt).
+        // The native chaining modes use the next slots, indexed by mode, then decrypt or encrypt.
+        static constexpr size_t NATIVE_MODE_COUNT = 3;
+        static_assert(2 * (NATIVE_MODE_COUNT + 1) == BlockCipherContext::SLOT_COUNT);
+        static size_t SlotIndex(bool encrypt) { return encrypt ? 1 : 0; }
+        static size_t SlotIndex(NativeMode mode, bool encrypt) { return 2 * (size_t(mode) + 1) + (encrypt ? 1 : 0); }
+
+        // Get an OpenSSL context in a slot, with the current key scheduled. Return null on error.
+        EVP_CIPHER_CTX* keyedContext(BlockCipherContext& context, size_t slot, const EVP_CIPHER* algo, bool encrypt) const;
 #endif
     };
 }
@@ -0,0 +1,37 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsBlockCipherContext.h"
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::BlockCipherContext::~BlockCipherContext()
+{
+    clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Free the resources of the cryptographic library.
+//----------------------------------------------------------------------------
+
+void ts::BlockCipherContext::clear()
+{
+#if !defined(TS_WINDOWS) && !defined(TS_NO_OPENSSL)
+    for (auto& slot : _slots) {
+        if (slot.ctx != nullptr) {
+            EVP_CIPHER_CTX_free(slot.ctx);
+            slot.ctx = nullptr;
+        }
+        slot.key_id = 0;
+    }
+#endif
+}
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Cipher context to use a block cipher which is shared between threads.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+#include "tsCryptoLibrary.h"
+
+namespace ts {
+    //!
+    //! Cipher context to use a block cipher which is shared between threads.
+    //! @ingroup libtscore crypto
+    //!
+    //! A BlockCipher object contains a key and the state of the cryptographic library. Its encryption
+    //! and decryption methods modify this state and cannot be called by several threads at the same time.
+    //!
+    //! Once the key is set, the @c const methods of BlockCipher which take a BlockCipherContext
+    //! parameter can be concurrently called by several threads on the same BlockCipher object.
+    //! Each thread uses its own BlockCipherContext, which contains the mutable state of the
+    //! cryptographic library and the working buffers. The key is shared, without locking.
+    //!
+    //! The resources of the cryptographic library are allocated the first time the context is used.
+    //! They are reused by all subsequent operations, including after a change of key in the block
+    //! cipher: only the key schedule is then recomputed in the context.
+    //!
+    //! The key of a shared BlockCipher shall not be changed while other threads use it.
+    //!
+    class TSCOREDLL BlockCipherContext
+    {
+        TS_NOCOPY(BlockCipherContext);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        BlockCipherContext() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~BlockCipherContext();
+
+        //!
+        //! Free the resources of the cryptographic library.
+        //! The context remains usable. The resources are allocated again when necessary.
+        //!
+        void clear();
+
+    private:
+        friend class BlockCipher;
+
+        // Working buffer for multi-message operations (interleaved lanes, key streams).
+        ByteBlock _work {};
+
+#if !defined(TS_WINDOWS) && !defined(TS_NO_OPENSSL)
+        // One library context per algorithm and direction. The algorithm is the base algorithm
+        // of the block cipher or one of its native chaining modes (see BlockCipher).
+        struct Slot
+        {
+            EVP_CIPHER_CTX* ctx = nullptr;  // OpenSSL context, allocated once.
+            uint64_t        key_id = 0;     // Identity of the key which is scheduled in ctx, zero if none.
+        };
+        static constexpr size_t SLOT_COUNT = 8;
+        std::array<Slot, SLOT_COUNT> _slots {};
+#endif
+    };
+}
@@ -32,6 +32,11 @@ namespace ts {
         //! Default constructor.
         CBC();
 
+        // Implementation of BlockCipher interface.
+        //! @cond nodoxygen
+        virtual bool hasContextInPlace() const override;
+        //! @endcond
+
     protected:
         //! Properties of this algorithm.
         //! @return A constant reference to the properties.
@@ -45,6 +50,8 @@ namespace ts {
         //! @cond nodoxygen
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
         //! @endcond
     };
 }
@@ -99,6 +106,11 @@ bool ts::CBC<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
+    // Use the native CBC mode of the cryptographic library when available.
+    if (this->nativeEncrypt(ts::BlockCipher::NativeMode::CBC, previous, pt, plain_length, ct)) {
+        return true;
+    }
+
     while (plain_length > 0) {
         // work = previous-cipher XOR plain-text
         MemXor(work1, previous, pt, bsize);
@@ -142,6 +154,11 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
 
+    // Use the native CBC mode of the cryptographic library when available.
+    if (this->nativeDecrypt(ts::BlockCipher::NativeMode::CBC, previous, ct, cipher_length, pt)) {
+        return true;
+    }
+
     while (cipher_length > 0) {
         // work = decrypt (cipher-text)
         if (!CIPHER::decryptImpl(ct, bsize, work1, bsize, nullptr)) {
@@ -169,4 +186,28 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     return true;
 }
 
+
+//----------------------------------------------------------------------------
+// Encryption and decryption of several independent messages in CBC mode,
+// using the native ECB mode of the cryptographic library in interleaved lanes.
+//----------------------------------------------------------------------------
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::CBC<CIPHER>::hasContextInPlace() const
+{
+    return this->nativeAvailable(ts::BlockCipher::NativeMode::ECB);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::CBC<CIPHER>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return this->inPlaceCBC(context, true, messages, sizes, count);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::CBC<CIPHER>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return this->inPlaceCBC(context, false, messages, sizes, count);
+}
+
 #endif
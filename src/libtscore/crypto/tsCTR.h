@@ -52,6 +52,11 @@ namespace ts {
         //!
         size_t counterBits() const {return _counter_bits;}
 
+        // Implementation of BlockCipher interface.
+        //! @cond nodoxygen
+        virtual bool hasContextInPlace() const override;
+        //! @endcond
+
     protected:
         //! Properties of this algorithm.
         //! @return A constant reference to the properties.
@@ -61,6 +66,8 @@ namespace ts {
         //! @cond nodoxygen
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
         //! @endcond
 
     private:
@@ -69,8 +76,8 @@ namespace ts {
         // We need two work blocks.
         // The first one contains the "input block" or counter.
         // The second one contains the "output block", the encrypted counter.
-        // This private method increments the counter block.
-        void incrementCounter();
+        // This private method increments a counter block, typically the first work block.
+        void incrementCounter(uint8_t* counter) const;
     };
 }
 
@@ -115,19 +122,17 @@ void ts::CTR<CIPHER>::setCounterBits(size_t counter_bits)
 
 
 //----------------------------------------------------------------------------
-// Increment the counter in the first work block.
+// Increment a counter block.
 //----------------------------------------------------------------------------
 
 template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
-void ts::CTR<CIPHER>::incrementCounter()
+void ts::CTR<CIPHER>::incrementCounter(uint8_t* counter) const
 {
     const size_t bsize = this->properties.block_size;
-    uint8_t* work1 = this->work.data();
     size_t bits = _counter_bits;
     bool carry = true; // initial increment.
 
-    // The first work block contains the "input block" or counter to increment.
-    for (uint8_t* b = work1 + bsize - 1; carry && bits > 0 && b > work1; --b) {
+    for (uint8_t* b = counter + bsize - 1; carry && bits > 0 && b > counter; --b) {
         const size_t bits_in_byte = std::min<size_t>(bits, 8);
         bits -= bits_in_byte;
         const uint8_t mask = uint8_t(0xFF >> (8 - bits_in_byte));
@@ -149,13 +154,25 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     uint8_t* work1 = this->work.data();
     uint8_t* work2 = this->work.data() + bsize;
 
-    if (plain_length % bsize != 0 || this->currentIV().size() != bsize || cipher_maxsize < plain_length) {
+    if (this->currentIV().size() != bsize || cipher_maxsize < plain_length) {
         return false;
     }
     if (cipher_length != nullptr) {
         *cipher_length = plain_length;
     }
 
+    // Use the native CTR mode of the cryptographic library when available. The native mode
+    // increments the complete block. This is identical when the counter does not wrap up.
+    if (this->properties.block_size >= 8 && plain_length > 0) {
+        const size_t bits = std::min<size_t>(_counter_bits, 64);
+        const uint64_t max = bits >= 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << bits) - 1;
+        const uint64_t counter = GetUInt64BE(this->currentIV().data() + bsize - 8) & max;
+        const uint64_t blocks = (plain_length + bsize - 1) / bsize;
+        if (blocks - 1 <= max - counter && this->nativeEncrypt(ts::BlockCipher::NativeMode::CTR, this->currentIV().data(), plain, plain_length, cipher)) {
+            return true;
+        }
+    }
+
     // work1 = iv
     MemCopy(work1, this->currentIV().data(), bsize);
 
@@ -173,7 +190,7 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
         // cipher-text = plain-text XOR work2
         MemXor(ct, work2, pt, size);
         // work1 += 1
-        incrementCounter();
+        incrementCounter(work1);
         // advance one block
         ct += size;
         pt += size;
@@ -194,4 +211,57 @@ bool ts::CTR<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     return encryptImpl(cipher, cipher_length, plain, plain_maxsize, plain_length);
 }
 
+
+//----------------------------------------------------------------------------
+// Encryption and decryption of several independent messages in CTR mode.
+// All messages start with the same IV and use the same key stream.
+//----------------------------------------------------------------------------
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::CTR<CIPHER>::hasContextInPlace() const
+{
+    return this->nativeAvailable(ts::BlockCipher::NativeMode::ECB);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::CTR<CIPHER>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    const size_t bsize = this->properties.block_size;
+    if (this->currentIV().size() != bsize) {
+        return false;
+    }
+
+    // Build the counter blocks for the longest message, then encrypt them all at once in ECB mode.
+    size_t blocks = 0;
+    for (size_t i = 0; i < count; ++i) {
+        blocks = std::max(blocks, (sizes[i] + bsize - 1) / bsize);
+    }
+    if (blocks == 0) {
+        return true;
+    }
+    ByteBlock& stream(ts::BlockCipher::ContextWork(context));
+    stream.resize(blocks * bsize);
+    MemCopy(stream.data(), this->currentIV().data(), bsize);
+    for (size_t blk = 1; blk < blocks; ++blk) {
+        MemCopy(stream.data() + blk * bsize, stream.data() + (blk - 1) * bsize, bsize);
+        incrementCounter(stream.data() + blk * bsize);
+    }
+    if (!this->nativeEncrypt(context, ts::BlockCipher::NativeMode::ECB, nullptr, stream.data(), stream.size(), stream.data())) {
+        return false;
+    }
+
+    // cipher-text = plain-text XOR key-stream
+    for (size_t i = 0; i < count; ++i) {
+        MemXor(messages[i], messages[i], stream.data(), sizes[i]);
+    }
+    return true;
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::CTR<CIPHER>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    // With CTR, the encryption and decryption are identical operations.
+    return contextEncryptInPlaceImpl(context, messages, sizes, count);
+}
+
 #endif
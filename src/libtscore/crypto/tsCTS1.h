@@ -102,6 +102,14 @@ bool ts::CTS1<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
+    // Use the native CBC mode of the cryptographic library when available.
+    const size_t bulk = ((plain_length - 1) / bsize) * bsize;
+    if (this->nativeEncrypt(ts::BlockCipher::NativeMode::CBC, previous, pt, bulk, ct)) {
+        ct += bulk;
+        pt += bulk;
+        plain_length -= bulk;
+    }
+
     while (plain_length > bsize) {
         // work = previous-cipher XOR plain-text
         MemXor(work1, previous, pt, bsize);
@@ -165,6 +173,19 @@ bool ts::CTS1<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, voi
     const uint8_t* previous = this->currentIV().data();
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
+    const size_t bulk = ((cipher_length - bsize - 1) / bsize) * bsize;
+
+    // Use the native CBC mode of the cryptographic library when available.
+    // Save the last cipher block first, the buffers may overlap.
+    if (bulk > 0) {
+        MemCopy(work3, ct + bulk - bsize, bsize);
+        if (this->nativeDecrypt(ts::BlockCipher::NativeMode::CBC, previous, ct, bulk, pt)) {
+            previous = work3;
+            ct += bulk;
+            pt += bulk;
+            cipher_length -= bulk;
+        }
+    }
 
     while (cipher_length > 2 * bsize) {
         // work = decrypt (cipher-text)
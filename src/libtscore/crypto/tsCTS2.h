@@ -92,6 +92,14 @@ bool ts::CTS2<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
+    // Use the native CBC mode of the cryptographic library when available.
+    const size_t bulk = (plain_length / bsize) * bsize;
+    if (this->nativeEncrypt(ts::BlockCipher::NativeMode::CBC, previous, pt, bulk, ct)) {
+        ct += bulk;
+        pt += bulk;
+        plain_length -= bulk;
+    }
+
     while (plain_length >= bsize) {
         // work = previous-cipher XOR plain-text
         MemXor(work1, previous, pt, bsize);
@@ -152,6 +160,19 @@ bool ts::CTS2<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, voi
 
     const size_t residue_size = cipher_length % bsize;
     const size_t trick_size = residue_size == 0 ? 0 : bsize + residue_size;
+    const size_t bulk = cipher_length - trick_size;
+
+    // Use the native CBC mode of the cryptographic library when available.
+    // Save the last cipher block first, the buffers may overlap.
+    if (bulk > 0) {
+        MemCopy(work3, ct + bulk - bsize, bsize);
+        if (this->nativeDecrypt(ts::BlockCipher::NativeMode::CBC, previous, ct, bulk, pt)) {
+            previous = work3;
+            ct += bulk;
+            pt += bulk;
+            cipher_length -= bulk;
+        }
+    }
 
     while (cipher_length > trick_size) {
         // work = decrypt (cipher-text)
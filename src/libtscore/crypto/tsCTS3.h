@@ -92,7 +92,14 @@ bool ts::CTS3<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
-    // Process in ECB mode, except the last 2 blocks
+    // Process in ECB mode, except the last 2 blocks.
+    // Use the native ECB mode of the cryptographic library when available.
+    const size_t bulk = ((plain_length - bsize - 1) / bsize) * bsize;
+    if (this->nativeEncrypt(ts::BlockCipher::NativeMode::ECB, nullptr, pt, bulk, ct)) {
+        ct += bulk;
+        pt += bulk;
+        plain_length -= bulk;
+    }
     while (plain_length > 2 * bsize) {
         if (!CIPHER::encryptImpl(pt, bsize, ct, bsize, nullptr)) {
             return false;
@@ -156,7 +163,14 @@ bool ts::CTS3<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, voi
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
 
-    // Process in ECB mode, except the last 2 blocks
+    // Process in ECB mode, except the last 2 blocks.
+    // Use the native ECB mode of the cryptographic library when available.
+    const size_t bulk = ((cipher_length - bsize - 1) / bsize) * bsize;
+    if (this->nativeDecrypt(ts::BlockCipher::NativeMode::ECB, nullptr, ct, bulk, pt)) {
+        ct += bulk;
+        pt += bulk;
+        cipher_length -= bulk;
+    }
     while (cipher_length > 2 * bsize) {
         if (!CIPHER::decryptImpl(ct, bsize, pt, bsize, nullptr)) {
             return false;
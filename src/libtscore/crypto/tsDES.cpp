@@ -65,6 +65,18 @@ const EVP_CIPHER* ts::DES::getAlgorithm() const
     return fetch.algorithm();
 }
 
+const EVP_CIPHER* ts::DES::getNativeAlgorithm(NativeMode mode) const
+{
+    // Thread-safe init-safe static data pattern:
+    static const FetchCipherAlgorithm fetch_ecb("DES-ECB", "legacy");
+    static const FetchCipherAlgorithm fetch_cbc("DES-CBC", "legacy");
+    switch (mode) {
+        case NativeMode::ECB: return fetch_ecb.algorithm();
+        case NativeMode::CBC: return fetch_cbc.algorithm();
+        default: return nullptr;
+    }
+}
+
 #endif
 
 
@@ -92,6 +104,21 @@ ts::ECB<ts::DES>::ECB(const BlockCipherProperties& props) : DES(props)
     canProcessInPlace(true);
 }
 
+bool ts::ECB<ts::DES>::hasContextInPlace() const
+{
+    return nativeAvailable(NativeMode::ECB);
+}
+
+bool ts::ECB<ts::DES>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceECB(context, true, messages, sizes, count);
+}
+
+bool ts::ECB<ts::DES>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceECB(context, false, messages, sizes, count);
+}
+
 #if defined(TS_WINDOWS)
 
 void ts::ECB<ts::DES>::getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const
@@ -139,6 +166,21 @@ ts::CBC<ts::DES>::CBC(const BlockCipherProperties& props) : DES(props)
     canProcessInPlace(true);
 }
 
+bool ts::CBC<ts::DES>::hasContextInPlace() const
+{
+    return nativeAvailable(NativeMode::ECB);
+}
+
+bool ts::CBC<ts::DES>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceCBC(context, true, messages, sizes, count);
+}
+
+bool ts::CBC<ts::DES>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceCBC(context, false, messages, sizes, count);
+}
+
 #if defined(TS_WINDOWS)
 
 void ts::CBC<ts::DES>::getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const
@@ -34,6 +34,11 @@ namespace ts {
         //!
         ECB();
 
+        // Implementation of BlockCipher interface.
+        //! @cond nodoxygen
+        virtual bool hasContextInPlace() const override;
+        //! @endcond
+
     protected:
         //! Properties of this algorithm.
         //! @return A constant reference to the properties.
@@ -47,6 +52,8 @@ namespace ts {
         //! @cond nodoxygen
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
         //! @endcond
     };
 }
@@ -143,4 +150,28 @@ bool ts::ECB<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     return true;
 }
 
+
+//----------------------------------------------------------------------------
+// Encryption and decryption of several independent messages in ECB mode,
+// using the native ECB mode of the cryptographic library.
+//----------------------------------------------------------------------------
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::ECB<CIPHER>::hasContextInPlace() const
+{
+    return this->nativeAvailable(ts::BlockCipher::NativeMode::ECB);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::ECB<CIPHER>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return this->inPlaceECB(context, true, messages, sizes, count);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::ECB<CIPHER>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return this->inPlaceECB(context, false, messages, sizes, count);
+}
+
 #endif
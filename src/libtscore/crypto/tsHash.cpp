@@ -208,3 +208,26 @@ bool ts::Hash::hash(const void* data, size_t data_size, ByteBlock& result)
     result.resize(ok ? retsize : 0);
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Compute the hash values of several independent messages.
+//----------------------------------------------------------------------------
+
+bool ts::Hash::hashMessages(const void* const messages[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize)
+{
+    const size_t hsize = hashSize();
+    if (count > 0 && (messages == nullptr || sizes == nullptr || hashes == nullptr || hashes_maxsize < count * hsize)) {
+        return false;
+    }
+
+    // The context is reinitialized for each message, but never reallocated.
+    uint8_t* out = reinterpret_cast<uint8_t*>(hashes);
+    for (size_t i = 0; i < count; ++i) {
+        if (!init() || !add(messages[i], sizes[i]) || !getHash(out, hsize)) {
+            return false;
+        }
+        out += hsize;
+    }
+    return true;
+}
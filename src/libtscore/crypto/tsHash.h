@@ -85,6 +85,21 @@ namespace ts {
         //!
         bool hash(const void* data, size_t data_size, ByteBlock& hash);
 
+        //!
+        //! Compute the hash values of several independent messages in one operation.
+        //! All messages are hashed with the same cryptographic context, without
+        //! allocating resources for each message. This is faster than creating a
+        //! new Hash instance for each message.
+        //! @param [in] messages Array of @a count addresses of messages to hash.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages.
+        //! @param [in] count Number of messages.
+        //! @param [out] hashes Address of returned hash buffer. The @a count hash values are
+        //! contiguously returned in the same order as the messages, each one using hashSize() bytes.
+        //! @param [in] hashes_maxsize Size in bytes of hash buffer. Must be at least @a count times hashSize().
+        //! @return True on success, false on error.
+        //!
+        bool hashMessages(const void* const messages[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize);
+
         //!
         //! Virtual destructor.
         //!
@@ -67,6 +67,18 @@ const EVP_CIPHER* ts::TDES::getAlgorithm() const
     return fetch.algorithm();
 }
 
+const EVP_CIPHER* ts::TDES::getNativeAlgorithm(NativeMode mode) const
+{
+    // Thread-safe init-safe static data pattern:
+    static const FetchCipherAlgorithm fetch_ecb("DES-EDE3");
+    static const FetchCipherAlgorithm fetch_cbc("DES-EDE3-CBC");
+    switch (mode) {
+        case NativeMode::ECB: return fetch_ecb.algorithm();
+        case NativeMode::CBC: return fetch_cbc.algorithm();
+        default: return nullptr;
+    }
+}
+
 #endif
 
 
@@ -94,6 +106,21 @@ ts::ECB<ts::TDES>::ECB(const BlockCipherProperties& props) : TDES(props)
     canProcessInPlace(true);
 }
 
+bool ts::ECB<ts::TDES>::hasContextInPlace() const
+{
+    return nativeAvailable(NativeMode::ECB);
+}
+
+bool ts::ECB<ts::TDES>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceECB(context, true, messages, sizes, count);
+}
+
+bool ts::ECB<ts::TDES>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceECB(context, false, messages, sizes, count);
+}
+
 #if defined(TS_WINDOWS)
 
 void ts::ECB<ts::TDES>::getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const
@@ -143,6 +170,21 @@ ts::CBC<ts::TDES>::CBC(const BlockCipherProperties& props) : TDES(props)
     canProcessInPlace(true);
 }
 
+bool ts::CBC<ts::TDES>::hasContextInPlace() const
+{
+    return nativeAvailable(NativeMode::ECB);
+}
+
+bool ts::CBC<ts::TDES>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceCBC(context, true, messages, sizes, count);
+}
+
+bool ts::CBC<ts::TDES>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    return inPlaceCBC(context, false, messages, sizes, count);
+}
+
 #if defined(TS_WINDOWS)
 
 void ts::CBC<ts::TDES>::getAlgorithm(::BCRYPT_ALG_HANDLE& algo, size_t& length, bool& ignore_iv) const
@@ -0,0 +1,331 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapCapture.h"
+#include "tsSysUtils.h"
+#include "tsIP.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <poll.h>
+    #include <arpa/inet.h>
+    #include <net/if_arp.h>
+    #include <linux/if_packet.h>
+    #include <linux/if_ether.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::PcapCapture::~PcapCapture()
+{
+    // The destructor of the superclass does not call the overridden method.
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Set the size of the capture ring.
+//----------------------------------------------------------------------------
+
+void ts::PcapCapture::setRingSize(size_t block_size, size_t block_count)
+{
+    _block_size = block_size;
+    _block_count = std::max<size_t>(1, block_count);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a capture is in progress.
+//----------------------------------------------------------------------------
+
+bool ts::PcapCapture::isOpen() const
+{
+#if defined(TS_LINUX)
+    return _sock >= 0;
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Start capturing frames on a network interface.
+//----------------------------------------------------------------------------
+
+bool ts::PcapCapture::openInterface(const UString& interface_name, Report& report)
+{
+#if defined(TS_LINUX)
+
+    if (isOpen()) {
+        report.error(u"capture already started");
+        return false;
+    }
+
+    // Reset counters and filters, as when opening a pcap file.
+    resetCounters();
+    resetFilters();
+    _abort = false;
+    _dropped = 0;
+    _next_block = 0;
+    _block = nullptr;
+    _frame = nullptr;
+    _frame_count = 0;
+
+    // Interface index, zero means all interfaces.
+    unsigned int if_index = 0;
+    if (!interface_name.empty()) {
+        if_index = ::if_nametoindex(interface_name.toUTF8().c_str());
+        if (if_index == 0) {
+            report.error(u"unknown network interface %s", interface_name);
+            return false;
+        }
+    }
+
+    // Create the raw packet socket, receiving all protocols.
+    _sock = ::socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    if (_sock < 0) {
+        report.error(u"error creating packet socket: %s", SysErrorCodeMessage());
+        return false;
+    }
+
+    // Use a memory-mapped TPACKET_V3 receive ring. The block size must be a multiple of the page size.
+    const size_t page_size = std::max<size_t>(1, size_t(::sysconf(_SC_PAGESIZE)));
+    const size_t block_size = round_up(std::max(_block_size, page_size), page_size);
+    constexpr size_t frame_size = 2048; // nominal value, not used with TPACKET_V3, except for checks.
+
+    int version = TPACKET_V3;
+    ::tpacket_req3 req;
+    TS_ZERO(req);
+    req.tp_block_size = (unsigned int)(block_size);
+    req.tp_block_nr = (unsigned int)(_block_count);
+    req.tp_frame_size = (unsigned int)(frame_size);
+    req.tp_frame_nr = (unsigned int)((block_size / frame_size) * _block_count);
+    req.tp_retire_blk_tov = 50; // milliseconds, a partially filled block is returned after this timeout.
+
+    ::sockaddr_ll addr;
+    TS_ZERO(addr);
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = int(if_index);
+
+    bool ok = true;
+    if (::setsockopt(_sock, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+        report.error(u"error setting TPACKET_V3 on packet socket: %s", SysErrorCodeMessage());
+        ok = false;
+    }
+    else if (::setsockopt(_sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        report.error(u"error creating packet capture ring (%d blocks of %'d bytes): %s", _block_count, block_size, SysErrorCodeMessage());
+        ok = false;
+    }
+    else {
+        _ring_size = block_size * _block_count;
+        void* ring = ::mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, _sock, 0);
+        if (ring == MAP_FAILED) {
+            report.error(u"error mapping packet capture ring: %s", SysErrorCodeMessage());
+            _ring_size = 0;
+            ok = false;
+        }
+        else {
+            _ring = reinterpret_cast<uint8_t*>(ring);
+            _block_size = block_size;
+        }
+    }
+    if (ok && ::bind(_sock, reinterpret_cast<::sockaddr*>(&addr), sizeof(addr)) != 0) {
+        report.error(u"error binding packet socket to %s: %s", interface_name.empty() ? u"all interfaces" : interface_name, SysErrorCodeMessage());
+        ok = false;
+    }
+    if (ok && _promiscuous && if_index != 0) {
+        ::packet_mreq mreq;
+        TS_ZERO(mreq);
+        mreq.mr_ifindex = int(if_index);
+        mreq.mr_type = PACKET_MR_PROMISC;
+        if (::setsockopt(_sock, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            report.error(u"error setting promiscuous mode on %s: %s", interface_name, SysErrorCodeMessage());
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        report.debug(u"capturing on %s, ring of %d blocks of %'d bytes", interface_name.empty() ? u"all interfaces" : interface_name, _block_count, _block_size);
+    }
+    else {
+        close();
+    }
+    return ok;
+
+#else
+
+    report.error(u"live network capture is not supported on this system");
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the capture.
+//----------------------------------------------------------------------------
+
+void ts::PcapCapture::close()
+{
+#if defined(TS_LINUX)
+    if (_sock >= 0) {
+        // Accumulate the last statistics before closing.
+        droppedFrames();
+    }
+    if (_ring != nullptr) {
+        ::munmap(_ring, _ring_size);
+        _ring = nullptr;
+        _ring_size = 0;
+    }
+    if (_sock >= 0) {
+        ::close(_sock);
+        _sock = -1;
+    }
+    _block = nullptr;
+    _frame = nullptr;
+    _frame_count = 0;
+#endif
+    PcapFilter::close();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of dropped frames.
+//----------------------------------------------------------------------------
+
+uint64_t ts::PcapCapture::droppedFrames()
+{
+#if defined(TS_LINUX)
+    // Reading the statistics resets them in the kernel.
+    if (_sock >= 0) {
+        ::tpacket_stats_v3 stats;
+        ::socklen_t len = sizeof(stats);
+        TS_ZERO(stats);
+        if (::getsockopt(_sock, SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0) {
+            _dropped += stats.tp_drops;
+        }
+    }
+#endif
+    return _dropped;
+}
+
+
+//----------------------------------------------------------------------------
+// Return the current block to the kernel.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+void ts::PcapCapture::releaseBlock()
+{
+    if (_block != nullptr) {
+        // Make sure all reads in the block are complete before the kernel reuses it.
+        std::atomic_thread_fence(std::memory_order_release);
+        reinterpret_cast<volatile ::tpacket_block_desc*>(_block)->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        _block = nullptr;
+        _frame = nullptr;
+        _frame_count = 0;
+        _next_block = (_next_block + 1) % _block_count;
+    }
+}
+#endif
+
+
+//----------------------------------------------------------------------------
+// Read the next captured frame from the capture ring.
+//----------------------------------------------------------------------------
+
+bool ts::PcapCapture::readFrame(const uint8_t*& frame, size_t& cap_size, size_t& orig_size, uint16_t& link_type, size_t& fcs_size, cn::microseconds& timestamp, Report& report)
+{
+#if defined(TS_LINUX)
+
+    if (_sock < 0 || _ring == nullptr) {
+        report.error(u"no network capture in progress");
+        return false;
+    }
+
+    // When all frames of the current block are read, the block is returned to the kernel.
+    // Therefore, the previously returned frame remains valid until this call.
+    if (_frame_count == 0) {
+        releaseBlock();
+    }
+
+    // Wait for the next block to be filled by the kernel.
+    cn::milliseconds waited = cn::milliseconds::zero();
+    constexpr cn::milliseconds poll_interval = cn::milliseconds(100);
+    while (_block == nullptr) {
+        uint8_t* const block = _ring + _next_block * _block_size;
+        const volatile ::tpacket_block_desc* desc = reinterpret_cast<const volatile ::tpacket_block_desc*>(block);
+        if ((desc->hdr.bh1.block_status & TP_STATUS_USER) != 0) {
+            // The block is now owned by the application.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            _block = block;
+            _frame = block + desc->hdr.bh1.offset_to_first_pkt;
+            _frame_count = desc->hdr.bh1.num_pkts;
+            if (_frame_count == 0) {
+                releaseBlock();
+            }
+            continue;
+        }
+        if (_abort) {
+            return false;
+        }
+        if (_timeout > cn::milliseconds::zero() && waited >= _timeout) {
+            report.error(u"network capture timeout");
+            return false;
+        }
+        // Poll with a short interval to check abort and timeout.
+        ::pollfd pfd;
+        TS_ZERO(pfd);
+        pfd.fd = _sock;
+        pfd.events = POLLIN | POLLERR;
+        if (::poll(&pfd, 1, int(poll_interval.count())) < 0 && errno != EINTR) {
+            report.error(u"error waiting for captured frames: %s", SysErrorCodeMessage());
+            return false;
+        }
+        waited += poll_interval;
+    }
+
+    // Return the next frame in the block.
+    const ::tpacket3_hdr* hdr = reinterpret_cast<const ::tpacket3_hdr*>(_frame);
+    frame = _frame + hdr->tp_mac;
+    cap_size = hdr->tp_snaplen;
+    orig_size = hdr->tp_len;
+    fcs_size = 0;
+
+    // The link layer depends on the interface of the frame, as described in the sockaddr_ll after the frame header.
+    // The Linux loopback interface uses Ethernet headers. When there is no link layer header (tun, ppp, raw IP),
+    // the frame starts at the network header. The frames with another link layer are returned with an unknown
+    // link type and are ignored by the superclass.
+    const ::sockaddr_ll* sll = reinterpret_cast<const ::sockaddr_ll*>(_frame + TPACKET_ALIGN(sizeof(::tpacket3_hdr)));
+    if (sll->sll_hatype == ARPHRD_ETHER || sll->sll_hatype == ARPHRD_LOOPBACK) {
+        link_type = LINKTYPE_ETHERNET;
+    }
+    else if (hdr->tp_mac == hdr->tp_net) {
+        link_type = LINKTYPE_RAW;
+    }
+    else {
+        link_type = LINKTYPE_UNKNOWN;
+        report.log(2, u"ignoring captured frame with unsupported hardware type %d", sll->sll_hatype);
+    }
+    timestamp = cn::microseconds(cn::microseconds::rep(hdr->tp_sec) * std::micro::den + hdr->tp_nsec / 1000);
+    _frame += hdr->tp_next_offset;
+    _frame_count--;
+    return true;
+
+#else
+
+    report.error(u"live network capture is not supported on this system");
+    return false;
+
+#endif
+}
@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Live capture of network frames with packet filtering.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPcapFilter.h"
+
+namespace ts {
+    //!
+    //! Live capture of network frames on a local interface, with packet filtering.
+    //! @ingroup libtscore net
+    //!
+    //! This class captures all Ethernet frames on a network interface, including frames
+    //! which are not sent to this system, typically on a mirror port ("SPAN port") of a
+    //! switch. Multicast traffic is captured without joining the multicast groups.
+    //! Interfaces without link layer header (tun, ppp) are captured as raw IP. The frames
+    //! from interfaces with other link layers are ignored.
+    //!
+    //! The IP packets are extracted and filtered exactly like a PcapFilter reading a
+    //! pcap file, using the same filtering methods. The packet numbers, timestamps and
+    //! time offsets are relative to the start of the capture.
+    //!
+    //! On Linux, the frames are captured using a raw packet socket (AF_PACKET) with a
+    //! TPACKET_V3 receive ring, which is memory-mapped in the application. The kernel
+    //! fills blocks of frames in the ring without system call per frame. The capture
+    //! timestamps are provided by the kernel.
+    //!
+    //! This feature is not supported on other operating systems. Capturing raw frames
+    //! usually requires the CAP_NET_RAW capability (typically root privileges).
+    //!
+    class TSCOREDLL PcapCapture: public PcapFilter
+    {
+        TS_NOCOPY(PcapCapture);
+    public:
+        //!
+        //! Default size in bytes of one block in the capture ring.
+        //!
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+        //!
+        //! Default number of blocks in the capture ring.
+        //!
+        static constexpr size_t DEFAULT_BLOCK_COUNT = 64;
+
+        //!
+        //! Default constructor.
+        //!
+        PcapCapture() = default;
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~PcapCapture() override;
+
+        //!
+        //! Set the size of the capture ring.
+        //! Must be called before openInterface().
+        //! @param [in] block_size Size in bytes of one block in the ring. This is rounded up to a multiple of
+        //! the system page size. Each block shall be larger than the largest captured frame.
+        //! @param [in] block_count Number of blocks in the ring.
+        //!
+        void setRingSize(size_t block_size, size_t block_count);
+
+        //!
+        //! Set promiscuous mode on the interface during the capture.
+        //! Must be called before openInterface().
+        //! @param [in] on If true, capture all frames on the network, not only those which are sent to this system.
+        //!
+        void setPromiscuous(bool on) { _promiscuous = on; }
+
+        //!
+        //! Set a reception timeout.
+        //! @param [in] timeout When no frame is captured after this timeout, readIP() returns an error.
+        //! When zero or negative, wait forever.
+        //!
+        void setReceiveTimeout(cn::milliseconds timeout) { _timeout = timeout; }
+
+        //!
+        //! Start capturing frames on a network interface.
+        //! @param [in] interface_name Name of the network interface, for instance "eth0".
+        //! If empty, capture on all interfaces.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool openInterface(const UString& interface_name, Report& report);
+
+        //!
+        //! Check if a capture is in progress.
+        //! @return True if the capture is open, false otherwise.
+        //!
+        bool isOpen() const;
+
+        //!
+        //! Abort a pending readIP() from another thread.
+        //! The capture remains open until close() is called.
+        //!
+        void abort() { _abort = true; }
+
+        //!
+        //! Get the number of frames which were dropped by the kernel, because the capture ring was full.
+        //! @return The number of dropped frames since the beginning of the capture.
+        //!
+        uint64_t droppedFrames();
+
+        // Inherited methods.
+        virtual void close() override;
+
+    protected:
+        // Inherited methods.
+        virtual bool readFrame(const uint8_t*& frame, size_t& cap_size, size_t& orig_size, uint16_t& link_type, size_t& fcs_size, cn::microseconds& timestamp, Report& report) override;
+
+    private:
+        size_t            _block_size = DEFAULT_BLOCK_SIZE;
+        size_t            _block_count = DEFAULT_BLOCK_COUNT;
+        bool              _promiscuous = false;
+        cn::milliseconds  _timeout {0};
+        std::atomic<bool> _abort {false};
+        uint64_t          _dropped = 0;       // Accumulated dropped frames.
+#if defined(TS_LINUX)
+        int               _sock = -1;         // Packet socket.
+        uint8_t*          _ring = nullptr;    // Memory-mapped capture ring.
+        size_t            _ring_size = 0;     // Size in bytes of the ring.
+        size_t            _next_block = 0;    // Index of next block to read in the ring.
+        uint8_t*          _block = nullptr;   // Current block being read, owned by the application, null if none.
+        uint8_t*          _frame = nullptr;   // Next frame header to read in current block.
+        size_t            _frame_count = 0;   // Remaining frames to read in current block.
+
+        // Return the current block to the kernel.
+        void releaseBlock();
+#endif
+    };
+}
@@ -11,6 +11,7 @@
 #include "tsByteBlock.h"
 #include "tsIntegerUtils.h"
 #include "tsSysUtils.h"
+#include "tsNullReport.h"
 
 
 //----------------------------------------------------------------------------
@@ -29,20 +30,12 @@ ts::PcapFile::~PcapFile()
 
 bool ts::PcapFile::open(const fs::path& filename, Report& report)
 {
-    if (_in != nullptr) {
+    if (isOpen()) {
         report.error(u"already open");
         return false;
     }
 
-    // Reset counters.
-    _error = false;
-    _file_size = 0;
-    _packet_count = 0;
-    _ip_packet_count = 0;
-    _packets_size = 0;
-    _ip_packets_size = 0;
-    _first_timestamp = cn::microseconds(-1);
-    _last_timestamp = cn::microseconds(-1);
+    resetCounters();
 
     // Open the file.
     if (filename.empty() || filename == u"-") {
@@ -53,7 +46,15 @@ bool ts::PcapFile::open(const fs::path& filename, Report& report)
         _in = &std::cin;
         _name = u"standard input";
     }
+    else if (_use_map && _map.open(filename, NULLREP)) {
+        // The file is mapped in memory, no input stream.
+        _map.adviseSequential();
+        _name = filename;
+    }
     else {
+        if (_use_map) {
+            report.debug(u"cannot map %s in memory, using standard I/O", filename);
+        }
         _file.open(filename, std::ios::in | std::ios::binary);
         if (!_file) {
             report.error(u"error opening %s", filename);
@@ -70,11 +71,31 @@ bool ts::PcapFile::open(const fs::path& filename, Report& report)
         return false;
     }
 
-    report.debug(u"opened %s, %s format version %d.%d, %s endian", _name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little");
+    report.debug(u"opened %s, %s format version %d.%d, %s endian%s", _name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little", _map.isOpen() ? u", memory-mapped" : u"");
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Reset all counters before starting a new capture.
+//----------------------------------------------------------------------------
+
+void ts::PcapFile::resetCounters()
+{
+    _error = false;
+    _file_size = 0;
+    _packet_count = 0;
+    _ip_packet_count = 0;
+    _packets_size = 0;
+    _ip_packets_size = 0;
+    _first_timestamp = cn::microseconds(-1);
+    _last_timestamp = cn::microseconds(-1);
+    _data_offset = 0;
+    _frame_offset = INVALID_OFFSET;
+    _ip_offset = INVALID_OFFSET;
+}
+
+
 //----------------------------------------------------------------------------
 // Close the file.
 //----------------------------------------------------------------------------
@@ -84,6 +105,7 @@ void ts::PcapFile::close()
     if (_file.is_open()) {
         _file.close();
     }
+    _map.close();
     _in = nullptr;
 }
 
@@ -94,6 +116,18 @@ void ts::PcapFile::close()
 
 bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 {
+    // In memory-mapped mode, the current position is the number of bytes read so far.
+    if (_map.isOpen()) {
+        if (size > _map.size() - _file_size) {
+            // End of file, no error message.
+            _file_size = _map.size();
+            return error();
+        }
+        MemCopy(data, _map.data() + _file_size, size);
+        _file_size += size;
+        return true;
+    }
+
     // Repeatedly read until all requested bytes are read.
     while (size > 0) {
         // Read at most "size" bytes.
@@ -105,14 +139,17 @@ bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
             return error();
         }
 
-        // Get file size so far.
+        // Actual number of bytes.
+        const size_t insize = std::min(size_t(_in->gcount()), size);
+
+        // Get file size so far. On non-seekable input (pipes), count the bytes.
         const std::ios::pos_type fpos = _in->tellg();
         if (fpos != std::ios::pos_type(-1)) {
             _file_size = uint64_t(fpos);
         }
-
-        // Actual number of bytes.
-        const size_t insize = std::min(size_t(_in->gcount()), size);
+        else {
+            _file_size += insize;
+        }
         size -= insize;
         data += insize;
     }
@@ -120,6 +157,40 @@ bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Read a data block, the first bytes of which were just read by readall().
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::readData(size_t size, const uint8_t* prefix_data, size_t prefix, const uint8_t*& data, Report& report)
+{
+    data = nullptr;
+    assert(prefix <= size);
+
+    if (_map.isOpen()) {
+        // In memory-mapped mode, directly point to the data in the file, the prefix was read just before.
+        assert(prefix <= _file_size);
+        if (size - prefix > _map.size() - _file_size) {
+            _file_size = _map.size();
+            return error();
+        }
+        _data_offset = _file_size - prefix;
+        data = _map.data() + _data_offset;
+        _file_size += size - prefix;
+    }
+    else {
+        // Read the data in the internal buffer.
+        _buffer.resize(size);
+        MemCopy(_buffer.data(), prefix_data, prefix);
+        if (!readall(_buffer.data() + prefix, size - prefix, report)) {
+            return error();
+        }
+        _data_offset = _file_size - size;
+        data = _buffer.data();
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Read a file header, starting from a magic which was read as big endian.
 //----------------------------------------------------------------------------
@@ -149,15 +220,16 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
         case PCAPNG_MAGIC: {
             // This is a pcap-ng file. Read the complete section header, compute endianness.
             _ng = true;
-            ByteBlock header;
-            if (!readNgBlockBody(magic, header, report)) {
+            const uint8_t* header = nullptr;
+            size_t header_size = 0;
+            if (!readNgBlockBody(magic, header, header_size, report)) {
                 return error();
             }
-            if (header.size() < 16) {
+            if (header_size < 16) {
                 return error(report, u"invalid pcap-ng file, truncated section header in %s", _name);
             }
-            _major = get16(header.data() + 4);
-            _minor = get16(header.data() + 6);
+            _major = get16(header + 4);
+            _minor = get16(header + 6);
             _if.clear(); // will read interface descriptions in dedicated blocks.
             break;
         }
@@ -228,9 +300,10 @@ bool ts::PcapFile::analyzeNgInterface(const uint8_t* data, size_t size, Report&
 // Read a pcap-ng block. The 32-bit block type has already been read.
 //----------------------------------------------------------------------------
 
-bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report)
+bool ts::PcapFile::readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, Report& report)
 {
-    body.clear();
+    body = nullptr;
+    body_size = 0;
 
     // Read the first "Block Total Length" field.
     uint8_t lenfield[4];
@@ -239,17 +312,17 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     }
 
     // If the block type is Section Header, then the endianness is given by the first 4 bytes.
+    uint8_t order[4];
+    size_t prefix = 0;
     if (block_type == PCAPNG_SECTION_HEADER) {
         // Pcap-ng files have an endian-neutral block-type value for section header.
         // The byte order is defined by the 'byte-order magic' at the beginning of the section header block body.
-        body.resize(4);
-        if (!readall(body.data(), body.size(), report)) {
-            body.clear();
+        if (!readall(order, sizeof(order), report)) {
             return error();
         }
-        const uint32_t order_magic = GetUInt32BE(body.data());
+        prefix = sizeof(order);
+        const uint32_t order_magic = GetUInt32BE(order);
         if (order_magic != PCAPNG_ORDER_BE && order_magic != PCAPNG_ORDER_LE) {
-            body.clear();
             return error(report, u"invalid pcap-ng file, unknown 'byte-order magic' 0x%X in %s", order_magic, _name);
         }
         _be = order_magic == PCAPNG_ORDER_BE;
@@ -258,18 +331,16 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     // Interpret the packet size. The packet size include 12 additional bytes
     // for the block type and the two block length fields.
     const size_t size = get32(lenfield);
-    if (size % 4 != 0 || size < 12 + body.size()) {
-        body.clear();
+    if (size % 4 != 0 || size < 12 + prefix) {
         return error(report, u"invalid pcap-ng block length %d in %s", size, _name);
     }
 
     // Read the rest of the block body.
-    const size_t start = body.size();
-    body.resize(size - 12);
-    if (!readall(body.data() + start, body.size() - start, report)) {
-        body.clear();
+    if (!readData(size - 12, order, prefix, body, report)) {
+        body = nullptr;
         return error();
     }
+    body_size = size - 12;
 
     // Read and check the last "Block Total Length" field.
     if (!readall(lenfield, sizeof(lenfield), report)) {
@@ -277,7 +348,8 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     }
     const size_t last_size = get32(lenfield);
     if (size != last_size) {
-        body.clear();
+        body = nullptr;
+        body_size = 0;
         return error(report, u"inconsistent pcap-ng block length in %s, leading length: %d, trailing length: %d", _name, size, last_size);
     }
     return true;
@@ -295,29 +367,158 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
     vlans.clear();
     timestamp = cn::microseconds(-1);
 
+    // Loop on captured frames until an IP packet is found.
+    for (;;) {
+
+        // The captured frame.
+        const uint8_t* frame = nullptr;
+        size_t cap_size = 0;   // captured frame size
+        size_t orig_size = 0;  // original frame size (on network)
+        uint16_t link_type = LINKTYPE_UNKNOWN;
+        size_t fcs_size = 0;
+        timestamp = cn::microseconds(-1);
+        vlans.clear();
+        _frame_offset = INVALID_OFFSET;
+        _ip_offset = INVALID_OFFSET;
+
+        if (!readFrame(frame, cap_size, orig_size, link_type, fcs_size, timestamp, report)) {
+            return error();
+        }
+        const uint8_t* const frame_start = frame;
+
+        // Now process the captured packet.
+        _packet_count++;
+        _packets_size += cap_size;
+        if (orig_size > cap_size) {
+            report.debug(u"truncated captured packet ignored (%d bytes, truncated to %d)", orig_size, cap_size);
+            continue; // loop to next packet block
+        }
+
+        // Adjust first and last timestamps.
+        if (timestamp >= cn::microseconds::zero()) {
+            if (_first_timestamp < cn::microseconds::zero()) {
+                _first_timestamp = timestamp;
+            }
+            _last_timestamp = timestamp;
+        }
+
+        report.log(2, u"captured packet: %d bytes (original: %d bytes), link type: %d", cap_size, orig_size, link_type);
+
+        // With LINKTYPE_NULL and LINKTYPE_LOOP, the standard says that there is a 4-byte header with a protocol type.
+        // However, in some pcap files (not pcap-ng), it has been noticed that LINKTYPE_NULL and LINKTYPE_LOOP can
+        // contain a raw Ethernet frame without the initial 4 bytes of encapsulation. So, first check if there is
+        // a valid IP protocol packet in such a packet. Otherwise, try later a raw Ethernet packet without the
+        // expected 4-byte header.
+        uint32_t bsd_proto = PCAPNG_BSD_UNKNOWN;
+        if (cap_size >= 4) {
+            if (link_type == LINKTYPE_NULL) {
+                // BSD loopback encapsulation; the link layer header is a 4-byte field, in host byte order.
+                bsd_proto = get32(frame);
+            }
+            else if (link_type == LINKTYPE_LOOP) {
+                // OpenBSD loopback encapsulation; the link-layer header is a 4-byte field, in network byte order.
+                bsd_proto = GetUInt32BE(frame);
+            }
+        }
+
+        // Analyze the captured packet, trying to find an IP datagram.
+        if (bsd_proto == PCAPNG_BSD_IPv4 || bsd_proto == PCAPNG_BSD_IPv6_24 || bsd_proto == PCAPNG_BSD_IPv6_28 || bsd_proto == PCAPNG_BSD_IPv6_30) {
+            // BSD encapsulation with a valid 4-byte header and IP packet inside.
+            // Skip the 4-byte header.
+            frame += 4;
+            cap_size -= 4;
+        }
+        else if ((link_type == LINKTYPE_ETHERNET || link_type == LINKTYPE_NULL || link_type == LINKTYPE_LOOP) && cap_size > ETHER_HEADER_SIZE + fcs_size) {
+            // Ethernet frame: 14-byte header: destination MAC (6 bytes), source MAC (6 bytes), ether type (2 bytes).
+            // This should apply to LINKTYPE_ETHERNET only. However, in some pcap files (not pcap-ng), it has been noticed that
+            // LINKTYPE_NULL and LINKTYPE_LOOP can contain a raw Ethernet frame without the initial 4 bytes of encapsulation.
+            // Get the EtherType, skip the Ethernet header, remove the trailing FCS byte.
+            uint16_t ether_type = GetUInt16BE(frame + ETHER_TYPE_OFFSET);
+            frame += ETHER_HEADER_SIZE;
+            cap_size -= ETHER_HEADER_SIZE + fcs_size;
+            // Loop on all forms of VLAN encapsulation, until we get the inner packet.
+            while (ether_type != ETHERTYPE_IPv4 && ether_type != ETHERTYPE_IPv6 && cap_size > 0) {
+                if ((ether_type == ETHERTYPE_802_1Q || ether_type == ETHERTYPE_802_1AD) && cap_size >= 4) {
+                    // IEEE 802.1Q or IEEE 802.1ad VLAN encapsulation.
+                    // Followed by 4 bytes: 2-byte flags and VLAN id, 2-byte next EtherType.
+                    ether_type = GetUInt16BE(frame + 2);
+                    vlans.push_back({ether_type, uint32_t(GetUInt16BE(frame) & 0x0FFF)});
+                    frame += 4;
+                    cap_size -= 4;
+                }
+                else if (ether_type == ETHERTYPE_802_1AH && cap_size >= 18) {
+                    // MAC in MAC (MIM), Provider Backbone Bridges VLAN encapsulation, IEEE 802.1ah.
+                    // Followed by 18 bytes: 4-byte flags and Service id, 6-byte customer destination MAC,
+                    // 6-byte customer source MAC, 2-byte next EtherType.
+                    ether_type = GetUInt16BE(frame + 16);
+                    vlans.push_back({ether_type, uint32_t(GetUInt24BE(frame + 1) & 0x0FFF)});
+                    frame += 18;
+                    cap_size -= 18;
+                }
+                else {
+                    // Unknown EtherType or truncated header => ignore.
+                    cap_size = 0;
+                }
+            }
+        }
+        else if (link_type == LINKTYPE_RAW && cap_size >= 1) {
+            // Raw IPv4 or IPv6 header (version in first byte), no encopsulation.
+            const uint8_t version = frame[0];
+            if (version != IPv4_VERSION && version != IPv6_VERSION) {
+                // Neither IPv4 nor IPv6.
+                cap_size = 0;
+            }
+        }
+        else {
+            // Not an identified IP packet.
+            cap_size = 0;
+        }
+
+        // A possible IP datagram was found.
+        if (cap_size > 0) {
+            if (packet.reset(frame, cap_size)) {
+                _ip_packet_count++;
+                _ip_packets_size += cap_size;
+                if (_frame_offset != INVALID_OFFSET) {
+                    _ip_offset = _frame_offset + (frame - frame_start);
+                }
+                return true;
+            }
+            else {
+                report.warning(u"invalid captured IP datagram, %d bytes (original: %d bytes), link type: %d", cap_size, orig_size, link_type);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next captured frame from the file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::readFrame(const uint8_t*& frame, size_t& cap_size, size_t& orig_size, uint16_t& link_type, size_t& fcs_size, cn::microseconds& timestamp, Report& report)
+{
     // Check that the file is open.
-    if (_in == nullptr) {
+    if (!isOpen()) {
         report.error(u"no pcap file open");
         return false;
     }
     if (_error) {
-        if (!_in->eof()) {
+        if (_in != nullptr && !_in->eof()) {
             report.debug(u"pcap file already in error state");
         }
         return false;
     }
 
-    // Loop on file blocks until an IP packet is found.
+    // Loop on file blocks until a captured packet is found.
     for (;;) {
 
-        // The captured packet will go there.
-        ByteBlock buffer;
-        size_t cap_start = 0;  // captured packet start index in buffer
-        size_t cap_size = 0;   // captured packet size
-        size_t orig_size = 0;  // original packet size (on network)
+        // The captured packet will be in the memory-mapped file or in _buffer.
+        const uint8_t* data = nullptr;
+        size_t data_size = 0;
+        size_t cap_start = 0;  // captured packet start index in data
         size_t if_index = 0;   // interface index
         timestamp = cn::microseconds(-1);
-        vlans.clear();
 
         // We are at the beginning of a data block.
         if (_ng) {
@@ -335,25 +536,24 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                 continue; // loop to next packet block
             }
             // Read one data block.
-            if (!readNgBlockBody(type, buffer, report)) {
+            if (!readNgBlockBody(type, data, data_size, report)) {
                 return error();
             }
             if (type == PCAPNG_INTERFACE_DESC) {
                 // Process an interface description.
-                if (!analyzeNgInterface(buffer.data(), buffer.size(), report)) {
+                if (!analyzeNgInterface(data, data_size, report)) {
                     return error();
                 }
                 continue; // loop to next packet block
             }
-            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer.size() >= 20) {
-                _packet_count++;
+            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && data_size >= 20) {
                 cap_start = 20;
-                cap_size = std::min<size_t>(get32(buffer.data() + 12), buffer.size() - 20);
-                orig_size = get32(buffer.data() + 16);
-                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(buffer.data()) : get32(buffer.data());
+                cap_size = std::min<size_t>(get32(data + 12), data_size - 20);
+                orig_size = get32(data + 16);
+                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(data) : get32(data);
                 if (if_index < _if.size() && _if[if_index].time_units != 0) {
                     const std::intmax_t units = _if[if_index].time_units;
-                    const std::intmax_t tstamp = std::intmax_t(uint64_t(get32(buffer.data() + 4)) << 32) + get32(buffer.data() + 8);
+                    const std::intmax_t tstamp = std::intmax_t(uint64_t(get32(data + 4)) << 32) + get32(data + 8);
                     // Take care to overflow in tstamp. Sometimes, the timestamp is a full time since 1970
                     // with time unit being 1,000,000,000. The value is close to the 64-bit max.
                     if (units == std::micro::den) {
@@ -373,11 +573,10 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                     }
                 }
             }
-            else if (type == PCAPNG_SIMPLE_PACKET && buffer.size() >= 4) {
-                _packet_count++;
+            else if (type == PCAPNG_SIMPLE_PACKET && data_size >= 4) {
                 cap_start = 4;
-                orig_size = get32(buffer.data());
-                cap_size = std::min(orig_size, buffer.size() - 4);
+                orig_size = get32(data);
+                cap_size = std::min(orig_size, data_size - 4);
             }
             else {
                 // This data block does not contain a captured packet, ignore it.
@@ -386,7 +585,6 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
         }
         else {
             // Pcap file, beginning of a packet block. Read the 16-byte header.
-            _packet_count++;
             uint8_t header[16];
             if (!readall(header, sizeof(header), report)) {
                 return error();
@@ -402,17 +600,10 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                 cn::microseconds((cn::microseconds::rep(tstamp) * std::micro::den) + (cn::microseconds::rep(sub_tstamp) * std::micro::den) / _if[0].time_units);
 
             // Read packet data.
-            buffer.resize(cap_size);
-            if (!readall(buffer.data(), buffer.size(), report)) {
+            if (!readData(cap_size, nullptr, 0, data, report)) {
                 return error();
             }
-        }
-
-        // Now process the captured packet.
-        _packets_size += cap_size;
-        if (orig_size > cap_size) {
-            report.debug(u"truncated captured packet ignored (%d bytes, truncated to %d)", orig_size, cap_size);
-            continue; // loop to next packet block
+            data_size = cap_size;
         }
 
         // Get link type, adjust timestamp.
@@ -422,95 +613,13 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
         }
         if (timestamp >= cn::microseconds::zero()) {
             timestamp += ifd.time_offset;
-            if (_first_timestamp < cn::microseconds::zero()) {
-                _first_timestamp = timestamp;
-            }
-            _last_timestamp = timestamp;
         }
+        link_type = ifd.link_type;
+        fcs_size = ifd.fcs_size;
+        frame = data + cap_start;
+        _frame_offset = _data_offset + cap_start;
 
-        report.log(2, u"pcap data block: %d bytes, captured packet at offset %d, %d bytes (original: %d bytes), link type: %d",
-                   buffer.size(), cap_start, cap_size, orig_size, ifd.link_type);
-
-        // With LINKTYPE_NULL and LINKTYPE_LOOP, the standard says that there is a 4-byte header with a protocol type.
-        // However, in some pcap files (not pcap-ng), it has been noticed that LINKTYPE_NULL and LINKTYPE_LOOP can
-        // contain a raw Ethernet frame without the initial 4 bytes of encapsulation. So, first check if there is
-        // a valid IP protocol packet in such a packet. Otherwise, try later a raw Ethernet packet without the
-        // expected 4-byte header.
-        uint32_t bsd_proto = PCAPNG_BSD_UNKNOWN;
-        if (cap_size >= 4) {
-            if (ifd.link_type == LINKTYPE_NULL) {
-                // BSD loopback encapsulation; the link layer header is a 4-byte field, in host byte order.
-                bsd_proto = get32(buffer.data() + cap_start);
-            }
-            else if (ifd.link_type == LINKTYPE_LOOP) {
-                // OpenBSD loopback encapsulation; the link-layer header is a 4-byte field, in network byte order.
-                bsd_proto = GetUInt32BE(buffer.data() + cap_start);
-            }
-        }
-
-        // Analyze the captured packet, trying to find an IP datagram.
-        if (bsd_proto == PCAPNG_BSD_IPv4 || bsd_proto == PCAPNG_BSD_IPv6_24 || bsd_proto == PCAPNG_BSD_IPv6_28 || bsd_proto == PCAPNG_BSD_IPv6_30) {
-            // BSD encapsulation with a valid 4-byte header and IP packet inside.
-            // Skip the 4-byte header.
-            cap_start += 4;
-            cap_size -= 4;
-        }
-        else if ((ifd.link_type == LINKTYPE_ETHERNET || ifd.link_type == LINKTYPE_NULL || ifd.link_type == LINKTYPE_LOOP) && cap_size > ETHER_HEADER_SIZE + ifd.fcs_size) {
-            // Ethernet frame: 14-byte header: destination MAC (6 bytes), source MAC (6 bytes), ether type (2 bytes).
-            // This should apply to LINKTYPE_ETHERNET only. However, in some pcap files (not pcap-ng), it has been noticed that
-            // LINKTYPE_NULL and LINKTYPE_LOOP can contain a raw Ethernet frame without the initial 4 bytes of encapsulation.
-            // Get the EtherType, skip the Ethernet header, remove the trailing FCS byte.
-            uint16_t ether_type = GetUInt16BE(buffer.data() + cap_start + ETHER_TYPE_OFFSET);
-            cap_start += ETHER_HEADER_SIZE;
-            cap_size -= ETHER_HEADER_SIZE + ifd.fcs_size;
-            // Loop on all forms of VLAN encapsulation, until we get the inner packet.
-            while (ether_type != ETHERTYPE_IPv4 && ether_type != ETHERTYPE_IPv6 && cap_size > 0) {
-                if ((ether_type == ETHERTYPE_802_1Q || ether_type == ETHERTYPE_802_1AD) && cap_size >= 4) {
-                    // IEEE 802.1Q or IEEE 802.1ad VLAN encapsulation.
-                    // Followed by 4 bytes: 2-byte flags and VLAN id, 2-byte next EtherType.
-                    ether_type = GetUInt16BE(buffer.data() + cap_start + 2);
-                    vlans.push_back({ether_type, uint32_t(GetUInt16BE(buffer.data() + cap_start) & 0x0FFF)});
-                    cap_start += 4;
-                    cap_size -= 4;
-                }
-                else if (ether_type == ETHERTYPE_802_1AH && cap_size >= 18) {
-                    // MAC in MAC (MIM), Provider Backbone Bridges VLAN encapsulation, IEEE 802.1ah.
-                    // Followed by 18 bytes: 4-byte flags and Service id, 6-byte customer destination MAC,
-                    // 6-byte customer source MAC, 2-byte next EtherType.
-                    ether_type = GetUInt16BE(buffer.data() + cap_start + 16);
-                    vlans.push_back({ether_type, uint32_t(GetUInt24BE(buffer.data() + cap_start + 1) & 0x0FFF)});
-                    cap_start += 18;
-                    cap_size -= 18;
-                }
-                else {
-                    // Unknown EtherType or truncated header => ignore.
-                    cap_size = 0;
-                }
-            }
-        }
-        else if (ifd.link_type == LINKTYPE_RAW && cap_size >= 1) {
-            // Raw IPv4 or IPv6 header (version in first byte), no encopsulation.
-            const uint8_t version = buffer[cap_start];
-            if (version != IPv4_VERSION && version != IPv6_VERSION) {
-                // Neither IPv4 nor IPv6.
-                cap_size = 0;
-            }
-        }
-        else {
-            // Not an identified IP packet.
-            cap_size = 0;
-        }
-
-        // A possible IP datagram was found.
-        if (cap_size > 0) {
-            if (packet.reset(buffer.data() + cap_start, cap_size)) {
-                _ip_packet_count++;
-                _ip_packets_size += cap_size;
-                return true;
-            }
-            else {
-                report.warning(u"invalid IP datagram in pcap file, %d bytes (original: %d bytes), link type: %d", cap_size, orig_size, ifd.link_type);
-            }
-        }
+        report.log(2, u"pcap data block: %d bytes, captured packet at offset %d, %d bytes (original: %d bytes)", data_size, cap_start, cap_size, orig_size);
+        return true;
     }
 }
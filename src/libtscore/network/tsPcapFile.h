@@ -17,6 +17,7 @@
 #include "tsTime.h"
 #include "tsIPPacket.h"
 #include "tsPcap.h"
+#include "tsMemoryMappedFile.h"
 
 namespace ts {
     //!
@@ -46,6 +47,26 @@ namespace ts {
         //!
         virtual ~PcapFile();
 
+        //!
+        //! Value of a file offset which is not available.
+        //!
+        static constexpr uint64_t INVALID_OFFSET = std::numeric_limits<uint64_t>::max();
+
+        //!
+        //! Request to map the file in memory instead of reading it.
+        //! Must be called before open(). This is only possible with regular files.
+        //! When the file cannot be mapped, open() falls back to standard I/O.
+        //! In memory-mapped mode, the captured frames are not copied.
+        //! @param [in] on When true, try to map the input file in memory.
+        //!
+        void setMemoryMap(bool on) { _use_map = on; }
+
+        //!
+        //! Check if the file is currently mapped in memory.
+        //! @return True if the file is mapped in memory.
+        //!
+        bool isMemoryMapped() const { return _map.isOpen(); }
+
         //!
         //! Open the file for read.
         //! @param [in] filename File name. If empty or "-", use standard input.
@@ -58,7 +79,7 @@ namespace ts {
         //! Check if the file is open.
         //! @return True if the file is open, false otherwise.
         //!
-        bool isOpen() const { return _in != nullptr; }
+        bool isOpen() const { return _in != nullptr || _map.isOpen(); }
 
         //!
         //! Get the file name.
@@ -87,6 +108,14 @@ namespace ts {
         //!
         uint64_t packetCount() const { return _packet_count; }
 
+        //!
+        //! Get the offset in the file of the last IP packet which was returned by readIP().
+        //! This offset can be used later to directly access the IP packet in the file, without parsing
+        //! the file structure. It is valid for the IP packets which are not reassembled or modified.
+        //! @return The offset in bytes from the beginning of the file or INVALID_OFFSET if unknown.
+        //!
+        uint64_t lastIPOffset() const { return _ip_offset; }
+
         //!
         //! Check if the end of file (or other error) has been reached.
         //! @return True on end of file or error.
@@ -157,6 +186,30 @@ namespace ts {
         //!
         virtual void close();
 
+    protected:
+        //!
+        //! Read the next captured frame, at link layer level.
+        //! The default implementation reads the next captured packet in the pcap or pcap-ng file.
+        //! A subclass may override this method to capture frames from another source,
+        //! the extraction of IP packets and the filtering of subclasses remain the same.
+        //! @param [out] frame Address of the captured frame. The frame data shall remain valid
+        //! until the next call to readFrame().
+        //! @param [out] cap_size Captured size of the frame in bytes.
+        //! @param [out] orig_size Original size of the frame on the network, in bytes.
+        //! If larger than @a cap_size, the frame was truncated during the capture and is ignored.
+        //! @param [out] link_type Link type of the frame (LINKTYPE_ETHERNET, etc.)
+        //! @param [out] fcs_size Number of Frame Cyclic Sequence bytes at the end of the frame.
+        //! @param [out] timestamp Capture timestamp in microseconds since Unix epoch or -1 if none is available.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or end of capture.
+        //!
+        virtual bool readFrame(const uint8_t*& frame, size_t& cap_size, size_t& orig_size, uint16_t& link_type, size_t& fcs_size, cn::microseconds& timestamp, Report& report);
+
+        //!
+        //! Reset all counters before starting a new capture.
+        //!
+        void resetCounters();
+
     private:
         // Descriptioon of one capture interface.
         // Pcap files have only one interface, pcap-ng files may have more.
@@ -186,6 +239,12 @@ namespace ts {
         cn::microseconds _first_timestamp {-1};   // Timestamp of first packet in file.
         cn::microseconds _last_timestamp {-1};    // Timestamp of last packet in file.
         std::vector<InterfaceDesc> _if {};        // Capture interfaces by index, only one in pcap files.
+        ByteBlock        _buffer {};              // Last captured frame, with file headers.
+        bool             _use_map = false;        // Try to map the file in memory.
+        MemoryMappedFile _map {};                 // Memory-mapped file, when open in memory-mapped mode.
+        uint64_t         _data_offset = 0;        // Offset in file of the last data which was read by readData().
+        uint64_t         _frame_offset = INVALID_OFFSET;  // Offset in file of the last frame which was read by readFrame().
+        uint64_t         _ip_offset = INVALID_OFFSET;     // Offset in file of the last IP packet which was returned by readIP().
 
         // Report an error (if fmt is not empty), set error indicator, return false.
         bool error()
@@ -203,6 +262,10 @@ namespace ts {
         // Read exactly "size" bytes. Return false if not enough bytes before eof.
         bool readall(uint8_t* data, size_t size, Report& report);
 
+        // Read a data block of "size" bytes, the first "prefix" bytes of which were just read by readall() into "prefix_data".
+        // Return a pointer to the complete block, in the memory-mapped file or in _buffer. Also set _data_offset.
+        bool readData(size_t size, const uint8_t* prefix_data, size_t prefix, const uint8_t*& data, Report& report);
+
         // Read a file / section header, starting from a magic number which was read as big endian.
         bool readHeader(uint32_t magic, Report& report);
 
@@ -211,8 +274,8 @@ namespace ts {
 
         // Read a pcap-ng block. The 32-bit block type has already been read.
         // Start at "Block total length". Read complete block, including the two length fields.
-        // Return only the block body.
-        bool readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report);
+        // Return only the block body, in the memory-mapped file or in _buffer.
+        bool readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, Report& report);
 
         // Read 32 or 16 bits using the endianness.
         uint16_t get16(const void* addr) const { return _be ? GetUInt16BE(addr) : GetUInt16LE(addr); }
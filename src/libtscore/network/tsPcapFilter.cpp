@@ -190,23 +190,32 @@ bool ts::PcapFilter::open(const fs::path& filename, Report& report)
     // Invoke superclass.
     const bool ok = PcapFile::open(filename, report);
     if (ok) {
-        // Reinitialize filters.
-        _protocols.clear();
-        _source.clear();
-        _destination.clear();
-        _bidirectional_filter = false;
-        _wildcard_filter = true;
-        _first_packet = _opt_first_packet;
-        _last_packet = _opt_last_packet;
-        _first_time_offset = _opt_first_time_offset;
-        _last_time_offset = _opt_last_time_offset;
-        _first_time = _opt_first_time;
-        _last_time = _opt_last_time;
+        resetFilters();
     }
     return ok;
 }
 
 
+//----------------------------------------------------------------------------
+// Reinitialize all filters from the command line options.
+//----------------------------------------------------------------------------
+
+void ts::PcapFilter::resetFilters()
+{
+    _protocols.clear();
+    _source.clear();
+    _destination.clear();
+    _bidirectional_filter = false;
+    _wildcard_filter = true;
+    _first_packet = _opt_first_packet;
+    _last_packet = _opt_last_packet;
+    _first_time_offset = _opt_first_time_offset;
+    _last_time_offset = _opt_last_time_offset;
+    _first_time = _opt_first_time;
+    _last_time = _opt_last_time;
+}
+
+
 //----------------------------------------------------------------------------
 // Read an IPv4 packet, inherited method.
 //----------------------------------------------------------------------------
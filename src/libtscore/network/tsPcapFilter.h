@@ -220,6 +220,13 @@ namespace ts {
         virtual bool open(const fs::path& filename, Report& report) override;
         virtual bool readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds& timestamp, Report& report) override;
 
+    protected:
+        //!
+        //! Reinitialize all filters from the command line options.
+        //! This is automatically done when opening a file.
+        //!
+        void resetFilters();
+
     private:
         std::set<uint8_t> _protocols {};
         IPSocketAddress   _source {};
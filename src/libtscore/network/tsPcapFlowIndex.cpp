@@ -0,0 +1,153 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapFlowIndex.h"
+#include "tsIPPacket.h"
+#include "tsNullReport.h"
+
+
+//----------------------------------------------------------------------------
+// Comparison of flow identifications, for use in containers.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFlowIndex::FlowId::operator<(const FlowId& other) const
+{
+    if (vlans != other.vlans) {
+        return vlans < other.vlans;
+    }
+    else if (source != other.source) {
+        return source < other.source;
+    }
+    else {
+        return destination < other.destination;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the index from a capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFlowIndex::build(PcapFile& file, Report& report)
+{
+    clear();
+    _filename = file.fileName();
+
+    IPPacket ip;
+    FlowId id;
+    cn::microseconds timestamp = cn::microseconds::zero();
+
+    // Read all IP packets and record the location of all UDP payloads.
+    while (file.readIP(ip, id.vlans, timestamp, report)) {
+        if (!ip.isUDP()) {
+            continue;
+        }
+        if (file.lastIPOffset() == PcapFile::INVALID_OFFSET) {
+            report.error(u"no file offset for IP packets in %s, cannot index", _filename);
+            clear();
+            return false;
+        }
+        id.source = ip.source();
+        id.destination = ip.destination();
+        Flow& flow(_flows[id]);
+        flow.payloads.push_back({file.lastIPOffset() + uint64_t(ip.protocolData() - ip.data()), ip.protocolDataSize()});
+        flow.data_size += ip.protocolDataSize();
+        if (timestamp >= cn::microseconds::zero()) {
+            if (flow.first_timestamp < cn::microseconds::zero()) {
+                flow.first_timestamp = timestamp;
+            }
+            flow.last_timestamp = timestamp;
+        }
+    }
+
+    report.debug(u"indexed %'d UDP flows in %s", _flows.size(), _filename);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the index.
+//----------------------------------------------------------------------------
+
+void ts::PcapFlowIndex::clear()
+{
+    closePayloads();
+    _flows.clear();
+    _filename.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Open/close the indexed file for direct access to the UDP payloads.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFlowIndex::openPayloads(Report& report)
+{
+    closePayloads();
+
+    if (_filename.empty() || _filename == u"-") {
+        report.error(u"no indexed capture file, cannot access payloads");
+        return false;
+    }
+
+    // Try to map the file in memory first.
+    if (_map.open(_filename, NULLREP)) {
+        return true;
+    }
+
+    report.debug(u"cannot map %s in memory, using standard I/O", _filename);
+    _file.open(_filename, std::ios::in | std::ios::binary);
+    if (!_file) {
+        report.error(u"error opening %s", _filename);
+        return false;
+    }
+    return true;
+}
+
+void ts::PcapFlowIndex::closePayloads()
+{
+    _map.close();
+    if (_file.is_open()) {
+        _file.close();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Read a UDP payload in the indexed file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFlowIndex::readPayload(const Location& location, const uint8_t*& data, ByteBlock& buffer, Report& report) const
+{
+    data = nullptr;
+
+    if (_map.isOpen()) {
+        // Memory-mapped file, thread-safe, no copy.
+        if (location.offset > _map.size() || location.size > _map.size() - location.offset) {
+            report.error(u"invalid payload location %'d (%'d bytes) in %s", location.offset, location.size, _filename);
+            return false;
+        }
+        data = _map.data() + location.offset;
+        return true;
+    }
+
+    // Standard I/O, serialize access to the file.
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_file.is_open()) {
+        report.error(u"payloads of %s are not open", _filename);
+        return false;
+    }
+    buffer.resize(location.size);
+    _file.clear();
+    if (!_file.seekg(std::streamoff(location.offset)) || !_file.read(reinterpret_cast<char*>(buffer.data()), std::streamsize(buffer.size()))) {
+        report.error(u"error reading %'d bytes at offset %'d in %s", location.size, location.offset, _filename);
+        return false;
+    }
+    data = buffer.data();
+    return true;
+}
@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Index of UDP flows in a pcap or pcap-ng file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPcapFile.h"
+#include "tsMemoryMappedFile.h"
+#include "tsIPSocketAddress.h"
+#include "tsIPProtocols.h"
+
+namespace ts {
+    //!
+    //! Index of UDP flows in a pcap or pcap-ng file.
+    //! @ingroup libtscore net
+    //!
+    //! The index is built in one pass over a capture file. For each UDP flow, it contains
+    //! the location in the file of all UDP payloads. After building the index, the payloads
+    //! of any flow can be directly accessed, without parsing the file again. The payloads
+    //! can be concurrently read by several threads, for instance to extract many flows in parallel.
+    //!
+    class TSCOREDLL PcapFlowIndex
+    {
+        TS_NOCOPY(PcapFlowIndex);
+    public:
+        //!
+        //! Location of one UDP payload in the capture file.
+        //!
+        class TSCOREDLL Location
+        {
+        public:
+            uint64_t offset = 0;  //!< Offset in bytes of the UDP payload in the file.
+            size_t   size = 0;    //!< Size in bytes of the UDP payload.
+        };
+
+        //!
+        //! Identification of a UDP flow.
+        //!
+        class TSCOREDLL FlowId
+        {
+        public:
+            VLANIdStack     vlans {};        //!< Stack of VLAN encapsulation.
+            IPSocketAddress source {};       //!< Source socket address.
+            IPSocketAddress destination {};  //!< Destination socket address.
+
+            //!
+            //! Comparison operator, for use in containers.
+            //! @param [in] other Other instance to compare.
+            //! @return True if this object is logically less than @a other.
+            //!
+            bool operator<(const FlowId& other) const;
+        };
+
+        //!
+        //! Description of a UDP flow in the capture file.
+        //!
+        class TSCOREDLL Flow
+        {
+        public:
+            uint64_t              data_size = 0;          //!< Total size in bytes of UDP payloads.
+            cn::microseconds      first_timestamp {-1};   //!< Capture timestamp of first datagram, negative if none.
+            cn::microseconds      last_timestamp {-1};    //!< Capture timestamp of last datagram, negative if none.
+            std::vector<Location> payloads {};            //!< Location of all UDP payloads in the file.
+        };
+
+        //!
+        //! Map of UDP flows, indexed by flow identification.
+        //!
+        using FlowMap = std::map<FlowId, Flow>;
+
+        //!
+        //! Default constructor.
+        //!
+        PcapFlowIndex() = default;
+
+        //!
+        //! Build the index from a capture file.
+        //! All IP packets from the current position up to the end of the file are read.
+        //! Any filter which is set in @a file (if it is a PcapFilter) applies. Non-UDP packets are ignored.
+        //! Specifying PcapFile::setMemoryMap() before opening the file is recommended on large files.
+        //! @param [in,out] file Capture file, already open. It is not closed at the end.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool build(PcapFile& file, Report& report);
+
+        //!
+        //! Clear the index and close the access to the payloads.
+        //!
+        void clear();
+
+        //!
+        //! Get the indexed UDP flows.
+        //! @return A constant reference to the map of flows.
+        //!
+        const FlowMap& flows() const { return _flows; }
+
+        //!
+        //! Get the name of the indexed file.
+        //! @return The name of the indexed file.
+        //!
+        const fs::path& fileName() const { return _filename; }
+
+        //!
+        //! Open the indexed file for direct access to the UDP payloads.
+        //! The file is mapped in memory when possible. Otherwise, standard I/O is used and the
+        //! concurrent accesses to the file are serialized.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool openPayloads(Report& report);
+
+        //!
+        //! Close the direct access to the UDP payloads.
+        //!
+        void closePayloads();
+
+        //!
+        //! Read a UDP payload in the indexed file.
+        //! This method is thread-safe. Several threads may concurrently read payloads.
+        //! @param [in] location Location of the UDP payload in the file.
+        //! @param [out] data Address of the UDP payload, in the memory-mapped file or in @a buffer.
+        //! @param [in,out] buffer Buffer which is used when the file is not memory-mapped.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool readPayload(const Location& location, const uint8_t*& data, ByteBlock& buffer, Report& report) const;
+
+    private:
+        fs::path              _filename {};  // Indexed file.
+        FlowMap               _flows {};     // All UDP flows.
+        MemoryMappedFile      _map {};       // Memory-mapped indexed file.
+        mutable std::mutex    _mutex {};     // Protect _file.
+        mutable std::ifstream _file {};      // Indexed file, when not memory-mapped.
+    };
+}
@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryMappedFile.h"
+#include "tsSysUtils.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/stat.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Map a file in memory.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::open(const fs::path& filename, Report& report)
+{
+    if (_is_open) {
+        report.error(u"%s: a file is already mapped", filename);
+        return false;
+    }
+
+#if defined(TS_WINDOWS)
+
+    _file = ::CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (_file == INVALID_HANDLE_VALUE) {
+        report.error(u"error opening %s: %s", filename, SysErrorCodeMessage());
+        return false;
+    }
+    ::LARGE_INTEGER fsize;
+    if (!::GetFileSizeEx(_file, &fsize)) {
+        report.error(u"error getting size of %s: %s", filename, SysErrorCodeMessage());
+        close();
+        return false;
+    }
+    if (uint64_t(fsize.QuadPart) > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.error(u"file %s is too large to be mapped in memory", filename);
+        close();
+        return false;
+    }
+    _size = size_t(fsize.QuadPart);
+    if (_size > 0) {
+        _mapping = ::CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping == nullptr) {
+            report.error(u"error mapping %s: %s", filename, SysErrorCodeMessage());
+            close();
+            return false;
+        }
+        _data = reinterpret_cast<const uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr) {
+            report.error(u"error mapping %s: %s", filename, SysErrorCodeMessage());
+            close();
+            return false;
+        }
+    }
+
+#else
+
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        report.error(u"error opening %s: %s", filename, SysErrorCodeMessage());
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        report.error(u"error getting size of %s: %s", filename, SysErrorCodeMessage());
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        report.error(u"%s is not a regular file, cannot be mapped in memory", filename);
+        ::close(fd);
+        return false;
+    }
+    if (uint64_t(st.st_size) > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.error(u"file %s is too large to be mapped in memory", filename);
+        ::close(fd);
+        return false;
+    }
+    _size = size_t(st.st_size);
+    if (_size > 0) {
+        void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            report.error(u"error mapping %s: %s", filename, SysErrorCodeMessage());
+            ::close(fd);
+            _size = 0;
+            return false;
+        }
+        _data = reinterpret_cast<const uint8_t*>(addr);
+    }
+    // The mapping remains valid after closing the file descriptor.
+    ::close(fd);
+
+#endif
+
+    _is_open = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the file.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::close()
+{
+#if defined(TS_WINDOWS)
+    if (_data != nullptr) {
+        ::UnmapViewOfFile(_data);
+    }
+    if (_mapping != nullptr) {
+        ::CloseHandle(_mapping);
+        _mapping = nullptr;
+    }
+    if (_file != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(_file);
+        _file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (_data != nullptr) {
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+    }
+#endif
+    _data = nullptr;
+    _size = 0;
+    _is_open = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Give a hint to the operating system that the file will be sequentially read.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::adviseSequential()
+{
+#if defined(TS_UNIX)
+    if (_data != nullptr) {
+        ::madvise(const_cast<uint8_t*>(_data), _size, MADV_SEQUENTIAL);
+    }
+#endif
+}
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only memory-mapped file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Read-only memory-mapped file.
+    //! @ingroup libtscore system
+    //!
+    //! The complete content of a file is mapped in the virtual memory of the process.
+    //! The data are loaded on demand by the operating system when they are accessed.
+    //! Since the mapped memory is read-only, it can be concurrently accessed by several threads.
+    //!
+    //! On 32-bit systems, the size of the virtual memory may be too small to map very large files.
+    //! Applications should be ready to fall back to traditional I/O when open() fails.
+    //!
+    class TSCOREDLL MemoryMappedFile
+    {
+        TS_NOCOPY(MemoryMappedFile);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        MemoryMappedFile() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~MemoryMappedFile();
+
+        //!
+        //! Map a file in memory.
+        //! @param [in] filename File name.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const fs::path& filename, Report& report);
+
+        //!
+        //! Unmap the file.
+        //!
+        void close();
+
+        //!
+        //! Check if the file is mapped.
+        //! @return True if the file is mapped, false otherwise.
+        //!
+        bool isOpen() const { return _is_open; }
+
+        //!
+        //! Get the address of the file content.
+        //! @return The address of the file content or a null pointer if the file is not mapped or empty.
+        //!
+        const uint8_t* data() const { return _data; }
+
+        //!
+        //! Get the size of the file content.
+        //! @return The size in bytes of the mapped file.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Give a hint to the operating system that the file will be sequentially read.
+        //! The effect, if any, depends on the operating system.
+        //!
+        void adviseSequential();
+
+    private:
+        bool           _is_open = false;
+        const uint8_t* _data = nullptr;
+        size_t         _size = 0;
+#if defined(TS_WINDOWS)
+        ::HANDLE _file = INVALID_HANDLE_VALUE;
+        ::HANDLE _mapping = nullptr;
+#endif
+    };
+}
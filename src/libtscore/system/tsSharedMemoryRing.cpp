@@ -0,0 +1,599 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryRing.h"
+#include "tsSysUtils.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/stat.h>
+    #include <signal.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Layout of the shared memory segment header.
+// See the description of the layout in the header file.
+//----------------------------------------------------------------------------
+
+class ts::SharedMemoryRing::Header
+{
+public:
+    std::atomic<uint32_t> magic {0};
+    uint32_t              version = 0;
+    uint32_t              header_size = 0;
+    uint32_t              element_size = 0;
+    uint32_t              capacity = 0;
+    std::atomic<uint32_t> owner_pid {0};
+    alignas(64) std::atomic<uint32_t> head {0};
+    std::atomic<uint32_t> consumer_waiting {0};
+    std::atomic<uint32_t> consumer_closed {0};
+    std::atomic<uint32_t> producer_wake {0};
+    alignas(64) std::atomic<uint32_t> tail {0};
+    std::atomic<uint32_t> producer_waiting {0};
+    std::atomic<uint32_t> producer_closed {0};
+    std::atomic<uint32_t> consumer_wake {0};
+};
+
+namespace {
+    constexpr uint32_t SHM_RING_MAGIC = 0x544D5352;
+    constexpr size_t   MAX_CAPACITY = size_t(1) << 31;
+
+    // Identifier of the current process.
+    uint32_t CurrentProcessId()
+    {
+#if defined(TS_WINDOWS)
+        return uint32_t(::GetCurrentProcessId());
+#else
+        return uint32_t(::getpid());
+#endif
+    }
+}
+
+// The shared fields must be usable from several processes.
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryRing::~SharedMemoryRing()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Open or create a ring in a shared memory segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryRing::open(const UString& name, size_t element_size, size_t capacity, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring %s already open", _name);
+        return false;
+    }
+    if (name.empty()) {
+        report.error(u"no shared memory name specified");
+        return false;
+    }
+    if (capacity > 0) {
+        if (element_size == 0) {
+            report.error(u"no element size specified for shared memory %s", name);
+            return false;
+        }
+        if (capacity > MAX_CAPACITY || capacity > (std::numeric_limits<size_t>::max() - HEADER_SIZE) / element_size) {
+            report.error(u"shared memory ring %s is too large", name);
+            return false;
+        }
+        // Round up to the next power of 2.
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        capacity = size;
+    }
+
+    _aborted = false;
+    if (!mapSegment(name, element_size, capacity, report)) {
+        return false;
+    }
+    if (!(_owner ? initHeader(element_size, capacity, report) : checkHeader(element_size, report))) {
+        close();
+        return false;
+    }
+    report.debug(u"%s shared memory ring %s, %d elements of %d bytes", _owner ? u"created" : u"opened", _name, _capacity, _element_size);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Map the segment, fill _header and _map_size.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryRing::mapSegment(const UString& name, size_t element_size, size_t capacity, Report& report)
+{
+    void* addr = nullptr;
+    bool created = false;
+    const size_t new_size = capacity == 0 ? 0 : HEADER_SIZE + capacity * element_size;
+
+#if defined(TS_WINDOWS)
+
+    _name = u"Local\\" + name;
+    if (capacity > 0) {
+        _mapping = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, ::DWORD(uint64_t(new_size) >> 32), ::DWORD(new_size), _name.wc_str());
+        created = _mapping != nullptr && ::GetLastError() != ERROR_ALREADY_EXISTS;
+    }
+    else {
+        _mapping = ::OpenFileMappingW(FILE_MAP_ALL_ACCESS, false, _name.wc_str());
+    }
+    if (_mapping == nullptr) {
+        report.error(u"error opening shared memory %s: %s", _name, SysErrorCodeMessage());
+        return false;
+    }
+    addr = ::MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    ::MEMORY_BASIC_INFORMATION info;
+    if (addr == nullptr || ::VirtualQuery(addr, &info, sizeof(info)) == 0) {
+        report.error(u"error mapping shared memory %s: %s", _name, SysErrorCodeMessage());
+        if (addr != nullptr) {
+            ::UnmapViewOfFile(addr);
+        }
+        ::CloseHandle(_mapping);
+        _mapping = nullptr;
+        return false;
+    }
+    _map_size = created ? new_size : size_t(info.RegionSize);
+
+#else
+
+    _name = name.starts_with(u"/") ? name : u"/" + name;
+    const std::string path(_name.toUTF8());
+
+    // Try to create the segment first, then open an existing one.
+    int fd = -1;
+    if (capacity > 0) {
+        fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+        created = fd >= 0;
+        if (fd < 0 && errno != EEXIST) {
+            report.error(u"error creating shared memory %s: %s", _name, SysErrorCodeMessage());
+            return false;
+        }
+    }
+    if (fd < 0) {
+        fd = ::shm_open(path.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            report.error(u"error opening shared memory %s: %s", _name, SysErrorCodeMessage());
+            return false;
+        }
+    }
+
+    size_t size = new_size;
+    if (created) {
+        if (::ftruncate(fd, off_t(size)) < 0) {
+            report.error(u"error sizing shared memory %s: %s", _name, SysErrorCodeMessage());
+            ::close(fd);
+            ::shm_unlink(path.c_str());
+            return false;
+        }
+    }
+    else {
+        // The creator may not have sized the segment yet, wait a bit.
+        struct stat st;
+        for (int count = 0; ; ++count) {
+            if (::fstat(fd, &st) < 0) {
+                report.error(u"error getting size of shared memory %s: %s", _name, SysErrorCodeMessage());
+                ::close(fd);
+                return false;
+            }
+            if (size_t(st.st_size) >= HEADER_SIZE) {
+                break;
+            }
+            if (count >= 100) {
+                report.error(u"shared memory %s is not initialized", _name);
+                ::close(fd);
+                return false;
+            }
+            std::this_thread::sleep_for(cn::milliseconds(10));
+        }
+        size = size_t(st.st_size);
+    }
+
+    addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping shared memory %s: %s", _name, SysErrorCodeMessage());
+        if (created) {
+            ::shm_unlink(path.c_str());
+        }
+        return false;
+    }
+    _map_size = size;
+
+#endif
+
+    _header = reinterpret_cast<Header*>(addr);
+    _owner = created;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Initialize the header of a new segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryRing::initHeader(size_t element_size, size_t capacity, Report& report)
+{
+    static_assert(sizeof(Header) <= HEADER_SIZE);
+
+    // A new segment is filled with zeroes. Construct the header in place.
+    new (_header) Header();
+    _header->version = LAYOUT_VERSION;
+    _header->header_size = uint32_t(HEADER_SIZE);
+    _header->element_size = uint32_t(element_size);
+    _header->capacity = uint32_t(capacity);
+    _header->owner_pid = CurrentProcessId();
+    _header->magic.store(SHM_RING_MAGIC, std::memory_order_release);
+
+    _element_size = element_size;
+    _capacity = capacity;
+    _elements = reinterpret_cast<uint8_t*>(_header) + HEADER_SIZE;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check the header of an existing segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryRing::checkHeader(size_t element_size, Report& report)
+{
+    // The creator may not have initialized the header yet, wait a bit.
+    for (int count = 0; _header->magic.load(std::memory_order_acquire) != SHM_RING_MAGIC; ++count) {
+        if (count >= 100) {
+            report.error(u"shared memory %s is not a TSDuck ring", _name);
+            return false;
+        }
+        std::this_thread::sleep_for(cn::milliseconds(10));
+    }
+
+    const size_t capacity = _header->capacity;
+    if (_header->version != LAYOUT_VERSION || _header->header_size != HEADER_SIZE) {
+        report.error(u"incompatible layout version %d in shared memory %s", _header->version, _name);
+        return false;
+    }
+    if (element_size != 0 && _header->element_size != element_size) {
+        report.error(u"shared memory %s contains elements of %d bytes, %d expected", _name, _header->element_size, element_size);
+        return false;
+    }
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || capacity > MAX_CAPACITY || _header->element_size == 0 ||
+        capacity > (_map_size - HEADER_SIZE) / _header->element_size)
+    {
+        report.error(u"invalid ring size in shared memory %s", _name);
+        return false;
+    }
+
+    // When the creator of the segment was killed, the segment remains with the state of the previous session.
+    // Take the ownership of the segment and reset this state. The compare-and-swap on the process id ensures
+    // that only one process takes over the segment when several ones open it at the same time.
+    uint32_t owner = _header->owner_pid.load(std::memory_order_acquire);
+    if (ownerTerminated() && _header->owner_pid.compare_exchange_strong(owner, CurrentProcessId(), std::memory_order_seq_cst)) {
+        report.verbose(u"shared memory %s was created by terminated process %d, resetting it", _name, owner);
+        _header->head.store(0, std::memory_order_seq_cst);
+        _header->tail.store(0, std::memory_order_seq_cst);
+        _header->consumer_waiting.store(0, std::memory_order_seq_cst);
+        _header->producer_waiting.store(0, std::memory_order_seq_cst);
+        _header->consumer_closed.store(0, std::memory_order_seq_cst);
+        _header->producer_closed.store(0, std::memory_order_seq_cst);
+        // A remaining peer from the previous session may sleep, let it check the new state.
+        Wake(_header->consumer_wake);
+        Wake(_header->producer_wake);
+        _owner = true;
+    }
+    else if (uint32_t(_header->tail.load(std::memory_order_acquire) - _header->head.load(std::memory_order_acquire)) > capacity) {
+        report.error(u"corrupted indexes in shared memory %s", _name);
+        return false;
+    }
+
+    _element_size = _header->element_size;
+    _capacity = capacity;
+    _elements = reinterpret_cast<uint8_t*>(_header) + HEADER_SIZE;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the process which created the segment has terminated.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryRing::ownerTerminated() const
+{
+    const uint32_t pid = _header->owner_pid.load(std::memory_order_acquire);
+    if (pid == 0 || pid == CurrentProcessId()) {
+        return false;
+    }
+#if defined(TS_WINDOWS)
+    ::HANDLE process = ::OpenProcess(SYNCHRONIZE, false, ::DWORD(pid));
+    if (process == nullptr) {
+        // An invalid parameter means that there is no such process.
+        return ::GetLastError() == ERROR_INVALID_PARAMETER;
+    }
+    const bool terminated = ::WaitForSingleObject(process, 0) == WAIT_OBJECT_0;
+    ::CloseHandle(process);
+    return terminated;
+#else
+    return ::kill(::pid_t(pid), 0) < 0 && errno == ESRCH;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Close the ring.
+//----------------------------------------------------------------------------
+
+void ts::SharedMemoryRing::close()
+{
+    if (_header != nullptr) {
+#if defined(TS_WINDOWS)
+        ::UnmapViewOfFile(_header);
+        ::CloseHandle(_mapping);
+        _mapping = nullptr;
+#else
+        ::munmap(_header, _map_size);
+        if (_owner) {
+            ::shm_unlink(_name.toUTF8().c_str());
+        }
+#endif
+    }
+    _header = nullptr;
+    _elements = nullptr;
+    _map_size = 0;
+    _element_size = 0;
+    _capacity = 0;
+    _owner = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of committed elements in the ring.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemoryRing::size() const
+{
+    return _header == nullptr ? 0 : size_t(uint32_t(_header->tail.load(std::memory_order_acquire) - _header->head.load(std::memory_order_acquire)));
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until an index changes.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryRing::waitIndex(const std::atomic<uint32_t>& index, uint32_t value, std::atomic<uint32_t>& waiting, std::atomic<uint32_t>& wake, const std::atomic<uint32_t>& closed, monotonic_time deadline)
+{
+    while (index.load(std::memory_order_acquire) == value) {
+        if (_aborted) {
+            return false;
+        }
+        if (closed.load(std::memory_order_seq_cst) != 0) {
+            // The index may have been updated just before closing.
+            return index.load(std::memory_order_seq_cst) != value;
+        }
+        const monotonic_time now = monotonic_time::clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+        // Get the wake-up sequence, signal that we wait and check again before sleeping. A wake-up which
+        // occurs after loading the sequence increments it and the sleep immediately returns.
+        const uint32_t seq = wake.load(std::memory_order_seq_cst);
+        waiting.store(1, std::memory_order_seq_cst);
+        if (index.load(std::memory_order_seq_cst) == value && !_aborted && closed.load(std::memory_order_seq_cst) == 0) {
+#if defined(TS_LINUX)
+            ::timespec ts;
+            ::timespec* tsp = nullptr;
+            if (deadline != monotonic_time::max()) {
+                const cn::nanoseconds remain = deadline - now;
+                ts.tv_sec = ::time_t(cn::duration_cast<cn::seconds>(remain).count());
+                ts.tv_nsec = long((remain % cn::seconds(1)).count());
+                tsp = &ts;
+            }
+            // Not a private futex, the sequence word can be shared with another process.
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wake), FUTEX_WAIT, seq, tsp, nullptr, 0);
+#else
+            // No portable inter-process wait on an address, poll the index.
+            std::this_thread::sleep_for(std::min<cn::nanoseconds>(deadline - now, cn::microseconds(100)));
+#endif
+        }
+        waiting.store(0, std::memory_order_seq_cst);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Wake up the other side, waiting on its sequence word.
+//----------------------------------------------------------------------------
+
+void ts::SharedMemoryRing::Wake(std::atomic<uint32_t>& wake)
+{
+    wake.fetch_add(1, std::memory_order_seq_cst);
+#if defined(TS_LINUX)
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wake), FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Abort any pending wait in this process.
+//----------------------------------------------------------------------------
+
+void ts::SharedMemoryRing::abort()
+{
+    _aborted = true;
+    if (_header != nullptr) {
+        Wake(_header->consumer_wake);
+        Wake(_header->producer_wake);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Producer side.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemoryRing::writeBuffer(uint8_t*& address)
+{
+    if (_header == nullptr) {
+        address = nullptr;
+        return 0;
+    }
+    const uint32_t tail = _header->tail.load(std::memory_order_relaxed);
+    const uint32_t head = _header->head.load(std::memory_order_acquire);
+    const size_t index = tail & (_capacity - 1);
+    address = _elements + index * _element_size;
+    return std::min(_capacity - size_t(uint32_t(tail - head)), _capacity - index);
+}
+
+void ts::SharedMemoryRing::commitWrite(size_t count)
+{
+    if (_header != nullptr && count > 0) {
+        _header->tail.store(_header->tail.load(std::memory_order_relaxed) + uint32_t(count), std::memory_order_seq_cst);
+        if (_header->consumer_waiting.load(std::memory_order_seq_cst) != 0) {
+            Wake(_header->consumer_wake);
+        }
+    }
+}
+
+bool ts::SharedMemoryRing::waitWrite(cn::milliseconds timeout)
+{
+    if (_header == nullptr) {
+        return false;
+    }
+    const monotonic_time deadline = timeout == cn::milliseconds::max() ? monotonic_time::max() : monotonic_time::clock::now() + timeout;
+    const uint32_t full_head = _header->tail.load(std::memory_order_relaxed) - uint32_t(_capacity);
+    return waitIndex(_header->head, full_head, _header->producer_waiting, _header->producer_wake, _header->consumer_closed, deadline) && !consumerClosed();
+}
+
+bool ts::SharedMemoryRing::write(const void* data, size_t count)
+{
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+    while (count > 0) {
+        if (consumerClosed()) {
+            return false;
+        }
+        uint8_t* dest = nullptr;
+        size_t n = writeBuffer(dest);
+        if (n == 0) {
+            if (!waitWrite()) {
+                return false;
+            }
+            continue;
+        }
+        n = std::min(n, count);
+        MemCopy(dest, src, n * _element_size);
+        commitWrite(n);
+        src += n * _element_size;
+        count -= n;
+    }
+    return true;
+}
+
+void ts::SharedMemoryRing::closeProducer()
+{
+    if (_header != nullptr) {
+        _header->producer_closed.store(1, std::memory_order_seq_cst);
+        Wake(_header->consumer_wake);
+    }
+}
+
+bool ts::SharedMemoryRing::consumerClosed() const
+{
+    return _header != nullptr && _header->consumer_closed.load(std::memory_order_acquire) != 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Consumer side.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemoryRing::readBuffer(const uint8_t*& address)
+{
+    if (_header == nullptr) {
+        address = nullptr;
+        return 0;
+    }
+    const uint32_t head = _header->head.load(std::memory_order_relaxed);
+    const uint32_t tail = _header->tail.load(std::memory_order_acquire);
+    const size_t index = head & (_capacity - 1);
+    address = _elements + index * _element_size;
+    return std::min(size_t(uint32_t(tail - head)), _capacity - index);
+}
+
+void ts::SharedMemoryRing::commitRead(size_t count)
+{
+    if (_header != nullptr && count > 0) {
+        _header->head.store(_header->head.load(std::memory_order_relaxed) + uint32_t(count), std::memory_order_seq_cst);
+        if (_header->producer_waiting.load(std::memory_order_seq_cst) != 0) {
+            Wake(_header->producer_wake);
+        }
+    }
+}
+
+bool ts::SharedMemoryRing::waitRead(cn::milliseconds timeout)
+{
+    if (_header == nullptr) {
+        return false;
+    }
+    const monotonic_time deadline = timeout == cn::milliseconds::max() ? monotonic_time::max() : monotonic_time::clock::now() + timeout;
+    const uint32_t head = _header->head.load(std::memory_order_relaxed);
+    return waitIndex(_header->tail, head, _header->consumer_waiting, _header->consumer_wake, _header->producer_closed, deadline);
+}
+
+size_t ts::SharedMemoryRing::read(void* data, size_t max_count, cn::milliseconds timeout)
+{
+    if (max_count == 0 || !waitRead(timeout)) {
+        return 0;
+    }
+
+    // Read the committed elements, in two parts when they wrap at the end of the ring.
+    uint8_t* dest = reinterpret_cast<uint8_t*>(data);
+    size_t count = 0;
+    while (count < max_count) {
+        const uint8_t* src = nullptr;
+        const size_t n = std::min(readBuffer(src), max_count - count);
+        if (n == 0) {
+            break;
+        }
+        MemCopy(dest, src, n * _element_size);
+        commitRead(n);
+        dest += n * _element_size;
+        count += n;
+    }
+    return count;
+}
+
+void ts::SharedMemoryRing::closeConsumer()
+{
+    if (_header != nullptr) {
+        _header->consumer_closed.store(1, std::memory_order_seq_cst);
+        Wake(_header->producer_wake);
+    }
+}
+
+bool ts::SharedMemoryRing::producerClosed() const
+{
+    return _header != nullptr && _header->producer_closed.load(std::memory_order_acquire) != 0;
+}
@@ -0,0 +1,268 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Lock-free ring buffer in a named shared memory segment.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Lock-free ring buffer in a named shared memory segment, for one producer and one consumer.
+    //! @ingroup libtscore system
+    //!
+    //! The ring contains fixed-size elements, typically TS packets. The producer and the consumer
+    //! can be in the same process or in distinct processes. They open the same named segment.
+    //! The first one to open the segment creates it and becomes its owner. The owner deletes the
+    //! name of the segment when it closes the ring. The other side keeps its mapping until it closes.
+    //!
+    //! The producer fills free elements directly in the shared memory and commits them. The consumer
+    //! reads committed elements directly in the shared memory and releases them. No data is copied
+    //! by the ring itself and no lock is used. When one side waits for the other one, it sleeps on
+    //! its "wake" sequence word which is incremented by the other side. On Linux, futexes are used
+    //! and the waiting side is awakened only when it actually sleeps. On other systems, the waiting
+    //! side polls the indexes.
+    //!
+    //! Layout of the shared memory segment (all integers are 32-bit, in native byte order):
+    //!
+    //! | Offset | Field            | Description
+    //! | ------ | ---------------- | -----------
+    //! | 0      | magic            | 0x544D5352 ("TSMR" in big endian) when the segment is initialized
+    //! | 4      | version          | Layout version (LAYOUT_VERSION)
+    //! | 8      | header_size      | Size in bytes of the header (HEADER_SIZE), offset of the first element
+    //! | 12     | element_size     | Size in bytes of each element
+    //! | 16     | capacity         | Number of elements in the ring, a power of 2
+    //! | 20     | owner_pid        | Process id of the creator of the segment
+    //! | 64     | head             | Free-running count of released elements, written by the consumer only
+    //! | 68     | consumer_waiting | Non-zero when the consumer sleeps on @e consumer_wake
+    //! | 72     | consumer_closed  | Non-zero when the consumer has closed the ring
+    //! | 76     | producer_wake    | Sequence word on which the producer sleeps, incremented by the consumer
+    //! | 128    | tail             | Free-running count of committed elements, written by the producer only
+    //! | 132    | producer_waiting | Non-zero when the producer sleeps on @e producer_wake
+    //! | 136    | producer_closed  | Non-zero when the producer has closed the ring (end of stream)
+    //! | 140    | consumer_wake    | Sequence word on which the consumer sleeps, incremented by the producer
+    //! | 256    | elements         | @e capacity elements of @e element_size bytes
+    //!
+    //! The index of an element in the ring is its counter modulo @e capacity. The number of
+    //! committed elements is @e tail - @e head, modulo 2^32. The producer writes the elements
+    //! before storing @e tail and the consumer reads them after loading @e tail (acquire/release
+    //! ordering).
+    //!
+    //! A waiting side loads its "wake" word, sets its "waiting" field, checks the indexes and the
+    //! "closed" fields again and sleeps only if the "wake" word is unchanged (FUTEX_WAIT on Linux).
+    //! After updating its index, a side increments the "wake" word of the other side and wakes it
+    //! up (FUTEX_WAKE on Linux) only when the corresponding "waiting" field is set. After setting
+    //! its "closed" field, a side always increments the "wake" word of the other side and wakes it
+    //! up. This way, no wake-up is lost. Applications in other languages (Python for instance) can
+    //! map the segment and implement the same protocol, possibly by polling the indexes.
+    //!
+    //! When the creator of a segment is killed, the segment remains. When another process opens
+    //! a segment which was created by a terminated process, it takes the ownership of the segment
+    //! and resets the indexes and all indicators of the previous session. The unread elements are
+    //! dropped.
+    //!
+    //! On UNIX systems, the segment is a POSIX shared memory object, visible in /dev/shm on Linux.
+    //! On Windows, the segment is a named file mapping in the "Local\" namespace.
+    //!
+    class TSCOREDLL SharedMemoryRing
+    {
+        TS_NOCOPY(SharedMemoryRing);
+    public:
+        //!
+        //! Version of the layout of the shared memory segment.
+        //!
+        static constexpr uint32_t LAYOUT_VERSION = 2;
+
+        //!
+        //! Size in bytes of the header of the shared memory segment.
+        //!
+        static constexpr size_t HEADER_SIZE = 256;
+
+        //!
+        //! Default constructor.
+        //!
+        SharedMemoryRing() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~SharedMemoryRing();
+
+        //!
+        //! Open or create a ring in a shared memory segment.
+        //! @param [in] name Name of the shared memory segment. On UNIX systems, a leading '/' is added when missing.
+        //! @param [in] element_size Size in bytes of each element. When opening an existing segment, zero means
+        //! any size. Otherwise, the size must be identical to the one of the existing segment.
+        //! @param [in] capacity Number of elements in the ring, rounded up to the next power of 2. This value is
+        //! used only when the segment does not exist yet. When zero, the segment must already exist.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& name, size_t element_size, size_t capacity, Report& report);
+
+        //!
+        //! Close the ring. When this object created the segment, the name of the segment is deleted.
+        //! This method does not signal the end of stream or the termination of the consumer.
+        //! Use closeProducer() or closeConsumer() before, as appropriate.
+        //!
+        void close();
+
+        //!
+        //! Check if the ring is open.
+        //! @return True if the ring is open.
+        //!
+        bool isOpen() const { return _header != nullptr; }
+
+        //!
+        //! Check if this object created the shared memory segment.
+        //! @return True if this object created the shared memory segment.
+        //!
+        bool isOwner() const { return _owner; }
+
+        //!
+        //! Get the size of the elements.
+        //! @return The size in bytes of each element.
+        //!
+        size_t elementSize() const { return _element_size; }
+
+        //!
+        //! Get the capacity of the ring.
+        //! @return The number of elements in the ring.
+        //!
+        size_t capacity() const { return _capacity; }
+
+        //!
+        //! Get the number of committed elements in the ring.
+        //! This is an approximate value since the other side may modify the ring at the same time.
+        //! @return The number of committed elements in the ring.
+        //!
+        size_t size() const;
+
+        //!
+        //! Abort any pending wait in this process. Subsequent waits immediately fail.
+        //! This method can be called from any thread.
+        //!
+        void abort();
+
+        //!
+        //! Producer: get the contiguous free area in the ring.
+        //! @param [out] address Address of the first free element in the shared memory.
+        //! @return Number of contiguous free elements at @a address. This may be less than the
+        //! total number of free elements when the free area wraps at the end of the ring.
+        //!
+        size_t writeBuffer(uint8_t*& address);
+
+        //!
+        //! Producer: commit elements which were written in the area returned by writeBuffer().
+        //! @param [in] count Number of elements to commit.
+        //!
+        void commitWrite(size_t count);
+
+        //!
+        //! Producer: wait until there is at least one free element in the ring.
+        //! @param [in] timeout Maximum time to wait. Use cn::milliseconds::max() to wait forever.
+        //! @return True if there is at least one free element, false on timeout, abort or if the consumer closed the ring.
+        //!
+        bool waitWrite(cn::milliseconds timeout = cn::milliseconds::max());
+
+        //!
+        //! Producer: copy elements in the ring, waiting for free space as long as necessary.
+        //! @param [in] data Address of the elements to write.
+        //! @param [in] count Number of elements to write.
+        //! @return True on success, false on abort or if the consumer closed the ring.
+        //!
+        bool write(const void* data, size_t count);
+
+        //!
+        //! Producer: signal the end of stream to the consumer.
+        //! The consumer can still read the committed elements.
+        //!
+        void closeProducer();
+
+        //!
+        //! Check if the consumer has closed the ring.
+        //! @return True if the consumer has closed the ring.
+        //!
+        bool consumerClosed() const;
+
+        //!
+        //! Consumer: get the contiguous committed area in the ring.
+        //! @param [out] address Address of the oldest committed element in the shared memory.
+        //! @return Number of contiguous committed elements at @a address. This may be less than the
+        //! total number of committed elements when the committed area wraps at the end of the ring.
+        //!
+        size_t readBuffer(const uint8_t*& address);
+
+        //!
+        //! Consumer: release elements which were read in the area returned by readBuffer().
+        //! @param [in] count Number of elements to release.
+        //!
+        void commitRead(size_t count);
+
+        //!
+        //! Consumer: wait until there is at least one committed element in the ring.
+        //! @param [in] timeout Maximum time to wait. Use cn::milliseconds::max() to wait forever.
+        //! @return True if there is at least one committed element, false on timeout, abort or
+        //! if the producer closed the ring and all elements were read (end of stream).
+        //!
+        bool waitRead(cn::milliseconds timeout = cn::milliseconds::max());
+
+        //!
+        //! Consumer: copy elements from the ring, waiting for elements as long as necessary.
+        //! @param [out] data Address of the buffer receiving the elements.
+        //! @param [in] max_count Maximum number of elements to read.
+        //! @param [in] timeout Maximum time to wait for the first element. Use cn::milliseconds::max() to wait forever.
+        //! @return Number of read elements, zero on timeout, abort or end of stream. All contiguous
+        //! committed elements are returned, up to @a max_count, without waiting for more elements.
+        //!
+        size_t read(void* data, size_t max_count, cn::milliseconds timeout = cn::milliseconds::max());
+
+        //!
+        //! Consumer: signal to the producer that the consumer no longer reads the ring.
+        //!
+        void closeConsumer();
+
+        //!
+        //! Check if the producer has closed the ring (end of stream).
+        //! @return True if the producer has closed the ring.
+        //!
+        bool producerClosed() const;
+
+    private:
+        class Header;  // Layout of the shared memory segment header.
+
+        UString           _name {};             // Actual name of the segment.
+        Header*           _header = nullptr;    // Mapped segment, null if not open.
+        uint8_t*          _elements = nullptr;  // First element in the segment.
+        size_t            _map_size = 0;        // Size of the mapped segment.
+        size_t            _element_size = 0;    // Size in bytes of each element.
+        size_t            _capacity = 0;        // Number of elements, a power of 2.
+        bool              _owner = false;       // This object created the segment.
+        std::atomic_bool  _aborted {false};     // Pending and future waits shall fail.
+#if defined(TS_WINDOWS)
+        ::HANDLE          _mapping = nullptr;   // Handle to the file mapping.
+#endif
+
+        // Map the segment, fill _header and _map_size. Return true on success.
+        bool mapSegment(const UString& name, size_t element_size, size_t capacity, Report& report);
+
+        // Initialize the header of a new segment or check the header of an existing segment.
+        bool initHeader(size_t element_size, size_t capacity, Report& report);
+        bool checkHeader(size_t element_size, Report& report);
+
+        // Check if the process which created the segment has terminated.
+        bool ownerTerminated() const;
+
+        // Wait until an index changes, wake the other side.
+        bool waitIndex(const std::atomic<uint32_t>& index, uint32_t value, std::atomic<uint32_t>& waiting, std::atomic<uint32_t>& wake, const std::atomic<uint32_t>& closed, monotonic_time deadline);
+        static void Wake(std::atomic<uint32_t>& wake);
+    };
+}
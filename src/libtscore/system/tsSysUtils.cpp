@@ -249,6 +249,37 @@ cn::milliseconds ts::GetProcessCpuTime()
 }
 
 
+//----------------------------------------------------------------------------
+// Get the CPU time of the calling thread in microseconds.
+//----------------------------------------------------------------------------
+
+bool ts::GetThreadCpuTime(cn::microseconds& cpu_time)
+{
+#if defined(TS_WINDOWS)
+
+    ::FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (::GetThreadTimes(::GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time) == 0) {
+        return false;
+    }
+    // FILETIME values are in 100-nanosecond units.
+    const auto ticks = [](const ::FILETIME& ft) { return (uint64_t(ft.dwHighDateTime) << 32) | uint64_t(ft.dwLowDateTime); };
+    cpu_time = cn::microseconds(cn::microseconds::rep((ticks(kernel_time) + ticks(user_time)) / 10));
+    return true;
+
+#else
+
+    ::timespec tspec;
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tspec) < 0) {
+        return false;
+    }
+    using rep = cn::microseconds::rep;
+    cpu_time = cn::microseconds(rep(tspec.tv_sec) * 1'000'000 + rep(tspec.tv_nsec) / 1000);
+    return true;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Get the virtual memory size of the process in bytes.
 //----------------------------------------------------------------------------
@@ -112,6 +112,15 @@ namespace ts {
     //!
     TSCOREDLL cn::milliseconds GetProcessCpuTime();
 
+    //!
+    //! Get the CPU time of the calling thread in microseconds.
+    //! Unlike GetProcessCpuTime(), this function does not throw exceptions and can be used in packet processing loops.
+    //! @ingroup system
+    //! @param [out] cpu_time The CPU time of the calling thread in microseconds.
+    //! @return True on success, false on error.
+    //!
+    TSCOREDLL bool GetThreadCpuTime(cn::microseconds& cpu_time);
+
     //!
     //! Get the virtual memory size of the process in bytes.
     //! @ingroup system
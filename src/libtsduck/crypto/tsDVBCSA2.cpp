@@ -479,7 +479,7 @@ void ts::DVBCSA2::DVBBlockCipher::init(const uint8_t *key)
 }
 
 
-void ts::DVBCSA2::DVBBlockCipher::decipher(const uint8_t *ib, uint8_t *bd)
+void ts::DVBCSA2::DVBBlockCipher::decipher(const uint8_t *ib, uint8_t *bd) const
 {
     int i;
     int sbox_in;
@@ -524,7 +524,7 @@ void ts::DVBCSA2::DVBBlockCipher::decipher(const uint8_t *ib, uint8_t *bd)
 }
 
 
-void ts::DVBCSA2::DVBBlockCipher::encipher(const uint8_t *bd, uint8_t *ib)
+void ts::DVBCSA2::DVBBlockCipher::encipher(const uint8_t *bd, uint8_t *ib) const
 {
     int i;
     int sbox_in;
@@ -618,8 +618,11 @@ bool ts::DVBCSA2::encryptImpl(const void* input, size_t input_length, void* outp
     if (input != output) {
         MemCopy(output, input, size);
     }
+    return encryptMessage(reinterpret_cast<uint8_t*>(output), size);
+}
 
-    uint8_t* data = reinterpret_cast<uint8_t*>(output);
+bool ts::DVBCSA2::encryptMessage(uint8_t* data, size_t size) const
+{
     const size_t nblocks = size / 8;   // number of blocks
     const size_t rsize = size % 8;     // residue size
 
@@ -692,8 +695,11 @@ bool ts::DVBCSA2::decryptImpl(const void* input, size_t input_length, void* outp
     if (input != output) {
         MemCopy(output, input, size);
     }
+    return decryptMessage(reinterpret_cast<uint8_t*>(output), size);
+}
 
-    uint8_t* data = reinterpret_cast<uint8_t*>(output);
+bool ts::DVBCSA2::decryptMessage(uint8_t* data, size_t size) const
+{
     const size_t nblocks = size / 8;  // number of blocks
     const size_t rsize = size % 8;    // residue size
 
@@ -740,3 +746,35 @@ bool ts::DVBCSA2::decryptImpl(const void* input, size_t input_length, void* outp
 
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt several independent messages with a caller-provided
+// context. DVB-CSA2 does not use the cryptographic library. The context is
+// not needed because the key schedule is only read.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCSA2::hasContextInPlace() const
+{
+    return true;
+}
+
+bool ts::DVBCSA2::contextEncryptInPlaceImpl(BlockCipherContext&, void* const messages[], const size_t sizes[], size_t count) const
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!encryptMessage(reinterpret_cast<uint8_t*>(messages[i]), sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::DVBCSA2::contextDecryptInPlaceImpl(BlockCipherContext&, void* const messages[], const size_t sizes[], size_t count) const
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!decryptMessage(reinterpret_cast<uint8_t*>(messages[i]), sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
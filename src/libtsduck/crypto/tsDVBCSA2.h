@@ -68,6 +68,9 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        // Implementation of BlockCipher interface.
+        virtual bool hasContextInPlace() const override;
+
     protected:
         //! Properties of this algorithm.
         //! @return A constant reference to the properties.
@@ -77,6 +80,8 @@ namespace ts {
         virtual bool setKeyImpl() override;
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
 
     private:
         // Block cipher data
@@ -86,8 +91,8 @@ namespace ts {
             int _kk[57]; // 56..1: scheduled keys, index 0 unused
         public:
             void init(const uint8_t *cw);
-            void encipher(const uint8_t *bd, uint8_t *ib);
-            void decipher(const uint8_t *ib, uint8_t *bd);
+            void encipher(const uint8_t *bd, uint8_t *ib) const;
+            void decipher(const uint8_t *ib, uint8_t *bd) const;
         };
 
         // Stream cipher data
@@ -116,5 +121,9 @@ namespace ts {
         uint8_t         _key[KEY_SIZE] {};
         DVBBlockCipher  _block {};
         DVBStreamCipher _stream {};
+
+        // Encrypt or decrypt a message in place. Only read the key schedule, can be called concurrently.
+        bool encryptMessage(uint8_t* data, size_t size) const;
+        bool decryptMessage(uint8_t* data, size_t size) const;
     };
 }
@@ -68,6 +68,11 @@ namespace ts {
         //!
         bool setShortIV(const ByteBlock& iv) { return setShortIV(iv.data(), iv.size()); }
 
+        // Implementation of BlockCipher interface.
+        //! @cond nodoxygen
+        virtual bool hasContextInPlace() const override;
+        //! @endcond
+
     protected:
         //! Properties of this algorithm.
         //! @return A constant reference to the properties.
@@ -82,11 +87,20 @@ namespace ts {
         //! @cond nodoxygen
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
+        virtual bool contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const override;
         //! @endcond
 
     private:
         bool _ignore_short_iv = false;
         ByteBlock _short_iv {};
+
+        // Check if the IV's are valid for multi-message processing.
+        bool validInPlaceIV() const;
+
+        // Process the residues of several messages: Rn = encrypt (Cn-1) XOR Rn, truncated.
+        // Same operation for encryption and decryption, Cn-1 being the last complete cipher block.
+        bool processResidues(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const;
     };
 }
 
@@ -170,6 +184,15 @@ bool ts::DVS042<CIPHER>::encryptImpl(const void* plain, size_t plain_length, voi
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
+    // Use the native CBC mode of the cryptographic library when available.
+    const size_t bulk = (plain_length / bsize) * bsize;
+    if (bulk > 0 && this->nativeEncrypt(ts::BlockCipher::NativeMode::CBC, previous, pt, bulk, ct)) {
+        previous = ct + bulk - bsize;
+        ct += bulk;
+        pt += bulk;
+        plain_length -= bulk;
+    }
+
     while (plain_length >= bsize) {
         // work = previous-cipher XOR plain-text
         MemXor(work1, previous, pt, bsize);
@@ -198,6 +221,79 @@ bool ts::DVS042<CIPHER>::encryptImpl(const void* plain, size_t plain_length, voi
 }
 
 
+//----------------------------------------------------------------------------
+// Encryption and decryption of several independent messages in DVS 042 mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::DVS042<CIPHER>::validInPlaceIV() const
+{
+    const size_t bsize = this->properties.block_size;
+    return this->currentIV().size() == bsize && (_ignore_short_iv || _short_iv.size() == 0 || _short_iv.size() == bsize);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::DVS042<CIPHER>::hasContextInPlace() const
+{
+    // Without native ECB mode, messages are processed one by one.
+    return this->nativeAvailable(ts::BlockCipher::NativeMode::ECB);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::DVS042<CIPHER>::contextEncryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    // Encrypt all complete blocks in CBC mode, in interleaved lanes, then the residues using the last cipher blocks.
+    return validInPlaceIV() &&
+        this->interleavedEncryptCBC(context, messages, sizes, count, this->currentIV().data()) &&
+        processResidues(context, messages, sizes, count);
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::DVS042<CIPHER>::contextDecryptInPlaceImpl(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    // Decrypt the residues first, while the last cipher blocks are still present,
+    // then all complete blocks of all messages at once.
+    return validInPlaceIV() &&
+        processResidues(context, messages, sizes, count) &&
+        this->interleavedDecryptCBC(context, messages, sizes, count, this->currentIV().data());
+}
+
+template<class CIPHER> requires std::derived_from<CIPHER, ts::BlockCipher>
+bool ts::DVS042<CIPHER>::processResidues(BlockCipherContext& context, void* const messages[], const size_t sizes[], size_t count) const
+{
+    const size_t bsize = this->properties.block_size;
+
+    // Process residues by groups of lanes: Rn = encrypt (Cn-1) XOR Rn, truncated.
+    // For short messages, encrypt (shortIV) is used instead of encrypt (Cn-1).
+    const uint8_t* const short_iv = !_ignore_short_iv && _short_iv.size() != 0 ? _short_iv.data() : this->currentIV().data();
+    ByteBlock& residues(ts::BlockCipher::ContextWork(context));
+    residues.resize(ts::BlockCipher::MAX_LANES * bsize);
+    for (size_t base = 0; base < count; base += ts::BlockCipher::MAX_LANES) {
+        const size_t end = base + std::min(ts::BlockCipher::MAX_LANES, count - base);
+        size_t lanes = 0;
+        for (size_t i = base; i < end; ++i) {
+            const size_t residue = sizes[i] % bsize;
+            if (residue > 0) {
+                const uint8_t* msg = reinterpret_cast<const uint8_t*>(messages[i]);
+                MemCopy(residues.data() + lanes++ * bsize, sizes[i] < bsize ? short_iv : msg + sizes[i] - residue - bsize, bsize);
+            }
+        }
+        if (lanes > 0 && !this->nativeEncrypt(context, ts::BlockCipher::NativeMode::ECB, nullptr, residues.data(), lanes * bsize, residues.data())) {
+            return false;
+        }
+        lanes = 0;
+        for (size_t i = base; i < end; ++i) {
+            const size_t residue = sizes[i] % bsize;
+            if (residue > 0) {
+                uint8_t* last = reinterpret_cast<uint8_t*>(messages[i]) + sizes[i] - residue;
+                MemXor(last, last, residues.data() + lanes++ * bsize, residue);
+            }
+        }
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Decryption in DVS 042 mode.
 // The algorithm needs to specifically process overlapping buffers.
@@ -225,6 +321,19 @@ bool ts::DVS042<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, v
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
 
+    // Use the native CBC mode of the cryptographic library when available.
+    // Save the last cipher block first, the buffers may overlap.
+    const size_t bulk = (cipher_length / bsize) * bsize;
+    if (bulk > 0) {
+        MemCopy(work3, ct + bulk - bsize, bsize);
+        if (this->nativeDecrypt(ts::BlockCipher::NativeMode::CBC, previous, ct, bulk, pt)) {
+            previous = work3;
+            ct += bulk;
+            pt += bulk;
+            cipher_length -= bulk;
+        }
+    }
+
     while (cipher_length >= bsize) {
         // work = decrypt (cipher-text)
         if (!CIPHER::decryptImpl(ct, bsize, work1, bsize, nullptr)) {
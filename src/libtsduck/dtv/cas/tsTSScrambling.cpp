@@ -31,8 +31,7 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _next_cw(_cw_list.end())
 {
     setScramblingType(_scrambling_type);
-    _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
-    _dvbcsa[1].setEntropyMode(other._dvbcsa[1].entropyMode());
+    copyParameters(other);
 }
 
 ts::TSScrambling::TSScrambling(TSScrambling&& other) :
@@ -43,8 +42,23 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _next_cw(_cw_list.end())
 {
     setScramblingType(_scrambling_type);
-    _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
-    _dvbcsa[1].setEntropyMode(other._dvbcsa[1].entropyMode());
+    copyParameters(other);
+}
+
+
+//----------------------------------------------------------------------------
+// Copy the configuration parameters of the ciphers from another instance.
+//----------------------------------------------------------------------------
+
+void ts::TSScrambling::copyParameters(const TSScrambling& other)
+{
+    for (size_t i = 0; i < 4; ++i) {
+        _dvbcsa[i].setEntropyMode(other._dvbcsa[i].entropyMode());
+        _aescbc[i].setIV(other._aescbc[i].currentIV());
+        _aesctr[i].setIV(other._aesctr[i].currentIV());
+        _aesctr[i].setCounterBits(other._aesctr[i].counterBits());
+        _scte52[i].setIV(other._scte52[i].currentIV());
+    }
 }
 
 
@@ -56,38 +70,38 @@ bool ts::TSScrambling::setScramblingType(uint8_t scrambling, bool overrideExplic
 {
     if (overrideExplicit || !_explicit_type) {
 
-        // Select the right pair of scramblers.
+        // Select the right sets of scramblers.
+        BlockCipher* engines[4] {nullptr, nullptr, nullptr, nullptr};
         switch (scrambling) {
             case SCRAMBLING_DVB_CSA1:
             case SCRAMBLING_DVB_CSA2:
-                _scrambler[0] = &_dvbcsa[0];
-                _scrambler[1] = &_dvbcsa[1];
+                SelectEngines(engines, _dvbcsa);
                 break;
             case SCRAMBLING_DVB_CISSA1:
-                _scrambler[0] = &_dvbcissa[0];
-                _scrambler[1] = &_dvbcissa[1];
+                SelectEngines(engines, _dvbcissa);
                 break;
             case SCRAMBLING_ATIS_IIF_IDSA:
-                _scrambler[0] = &_idsa[0];
-                _scrambler[1] = &_idsa[1];
+                SelectEngines(engines, _idsa);
                 break;
             case SCRAMBLING_DUCK_AES_CBC:
-                _scrambler[0] = &_aescbc[0];
-                _scrambler[1] = &_aescbc[1];
+                SelectEngines(engines, _aescbc);
                 break;
             case SCRAMBLING_DUCK_AES_CTR:
-                _scrambler[0] = &_aesctr[0];
-                _scrambler[1] = &_aesctr[1];
+                SelectEngines(engines, _aesctr);
+                break;
+            case SCRAMBLING_DUCK_SCTE52:
+                SelectEngines(engines, _scte52);
                 break;
             default:
                 // Fallback to DVB-CSA2 if no scrambler was previously defined.
                 if (_scrambler[0] == nullptr || _scrambler[1] == nullptr) {
                     _scrambling_type = SCRAMBLING_DVB_CSA2;
-                    _scrambler[0] = &_dvbcsa[0];
-                    _scrambler[1] = &_dvbcsa[1];
+                    SelectEngines(engines, _dvbcsa);
+                    setEngines(engines);
                 }
                 return false;
         }
+        setEngines(engines);
 
         // Set scrambling type.
         if (_scrambling_type != scrambling) {
@@ -99,17 +113,35 @@ bool ts::TSScrambling::setScramblingType(uint8_t scrambling, bool overrideExplic
     }
 
     // Make sure the current scramblers notify alerts to this object.
-    _scrambler[0]->setAlertHandler(this);
-    _scrambler[1]->setAlertHandler(this);
-    _scrambler[0]->setCipherId(0);
-    _scrambler[1]->setCipherId(1);
+    std::lock_guard<std::mutex> lock(_standby_mutex);
+    for (size_t i = 0; i < 2; ++i) {
+        _scrambler[i]->setAlertHandler(this);
+        _standby[i]->setAlertHandler(this);
+        _scrambler[i]->setCipherId(int(i));
+        _standby[i]->setCipherId(int(i));
+    }
     return true;
 }
 
+// Select the active and standby engines, even and odd.
+void ts::TSScrambling::setEngines(BlockCipher* const engines[4])
+{
+    // Keep the active and standby engines unchanged if they are from the same algorithm,
+    // in which case they may have been swapped.
+    if (_scrambler[0] != engines[0] && _scrambler[0] != engines[2]) {
+        std::lock_guard<std::mutex> lock(_standby_mutex);
+        for (size_t i = 0; i < 2; ++i) {
+            _scrambler[i] = engines[i];
+            _standby[i] = engines[i + 2];
+        }
+    }
+}
+
 void ts::TSScrambling::setEntropyMode(DVBCSA2::EntropyMode mode)
 {
-    _dvbcsa[0].setEntropyMode(mode);
-    _dvbcsa[1].setEntropyMode(mode);
+    for (auto& csa : _dvbcsa) {
+        csa.setEntropyMode(mode);
+    }
 }
 
 ts::DVBCSA2::EntropyMode ts::TSScrambling::entropyMode() const
@@ -154,10 +186,10 @@ void ts::TSScrambling::defineArgs(Args &args)
               u"Use ATIS-IDSA scrambling (ATIS-0800006) instead of DVB-CSA2 (the "
               u"default). The control words are 16-byte long instead of 8-byte.");
 
-    args.option(u"iv", 0, Args::HEXADATA, 0, Args::UNLIMITED_COUNT, AES128::BLOCK_SIZE, AES128::BLOCK_SIZE);
+    args.option(u"iv", 0, Args::HEXADATA, 0, Args::UNLIMITED_COUNT, DES::BLOCK_SIZE, AES128::BLOCK_SIZE);
     args.help(u"iv",
-              u"With --aes-cbc or --aes-ctr, specifies a fixed initialization vector for all TS packets. "
-              u"The value must be a string of 32 hexadecimal digits. "
+              u"With --aes-cbc, --aes-ctr or --scte52, specifies a fixed initialization vector for all TS packets. "
+              u"The value must be a string of 32 hexadecimal digits (16 digits with --scte52). "
               u"The default IV is all zeroes.");
 
     args.option(u"ctr-counter-bits", 0, Args::UNSIGNED);
@@ -195,6 +227,15 @@ void ts::TSScrambling::defineArgs(Args &args)
     args.option(u"dvb-csa2");
     args.help(u"dvb-csa2", u"Use DVB-CSA2 scrambling. This is the default.");
 
+    args.option(u"scte52");
+    args.help(u"scte52",
+              u"Use ANSI/SCTE 52 2008 scrambling (DES-CBC, also known as DVS 042) instead of DVB-CSA2 (the default). "
+              u"The control words are 8-byte long. "
+              u"The residue is included in the scrambling. "
+              u"Specify the initialization vector using the --iv option.\n\n"
+              u"The TSDuck scrambler automatically sets the scrambling_descriptor with "
+              u"user-defined value " + UString::Hexa(uint8_t(SCRAMBLING_DUCK_SCTE52)) + u".");
+
     args.option(u"no-entropy-reduction", 'n');
     args.help(u"no-entropy-reduction",
               u"With DVB-CSA2, do not perform control word entropy reduction to 48 bits. "
@@ -215,11 +256,12 @@ bool ts::TSScrambling::loadArgs(DuckContext& duck, Args& args)
         args.present(u"dvb-cissa") +
         args.present(u"dvb-csa2") +
         args.present(u"aes-cbc") +
-        args.present(u"aes-ctr");
+        args.present(u"aes-ctr") +
+        args.present(u"scte52");
 
     // Set the scrambler to use.
     if (algo_count > 1) {
-        args.error(u"--atis-idsa, --dvb-cissa, --dvb-csa2, --aes-cbc, --aes-ctr are mutually exclusive");
+        args.error(u"--atis-idsa, --dvb-cissa, --dvb-csa2, --aes-cbc, --aes-ctr, --scte52 are mutually exclusive");
     }
     else if (args.present(u"atis-idsa")) {
         setScramblingType(SCRAMBLING_ATIS_IIF_IDSA);
@@ -233,6 +275,9 @@ bool ts::TSScrambling::loadArgs(DuckContext& duck, Args& args)
     else if (args.present(u"aes-ctr")) {
         setScramblingType(SCRAMBLING_DUCK_AES_CTR);
     }
+    else if (args.present(u"scte52")) {
+        setScramblingType(SCRAMBLING_DUCK_SCTE52);
+    }
     else {
         setScramblingType(SCRAMBLING_DVB_CSA2);
     }
@@ -244,21 +289,32 @@ bool ts::TSScrambling::loadArgs(DuckContext& duck, Args& args)
     // Set DVB-CSA2 entropy mode regardless of --atis-idsa or --dvb-cissa in case we switch later to DVB-CSA2.
     setEntropyMode(args.present(u"no-entropy-reduction") ? DVBCSA2::FULL_CW : DVBCSA2::REDUCE_ENTROPY);
 
-    // Set AES-CBC/CTR initialization vector. The default is all zeroes.
-    const ByteBlock iv(args.hexaValue(u"iv", ByteBlock(AES128::BLOCK_SIZE, 0x00)));
-    if (!_aescbc[0].setIV(iv.data(), iv.size()) ||
-        !_aescbc[1].setIV(iv.data(), iv.size()) ||
-        !_aesctr[0].setIV(iv.data(), iv.size()) ||
-        !_aesctr[1].setIV(iv.data(), iv.size()))
-    {
-        args.error(u"error setting AES initialization vector");
+    // Set AES-CBC/CTR or SCTE 52 initialization vector. The default is all zeroes.
+    if (args.present(u"scte52")) {
+        const ByteBlock iv(args.hexaValue(u"iv", ByteBlock(DES::BLOCK_SIZE, 0x00)));
+        for (auto& scte : _scte52) {
+            if (!scte.setIV(iv.data(), iv.size())) {
+                args.error(u"error setting SCTE 52 initialization vector, must be %d bytes", DES::BLOCK_SIZE);
+                break;
+            }
+        }
+    }
+    else {
+        const ByteBlock iv(args.hexaValue(u"iv", ByteBlock(AES128::BLOCK_SIZE, 0x00)));
+        for (size_t i = 0; i < 4; ++i) {
+            if (!_aescbc[i].setIV(iv.data(), iv.size()) || !_aesctr[i].setIV(iv.data(), iv.size())) {
+                args.error(u"error setting AES initialization vector");
+                break;
+            }
+        }
     }
 
     // Set the size of the counter part with CTS mode.
     // The default is zero, meaning half nounce / half counter.
     const size_t counter_bits = args.intValue<size_t>(u"ctr-counter-bits");
-    _aesctr[0].setCounterBits(counter_bits);
-    _aesctr[1].setCounterBits(counter_bits);
+    for (auto& ctr : _aesctr) {
+        ctr.setCounterBits(counter_bits);
+    }
 
     // Get control words as list of strings.
     UStringList lines;
@@ -411,7 +467,19 @@ bool ts::TSScrambling::setNextFixedCW(int parity)
 
 bool ts::TSScrambling::setCW(const ByteBlock& cw, int parity)
 {
-    BlockCipher* algo = _scrambler[parity & 1];
+    const size_t index = parity & 1;
+
+    // If the key schedule of this CW was prepared in the standby engine, swap engines.
+    {
+        std::lock_guard<std::mutex> lock(_standby_mutex);
+        if (IsPrepared(_standby[index], cw)) {
+            std::swap(_scrambler[index], _standby[index]);
+            _report.debug(u"using prepared scrambling key: " + UString::Dump(cw, UString::SINGLE_LINE));
+            return true;
+        }
+    }
+
+    BlockCipher* algo = _scrambler[index];
     assert(algo != nullptr);
 
     if (algo->setKey(cw.data(), cw.size())) {
@@ -425,6 +493,36 @@ bool ts::TSScrambling::setCW(const ByteBlock& cw, int parity)
 }
 
 
+//----------------------------------------------------------------------------
+// Prepare a control word for a future call to setCW().
+//----------------------------------------------------------------------------
+
+// Check if an engine has a prepared key: same key, never used since set.
+// A previously used engine is not reused as is, to keep the "first usage" alerts.
+bool ts::TSScrambling::IsPrepared(const BlockCipher* algo, const ByteBlock& cw)
+{
+    return algo->hasKey() && algo->encryptionCount() == 0 && algo->decryptionCount() == 0 && algo->currentKey() == cw;
+}
+
+bool ts::TSScrambling::prepareCW(const ByteBlock& cw, int parity)
+{
+    std::lock_guard<std::mutex> lock(_standby_mutex);
+    BlockCipher* algo = _standby[parity & 1];
+    assert(algo != nullptr);
+
+    if (IsPrepared(algo, cw)) {
+        return true;
+    }
+    else if (algo->setKey(cw.data(), cw.size())) {
+        return true;
+    }
+    else {
+        _report.error(u"error preparing %d-byte key to %s", cw.size(), algo->name());
+        return false;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Set the parity of all subsequent encryptions.
 //----------------------------------------------------------------------------
@@ -440,6 +538,33 @@ bool ts::TSScrambling::setEncryptParity(int parity)
 }
 
 
+//----------------------------------------------------------------------------
+// Size of the payload to process in a packet.
+//----------------------------------------------------------------------------
+
+size_t ts::TSScrambling::ScrambledSize(const TSPacket& pkt, const BlockCipher* algo)
+{
+    size_t psize = pkt.getPayloadSize();
+    if (!algo->residueAllowed()) {
+        // Remove the residue from the payload.
+        assert(algo->blockSize() != 0);
+        psize -= psize % algo->blockSize();
+    }
+    return psize;
+}
+
+
+//----------------------------------------------------------------------------
+// Make sure that an encryption parity and the corresponding CW are set.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::prepareEncrypt()
+{
+    // If no current parity is set, start with even by default.
+    return _encrypt_scv != SC_CLEAR || setEncryptParity(SC_EVEN_KEY);
+}
+
+
 //----------------------------------------------------------------------------
 // Encrypt a TS packet with the current parity and corresponding CW.
 //----------------------------------------------------------------------------
@@ -458,7 +583,7 @@ bool ts::TSScrambling::encrypt(TSPacket& pkt)
     }
 
     // If no current parity is set, start with even by default.
-    if (_encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+    if (!prepareEncrypt()) {
         return false;
     }
 
@@ -468,12 +593,7 @@ bool ts::TSScrambling::encrypt(TSPacket& pkt)
     assert(algo != nullptr);
 
     // Check if the residue shall be included in the scrambling.
-    size_t psize = pkt.getPayloadSize();
-    if (!algo->residueAllowed()) {
-        // Remove the residue from the payload.
-        assert(algo->blockSize() != 0);
-        psize -= psize % algo->blockSize();
-    }
+    const size_t psize = ScrambledSize(pkt, algo);
 
     // Encrypt the packet. Encrypting "in place" is handled by the API.
     const bool ok = psize == 0 || algo->encrypt(pkt.getPayload(), psize, pkt.getPayload(), psize);
@@ -487,6 +607,20 @@ bool ts::TSScrambling::encrypt(TSPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Select the decryption key for a scrambling control value.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::setDecryptParity(uint8_t scv)
+{
+    const uint8_t previous_scv = _decrypt_scv;
+    _decrypt_scv = scv;
+
+    // In case of fixed control word, use next key when the scrambling control changes.
+    return !hasFixedCW() || previous_scv == _decrypt_scv || setNextFixedCW(_decrypt_scv);
+}
+
+
 //----------------------------------------------------------------------------
 // Decrypt a TS packet with the CW corresponding to the parity in the packet.
 //----------------------------------------------------------------------------
@@ -500,11 +634,7 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
 
     // Update current parity.
-    const uint8_t previous_scv = _decrypt_scv;
-    _decrypt_scv = scv;
-
-    // In case of fixed control word, use next key when the scrambling control changes.
-    if (hasFixedCW() && previous_scv != _decrypt_scv && !setNextFixedCW(_decrypt_scv)) {
+    if (!setDecryptParity(scv)) {
         return false;
     }
 
@@ -513,12 +643,7 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     assert(algo != nullptr);
 
     // Check if the residue shall be included in the scrambling.
-    size_t psize = pkt.getPayloadSize();
-    if (!algo->residueAllowed()) {
-        // Remove the residue from the payload.
-        assert(algo->blockSize() != 0);
-        psize -= psize % algo->blockSize();
-    }
+    const size_t psize = ScrambledSize(pkt, algo);
 
     // Decrypt the packet. Decrypting "in place" is handled by the API.
     const bool ok = psize == 0 || algo->decrypt(pkt.getPayload(), psize, pkt.getPayload(), psize);
@@ -530,3 +655,160 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Common code for multi-packet operations.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::collectEncrypt(Context& context, TSPacket* const pkts[], size_t count, const BlockCipher* algo) const
+{
+    // Silently pass packets without payload.
+    context._pkts.clear();
+    for (size_t i = 0; i < count; ++i) {
+        TSPacket* pkt = pkts[i];
+        if (pkt != nullptr && pkt->isScrambled()) {
+            _report.error(u"try to scramble an already scrambled packet");
+            return false;
+        }
+        if (pkt != nullptr && pkt->hasPayload()) {
+            context._pkts.push_back(pkt);
+        }
+    }
+    CollectPayloads(context, algo);
+    return true;
+}
+
+uint8_t ts::TSScrambling::NextDecryptBatch(Context& context, TSPacket* const pkts[], size_t count, size_t& index)
+{
+    context._pkts.clear();
+    uint8_t batch_scv = SC_CLEAR;
+    for (; index < count; ++index) {
+        // Clear or invalid packets are silently accepted.
+        TSPacket* pkt = pkts[index];
+        const uint8_t scv = pkt == nullptr ? uint8_t(SC_CLEAR) : pkt->getScrambling();
+        if (scv == SC_EVEN_KEY || scv == SC_ODD_KEY) {
+            // A parity change terminates the current batch.
+            if (batch_scv != SC_CLEAR && scv != batch_scv) {
+                break;
+            }
+            batch_scv = scv;
+            context._pkts.push_back(pkt);
+        }
+    }
+    return batch_scv;
+}
+
+void ts::TSScrambling::CollectPayloads(Context& context, const BlockCipher* algo)
+{
+    context._data.clear();
+    context._size.clear();
+    for (auto pkt : context._pkts) {
+        const size_t psize = ScrambledSize(*pkt, algo);
+        if (psize > 0) {
+            context._data.push_back(pkt->getPayload());
+            context._size.push_back(psize);
+        }
+    }
+}
+
+bool ts::TSScrambling::endBatch(Context& context, bool success, bool encrypt, uint8_t scv, const BlockCipher* algo) const
+{
+    if (success) {
+        for (auto pkt : context._pkts) {
+            pkt->setScrambling(encrypt ? scv : uint8_t(SC_CLEAR));
+        }
+    }
+    else {
+        _report.error(u"packet %s error using %s", encrypt ? u"encryption" : u"decryption", algo->name());
+    }
+    context._pkts.clear();
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt several TS packets with the current parity and corresponding CW.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* const pkts[], size_t count)
+{
+    // If no current parity is set, start with even by default.
+    if (!prepareEncrypt()) {
+        return false;
+    }
+
+    // Select scrambling algo.
+    assert(_encrypt_scv == SC_EVEN_KEY || _encrypt_scv == SC_ODD_KEY);
+    BlockCipher* algo = _scrambler[_encrypt_scv & 1];
+    assert(algo != nullptr);
+
+    // Encrypt all payloads at once.
+    return collectEncrypt(_batch, pkts, count, algo) &&
+           endBatch(_batch, algo->encryptInPlace(_batch._data.data(), _batch._size.data(), _batch._data.size()), true, _encrypt_scv, algo);
+}
+
+bool ts::TSScrambling::encrypt(Context& context, TSPacket* const pkts[], size_t count) const
+{
+    // The parity cannot be selected here, this object is not modified.
+    if (_encrypt_scv != SC_EVEN_KEY && _encrypt_scv != SC_ODD_KEY) {
+        _report.error(u"no encryption parity set");
+        return false;
+    }
+    const BlockCipher* algo = _scrambler[_encrypt_scv & 1];
+    assert(algo != nullptr);
+
+    // Encrypt all payloads at once, using the shared key and the context of the caller.
+    return collectEncrypt(context, pkts, count, algo) &&
+           endBatch(context, algo->encryptInPlace(context._cipher, context._data.data(), context._size.data(), context._data.size()), true, _encrypt_scv, algo);
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several TS packets with the CW corresponding to their parity.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decrypt(TSPacket* const pkts[], size_t count)
+{
+    size_t index = 0;
+    uint8_t scv = SC_CLEAR;
+    while ((scv = NextDecryptBatch(_batch, pkts, count, index)) != SC_CLEAR) {
+        // All packets in the batch have the same parity.
+        if (!setDecryptParity(scv)) {
+            _batch._pkts.clear();
+            return false;
+        }
+        BlockCipher* algo = _scrambler[scv & 1];
+        assert(algo != nullptr);
+        CollectPayloads(_batch, algo);
+        if (!endBatch(_batch, algo->decryptInPlace(_batch._data.data(), _batch._size.data(), _batch._data.size()), false, scv, algo)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::TSScrambling::decrypt(Context& context, TSPacket* const pkts[], size_t count) const
+{
+    size_t index = 0;
+    uint8_t scv = SC_CLEAR;
+    while ((scv = NextDecryptBatch(context, pkts, count, index)) != SC_CLEAR) {
+        const BlockCipher* algo = _scrambler[scv & 1];
+        assert(algo != nullptr);
+        CollectPayloads(context, algo);
+        if (!endBatch(context, algo->decryptInPlace(context._cipher, context._data.data(), context._size.data(), context._data.size()), false, scv, algo)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the cipher engines can be concurrently used with distinct contexts.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::canShareKeys() const
+{
+    return _scrambler[0] != nullptr && _scrambler[0]->hasContextInPlace() && _scrambler[1] != nullptr && _scrambler[1]->hasContextInPlace();
+}
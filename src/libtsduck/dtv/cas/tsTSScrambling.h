@@ -22,6 +22,7 @@
 #include "tsCBC.h"
 #include "tsCTR.h"
 #include "tsIDSA.h"
+#include "tsSCTE52.h"
 
 namespace ts {
 
@@ -37,7 +38,8 @@ namespace ts {
     //! The scrambling type is indicated by a constant as present in a scrambling_descriptor.
     //! Currently, SCRAMBLING_DVB_CSA2, SCRAMBLING_DVB_CISSA1 and SCRAMBLING_ATIS_IIF_IDSA
     //! are supported as standard scrambling algorithms. Additionally, the non-standard
-    //! algorithms are also supported: SCRAMBLING_DUCK_AES_CBC, SCRAMBLING_DUCK_AES_CTR.
+    //! algorithms are also supported: SCRAMBLING_DUCK_AES_CBC, SCRAMBLING_DUCK_AES_CTR,
+    //! SCRAMBLING_DUCK_SCTE52.
     //!
     //! With fixed control words from the command line:
     //! - For encryption, the next key is used each time setEncryptParity() is called
@@ -48,6 +50,31 @@ namespace ts {
     class TSDUCKDLL TSScrambling : private BlockCipherAlertInterface
     {
     public:
+        //!
+        //! Per-thread context for concurrent multi-packet operations.
+        //!
+        //! The const versions of encrypt() and decrypt() on several packets use the keyed cipher
+        //! engines of a TSScrambling instance, without modifying them. All thread-dependent data
+        //! are stored in an instance of this class. Several threads can concurrently encrypt or
+        //! decrypt packets with the same TSScrambling instance, each of them using its own context.
+        //!
+        class TSDUCKDLL Context
+        {
+            TS_NOCOPY(Context);
+        public:
+            //!
+            //! Default constructor.
+            //!
+            Context() = default;
+
+        private:
+            friend class TSScrambling;
+            BlockCipherContext     _cipher {};  // Cipher engine data.
+            std::vector<TSPacket*> _pkts {};    // Packets in multi-packet operations.
+            std::vector<void*>     _data {};    // Payloads to process in multi-packet operations.
+            std::vector<size_t>    _size {};    // Payload sizes in multi-packet operations.
+        };
+
         //!
         //! Default constructor.
         //! @param [in,out] report Where to report error and information.
@@ -170,6 +197,23 @@ namespace ts {
         //!
         bool setCW(const ByteBlock& cw, int parity);
 
+        //!
+        //! Prepare a control word for a future call to setCW().
+        //! The key schedule of the control word is computed in advance in a standby cipher engine.
+        //! When setCW() is later called with the same control word and parity, the standby engine
+        //! becomes the active one and the key schedule is not recomputed.
+        //!
+        //! This method can be called from another thread than the one which processes the packets,
+        //! typically a thread which generates or deciphers ECM's. The standby engines are protected
+        //! by a mutex. If the scrambling type is changed in the meantime, the prepared key is lost
+        //! and setCW() computes the key schedule again.
+        //!
+        //! @param [in] cw The control word to prepare.
+        //! @param [in] parity Use the parity of this integer value (odd or even).
+        //! @return True on success, false on error.
+        //!
+        bool prepareCW(const ByteBlock& cw, int parity);
+
         //!
         //! Set the parity of all subsequent encryptions.
         //! @param [in] parity Use the parity of this integer value (odd or even).
@@ -177,6 +221,13 @@ namespace ts {
         //!
         bool setEncryptParity(int parity);
 
+        //!
+        //! Make sure that an encryption parity and the corresponding CW are set.
+        //! If no parity was set, start with the even one. This is automatically done by encrypt().
+        //! @return True on success, false on error (error setting next fixed CW, if any).
+        //!
+        bool prepareEncrypt();
+
         //!
         //! Encrypt a TS packet with the current parity and corresponding CW.
         //! @param [in,out] pkt The packet to encrypt.
@@ -191,6 +242,59 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt several TS packets with the current parity and corresponding CW.
+        //! The result is identical to calling encrypt() on each packet. However, the payloads of all
+        //! packets are passed at once to the cipher, which can encrypt them in interleaved lanes.
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt. Null pointers are ignored.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //! In case of error, no packet is modified.
+        //!
+        bool encrypt(TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Decrypt several TS packets with the CW corresponding to the parity in each packet.
+        //! The result is identical to calling decrypt() on each packet. However, consecutive packets
+        //! with the same parity are passed at once to the cipher.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt. Null pointers are ignored.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. A clear packet is not an error.
+        //!
+        bool decrypt(TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Check if the cipher engines can be concurrently used with distinct contexts.
+        //! @return True if the const versions of encrypt() and decrypt() with a Context
+        //! are supported by the current scrambling algorithm.
+        //!
+        bool canShareKeys() const;
+
+        //!
+        //! Encrypt several TS packets with the current parity and corresponding CW, using a caller-provided context.
+        //! This instance is not modified. Several threads can concurrently use this method, each with its own context.
+        //! The encryption parity and the corresponding CW must have been previously set, see prepareEncrypt().
+        //! @param [in,out] context Context of the calling thread.
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt. Null pointers are ignored.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //! In case of error, no packet is modified.
+        //! @see canShareKeys()
+        //!
+        bool encrypt(Context& context, TSPacket* const pkts[], size_t count) const;
+
+        //!
+        //! Decrypt several TS packets with the CW corresponding to the parity in each packet, using a caller-provided context.
+        //! This instance is not modified. Several threads can concurrently use this method, each with its own context.
+        //! Fixed control words are not switched on parity changes, the current CW of each parity is used.
+        //! @param [in,out] context Context of the calling thread.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt. Null pointers are ignored.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. A clear packet is not an error.
+        //! @see canShareKeys()
+        //!
+        bool decrypt(Context& context, TSPacket* const pkts[], size_t count) const;
+
     private:
         // List of control words
         using CWList = std::list<ByteBlock>;
@@ -204,16 +308,55 @@ namespace ts {
         CWList::iterator _next_cw {};
         uint8_t          _encrypt_scv = SC_CLEAR;  // Encryption: key to use (SC_EVEN_KEY or SC_ODD_KEY).
         uint8_t          _decrypt_scv = SC_CLEAR;  // Decryption: previous scrambling_control value.
-        DVBCSA2          _dvbcsa[2] {};            // Index 0 = even key, 1 = odd key.
-        DVBCISSA         _dvbcissa[2] {};
-        IDSA             _idsa[2] {};
-        CBC<AES128>      _aescbc[2] {};
-        CTR<AES128>      _aesctr[2] {};
-        BlockCipher*     _scrambler[2] {nullptr, nullptr};
+        DVBCSA2          _dvbcsa[4] {};            // Index 0 = even key, 1 = odd key, 2 and 3 = standby even and odd.
+        DVBCISSA         _dvbcissa[4] {};
+        IDSA             _idsa[4] {};
+        CBC<AES128>      _aescbc[4] {};
+        CTR<AES128>      _aesctr[4] {};
+        SCTE52_2008      _scte52[4] {};
+        BlockCipher*     _scrambler[2] {nullptr, nullptr};  // Active engines, even and odd.
+        BlockCipher*     _standby[2] {nullptr, nullptr};    // Standby engines with prepared keys, even and odd.
+        std::mutex       _standby_mutex {};                 // Protect the standby engines.
+        Context          _batch {};                         // Context of non-const multi-packet operations.
 
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
 
+        // Select the active and standby engines from an array of 4 engines, see _dvbcsa.
+        template <class CIPHER>
+        static void SelectEngines(BlockCipher* engines[4], CIPHER algos[4])
+        {
+            for (size_t i = 0; i < 4; ++i) {
+                engines[i] = &algos[i];
+            }
+        }
+        void setEngines(BlockCipher* const engines[4]);
+
+        // Check if an engine has a prepared key which was never used.
+        static bool IsPrepared(const BlockCipher* algo, const ByteBlock& cw);
+
+        // Copy the configuration parameters of the ciphers (IV, etc.) from another instance.
+        void copyParameters(const TSScrambling& other);
+
+        // Size of the payload to process in a packet, without residue if the algorithm does not process it.
+        static size_t ScrambledSize(const TSPacket& pkt, const BlockCipher* algo);
+
+        // Select the decryption key for a scrambling control value.
+        bool setDecryptParity(uint8_t scv);
+
+        // Collect the packets to encrypt in a context. Return false on already scrambled packet.
+        bool collectEncrypt(Context& context, TSPacket* const pkts[], size_t count, const BlockCipher* algo) const;
+
+        // Collect in a context the next packets with the same parity, starting at index.
+        // Return the parity or SC_CLEAR when there is no more packet to decrypt.
+        static uint8_t NextDecryptBatch(Context& context, TSPacket* const pkts[], size_t count, size_t& index);
+
+        // Collect the payloads of the packets in a context.
+        static void CollectPayloads(Context& context, const BlockCipher* algo);
+
+        // Update the packets in a context after encryption or decryption.
+        bool endBatch(Context& context, bool success, bool encrypt, uint8_t scv, const BlockCipher* algo) const;
+
         // Implementation of BlockCipherAlertInterface.
         virtual bool handleBlockCipherAlert(BlockCipher& cipher, AlertReason reason) override;
 
@@ -0,0 +1,151 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSScramblingPool.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::TSScramblingPool::TSScramblingPool(Report& report) :
+    _report(report)
+{
+}
+
+ts::TSScramblingPool::~TSScramblingPool()
+{
+    stop();
+}
+
+ts::TSScramblingPool::Worker::~Worker()
+{
+    terminate();
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start / stop the threads of the pool.
+//----------------------------------------------------------------------------
+
+bool ts::TSScramblingPool::start(size_t threads)
+{
+    stop();
+    for (size_t i = 0; i < threads; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+        if (!_workers.back()->start()) {
+            _report.error(u"error starting scrambling thread");
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ts::TSScramblingPool::stop()
+{
+    // The destructor of each worker terminates its thread.
+    _workers.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSScramblingPool::encrypt(TSScrambling& master, TSPacket* const pkts[], size_t count)
+{
+    // The workers need the current key of the master.
+    return master.prepareEncrypt() && process(true, master, pkts, count);
+}
+
+bool ts::TSScramblingPool::decrypt(TSScrambling& master, TSPacket* const pkts[], size_t count)
+{
+    // With fixed control words, the key of a packet depends on the sequence of parity changes.
+    return master.hasFixedCW() ? master.decrypt(pkts, count) : process(false, master, pkts, count);
+}
+
+bool ts::TSScramblingPool::process(bool encrypt, TSScrambling& master, TSPacket* const pkts[], size_t count)
+{
+    // Number of chunks, including the one for the calling thread.
+    const size_t chunks = std::min(_workers.size() + 1, std::max<size_t>(1, count / MIN_PACKETS_PER_THREAD));
+    if (chunks <= 1 || !master.canShareKeys()) {
+        return encrypt ? master.encrypt(pkts, count) : master.decrypt(pkts, count);
+    }
+
+    // Submit all chunks but the first one to the workers. They share the keys of the master.
+    // The master is not modified until all workers complete.
+    const size_t chunk_size = (count + chunks - 1) / chunks;
+    size_t submitted = 0;
+    for (size_t i = 1; i < chunks && i * chunk_size < count; ++i) {
+        _workers[i - 1]->submit(encrypt, &master, pkts + i * chunk_size, std::min(chunk_size, count - i * chunk_size));
+        submitted++;
+    }
+
+    // Process the first chunk in the calling thread.
+    bool success = encrypt ? master.encrypt(_context, pkts, chunk_size) : master.decrypt(_context, pkts, chunk_size);
+
+    // Wait for all workers.
+    for (size_t i = 0; i < submitted; ++i) {
+        success = _workers[i]->wait() && success;
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Worker thread.
+//----------------------------------------------------------------------------
+
+void ts::TSScramblingPool::Worker::submit(bool encrypt, const TSScrambling* master, TSPacket* const pkts[], size_t count)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _encrypt = encrypt;
+    _master = master;
+    _pkts = pkts;
+    _count = count;
+    _busy = true;
+    _work_to_do.notify_one();
+}
+
+bool ts::TSScramblingPool::Worker::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _work_done.wait(lock, [this]() { return !_busy; });
+    return _success;
+}
+
+void ts::TSScramblingPool::Worker::terminate()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _terminate = true;
+    _work_to_do.notify_one();
+}
+
+void ts::TSScramblingPool::Worker::main()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _work_to_do.wait(lock, [this]() { return _busy || _terminate; });
+        if (_terminate) {
+            break;
+        }
+        // Process the packets without holding the mutex.
+        const TSScrambling* master = _master;
+        TSPacket* const* pkts = _pkts;
+        const size_t count = _count;
+        const bool encrypt = _encrypt;
+        lock.unlock();
+        const bool success = encrypt ? master->encrypt(_context, pkts, count) : master->decrypt(_context, pkts, count);
+        lock.lock();
+        _success = success;
+        _busy = false;
+        _work_done.notify_one();
+    }
+}
@@ -0,0 +1,146 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Pool of threads for transport stream scrambling.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSScrambling.h"
+#include "tsThread.h"
+
+namespace ts {
+    //!
+    //! Pool of threads for transport stream scrambling.
+    //! @ingroup libtsduck mpeg
+    //!
+    //! "Master" TSScrambling instances are owned by the application. They manage the control
+    //! words, their parity and the crypto-periods. There can be several master instances, for
+    //! instance one per ECM stream in a descrambler. When a large group of packets shall be
+    //! scrambled or descrambled with a master instance, the packets are split into contiguous
+    //! chunks which are processed in parallel, one by the calling thread and the others by the
+    //! threads of the pool. All threads share the keyed cipher engines of the master instance,
+    //! each thread with its own TSScrambling::Context. The keys are never copied and no thread
+    //! recomputes a key schedule when the control words change. When the scrambling algorithm
+    //! cannot share its keys, all packets are processed by the calling thread.
+    //!
+    //! The packets are processed in place. They are never reordered. When a method returns,
+    //! all packets have been processed.
+    //!
+    //! The control words must not change while a group of packets is processed. If the
+    //! application changes the control words in the middle of a group of packets, it shall
+    //! process the group in several calls, one per crypto-period.
+    //!
+    class TSDUCKDLL TSScramblingPool
+    {
+        TS_NOBUILD_NOCOPY(TSScramblingPool);
+    public:
+        //!
+        //! Minimum number of packets per thread. Smaller groups of packets use less threads.
+        //!
+        static constexpr size_t MIN_PACKETS_PER_THREAD = 32;
+
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report error and information.
+        //!
+        TSScramblingPool(Report& report);
+
+        //!
+        //! Destructor.
+        //! The threads are terminated.
+        //!
+        ~TSScramblingPool();
+
+        //!
+        //! Start the threads of the pool.
+        //! @param [in] threads Number of threads in the pool, in addition to the calling thread.
+        //! When zero, all packets are processed by the calling thread.
+        //! @return True on success, false on error.
+        //!
+        bool start(size_t threads);
+
+        //!
+        //! Terminate all threads of the pool.
+        //!
+        void stop();
+
+        //!
+        //! Get the number of threads in the pool.
+        //! @return The number of threads in the pool, in addition to the calling thread.
+        //!
+        size_t threadCount() const { return _workers.size(); }
+
+        //!
+        //! Encrypt TS packets with the current parity and corresponding CW of a master instance.
+        //! @param [in,out] master The master scrambling instance.
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt. Null pointers are ignored.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //! @see TSScrambling::encrypt(TSPacket* const[], size_t)
+        //!
+        bool encrypt(TSScrambling& master, TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Decrypt TS packets with the CW of a master instance corresponding to the parity in each packet.
+        //! When the master instance uses a list of fixed control words, the next CW is used at each change
+        //! of parity. In that case, the packets are sequentially decrypted by the master instance, in the
+        //! calling thread, because the key of a packet depends on all previous packets.
+        //! @param [in,out] master The master scrambling instance.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt. Null pointers are ignored.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. Clear packets are not an error.
+        //! @see TSScrambling::decrypt(TSPacket* const[], size_t)
+        //!
+        bool decrypt(TSScrambling& master, TSPacket* const pkts[], size_t count);
+
+    private:
+        // One thread of the pool.
+        class Worker : public Thread
+        {
+            TS_NOCOPY(Worker);
+        public:
+            // Constructor and destructor.
+            Worker() = default;
+            virtual ~Worker() override;
+
+            // Submit a group of packets to encrypt or decrypt with the keys of a master instance.
+            void submit(bool encrypt, const TSScrambling* master, TSPacket* const pkts[], size_t count);
+
+            // Wait for completion of the previous submission.
+            bool wait();
+
+            // Request the thread to terminate.
+            void terminate();
+
+        private:
+            std::mutex              _mutex {};
+            std::condition_variable _work_to_do {};
+            std::condition_variable _work_done {};
+            TSScrambling::Context   _context {};  // Used by the thread only.
+            const TSScrambling*     _master = nullptr;
+            TSPacket* const*        _pkts = nullptr;
+            size_t                  _count = 0;
+            bool                    _encrypt = true;
+            bool                    _busy = false;
+            bool                    _success = true;
+            bool                    _terminate = false;
+
+            // Implementation of Thread.
+            virtual void main() override;
+        };
+
+        Report& _report;
+        TSScrambling::Context _context {};  // Context of the calling thread.
+        std::vector<std::unique_ptr<Worker>> _workers {};
+
+        // Common code for encrypt and decrypt.
+        bool process(bool encrypt, TSScrambling& master, TSPacket* const pkts[], size_t count);
+    };
+}
@@ -106,6 +106,7 @@ namespace ts {
         SCRAMBLING_USER_MIN      = 0x80, //!< First user-defined value.
         SCRAMBLING_DUCK_AES_CBC  = 0xF0, //!< TSDuck-defined value, AES-128-CBC (with externally-defined IV).
         SCRAMBLING_DUCK_AES_CTR  = 0xF1, //!< TSDuck-defined value, AES-128-CTR (with externally-defined IV).
+        SCRAMBLING_DUCK_SCTE52   = 0xF2, //!< TSDuck-defined value, ANSI/SCTE 52 2008, DES-CBC (with externally-defined IV).
         SCRAMBLING_USER_MAX      = 0xFE, //!< Last user-defined value.
         SCRAMBLING_RESERVED      = 0xFF, //!< Reserved value.
     };
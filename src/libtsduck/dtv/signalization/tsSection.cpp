@@ -342,7 +342,8 @@ ts::ByteBlock ts::Section::hash() const
 {
     ByteBlock result;
     if (isValid()) {
-        SHA1 algo;
+        // One hash context per thread, reused for all sections, instead of one new context per section.
+        thread_local SHA1 algo;
         algo.hash(content(), size(), result);
     }
     return result;
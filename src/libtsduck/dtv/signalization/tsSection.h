@@ -381,6 +381,7 @@ namespace ts {
 
         //!
         //! Get a hash of the section content.
+        //! The hash context is allocated once per thread and reused for all sections.
         //! @return SHA-1 value of the section content.
         //!
         ByteBlock hash() const;
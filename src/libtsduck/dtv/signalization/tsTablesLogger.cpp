@@ -165,7 +165,8 @@ void ts::TablesLogger::defineArgs(Args& args)
     args.option(u"no-deep-duplicate");
     args.help(u"no-deep-duplicate",
               u"Do not report identical sections in the same PID, even when non-consecutive. "
-              u"A hash of each section is kept for each PID and later identical sections are not reported.\n"
+              u"A hash of each section is kept for each PID and later identical sections are not reported. "
+              u"A table with long sections is not reported when all its sections were already reported.\n"
               u"Warning: This option accumulates memory for hash values of all sections since the beginning. "
               u"Do not use that option for commands running too long or the process may crash with insufficient memory.");
 
@@ -517,14 +518,75 @@ void ts::TablesLogger::feedPacket(const TSPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Detect and track duplicate tables by PID.
+//----------------------------------------------------------------------------
+
+bool ts::TablesLogger::isDuplicate(const BinaryTable& table)
+{
+    // Tables with a short section are checked for consecutive and deep duplicates.
+    // Tables with long sections are checked for deep duplicates only.
+    const bool short_section = table.isShortSection();
+    if (!_no_deep_duplicate && !(_no_duplicate && short_section)) {
+        return false;
+    }
+
+    // Get a SHA-1 for all sections of the table in one operation.
+    const size_t count = table.sectionCount();
+    const size_t hsize = _sha1.hashSize();
+    _hash_messages.resize(count);
+    _hash_sizes.resize(count);
+    _hashes.resize(count * hsize);
+    for (size_t i = 0; i < count; ++i) {
+        const SectionPtr section(table.sectionAt(i));
+        if (section == nullptr || !section->isValid()) {
+            return false;
+        }
+        _hash_messages[i] = section->content();
+        _hash_sizes[i] = section->size();
+    }
+    if (!_sha1.hashMessages(_hash_messages.data(), _hash_sizes.data(), count, _hashes.data(), _hashes.size())) {
+        return false;
+    }
+
+    const PID pid = table.sourcePID();
+    if (short_section) {
+        const ByteBlock hash(_hashes.data(), hsize);
+        return (_no_duplicate && isSameAsLast(pid, hash, &TablesLogger::_short_sections)) || (_no_deep_duplicate && isDeepDuplicate(pid, hash));
+    }
+    else {
+        // The table is a deep duplicate when all its sections were already found on that PID.
+        bool duplicate = true;
+        for (size_t i = 0; i < count; ++i) {
+            duplicate = isDeepDuplicate(pid, ByteBlock(_hashes.data() + i * hsize, hsize)) && duplicate;
+        }
+        return duplicate;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Detect and track duplicate section by PID.
 //----------------------------------------------------------------------------
 
 bool ts::TablesLogger::isDuplicate(PID pid, const Section& section, std::map<PID,ByteBlock> TablesLogger::* tracker)
 {
-    // Get a SHA-1 for the section.
+    if (!_no_duplicate && !_no_deep_duplicate) {
+        return false;
+    }
+
+    // Get a SHA-1 for the section, used by the two checks.
     const ByteBlock hash(section.hash());
+    return (_no_duplicate && isSameAsLast(pid, hash, tracker)) || (_no_deep_duplicate && isDeepDuplicate(pid, hash));
+}
+
+
+//----------------------------------------------------------------------------
+// Detect and track consecutive duplicate sections by PID.
+//----------------------------------------------------------------------------
+
+bool ts::TablesLogger::isSameAsLast(PID pid, const ByteBlock& hash, std::map<PID,ByteBlock> TablesLogger::* tracker)
+{
     ByteBlock& last((this->*tracker)[pid]);
     if (last.empty() || last != hash) {
         // Not the same section, keep the hash for next time.
@@ -542,10 +604,8 @@ bool ts::TablesLogger::isDuplicate(PID pid, const Section& section, std::map<PID
 // Detect and track deep duplicate sections by PID.
 //----------------------------------------------------------------------------
 
-bool ts::TablesLogger::isDeepDuplicate(PID pid, const Section& section)
+bool ts::TablesLogger::isDeepDuplicate(PID pid, const ByteBlock& hash)
 {
-    // Get a SHA-1 for the section.
-    const ByteBlock hash(section.hash());
     auto& set(_deep_hashes[pid]);
     if (set.find(hash) == set.end()) {
         // Section not yet found on that PID, keep the hash for next time.
@@ -586,16 +646,9 @@ void ts::TablesLogger::handleTable(SectionDemux& demux, const BinaryTable& table
         return;
     }
 
-    // Ignore duplicate tables with a short section.
-    if (table.isShortSection()) {
-        if (_no_duplicate && isDuplicate(pid, *table.sectionAt(0), &TablesLogger::_short_sections)) {
-            // Same section as previously, ignore it.
-            return;
-        }
-        if (_no_deep_duplicate && isDeepDuplicate(pid, *table.sectionAt(0))) {
-            // Section alread seen on that PID, ignore it.
-            return;
-        }
+    // Ignore duplicate tables with a short section and tables with all sections already seen on that PID.
+    if (isDuplicate(table)) {
+        return;
     }
 
     // Filtering done, now save table in various formats.
@@ -756,12 +809,8 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& section
     }
 
     // Ignore duplicate sections.
-    if (_no_duplicate && isDuplicate(pid, section, &TablesLogger::_last_sections)) {
-        // Same section (same hash) as previously, ignore it.
-        return;
-    }
-    if (_no_deep_duplicate && isDeepDuplicate(pid, section)) {
-        // Section alread seen on that PID, ignore it.
+    if (isDuplicate(pid, section, &TablesLogger::_last_sections)) {
+        // Same section (same hash) as previously or already seen on that PID, ignore it.
         return;
     }
 
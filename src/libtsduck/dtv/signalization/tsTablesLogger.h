@@ -25,6 +25,7 @@
 #include "tsxmlJSONConverter.h"
 #include "tsjsonRunningDocument.h"
 #include "tsDuckProtocol.h"
+#include "tsSHA1.h"
 
 namespace ts {
     //!
@@ -222,6 +223,10 @@ namespace ts {
         std::map<PID,ByteBlock>  _short_sections {};         // Tracking duplicate short sections by PID with a section hash.
         std::map<PID,ByteBlock>  _last_sections {};          // Tracking duplicate sections by PID with a section hash (with --all-sections).
         std::map<PID,std::set<ByteBlock>> _deep_hashes {};   // Tracking of deep duplicate sections.
+        SHA1                     _sha1 {};                   // Hash of all sections of a table.
+        std::vector<const void*> _hash_messages {};          // Addresses of the sections of the table to hash.
+        std::vector<size_t>      _hash_sizes {};             // Sizes of the sections of the table to hash.
+        ByteBlock                _hashes {};                 // Hash values of all sections of the table.
         std::set<uint64_t>       _sections_once {};          // Tracking sets of PID/TID/TDIext/secnum/version with --all-once.
         TablesLoggerFilterVector _section_filters {};        // All registered section filters.
         duck::Protocol           _duck_protocol {};          // To generate UDP messages.
@@ -257,9 +262,13 @@ namespace ts {
         void logSection(const Section&);
         void logInvalid(const DemuxedData&, const UString&);
 
-        // Detect and track duplicate section by PID.
+        // Detect and track duplicate tables and sections by PID.
+        // Each section is hashed only once, when at least one of the two checks is enabled.
+        // All sections of a table are hashed in one operation.
+        bool isDuplicate(const BinaryTable& table);
         bool isDuplicate(PID pid, const Section& section, std::map<PID,ByteBlock> TablesLogger::* tracker);
-        bool isDeepDuplicate(PID pid, const Section& section);
+        bool isSameAsLast(PID pid, const ByteBlock& hash, std::map<PID,ByteBlock> TablesLogger::* tracker);
+        bool isDeepDuplicate(PID pid, const ByteBlock& hash);
     };
 
     //!
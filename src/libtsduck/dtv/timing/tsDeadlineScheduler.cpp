@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsDeadlineScheduler.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and reset.
+//----------------------------------------------------------------------------
+
+ts::DeadlineScheduler::DeadlineScheduler(size_t count) :
+    _inputs(count)
+{
+}
+
+void ts::DeadlineScheduler::reset(size_t count)
+{
+    _inputs.clear();
+    _inputs.resize(count);
+    _selected = NPOS;
+    _selected_pcr = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Set the estimated bitrate of an input stream.
+//----------------------------------------------------------------------------
+
+void ts::DeadlineScheduler::setBitRate(size_t index, const BitRate& bitrate)
+{
+    if (index < _inputs.size()) {
+        _inputs[index].bitrate = bitrate;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Select the input for the next output packet.
+//----------------------------------------------------------------------------
+
+void ts::DeadlineScheduler::startSelection()
+{
+    _selected = NPOS;
+    _selected_pcr = false;
+}
+
+void ts::DeadlineScheduler::addCandidate(size_t index, bool has_pcr)
+{
+    if (index < _inputs.size() &&
+        (_selected == NPOS ||
+         (has_pcr && !_selected_pcr) ||
+         (has_pcr == _selected_pcr && _inputs[index].deadline < _inputs[_selected].deadline)))
+    {
+        _selected = index;
+        _selected_pcr = has_pcr;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Declare that a packet from an input stream was inserted.
+//----------------------------------------------------------------------------
+
+void ts::DeadlineScheduler::packetInserted(size_t index, PacketCounter packet, const BitRate& ts_bitrate)
+{
+    if (index < _inputs.size()) {
+        Input& in(_inputs[index]);
+        // An input which was idle for a while does not get an advance over the other inputs.
+        in.deadline = std::max(in.deadline, double(packet));
+        if (in.bitrate > 0 && ts_bitrate > 0) {
+            in.deadline += (ts_bitrate / in.bitrate).toDouble();
+        }
+        else {
+            // Unknown bitrate, assume an equal share of the output.
+            in.deadline += double(_inputs.size());
+        }
+    }
+}
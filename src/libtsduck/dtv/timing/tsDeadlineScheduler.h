@@ -0,0 +1,108 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Earliest deadline first scheduler of input streams in a multiplexer.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Earliest deadline first scheduler of input streams in a multiplexer.
+    //! @ingroup libtsduck mpeg
+    //!
+    //! Each input stream has a deadline, expressed as an index of packet in the output stream,
+    //! before which its next packet should be inserted. Each time a packet of an input is inserted,
+    //! the deadline of this input advances by the ratio between the output bitrate and the bitrate
+    //! of the input, like a virtual clock. When the bitrate of an input is not yet known, its
+    //! deadline advances by the number of inputs, as if all inputs equally shared the output.
+    //!
+    //! For each output packet, the application declares the inputs which have a packet ready to
+    //! be inserted, using addCandidate(). The scheduler selects, by order of priority:
+    //! - a packet containing a PCR, to minimize the jitter,
+    //! - the input with the earliest deadline, meaning the most late input according to its bitrate,
+    //! - the first declared candidate, among inputs with equal deadlines.
+    //!
+    class TSDUCKDLL DeadlineScheduler
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] count Number of input streams.
+        //!
+        DeadlineScheduler(size_t count = 0);
+
+        //!
+        //! Reset the scheduler.
+        //! @param [in] count Number of input streams.
+        //!
+        void reset(size_t count);
+
+        //!
+        //! Get the number of input streams.
+        //! @return The number of input streams.
+        //!
+        size_t count() const { return _inputs.size(); }
+
+        //!
+        //! Set the estimated bitrate of an input stream.
+        //! @param [in] index Index of the input stream.
+        //! @param [in] bitrate Estimated bitrate of the input stream, zero if unknown.
+        //!
+        void setBitRate(size_t index, const BitRate& bitrate);
+
+        //!
+        //! Get the deadline of an input stream.
+        //! @param [in] index Index of the input stream.
+        //! @return Index of the output packet before which the next packet of the input should be inserted.
+        //!
+        double deadline(size_t index) const { return index < _inputs.size() ? _inputs[index].deadline : 0.0; }
+
+        //!
+        //! Start the selection of the input for the next output packet.
+        //!
+        void startSelection();
+
+        //!
+        //! Declare an input stream which has a packet ready to be inserted.
+        //! @param [in] index Index of the input stream.
+        //! @param [in] has_pcr True if the next packet of the input contains a PCR.
+        //!
+        void addCandidate(size_t index, bool has_pcr);
+
+        //!
+        //! Get the selected input stream.
+        //! @return Index of the selected input stream among the candidates or NPOS if there is no candidate.
+        //!
+        size_t selected() const { return _selected; }
+
+        //!
+        //! Declare that a packet from an input stream was inserted in the output stream.
+        //! @param [in] index Index of the input stream.
+        //! @param [in] packet Index of the packet in the output stream.
+        //! @param [in] ts_bitrate Bitrate of the output stream.
+        //!
+        void packetInserted(size_t index, PacketCounter packet, const BitRate& ts_bitrate);
+
+    private:
+        // Description of an input stream.
+        class Input
+        {
+        public:
+            BitRate bitrate = 0;   // Estimated bitrate of the input, zero if unknown.
+            double  deadline = 0;  // Output packet index before which the next packet should be inserted.
+        };
+
+        std::vector<Input> _inputs {};
+        size_t _selected = NPOS;       // Currently selected input.
+        bool   _selected_pcr = false;  // The next packet of the selected input contains a PCR.
+    };
+}
@@ -17,7 +17,8 @@
 
 ts::PCRAnalyzer::PCRAnalyzer(size_t min_pid, size_t min_pcr) :
     _min_pid(std::max<size_t>(1, min_pid)),
-    _min_pcr(std::max<size_t>(1, min_pcr))
+    _min_pcr(std::max<size_t>(1, min_pcr)),
+    _inst_windows(cn::seconds(1), FOOLPROOF_MAP_LIMIT, PCR(PCR_SCALE))
 {
     TS_ZERO(_pid);
 }
@@ -76,6 +77,8 @@ void ts::PCRAnalyzer::reset()
     _pcr_pids = 0;
     _inst_ts_bitrate_188 = 0;
     _inst_ts_bitrate_204 = 0;
+    _last_pcr_value = INVALID_PCR;
+    _last_pcr_packet = 0;
 
     for (size_t i = 0; i < PID_MAX; ++i) {
         if (_pid[i] != nullptr) {
@@ -84,7 +87,7 @@ void ts::PCRAnalyzer::reset()
         }
     }
 
-    _packet_pcr_index_map.clear();
+    _inst_windows.reset();
 }
 
 
@@ -109,6 +112,12 @@ void ts::PCRAnalyzer::setIgnoreErrors(bool ignore)
     _ignore_errors = ignore;
 }
 
+void ts::PCRAnalyzer::setTimingAnalysis(bool on)
+{
+    reset();
+    _timing = on;
+}
+
 
 //----------------------------------------------------------------------------
 // Process a discontinuity in the transport stream
@@ -122,9 +131,11 @@ void ts::PCRAnalyzer::processDiscontinuity()
     for (size_t i = 0; i < PID_MAX; ++i) {
         if (_pid[i] != nullptr) {
             _pid[i]->last_pcr_value = INVALID_PCR;
+            _pid[i]->last_pcr_timestamp = INVALID_PCR;
         }
     }
-    _packet_pcr_index_map.clear();
+    _inst_windows.reset();
+    _last_pcr_value = INVALID_PCR;
 }
 
 
@@ -200,12 +211,98 @@ void ts::PCRAnalyzer::getStatus(Status& stat) const
 }
 
 
+//----------------------------------------------------------------------------
+// Get the timing distributions of a PID.
+//----------------------------------------------------------------------------
+
+const ts::PCRAnalyzer::PIDTiming* ts::PCRAnalyzer::pidTiming(PID pid) const
+{
+    return pid >= PID_MAX || _pid[pid] == nullptr ? nullptr : _pid[pid]->timing.get();
+}
+
+
+//----------------------------------------------------------------------------
+// Display a report of all timing distributions.
+//----------------------------------------------------------------------------
+
+void ts::PCRAnalyzer::reportTiming(std::ostream& strm, const UString& margin) const
+{
+    // Values are displayed in micro-seconds.
+    constexpr int64_t divisor = SYSTEM_CLOCK_FREQ / 1'000'000;
+
+    const auto line = [&strm, &margin](PID pid, const UChar* name, const LogHistogram& hist) {
+        if (hist.count() > 0) {
+            strm << margin << UString::Format(u"PID %n, %s (us): %s", pid, name, hist.summary(divisor)) << std::endl;
+        }
+    };
+
+    for (PID pid = 0; pid < PID_MAX; ++pid) {
+        const PIDTiming* tm = pidTiming(pid);
+        if (tm != nullptr) {
+            line(pid, _use_dts ? u"DTS accuracy" : u"PCR accuracy", tm->pcr_accuracy);
+            line(pid, _use_dts ? u"DTS interval" : u"PCR interval", tm->pcr_interval);
+            line(pid, _use_dts ? u"DTS arrival jitter" : u"PCR arrival jitter", tm->pcr_arrival);
+            line(pid, u"PTS-PCR offset", tm->pts_offset);
+            line(pid, u"DTS-PCR offset", tm->dts_offset);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the current estimated PCR in the transport stream.
+//----------------------------------------------------------------------------
+
+uint64_t ts::PCRAnalyzer::currentPCR() const
+{
+    if (_last_pcr_value == INVALID_PCR || _ts_bitrate_cnt == 0) {
+        return _last_pcr_value;
+    }
+    else {
+        // Extrapolate the last PCR using the average bitrate.
+        const BitRate bits = BitRate((_ts_pkt_cnt - _last_pcr_packet) * PKT_SIZE_BITS * SYSTEM_CLOCK_FREQ);
+        const BitRate rate = bitrate188();
+        return rate == 0 ? _last_pcr_value : (_last_pcr_value + uint64_t((bits / rate).toInt())) % PCR_SCALE;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Feed PTS and DTS offsets from a packet, relative to the current PCR.
+//----------------------------------------------------------------------------
+
+void ts::PCRAnalyzer::feedTimestampOffsets(const TSPacket& pkt, PID pid)
+{
+    const bool has_pts = pkt.hasPTS();
+    const bool has_dts = pkt.hasDTS();
+    const uint64_t pcr = _use_dts || (!has_pts && !has_dts) ? INVALID_PCR : currentPCR();
+
+    if (pcr != INVALID_PCR) {
+        PIDAnalysis* ps = _pid[pid];
+        if (ps->timing == nullptr) {
+            ps->timing = std::make_unique<PIDTiming>();
+        }
+        // Signed difference between a PTS or DTS and the PCR, modulo PCR_SCALE.
+        const auto offset = [pcr](uint64_t pts) {
+            const int64_t diff = int64_t((pts * SYSTEM_CLOCK_SUBFACTOR + PCR_SCALE - pcr) % PCR_SCALE);
+            return diff >= int64_t(PCR_SCALE / 2) ? diff - int64_t(PCR_SCALE) : diff;
+        };
+        if (has_pts) {
+            ps->timing->pts_offset.feed(offset(pkt.getPTS()));
+        }
+        if (has_dts) {
+            ps->timing->dts_offset.feed(offset(pkt.getDTS()));
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Feed the PCR analyzer with a new transport packet.
 // Return true if we have collected enough packet to evaluate TS bitrate.
 //----------------------------------------------------------------------------
 
-bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
+bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt, const TSPacketMetadata* mdata)
 {
     // Count one more packet in the TS
     _ts_pkt_cnt++;
@@ -272,11 +369,16 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
         // Get PCR value (or DTS)
         const uint64_t pcr_dts = _use_dts ? pkt.getDTS() : pkt.getPCR();
 
+        // Input timestamp of the packet, if any.
+        const bool has_timestamp = mdata != nullptr && mdata->hasInputTimeStamp();
+        const uint64_t timestamp = has_timestamp ? uint64_t(mdata->getInputTimeStamp().count()) : INVALID_PCR;
+        const TimeSource timesource = has_timestamp ? mdata->getInputTimeSource() : TimeSource::UNDEFINED;
+
         // If last PCR/DTS valid, compute transport rate between the two
         if (ps->last_pcr_value != INVALID_PCR && ps->last_pcr_value != pcr_dts) {
 
             // Compute transport rate in b/s since last PCR/DTS
-            uint64_t diff_values = _use_dts ?
+            const uint64_t diff_values = _use_dts ?
                 DiffPTS(ps->last_pcr_value, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
                 DiffPCR(ps->last_pcr_value, pcr_dts);
 
@@ -285,21 +387,21 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             BitRate ts_bitrate_204 = diff_values == 0 ? 0 :
                 BitRate((_ts_pkt_cnt - ps->last_pcr_packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
 
-            // Clear out values older than 1 second from _packet_pcr_index_map.
-            // Note that this is a map that covers PCR/DTS packets across all PIDs
-            // as long as the clocks used to generate the PCR/DTS values for different
-            // programs is the same clock, there should be no issue, but if the PCR/DTS values
-            // across the two programs are wildly different, then the following approach won't work.
-            while (!_packet_pcr_index_map.empty()) {
-                const uint64_t earliestPCR_DTS = _packet_pcr_index_map.begin()->first;
-                diff_values = _use_dts ?
-                    DiffPTS(earliestPCR_DTS, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(earliestPCR_DTS, pcr_dts);
-                if (diff_values > SYSTEM_CLOCK_FREQ) {
-                    _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
+            // Timing distributions, before updating the average bitrate with the current PCR.
+            if (_timing) {
+                if (ps->timing == nullptr) {
+                    ps->timing = std::make_unique<PIDTiming>();
+                }
+                ps->timing->pcr_interval.feed(int64_t(diff_values));
+                const BitRate avg_bitrate = bitrate188();
+                if (avg_bitrate > 0) {
+                    // Expected PCR interval from the average bitrate.
+                    const int64_t expected = (BitRate((_ts_pkt_cnt - ps->last_pcr_packet) * PKT_SIZE_BITS * SYSTEM_CLOCK_FREQ) / avg_bitrate).toInt();
+                    ps->timing->pcr_accuracy.feed(int64_t(diff_values) - expected);
                 }
-                else {
-                    break;
+                if (has_timestamp && ps->last_pcr_timestamp != INVALID_PCR && ps->last_pcr_timesource == timesource && timestamp >= ps->last_pcr_timestamp) {
+                    // Jitter = difference between actual arrival duration and PCR duration.
+                    ps->timing->pcr_arrival.feed(int64_t(timestamp - ps->last_pcr_timestamp) - int64_t(diff_values));
                 }
             }
 
@@ -317,18 +419,6 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             _ts_bitrate_204 += ts_bitrate_204;
             _ts_bitrate_cnt++;
 
-            // Transport stream instantaneous statistics.
-            // For instantaneous bit rates, these are the actual bit rates, and it doesn't use the "count" approach.
-            if (!_packet_pcr_index_map.empty()) {
-                diff_values = _use_dts ?
-                    DiffPTS(_packet_pcr_index_map.begin()->first, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(_packet_pcr_index_map.begin()->first, pcr_dts);
-                _inst_ts_bitrate_188 = diff_values == 0 ? 0 :
-                    BitRate((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / diff_values;
-                _inst_ts_bitrate_204 = diff_values == 0 ? 0 :
-                    BitRate((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
-            }
-
             // Check if we got enough values for this PID
             if (ps->ts_bitrate_cnt == _min_pcr) {
                 _completed_pids++;
@@ -340,17 +430,33 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
         if (ps->last_pcr_value != pcr_dts) {
             ps->last_pcr_value = pcr_dts;
             ps->last_pcr_packet = _ts_pkt_cnt;
+            ps->last_pcr_timestamp = timestamp;
+            ps->last_pcr_timesource = timesource;
+            if (!_use_dts) {
+                _last_pcr_value = pcr_dts;
+                _last_pcr_packet = _ts_pkt_cnt;
+            }
 
-            // Also add PCR (or DTS)/packet index combo to map for use in instantaneous bit rate calculations.
-            _packet_pcr_index_map[pcr_dts] = _ts_pkt_cnt;
+            // Also add PCR (or DTS)/packet index in the sliding window of the last second of this PID for
+            // instantaneous bitrate. There is one window per PID because the clocks which are used to generate
+            // the PCR/DTS values of distinct programs may be unrelated. The window is limited in size, a crazy
+            // TS cannot accumulate thousands of PCR values in one second.
+            _inst_windows.feed(pid, PCR(_use_dts ? pcr_dts * SYSTEM_CLOCK_SUBFACTOR : pcr_dts), _ts_pkt_cnt);
 
-            // Make sure that some crazy TS does not accumulate thousands of PCR values in the same second range.
-            while (_packet_pcr_index_map.size() > FOOLPROOF_MAP_LIMIT) {
-                // Erase older entries.
-                _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
+            // Transport stream instantaneous statistics, from the PID which carried the last PCR/DTS.
+            // For instantaneous bit rates, these are the actual bit rates, and it doesn't use the "count" approach.
+            const RollingBitRate<PCR>& inst(_inst_windows.window(pid));
+            if (inst.size() > 1) {
+                _inst_ts_bitrate_188 = inst.bitrate();
+                _inst_ts_bitrate_204 = (_inst_ts_bitrate_188 * PKT_RS_SIZE) / PKT_SIZE;
             }
         }
     }
 
+    // Process PTS and DTS offsets from the current PCR.
+    if (_timing) {
+        feedTimestampOffsets(pkt, pid);
+    }
+
     return _bitrate_valid;
 }
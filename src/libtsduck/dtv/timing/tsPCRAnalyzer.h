@@ -13,7 +13,10 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
 #include "tsStringifyInterface.h"
+#include "tsLogHistogram.h"
+#include "tsRollingBitRate.h"
 
 namespace ts {
     //!
@@ -80,12 +83,32 @@ namespace ts {
         //!
         void setIgnoreErrors(bool ignore);
 
+        //!
+        //! Enable or disable the analysis of timing distributions per PID.
+        //! When enabled, constant-memory histograms are maintained for each PID with
+        //! PCR (or DTS) and for each PID with PTS or DTS. This is disabled by default.
+        //! Changing this setting resets all collected information.
+        //! @param [in] on When true, analyze timing distributions.
+        //! @see PIDTiming
+        //!
+        void setTimingAnalysis(bool on);
+
         //!
         //! The following method feeds the analyzer with a TS packet.
         //! @param [in] pkt A new transport stream packet.
         //! @return True if we have collected enough packet to evaluate TS bitrate.
         //!
-        bool feedPacket(const TSPacket& pkt);
+        bool feedPacket(const TSPacket& pkt) { return feedPacket(pkt, nullptr); }
+
+        //!
+        //! The following method feeds the analyzer with a TS packet and its metadata.
+        //! The input timestamp of the packet, if any, is used to analyze the PCR-to-arrival
+        //! jitter when timing analysis is enabled.
+        //! @param [in] pkt A new transport stream packet.
+        //! @param [in] mdata Metadata of the packet.
+        //! @return True if we have collected enough packet to evaluate TS bitrate.
+        //!
+        bool feedPacket(const TSPacket& pkt, const TSPacketMetadata& mdata) { return feedPacket(pkt, &mdata); }
 
         //!
         //! Check if we have collected enough packet to evaluate TS bitrate.
@@ -121,12 +144,14 @@ namespace ts {
 
         //!
         //! Get the evaluated TS bitrate in bits/second based on 188-byte packets for the last second.
+        //! The last second is measured on the PCR's (or DTS's) of the PID which carried the last PCR.
         //! @return The evaluated TS bitrate in bits/second based on 188-byte packets.
         //!
         BitRate instantaneousBitrate188() const;
 
         //!
         //! Get the evaluated TS bitrate in bits/second based on 204-byte packets for the last second.
+        //! The last second is measured on the PCR's (or DTS's) of the PID which carried the last PCR.
         //! @return The evaluated TS bitrate in bits/second based on 204-byte packets.
         //!
         BitRate instantaneousBitrate204() const;
@@ -174,7 +199,68 @@ namespace ts {
         //!
         void getStatus(Status& status) const;
 
+        //!
+        //! Timing distributions of one PID, when timing analysis is enabled.
+        //! All values are in PCR units (27 MHz). Percentiles are available in each histogram.
+        //! @see setTimingAnalysis()
+        //!
+        struct TSDUCKDLL PIDTiming
+        {
+            //!
+            //! PCR accuracy: difference between each PCR (or DTS) and its expected value,
+            //! based on the previous one and the average TS bitrate.
+            //!
+            LogHistogram pcr_accuracy {};
+            //!
+            //! Interval between two consecutive PCR's (or DTS's) in the PID.
+            //!
+            LogHistogram pcr_interval {};
+            //!
+            //! PCR-to-arrival jitter: difference between the interval of input timestamps
+            //! and the interval of PCR's (or DTS's) for two consecutive PCR's in the PID.
+            //! Only packets with input timestamps from the same source are used.
+            //!
+            LogHistogram pcr_arrival {};
+            //!
+            //! Offset between each PTS in the PID and the current PCR of the transport stream.
+            //! The current PCR is extrapolated from the most recent PCR in any PID, using the TS bitrate.
+            //! This is meaningful on a single-program TS or when all programs share the same clock.
+            //! Not computed when DTS are used instead of PCR.
+            //!
+            LogHistogram pts_offset {};
+            //!
+            //! Offset between each DTS in the PID and the current PCR of the transport stream.
+            //! @see pts_offset
+            //!
+            LogHistogram dts_offset {};
+        };
+
+        //!
+        //! Get the timing distributions of a PID.
+        //! @param [in] pid The PID to get.
+        //! @return A pointer to the timing distributions of @a pid or a null pointer if
+        //! timing analysis is disabled or there is nothing to report for this PID.
+        //!
+        const PIDTiming* pidTiming(PID pid) const;
+
+        //!
+        //! Display a report of all timing distributions, one line per PID and per metric.
+        //! Values are displayed in micro-seconds.
+        //! @param [in,out] strm Output text stream.
+        //! @param [in] margin Left margin string.
+        //!
+        void reportTiming(std::ostream& strm, const UString& margin = UString()) const;
+
     private:
+        // Feed the analyzer with a TS packet and optional metadata.
+        bool feedPacket(const TSPacket& pkt, const TSPacketMetadata* mdata);
+
+        // Feed PTS and DTS offsets from a packet.
+        void feedTimestampOffsets(const TSPacket& pkt, PID pid);
+
+        // Get the current estimated PCR in the transport stream (INVALID_PCR if unknown).
+        uint64_t currentPCR() const;
+
         // Process a discontinuity in the transport stream
         void processDiscontinuity();
 
@@ -188,11 +274,15 @@ namespace ts {
             BitRate  ts_bitrate_188 = 0;   // Sum of all computed TS bitrates (188-byte)
             BitRate  ts_bitrate_204 = 0;   // Sum of all computed TS bitrates (204-byte)
             uint64_t ts_bitrate_cnt = 0;   // Count of computed TS bitrates
+            uint64_t last_pcr_timestamp = INVALID_PCR;  // Input timestamp of packet containing last PCR/DTS
+            TimeSource last_pcr_timesource = TimeSource::UNDEFINED;  // Source of input timestamp
+            std::unique_ptr<PIDTiming> timing {};  // Timing distributions, when enabled
         };
 
         // Private members:
         bool     _use_dts = false;         // Use DTS instead of PCR
         bool     _ignore_errors = false;   // Ignore TS errors such as discontinuities.
+        bool     _timing = false;          // Analyze timing distributions.
         size_t   _min_pid {1};             // Min # of PID
         size_t   _min_pcr {1};             // Min # of PCR per PID
         bool     _bitrate_valid = false;   // Bitrate evaluation is valid
@@ -205,8 +295,10 @@ namespace ts {
         size_t   _completed_pids = 0;      // Number of PIDs with enough PCRs
         size_t   _pcr_pids = 0;            // Number of PIDs with PCRs
         size_t   _discontinuities = 0;     // Number of discontinuities
+        uint64_t _last_pcr_value = INVALID_PCR; // Last PCR value in any PID (for PTS/DTS offsets)
+        uint64_t _last_pcr_packet = 0;     // Packet index containing last PCR in any PID
         PIDAnalysis* _pid[PID_MAX] {};     // Per-PID stats
-        std::map<uint64_t, uint64_t> _packet_pcr_index_map {}; // Map of PCR/DTS to packet index across entire TS
-        static constexpr size_t FOOLPROOF_MAP_LIMIT = 1000;    // Max number of entries in the PCR map
+        PIDRollingBitRate<PCR> _inst_windows;  // Sliding windows of PCR/DTS and TS packet index, per PID with PCR/DTS
+        static constexpr size_t FOOLPROOF_MAP_LIMIT = 1000;    // Max number of entries in a sliding window
     };
 }
@@ -0,0 +1,339 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Rolling bitrate evaluation over a sliding window.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Rolling bitrate evaluation over a sliding window.
+    //! @ingroup libtsduck mpeg
+    //!
+    //! The application periodically feeds samples. Each sample is made of a time
+    //! and cumulative packet counters at that time. The bitrate is computed between
+    //! the oldest and the most recent samples in the sliding window.
+    //!
+    //! The time base is a std::chrono::duration type. It can be a stream clock
+    //! such as PCR (27 MHz) or DTS, possibly wrapping up at some modulo value,
+    //! or a wall clock such as cn::nanoseconds.
+    //!
+    //! The samples are stored in a flat ring buffer which is allocated once,
+    //! when the window is defined. Feeding a sample never allocates memory.
+    //!
+    //! The sliding window is limited in duration, in number of samples, or both.
+    //! When the maximum number of samples is reached, the oldest one is dropped.
+    //!
+    //! Two cumulative packet counters are maintained in each sample: the total
+    //! number of packets and the number of "net" packets, an application-defined
+    //! subset of the packets (typically non-null packets or packets from one PID).
+    //!
+    //! @tparam DURATION A std::chrono::duration type for the time base.
+    //!
+    template <class DURATION>
+    class RollingBitRate
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] window Maximum duration of the sliding window. Zero means unlimited.
+        //! @param [in] max_samples Maximum number of samples in the sliding window, including
+        //! the oldest one which serves as time reference. Must be at least 2.
+        //! @param [in] modulo If non zero, the time base wraps up at this value (e.g. PCR_SCALE
+        //! for PCR values). A time which is less than half the modulo before the previous one
+        //! is considered as a small step backward.
+        //!
+        RollingBitRate(DURATION window = DURATION::zero(), size_t max_samples = 2, DURATION modulo = DURATION::zero());
+
+        //!
+        //! Redefine the sliding window. All samples are dropped.
+        //! @param [in] window Maximum duration of the sliding window. Zero means unlimited.
+        //! @param [in] max_samples Maximum number of samples in the sliding window.
+        //! @param [in] modulo If non zero, the time base wraps up at this value.
+        //!
+        void setWindow(DURATION window, size_t max_samples, DURATION modulo = DURATION::zero());
+
+        //!
+        //! Drop all samples.
+        //!
+        void reset();
+
+        //!
+        //! Feed a new sample, at the end of the sliding window.
+        //! Older samples which are outside the window are dropped.
+        //! @param [in] time Time of the sample.
+        //! @param [in] packets Cumulative number of packets at @a time.
+        //! @param [in] net_packets Cumulative number of "net" packets at @a time.
+        //!
+        void feed(DURATION time, PacketCounter packets, PacketCounter net_packets = 0);
+
+        //!
+        //! Get the number of samples in the sliding window.
+        //! @return The number of samples in the sliding window.
+        //!
+        size_t size() const { return _count; }
+
+        //!
+        //! Check if the sliding window contains the maximum number of samples.
+        //! @return True if the sliding window contains the maximum number of samples.
+        //!
+        bool full() const { return _count == _samples.size(); }
+
+        //!
+        //! Get the duration of the sliding window, from the oldest to the most recent sample.
+        //! @return The duration of the sliding window.
+        //!
+        DURATION duration() const { return _count < 2 ? DURATION::zero() : elapsed(oldest().time, newest().time); }
+
+        //!
+        //! Get the number of packets in the sliding window.
+        //! @return The number of packets between the oldest and the most recent sample.
+        //!
+        PacketCounter packets() const { return _count < 2 ? 0 : newest().packets - oldest().packets; }
+
+        //!
+        //! Get the number of "net" packets in the sliding window.
+        //! @return The number of "net" packets between the oldest and the most recent sample.
+        //!
+        PacketCounter netPackets() const { return _count < 2 ? 0 : newest().net_packets - oldest().net_packets; }
+
+        //!
+        //! Get the bitrate over the sliding window.
+        //! @return The TS bitrate in bits/second based on 188-byte packets, zero if unknown.
+        //!
+        BitRate bitrate() const { return PacketBitRate(packets(), duration()); }
+
+        //!
+        //! Get the "net" bitrate over the sliding window.
+        //! @return The bitrate of "net" packets in bits/second based on 188-byte packets, zero if unknown.
+        //!
+        BitRate netBitRate() const { return PacketBitRate(netPackets(), duration()); }
+
+    private:
+        // Description of a sample.
+        struct Sample
+        {
+            DURATION      time {};
+            PacketCounter packets = 0;
+            PacketCounter net_packets = 0;
+        };
+
+        DURATION            _window {};     // Max window duration, zero if unlimited.
+        DURATION            _modulo {};     // Time wrap up value, zero if none.
+        std::vector<Sample> _samples {};    // Ring buffer of samples, fixed size.
+        size_t              _first = 0;     // Index of oldest sample.
+        size_t              _count = 0;     // Number of samples in the ring.
+
+        // Access oldest and newest samples. The ring must not be empty.
+        const Sample& oldest() const { return _samples[_first]; }
+        const Sample& newest() const { return _samples[(_first + _count - 1) % _samples.size()]; }
+
+        // Time elapsed between two samples, zero if t2 is before t1.
+        DURATION elapsed(DURATION t1, DURATION t2) const;
+    };
+
+    //!
+    //! Rolling bitrate evaluation over sliding windows, one per PID.
+    //! @ingroup libtsduck mpeg
+    //!
+    //! Each PID has its own sliding window, as described in RollingBitRate, all windows having
+    //! the same characteristics. Distinct windows are required when the time values of distinct
+    //! PID's are not comparable, typically the PCR's of programs which use distinct clocks.
+    //!
+    //! The window of a PID is allocated when the first sample of this PID is fed. After that,
+    //! feeding samples never allocates memory, even after reset().
+    //!
+    //! @tparam DURATION A std::chrono::duration type for the time base.
+    //!
+    template <class DURATION>
+    class PIDRollingBitRate
+    {
+        TS_NOCOPY(PIDRollingBitRate);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] window Maximum duration of each sliding window. Zero means unlimited.
+        //! @param [in] max_samples Maximum number of samples in each sliding window.
+        //! @param [in] modulo If non zero, the time base wraps up at this value.
+        //! @see RollingBitRate
+        //!
+        PIDRollingBitRate(DURATION window = DURATION::zero(), size_t max_samples = 2, DURATION modulo = DURATION::zero());
+
+        //!
+        //! Redefine the sliding windows. All samples are dropped.
+        //! @param [in] window Maximum duration of each sliding window. Zero means unlimited.
+        //! @param [in] max_samples Maximum number of samples in each sliding window.
+        //! @param [in] modulo If non zero, the time base wraps up at this value.
+        //!
+        void setWindow(DURATION window, size_t max_samples, DURATION modulo = DURATION::zero());
+
+        //!
+        //! Drop all samples in all PID's.
+        //!
+        void reset();
+
+        //!
+        //! Feed a new sample in the sliding window of a PID.
+        //! @param [in] pid The PID of the sample.
+        //! @param [in] time Time of the sample.
+        //! @param [in] packets Cumulative number of packets at @a time.
+        //! @param [in] net_packets Cumulative number of "net" packets at @a time.
+        //!
+        void feed(PID pid, DURATION time, PacketCounter packets, PacketCounter net_packets = 0);
+
+        //!
+        //! Get the sliding window of a PID.
+        //! @param [in] pid The PID to get.
+        //! @return A constant reference to the sliding window of @a pid. If no sample was
+        //! fed in that PID, the returned window is empty.
+        //!
+        const RollingBitRate<DURATION>& window(PID pid) const { return pid < PID_MAX && _pids[pid] != nullptr ? *_pids[pid] : _empty; }
+
+        //!
+        //! Get the bitrate over the sliding window of a PID.
+        //! @param [in] pid The PID to get.
+        //! @return The TS bitrate in bits/second based on 188-byte packets, zero if unknown.
+        //!
+        BitRate bitrate(PID pid) const { return window(pid).bitrate(); }
+
+        //!
+        //! Get the "net" bitrate over the sliding window of a PID.
+        //! @param [in] pid The PID to get.
+        //! @return The bitrate of "net" packets in bits/second based on 188-byte packets, zero if unknown.
+        //!
+        BitRate netBitRate(PID pid) const { return window(pid).netBitRate(); }
+
+    private:
+        using WindowPtr = std::unique_ptr<RollingBitRate<DURATION>>;
+
+        DURATION _window {};                  // Max window duration, zero if unlimited.
+        DURATION _modulo {};                  // Time wrap up value, zero if none.
+        size_t   _max_samples = 2;            // Max number of samples per window.
+        std::array<WindowPtr, PID_MAX> _pids {};  // Sliding windows per PID, allocated on first sample.
+        RollingBitRate<DURATION> _empty {};   // Always empty, for PID's without sample.
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+// Constructor.
+template <class DURATION>
+ts::RollingBitRate<DURATION>::RollingBitRate(DURATION window, size_t max_samples, DURATION modulo)
+{
+    setWindow(window, max_samples, modulo);
+}
+
+// Redefine the sliding window.
+template <class DURATION>
+void ts::RollingBitRate<DURATION>::setWindow(DURATION window, size_t max_samples, DURATION modulo)
+{
+    _window = window;
+    _modulo = modulo;
+    _samples.resize(std::max<size_t>(2, max_samples));
+    reset();
+}
+
+// Drop all samples.
+template <class DURATION>
+void ts::RollingBitRate<DURATION>::reset()
+{
+    _first = 0;
+    _count = 0;
+}
+
+// Time elapsed between two samples.
+template <class DURATION>
+DURATION ts::RollingBitRate<DURATION>::elapsed(DURATION t1, DURATION t2) const
+{
+    if (_modulo <= DURATION::zero()) {
+        return t2 >= t1 ? t2 - t1 : DURATION::zero();
+    }
+    else {
+        const DURATION diff = ((t2 - t1) % _modulo + _modulo) % _modulo;
+        return diff > _modulo / 2 ? DURATION::zero() : diff;
+    }
+}
+
+// Feed a new sample.
+template <class DURATION>
+void ts::RollingBitRate<DURATION>::feed(DURATION time, PacketCounter packets, PacketCounter net_packets)
+{
+    // Drop the oldest sample when the ring is full.
+    if (_count == _samples.size()) {
+        _first = (_first + 1) % _samples.size();
+        _count--;
+    }
+
+    // Store the new sample at the end of the ring.
+    Sample& last(_samples[(_first + _count++) % _samples.size()]);
+    last.time = time;
+    last.packets = packets;
+    last.net_packets = net_packets;
+
+    // Drop old samples which are outside the window.
+    if (_window > DURATION::zero()) {
+        while (_count > 1 && elapsed(oldest().time, time) > _window) {
+            _first = (_first + 1) % _samples.size();
+            _count--;
+        }
+    }
+}
+
+
+// Per-PID constructor.
+template <class DURATION>
+ts::PIDRollingBitRate<DURATION>::PIDRollingBitRate(DURATION window, size_t max_samples, DURATION modulo) :
+    _window(window),
+    _modulo(modulo),
+    _max_samples(max_samples)
+{
+}
+
+// Redefine the per-PID sliding windows.
+template <class DURATION>
+void ts::PIDRollingBitRate<DURATION>::setWindow(DURATION window, size_t max_samples, DURATION modulo)
+{
+    _window = window;
+    _modulo = modulo;
+    _max_samples = max_samples;
+    for (auto& win : _pids) {
+        if (win != nullptr) {
+            win->setWindow(_window, _max_samples, _modulo);
+        }
+    }
+}
+
+// Drop all samples in all PID's.
+template <class DURATION>
+void ts::PIDRollingBitRate<DURATION>::reset()
+{
+    for (auto& win : _pids) {
+        if (win != nullptr) {
+            win->reset();
+        }
+    }
+}
+
+// Feed a new sample in the sliding window of a PID.
+template <class DURATION>
+void ts::PIDRollingBitRate<DURATION>::feed(PID pid, DURATION time, PacketCounter packets, PacketCounter net_packets)
+{
+    if (pid < PID_MAX) {
+        if (_pids[pid] == nullptr) {
+            _pids[pid] = std::make_unique<RollingBitRate<DURATION>>(_window, _max_samples, _modulo);
+        }
+        _pids[pid]->feed(time, packets, net_packets);
+    }
+}
@@ -28,21 +28,17 @@ ts::TSSpeedMetrics::TSSpeedMetrics(PacketCounter packets, cn::nanoseconds nanose
 
 void ts::TSSpeedMetrics::start()
 {
-    // Reset the content of all intervals to {0, 0}
-    _intervals.clear();
-    _intervals.resize(_max_intervals_num);
-    _next_interval = 0;
-
-    // Reset accumulated counters.
-    _total.clear();
+    // The sliding window contains the start of the first interval and the end of all intervals.
+    _window.setWindow(cn::nanoseconds::zero(), _max_intervals_num + 1);
+    _total_packets = 0;
 
     // Get initial time reference.
     _session_start = monotonic_time::clock::now();
     _clock = _session_start;
+    _window.feed(cn::nanoseconds::zero(), 0);
 
     // Initialize first interval.
     _start_interval = cn::nanoseconds::zero();
-    _count_interval = 0;
     _remain_interval = _min_packets;
 }
 
@@ -54,7 +50,7 @@ void ts::TSSpeedMetrics::start()
 bool ts::TSSpeedMetrics::processedPacket(PacketCounter count)
 {
     // Accumulate in current interval.
-    _count_interval += count;
+    _total_packets += count;
     _remain_interval -= std::min(_remain_interval, count);
 
     // Is it time to reconsider the clock ?
@@ -72,26 +68,12 @@ bool ts::TSSpeedMetrics::processedPacket(PacketCounter count)
             _remain_interval = std::max<PacketCounter>(1, _min_packets / 2);
         }
         else {
-            // Enough data for this interval. Add it into accumulated data.
-            // First, remove from total the data of the interval we are going to overwrite.
-            assert(_next_interval < _intervals.size());
-            assert(_total.duration >= _intervals[_next_interval].duration);
-            assert(_total.packets >= _intervals[_next_interval].packets);
-            _total.duration -= _intervals[_next_interval].duration;
-            _total.packets -= _intervals[_next_interval].packets;
-
-            // Then, add current data in the accumulated data.
-            _intervals[_next_interval].packets = _count_interval;
-            _intervals[_next_interval].duration = in_interval;
-            _total.packets += _count_interval;
-            _total.duration += in_interval;
-
-            // Next entry to overwrite in circular buffer.
-            _next_interval = (_next_interval + 1) % _intervals.size();
+            // Enough data for this interval. Add its end point into the sliding window.
+            // The oldest interval is automatically dropped when the window is full.
+            _window.feed(in_session, _total_packets);
 
             // Initialize next interval (_remain_interval is already zero).
             _start_interval = in_session;
-            _count_interval = 0;
         }
     }
 
@@ -105,5 +87,5 @@ bool ts::TSSpeedMetrics::processedPacket(PacketCounter count)
 
 ts::BitRate ts::TSSpeedMetrics::bitrate() const
 {
-    return PacketBitRate(_total.packets, _total.duration);
+    return _window.bitrate();
 }
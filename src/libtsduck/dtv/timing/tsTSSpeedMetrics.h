@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsRollingBitRate.h"
 
 namespace ts {
     //!
@@ -104,15 +105,6 @@ namespace ts {
         cn::nanoseconds sessionNanoSeconds() const { return _clock - _session_start; }
 
     private:
-        // Results on an interval of time.
-        struct Interval
-        {
-            void clear() { packets = 0; duration = cn::nanoseconds::zero(); }
-
-            PacketCounter   packets = 0;   // Number of processed packets.
-            cn::nanoseconds duration {0};  // Processing duration.
-        };
-
         // Configuration data:
         PacketCounter   _min_packets = MIN_PACKET_PER_INTERVAL;    // Minimum packets to accumulate per interval.
         cn::nanoseconds _min_nanosecs = MIN_NANOSEC_PER_INTERVAL;  // Minimum number of nanoseconds per interval.
@@ -121,12 +113,10 @@ namespace ts {
         monotonic_time  _session_start {};      // The clock when start() was called.
         monotonic_time  _clock {};              // The reference clock.
         // Accumulated data since beginning of session:
-        std::vector<Interval> _intervals {};    // Accumulate results, circular buffer.
-        size_t          _next_interval = 0;     // Next interval to overwrite.
-        Interval        _total {};              // Accumulated values in all _intervals.
+        RollingBitRate<cn::nanoseconds> _window {};  // Sliding window over the last intervals.
+        PacketCounter   _total_packets = 0;     // Number of processed packets since start of session.
         // Description of current interval:
         cn::nanoseconds _start_interval {0};    // Start time of interval, from _start_session.
-        PacketCounter   _count_interval = 0;    // Number of processed packets in current interval.
         PacketCounter   _remain_interval = 0;   // Number of packets to process in this interval before checking the clock.
     };
 }
@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTransportBufferModel.h"
+
+
+//----------------------------------------------------------------------------
+// Reset the buffer to its initial state.
+//----------------------------------------------------------------------------
+
+void ts::TransportBufferModel::reset()
+{
+    _leak_rate = 0;
+    _level = 0;
+    _last_packet = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Update the leak rate from a new estimation of the bitrate of the PID.
+//----------------------------------------------------------------------------
+
+void ts::TransportBufferModel::setPIDBitRate(const BitRate& pid_bitrate)
+{
+    const BitRate leak = std::max(BitRate(MIN_LEAK_RATE), 12 * pid_bitrate / 10);
+    _leak_rate = leak >= _leak_rate ? leak : (7 * _leak_rate + leak) / 8;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the level of the buffer at a given position in the transport stream.
+//----------------------------------------------------------------------------
+
+double ts::TransportBufferModel::level(PacketCounter packet, const BitRate& ts_bitrate) const
+{
+    if (ts_bitrate == 0 || packet <= _last_packet) {
+        return _level;
+    }
+    else {
+        // Number of bytes which leaked out of the buffer since the last inserted packet.
+        const double leaked = (_leak_rate.toDouble() * double(packet - _last_packet) * PKT_SIZE) / ts_bitrate.toDouble();
+        return std::max(0.0, _level - leaked);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a packet of the PID can be inserted.
+//----------------------------------------------------------------------------
+
+bool ts::TransportBufferModel::canInsert(PacketCounter packet, const BitRate& ts_bitrate) const
+{
+    return _leak_rate == 0 || level(packet, ts_bitrate) + PKT_SIZE <= TB_SIZE;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a packet of the PID in the buffer.
+//----------------------------------------------------------------------------
+
+void ts::TransportBufferModel::insert(PacketCounter packet, const BitRate& ts_bitrate)
+{
+    // While the leak rate is unknown, the packets are not accounted, the buffer would only grow.
+    _level = _leak_rate == 0 ? 0 : level(packet, ts_bitrate) + PKT_SIZE;
+    _last_packet = packet;
+}
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Model of the transport buffer (TB) of a PID in the T-STD.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Model of the transport buffer (TB) of a PID, as defined in the T-STD of ISO/IEC 13818-1.
+    //! @ingroup libtsduck mpeg
+    //!
+    //! The buffer has a size of 512 bytes. It is filled by the packets of the PID in the transport
+    //! stream and leaks at a rate which is derived from the bitrate of the PID. A multiplexer
+    //! shall not insert a packet of the PID while it would overflow the buffer.
+    //!
+    //! The position in the transport stream is expressed as a packet index. The elapsed time
+    //! between two packets is computed from the bitrate of the transport stream.
+    //!
+    class TSDUCKDLL TransportBufferModel
+    {
+    public:
+        //!
+        //! Size in bytes of a transport buffer.
+        //!
+        static constexpr size_t TB_SIZE = 512;
+
+        //!
+        //! Minimum leak rate of a transport buffer in bits/second, Rxsys in the T-STD.
+        //!
+        static constexpr BitRate::int_t MIN_LEAK_RATE = 1'000'000;
+
+        //!
+        //! Reset the buffer to its initial state: empty with an unknown leak rate.
+        //!
+        void reset();
+
+        //!
+        //! Get the leak rate of the buffer.
+        //! @return The leak rate in bits/second or zero when not yet known.
+        //!
+        BitRate leakRate() const { return _leak_rate; }
+
+        //!
+        //! Update the leak rate of the buffer from a new estimation of the bitrate of the PID.
+        //! The leak rate is 1.2 times the bitrate of the PID, as for video in the T-STD, and at least Rxsys.
+        //! It immediately increases at the beginning of a burst and slowly decreases after it.
+        //! @param [in] pid_bitrate Estimated bitrate of the PID.
+        //!
+        void setPIDBitRate(const BitRate& pid_bitrate);
+
+        //!
+        //! Get the level of the buffer at a given position in the transport stream.
+        //! @param [in] packet Index of the current packet in the transport stream.
+        //! @param [in] ts_bitrate Bitrate of the transport stream.
+        //! @return The level of the buffer in bytes, before inserting the current packet.
+        //!
+        double level(PacketCounter packet, const BitRate& ts_bitrate) const;
+
+        //!
+        //! Check if a packet of the PID can be inserted without overflowing the buffer.
+        //! @param [in] packet Index of the current packet in the transport stream.
+        //! @param [in] ts_bitrate Bitrate of the transport stream.
+        //! @return True if the packet can be inserted. Always true when the leak rate is not yet known.
+        //!
+        bool canInsert(PacketCounter packet, const BitRate& ts_bitrate) const;
+
+        //!
+        //! Insert a packet of the PID in the buffer.
+        //! @param [in] packet Index of the inserted packet in the transport stream.
+        //! @param [in] ts_bitrate Bitrate of the transport stream.
+        //!
+        void insert(PacketCounter packet, const BitRate& ts_bitrate);
+
+    private:
+        BitRate       _leak_rate = 0;    // Leak rate of the buffer, zero when not yet known.
+        double        _level = 0;        // Buffer level in bytes after the last inserted packet.
+        PacketCounter _last_packet = 0;  // Packet index in transport stream of last inserted packet.
+    };
+}
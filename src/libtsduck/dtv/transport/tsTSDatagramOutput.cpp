@@ -353,6 +353,22 @@ bool ts::TSDatagramOutput::send(const TSPacket* pkt, const TSPacketMetadata* met
         }
     }
 
+    // Without RTP header and trailer, the TS packets are sent as is. All complete bursts
+    // are contiguous datagrams which can be passed at once to the output handler.
+    if (!_use_rtp && !_rs204_format && packet_count >= 2 * _pkt_burst) {
+        const size_t dgram_count = packet_count / _pkt_burst;
+        const size_t count = dgram_count * _pkt_burst;
+        if (!_output->sendDatagrams(pkt, _pkt_burst * PKT_SIZE, dgram_count, report)) {
+            return false;
+        }
+        _pkt_count += count;
+        if (metadata != nullptr) {
+            metadata += count;
+        }
+        pkt += count;
+        packet_count -= count;
+    }
+
     // Send subsequent packets from the global buffer.
     while (packet_count >= min_burst) {
         size_t count = std::min(packet_count, _pkt_burst);
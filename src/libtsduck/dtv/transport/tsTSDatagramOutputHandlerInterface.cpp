@@ -11,3 +11,20 @@
 ts::TSDatagramOutputHandlerInterface::~TSDatagramOutputHandlerInterface()
 {
 }
+
+
+//----------------------------------------------------------------------------
+// Default implementation: send datagrams one by one.
+//----------------------------------------------------------------------------
+
+bool ts::TSDatagramOutputHandlerInterface::sendDatagrams(const void* address, size_t size, size_t count, Report& report)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(address);
+    for (size_t i = 0; i < count; ++i) {
+        if (!sendDatagram(data, size, report)) {
+            return false;
+        }
+        data += size;
+    }
+    return true;
+}
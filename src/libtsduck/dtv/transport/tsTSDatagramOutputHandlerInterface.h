@@ -37,5 +37,17 @@ namespace ts {
         //! @return True on success, false on error.
         //!
         virtual bool sendDatagram(const void* address, size_t size, Report& report) = 0;
+
+        //!
+        //! Send several consecutive datagram messages of the same size.
+        //! The datagrams are contiguous in memory. The default implementation calls sendDatagram()
+        //! for each datagram. Subclasses may override it to send all datagrams with less overhead.
+        //! @param [in] address Address of the first datagram content.
+        //! @param [in] size Size in bytes of each datagram.
+        //! @param [in] count Number of datagrams to send.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendDatagrams(const void* address, size_t size, size_t count, Report& report);
     };
 }
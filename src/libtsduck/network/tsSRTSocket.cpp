@@ -271,6 +271,13 @@ void ts::SRTSocket::defineArgs(ts::Args& args)
               u"from srt_accept). This string can be used completely free-form, however it's highly "
               u"recommended to follow the SRT Access Control guidlines.");
 
+    args.option<cn::milliseconds>(u"summary-interval");
+    args.help(u"summary-interval",
+              u"Report a one-line summary of the main SRT statistics at regular intervals, in milliseconds: "
+              u"RTT, retransmitted, lost and dropped packets, send or receive buffer level. "
+              u"The specified interval is a minimum value, actual reporting can occur "
+              u"only when data are exchanged over the SRT socket.");
+
     args.option(u"udp-rcvbuf", 0, Args::POSITIVE);
     args.help(u"udp-rcvbuf", u"UDP socket receive buffer size in bytes.");
 
@@ -279,6 +286,26 @@ void ts::SRTSocket::defineArgs(ts::Args& args)
 }
 
 
+//----------------------------------------------------------------------------
+// Summary of SRT statistics, for logging purpose.
+// These methods are defined even in the absence of libsrt.
+//----------------------------------------------------------------------------
+
+ts::UString ts::SRTStatistics::sendSummary() const
+{
+    return UString::Format(u"SRT send: %'d packets, retransmit: %'d, lost: %'d, dropped: %'d, send buffer: %'d packets (%'d bytes, %s), RTT: %.3f ms",
+                           sent_packets, retransmit_packets, send_lost_packets, send_dropped_packets,
+                           send_buffer_packets, send_buffer_bytes, send_buffer_time, rtt_ms);
+}
+
+ts::UString ts::SRTStatistics::receiveSummary() const
+{
+    return UString::Format(u"SRT receive: %'d packets, lost: %'d, dropped: %'d, receive buffer: %'d packets (%s), RTT: %.3f ms",
+                           received_packets, recv_lost_packets, recv_dropped_packets,
+                           recv_buffer_packets, recv_buffer_time, rtt_ms);
+}
+
+
 //----------------------------------------------------------------------------
 // Stubs in the absence of libsrt.
 //----------------------------------------------------------------------------
@@ -295,9 +322,12 @@ bool ts::SRTSocket::close(Report& report) NOSRT_ERROR
 bool ts::SRTSocket::peerDisconnected() const { return false; }
 bool ts::SRTSocket::loadArgs(DuckContext&, Args&) { return true; }
 bool ts::SRTSocket::send(const void*, size_t, Report& report) NOSRT_ERROR
+bool ts::SRTSocket::sendMessages(const void*, size_t, size_t, Report& report) NOSRT_ERROR
 bool ts::SRTSocket::receive(void*, size_t, size_t&, Report& report) NOSRT_ERROR
 bool ts::SRTSocket::receive(void*, size_t, size_t&, cn::microseconds&, Report& report) NOSRT_ERROR
+bool ts::SRTSocket::receiveNoWait(void*, size_t, size_t&, cn::microseconds&, Report& report) NOSRT_ERROR
 bool ts::SRTSocket::reportStatistics(SRTStatMode, Report& report) NOSRT_ERROR
+bool ts::SRTSocket::getStatistics(SRTStatistics&, Report& report) NOSRT_ERROR
 bool ts::SRTSocket::getSockOpt(int, const char*, void*, int&, Report& report) const NOSRT_ERROR
 int  ts::SRTSocket::getSocket() const { return -1; }
 bool ts::SRTSocket::getMessageApi() const { return false; }
@@ -317,6 +347,7 @@ size_t ts::SRTSocket::totalReceivedBytes() const { return 0; }
 //----------------------------------------------------------------------------
 
 #define DEFAULT_POLLING_TIME 100
+#define RECEIVE_POLL_MS      100  // Maximum wait time in srt_epoll_wait() before checking if the socket was closed.
 
 namespace {
     class SRTInit
@@ -396,6 +427,7 @@ public:
      Guts(SRTSocket* parent) : _parent(parent) {}
 
      bool send(const void* data, size_t size, const IPSocketAddress& dest, Report& report);
+     bool sendData(const void* data, size_t size, Report& report);
      bool setSockOpt(int optName, const char* optNameStr, const void* optval, size_t optlen, Report& report);
      bool setSockOptPre(Report& report);
      bool setSockOptPost(Report& report);
@@ -403,6 +435,7 @@ public:
      bool srtConnect(const IPSocketAddress& addr, Report& report);
      bool srtBind(const IPSocketAddress& addr, Report& report);
      bool reportStats(Report& report);
+     bool receive(void* data, size_t max_size, size_t& ret_size, cn::microseconds& timestamp, bool wait, Report& report);
 
      // Socket working data.
      IPSocketAddress      local_address {};
@@ -413,6 +446,8 @@ public:
      size_t               total_sent_bytes = 0;
      size_t               total_received_bytes = 0;
      Time                 next_stats {};
+     Time                 next_summary {};
+     volatile int         rcv_eid = -1;                  // SRT epoll id for non-blocking reception, created on first receive.
 
      // Socket options.
      ::SRT_TRANSTYPE transtype = SRTT_INVALID;
@@ -454,6 +489,7 @@ public:
      bool        json_line = false;
      UString     json_prefix {};
      cn::milliseconds stats_interval = cn::milliseconds(0);
+     cn::milliseconds summary_interval = cn::milliseconds(0);
      SRTStatMode      stats_mode = SRTStatMode::ALL;
 private:
      // Callback which is called on any incoming connection.
@@ -579,6 +615,9 @@ bool ts::SRTSocket::open(SRTSocketMode mode,
     if (_guts->stats_interval > cn::milliseconds::zero()) {
         _guts->next_stats = Time::CurrentUTC() + _guts->stats_interval;
     }
+    if (_guts->summary_interval > cn::milliseconds::zero()) {
+        _guts->next_summary = Time::CurrentUTC() + _guts->summary_interval;
+    }
 
     if (!success) {
         close(report);
@@ -608,8 +647,10 @@ bool ts::SRTSocket::close(Report& report)
     // clear the socket value first, then close.
     const ::SRTSOCKET sock = _guts->sock;
     const ::SRTSOCKET listener = _guts->listener;
+    const int rcv_eid = _guts->rcv_eid;
     _guts->listener = SRT_INVALID_SOCK;
     _guts->sock = SRT_INVALID_SOCK;
+    _guts->rcv_eid = -1;
 
     if (sock != SRT_INVALID_SOCK) {
         // Close the SRT data socket.
@@ -622,6 +663,11 @@ bool ts::SRTSocket::close(Report& report)
             ::srt_close(listener);
         }
     }
+
+    // Release the epoll id which was used for reception. A concurrent srt_epoll_wait() fails on invalid id.
+    if (rcv_eid >= 0) {
+        ::srt_epoll_release(rcv_eid);
+    }
     return true;
 }
 
@@ -633,12 +679,24 @@ bool ts::SRTSocket::close(Report& report)
 bool ts::SRTSocket::Guts::reportStats(Report& report)
 {
     bool status = true;
-    if (stats_interval > cn::milliseconds::zero()) {
+    if (stats_interval > cn::milliseconds::zero() || summary_interval > cn::milliseconds::zero()) {
         const Time now(Time::CurrentUTC());
-        if (now >= next_stats) {
+        if (stats_interval > cn::milliseconds::zero() && now >= next_stats) {
             next_stats = now + stats_interval;
             status = _parent->reportStatistics(stats_mode, report);
         }
+        if (summary_interval > cn::milliseconds::zero() && now >= next_summary) {
+            next_summary = now + summary_interval;
+            SRTStatistics stats;
+            if (_parent->getStatistics(stats, report)) {
+                if (total_sent_bytes > 0) {
+                    report.info(stats.sendSummary());
+                }
+                if (total_received_bytes > 0) {
+                    report.info(stats.receiveSummary());
+                }
+            }
+        }
     }
     return status;
 }
@@ -771,6 +829,7 @@ bool ts::SRTSocket::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(_guts->udp_rcvbuf, u"udp-rcvbuf", -1);
     args.getIntValue(_guts->udp_sndbuf, u"udp-sndbuf", -1);
     args.getChronoValue(_guts->stats_interval, u"statistics-interval");
+    args.getChronoValue(_guts->summary_interval, u"summary-interval");
     _guts->final_stats = _guts->stats_interval > cn::milliseconds::zero() || args.present(u"final-statistics");
     _guts->json_line = args.present(u"json-line");
     args.getValue(_guts->json_prefix, u"json-line");
@@ -1023,6 +1082,11 @@ bool ts::SRTSocket::send(const void* data, size_t size, Report& report)
 }
 
 bool ts::SRTSocket::Guts::send(const void* data, size_t size, const IPSocketAddress& dest, Report& report)
+{
+    return sendData(data, size, report) && reportStats(report);
+}
+
+bool ts::SRTSocket::Guts::sendData(const void* data, size_t size, Report& report)
 {
     // If socket was disconnected or aborted, silently fail.
     if (disconnected || sock == SRT_INVALID_SOCK) {
@@ -1044,7 +1108,31 @@ bool ts::SRTSocket::Guts::send(const void* data, size_t size, const IPSocketAddr
     }
 
     total_sent_bytes += size;
-    return reportStats(report);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send several consecutive messages of the same size.
+//----------------------------------------------------------------------------
+
+bool ts::SRTSocket::sendMessages(const void* data, size_t message_size, size_t count, Report& report)
+{
+    bool ok = true;
+    if (!_guts->messageapi) {
+        // With the Buffer API, message boundaries are not preserved, send everything at once.
+        ok = _guts->sendData(data, message_size * count, report);
+    }
+    else {
+        // With the Message API, libsrt needs one call per message, there is no multi-message call.
+        const char* msg = reinterpret_cast<const char*>(data);
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = _guts->sendData(msg, message_size, report);
+            msg += message_size;
+        }
+    }
+    // Check periodic statistics once for all messages.
+    return ok && _guts->reportStats(report);
 }
 
 
@@ -1059,38 +1147,91 @@ bool ts::SRTSocket::receive(void* data, size_t max_size, size_t& ret_size, Repor
 }
 
 bool ts::SRTSocket::receive(void* data, size_t max_size, size_t& ret_size, cn::microseconds& timestamp, Report& report)
+{
+    return _guts->receive(data, max_size, ret_size, timestamp, true, report) && _guts->reportStats(report);
+}
+
+bool ts::SRTSocket::receiveNoWait(void* data, size_t max_size, size_t& ret_size, cn::microseconds& timestamp, Report& report)
+{
+    return _guts->receive(data, max_size, ret_size, timestamp, false, report);
+}
+
+bool ts::SRTSocket::Guts::receive(void* data, size_t max_size, size_t& ret_size, cn::microseconds& timestamp, bool wait, Report& report)
 {
     ret_size = 0;
     timestamp = cn::microseconds(-1);
 
     // If socket was disconnected or aborted, silently fail.
-    if (_guts->disconnected || _guts->sock == SRT_INVALID_SOCK) {
+    if (disconnected || sock == SRT_INVALID_SOCK) {
         return false;
     }
 
-    // Message data
-    ::SRT_MSGCTRL ctrl;
-    TS_ZERO(ctrl);
+    // On first receive, after the connection is established, switch the socket to non-blocking
+    // reception. Waiting for the first message uses an SRT epoll. The following messages which
+    // are already available are then received without waiting.
+    if (rcv_eid < 0) {
+        const bool rcvsyn = false;
+        const int events = SRT_EPOLL_IN | SRT_EPOLL_ERR;
+        if (!setSockOpt(SRTO_RCVSYN, "SRTO_RCVSYN", &rcvsyn, sizeof(rcvsyn), report)) {
+            return false;
+        }
+        const int eid = ::srt_epoll_create();
+        if (eid < 0) {
+            report.error(u"error during srt_epoll_create(): %s", ::srt_getlasterror_str());
+            return false;
+        }
+        if (::srt_epoll_add_usock(eid, sock, &events) < 0) {
+            report.error(u"error during srt_epoll_add_usock(): %s", ::srt_getlasterror_str());
+            ::srt_epoll_release(eid);
+            return false;
+        }
+        rcv_eid = eid;
+    }
+
+    for (;;) {
+        // Message data
+        ::SRT_MSGCTRL ctrl;
+        TS_ZERO(ctrl);
 
-    const int ret = ::srt_recvmsg2(_guts->sock, reinterpret_cast<char*>(data), int(max_size), &ctrl);
-    if (ret < 0) {
-        // Differentiate peer disconnection (aka "end of file") and actual errors.
+        const int ret = ::srt_recvmsg2(sock, reinterpret_cast<char*>(data), int(max_size), &ctrl);
+        if (ret >= 0) {
+            if (ctrl.srctime != 0) {
+                timestamp = cn::microseconds(cn::microseconds::rep(ctrl.srctime));
+            }
+            ret_size = size_t(ret);
+            total_received_bytes += ret_size;
+            return true;
+        }
+
+        // Differentiate peer disconnection (aka "end of file"), no message yet and actual errors.
         const int err = ::srt_getlasterror(nullptr);
-        if (err == SRT_ECONNLOST || err == SRT_EINVSOCK) {
-            _guts->disconnected = true;
+        if (err == SRT_EASYNCRCV && wait) {
+            // No message available yet, wait for one. The wait is bounded to periodically check if the socket was closed.
+            ::SRTSOCKET ready[1];
+            int ready_count = 1;
+            if (::srt_epoll_wait(rcv_eid, ready, &ready_count, nullptr, nullptr, RECEIVE_POLL_MS, nullptr, nullptr, nullptr, nullptr) < 0 &&
+                ::srt_getlasterror(nullptr) != SRT_ETIMEOUT)
+            {
+                if (sock != SRT_INVALID_SOCK) {
+                    report.error(u"error during srt_epoll_wait(): %s", ::srt_getlasterror_str());
+                }
+                return false;
+            }
+            if (disconnected || sock == SRT_INVALID_SOCK) {
+                return false;
+            }
         }
-        else if (_guts->sock != SRT_INVALID_SOCK) {
-            // Display error only if the socket was not closed in the meantime.
-            report.error(u"error during srt_recv(): %s", ::srt_getlasterror_str());
+        else {
+            if (err == SRT_ECONNLOST || err == SRT_EINVSOCK) {
+                disconnected = true;
+            }
+            else if (err != SRT_EASYNCRCV && sock != SRT_INVALID_SOCK) {
+                // Display error only if the socket was not closed in the meantime.
+                report.error(u"error during srt_recv(): %s", ::srt_getlasterror_str());
+            }
+            return false;
         }
-        return false;
     }
-    if (ctrl.srctime != 0) {
-        timestamp = cn::microseconds(cn::microseconds::rep(ctrl.srctime));
-    }
-    ret_size = size_t(ret);
-    _guts->total_received_bytes += ret_size;
-    return _guts->reportStats(report);
 }
 
 
@@ -1109,6 +1250,47 @@ size_t ts::SRTSocket::totalReceivedBytes() const
 }
 
 
+//----------------------------------------------------------------------------
+// Get a summary of the statistics about the socket.
+//----------------------------------------------------------------------------
+
+bool ts::SRTSocket::getStatistics(SRTStatistics& stats, Report& report)
+{
+    stats = SRTStatistics();
+
+    // If socket was closed, silently fail.
+    if (_guts->sock == SRT_INVALID_SOCK) {
+        return false;
+    }
+
+    // Get cumulated statistics, do not clear the interval ones.
+    ::SRT_TRACEBSTATS bstats;
+    TS_ZERO(bstats);
+    if (::srt_bstats(_guts->sock, &bstats, 0) < 0) {
+        if (!_guts->disconnected) {
+            report.error(u"error during srt_bstats: %s", ::srt_getlasterror_str());
+        }
+        return false;
+    }
+
+    stats.elapsed = cn::milliseconds(cn::milliseconds::rep(bstats.msTimeStamp));
+    stats.rtt_ms = bstats.msRTT;
+    stats.sent_packets = uint64_t(std::max<int64_t>(0, bstats.pktSentTotal));
+    stats.retransmit_packets = uint64_t(std::max<int64_t>(0, bstats.pktRetransTotal));
+    stats.send_lost_packets = uint64_t(std::max<int64_t>(0, bstats.pktSndLossTotal));
+    stats.send_dropped_packets = uint64_t(std::max<int64_t>(0, bstats.pktSndDropTotal));
+    stats.send_buffer_packets = uint64_t(std::max<int64_t>(0, bstats.pktSndBuf));
+    stats.send_buffer_bytes = uint64_t(std::max<int64_t>(0, bstats.byteSndBuf));
+    stats.send_buffer_time = cn::milliseconds(cn::milliseconds::rep(bstats.msSndBuf));
+    stats.received_packets = uint64_t(std::max<int64_t>(0, bstats.pktRecvTotal));
+    stats.recv_lost_packets = uint64_t(std::max<int64_t>(0, bstats.pktRcvLossTotal));
+    stats.recv_dropped_packets = uint64_t(std::max<int64_t>(0, bstats.pktRcvDropTotal));
+    stats.recv_buffer_packets = uint64_t(std::max<int64_t>(0, bstats.pktRcvBuf));
+    stats.recv_buffer_time = cn::milliseconds(cn::milliseconds::rep(bstats.msRcvBuf));
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Get statistics about the socket and report them.
 //----------------------------------------------------------------------------
@@ -1280,6 +1462,9 @@ bool ts::SRTSocket::reportStatistics(SRTStatMode mode, Report& report)
                 msg.format(u", send: %d ms", stats.msSndTsbPdDelay);
             }
             msg.format(u", RTT: %f ms", stats.msRTT);
+            if (show_send) {
+                msg.format(u"\n  Send buffer: %'d packets, %'d bytes, %d ms", stats.pktSndBuf, stats.byteSndBuf, stats.msSndBuf);
+            }
         }
         if (none) {
             msg.append(u" none available");
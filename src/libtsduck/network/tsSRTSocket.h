@@ -47,6 +47,43 @@ TS_ENABLE_BITMASK_OPERATORS(ts::SRTStatMode);
 
 namespace ts {
 
+    //!
+    //! Summary of Secure Reliable Transport (SRT) statistics on a socket.
+    //! This is a subset of the statistics from libsrt, for monitoring purpose.
+    //! All counters are cumulated since the socket was opened.
+    //!
+    class TSDUCKDLL SRTStatistics
+    {
+    public:
+        cn::milliseconds elapsed {};               //!< Time since the connection was established.
+        double           rtt_ms = 0.0;             //!< Round trip time in milliseconds.
+        uint64_t         sent_packets = 0;         //!< Number of sent packets.
+        uint64_t         retransmit_packets = 0;   //!< Number of retransmitted packets.
+        uint64_t         send_lost_packets = 0;    //!< Number of sent packets which were reported lost by the receiver.
+        uint64_t         send_dropped_packets = 0; //!< Number of packets dropped by the sender because they were too late.
+        uint64_t         send_buffer_packets = 0;  //!< Current number of unacknowledged packets in the send buffer.
+        uint64_t         send_buffer_bytes = 0;    //!< Current number of unacknowledged bytes in the send buffer.
+        cn::milliseconds send_buffer_time {};      //!< Current timespan of unacknowledged packets in the send buffer.
+        uint64_t         received_packets = 0;     //!< Number of received packets.
+        uint64_t         recv_lost_packets = 0;    //!< Number of lost received packets.
+        uint64_t         recv_dropped_packets = 0; //!< Number of received packets which were dropped because they were too late.
+        uint64_t         recv_buffer_packets = 0;  //!< Current number of acknowledged packets in the receive buffer.
+        cn::milliseconds recv_buffer_time {};      //!< Current timespan of acknowledged packets in the receive buffer.
+
+        //!
+        //! Format the main send statistics as a one-line string, for logging purpose.
+        //! @return A one-line summary of the send statistics.
+        //!
+        UString sendSummary() const;
+
+        //!
+        //! Format the main receive statistics as a one-line string, for logging purpose.
+        //! @return A one-line summary of the receive statistics.
+        //!
+        UString receiveSummary() const;
+    };
+
+
     class Args;
     class DuckContext;
 
@@ -143,6 +180,19 @@ namespace ts {
         //!
         bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Send several consecutive messages of the same size to the default destination address and port.
+        //! With the Buffer API, all messages are passed at once to libsrt. With the Message API, libsrt
+        //! has no multi-message send call and each message is passed in sequence. In both cases, the
+        //! internal bookkeeping (sent bytes, periodic statistics) is done once per call.
+        //! @param [in] data Address of the first message to send. All messages are contiguous in memory.
+        //! @param [in] message_size Size in bytes of each message to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendMessages(const void* data, size_t message_size, size_t count, Report& report = CERR);
+
         //!
         //! Receive a message.
         //! @param [out] data Address of the buffer for the received message.
@@ -164,6 +214,19 @@ namespace ts {
         //!
         bool receive(void* data, size_t max_size, size_t& ret_size, cn::microseconds& timestamp, Report& report = CERR);
 
+        //!
+        //! Receive a message with timestamp, only if one is immediately available, without waiting.
+        //! This is typically used after receive() to get all messages which were received in the meantime.
+        //! In live mode, a message is available when its time to play has come.
+        //! @param [out] data Address of the buffer for the received message.
+        //! @param [in] max_size Size in bytes of the reception buffer.
+        //! @param [out] ret_size Size in bytes of the received message. Will never be larger than @a max_size.
+        //! @param [out] timestamp Source timestamp in micro-seconds, negative if not available.
+        //! @param [in,out] report Where to report error.
+        //! @return True when a message was received, false when no message is immediately available or on error.
+        //!
+        bool receiveNoWait(void* data, size_t max_size, size_t& ret_size, cn::microseconds& timestamp, Report& report = CERR);
+
         //!
         //! Get the total number of sent bytes since the socket was opened.
         //! @return The total number of sent bytes since the socket was opened.
@@ -191,6 +254,14 @@ namespace ts {
         //!
         bool reportStatistics(SRTStatMode mode = SRTStatMode::ALL, Report& report = CERR);
 
+        //!
+        //! Get a summary of the statistics about the socket.
+        //! @param [out] stats Returned statistics.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool getStatistics(SRTStatistics& stats, Report& report = CERR);
+
         //!
         //! Get SRT option.
         //! @param [in] optName Option name as enumeration. The possible values for @a optName are given
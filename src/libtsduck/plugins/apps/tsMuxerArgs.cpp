@@ -114,6 +114,14 @@ void ts::MuxerArgs::defineArgs(Args& args)
               u"In case of initial restart error, wait the specified delay before retrying. "
               u"The default is " + UString::Chrono(DEFAULT_RESTART_DELAY, true) + u".");
 
+    args.option(u"schedule");
+    args.help(u"schedule",
+              u"Schedule the input packets according to the estimated bitrate of each input and the transport "
+              u"buffer model of each PID, to avoid bursts in the output stream. "
+              u"The packets with a PCR have priority and their PCR is restamped at their actual insertion point. "
+              u"The null packets from the input plugins are removed and replaced by useful packets from other inputs. "
+              u"By default, the packets are taken from the input plugins in round-robin order, as soon as they are available.");
+
     args.option(u"sdt", 0, TableScopeEnum());
     args.help(u"sdt", u"type",
               u"Specify which type of SDT shall be merged in the output stream. The default is \"actual\".");
@@ -155,6 +163,7 @@ bool ts::MuxerArgs::loadArgs(DuckContext& duck, Args& args)
     inputOnce = args.present(u"terminate");
     outputOnce = args.present(u"terminate-with-output");
     ignoreConflicts = args.present(u"ignore-conflicts");
+    schedule = args.present(u"schedule");
     args.getValue(outputBitRate, u"bitrate");
     args.getChronoValue(inputRestartDelay, u"restart-delay", DEFAULT_RESTART_DELAY);
     outputRestartDelay = inputRestartDelay;
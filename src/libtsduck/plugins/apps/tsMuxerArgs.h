@@ -40,6 +40,7 @@ namespace ts {
         bool                inputOnce = false;                             //!< Terminate when all input plugins complete, do not restart plugins.
         bool                outputOnce = false;                            //!< Terminate when the output plugin fails, do not restart.
         bool                ignoreConflicts = false;                       //!< Ignore PID or service conflicts (inconsistent stream).
+        bool                schedule = false;                              //!< Schedule input packets by input bitrate and PID buffer model, remove input stuffing.
         cn::milliseconds    inputRestartDelay = DEFAULT_RESTART_DELAY;     //!< When an input start fails, retry after that delay.
         cn::milliseconds    outputRestartDelay = DEFAULT_RESTART_DELAY;    //!< When the output start fails, retry after that delay.
         cn::microseconds    cadence = DEFAULT_CADENCE;                     //!< Internal polling cadence in microseconds.
@@ -35,6 +35,11 @@ ts::TSPControlCommand::TSPControlCommand(Report& report) :
 
     arg = command(u"list", u"List all running plugins", u"[options]", flags);
 
+    arg = command(u"statistics", u"Display instrumentation data of all plugins", u"[options]", flags);
+    arg->setIntro(u"Display instrumentation data of all plugins: packet rate, CPU time, time waiting for packets "
+                  u"versus processing them, buffer occupancy and per-packet latency percentiles. "
+                  u"The tsp command must have been started with option --instrumentation.");
+
     arg = command(u"suspend", u"Suspend a plugin", u"[options] plugin-index", flags);
     arg->setIntro(u"Suspend a plugin. When a packet processing plugin is suspended, "
                   u"the TS packets are directly passed from the previous to the next plugin, "
@@ -11,7 +11,9 @@
 #include "tstspOutputExecutor.h"
 #include "tstspProcessorExecutor.h"
 #include "tstspControlServer.h"
+#include "tstspLatencyTrace.h"
 #include "tsFatal.h"
+#include "tsjsonObject.h"
 
 
 //----------------------------------------------------------------------------
@@ -74,6 +76,42 @@ void ts::TSProcessor::cleanupInternal()
         delete _metadata_buffer;
         _metadata_buffer = nullptr;
     }
+
+    // Deallocate latency trace buffer.
+    if (_trace != nullptr) {
+        delete _trace;
+        _trace = nullptr;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report instrumentation data at end of processing.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessor::reportInstrumentation()
+{
+    if (!_args.instrumentation || _input == nullptr) {
+        return;
+    }
+
+    json::Object root;
+    size_t index = 0;
+    tsp::PluginExecutor* proc = _input;
+    do {
+        tsp::PluginExecutor::Telemetry tel;
+        proc->getTelemetry(tel);
+        _report.verbose(u"instrumentation: %d: %s: %s", index, proc->pluginName(), tel.summary());
+        json::Value& jplugin(root.query(u"plugins[]", true));
+        jplugin.add(u"index", index++);
+        jplugin.add(u"type", PluginTypeNames().name(proc->plugin()->type()));
+        jplugin.add(u"name", proc->pluginName());
+        tel.toJSON(jplugin);
+    } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
+
+    if (!_args.instrumentation_json.empty()) {
+        root.save(_args.instrumentation_json, 2, true, _report);
+    }
 }
 
 
@@ -170,6 +208,17 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
         CheckNonNull(_metadata_buffer);
 
+        // Optional latency trace buffer, shared by all executors.
+        if (!_args.latency_trace.empty()) {
+            _trace = new tsp::LatencyTrace(_args.latency_trace_size, _args.plugins.size() + 2, _packet_buffer->count(), _args.latency_trace_interval);
+            CheckNonNull(_trace);
+            proc = _input;
+            do {
+                _trace->setPluginName(proc->pluginIndex(), proc->pluginName());
+                proc->setLatencyTrace(_trace);
+            } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
+        }
+
         // End of locked section.
     }
 
@@ -263,6 +312,15 @@ void ts::TSProcessor::waitForTermination()
         // Make sure the control server thread is terminated before deleting plugins.
         _control->close();
 
+        // Report instrumentation data before deleting plugins.
+        reportInstrumentation();
+
+        // Save the latency trace.
+        if (_trace != nullptr) {
+            _report.verbose(u"sampled end-to-end packet residence time (us): %s", _trace->residence().summary());
+            _trace->save(_args.latency_trace, _report);
+        }
+
         // Deallocate all plugins and plugin executor
         cleanupInternal();
     }
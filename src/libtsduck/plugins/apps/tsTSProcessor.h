@@ -24,6 +24,7 @@ namespace ts {
         class InputExecutor;
         class OutputExecutor;
         class ControlServer;
+        class LatencyTrace;
     }
     //! @endcond
 
@@ -96,8 +97,12 @@ namespace ts {
         tsp::ControlServer*   _control = nullptr;          // TSP control command server thread.
         PacketBuffer*         _packet_buffer = nullptr;    // Global TS packet buffer.
         PacketMetadataBuffer* _metadata_buffer = nullptr;  // Global packet metabata buffer.
+        tsp::LatencyTrace*    _trace = nullptr;            // Packet-path latency trace buffer.
 
         // Deallocate and cleanup internal resources.
         void cleanupInternal();
+
+        // Report instrumentation data at end of processing.
+        void reportInstrumentation();
     };
 }
@@ -114,6 +114,41 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"a valid bitrate value from the beginning. "
               u"The default initial load is half the size of the global buffer.");
 
+    args.option(u"instrumentation");
+    args.help(u"instrumentation",
+              u"Collect instrumentation data in all plugins: CPU time of each plugin thread, packet rate, "
+              u"time waiting for packets versus processing them, occupancy of the buffer between plugins "
+              u"and distribution of the per-packet latency through each plugin. "
+              u"The instrumentation data can be queried using the tspcontrol command 'statistics'. "
+              u"When --verbose is specified, they are also displayed at end of processing.");
+
+    args.option(u"instrumentation-json", 0, Args::FILENAME);
+    args.help(u"instrumentation-json", u"filename",
+              u"Save the instrumentation data of all plugins in the specified JSON file at end of processing. "
+              u"If the file name is \"-\", the JSON data are written on the standard output. "
+              u"This option implies --instrumentation.");
+
+    args.option(u"latency-trace", 0, Args::FILENAME);
+    args.help(u"latency-trace", u"filename",
+              u"Trace the latency of packets through the chain of plugins and save the trace in the specified "
+              u"file at end of processing, in Chrome trace JSON format, as used by chrome://tracing or Perfetto. "
+              u"The ingress time of each packet is recorded when it is received by the input plugin. "
+              u"At most once per sampling interval (see --latency-trace-interval), when a plugin passes a "
+              u"batch of packets to the next one, a checkpoint event is recorded with the age of the first "
+              u"packet in the batch. The samples of the output plugin give the end-to-end residence time. "
+              u"If the file name is \"-\", the trace is written on the standard output.");
+
+    args.option<cn::milliseconds>(u"latency-trace-interval");
+    args.help(u"latency-trace-interval",
+              u"With --latency-trace, specify the minimum interval between two checkpoint events of the same plugin. "
+              u"The default is " + UString::Chrono(DEFAULT_LATENCY_TRACE_INTERVAL) + u".");
+
+    args.option(u"latency-trace-size", 0, Args::POSITIVE);
+    args.help(u"latency-trace-size", u"count",
+              u"With --latency-trace, specify the maximum number of events in the trace buffer. "
+              u"When the buffer is full, the oldest events are overwritten. "
+              u"The default is " + UString::Decimal(DEFAULT_LATENCY_TRACE_SIZE) + u" events.");
+
     args.option(u"log-plugin-index");
     args.help(u"log-plugin-index",
               u"In log messages, add the plugin index to the plugin name. "
@@ -168,6 +203,11 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
 {
     app_name = args.appName();
     log_plugin_index = args.present(u"log-plugin-index");
+    args.getPathValue(instrumentation_json, u"instrumentation-json");
+    instrumentation = args.present(u"instrumentation") || !instrumentation_json.empty();
+    args.getPathValue(latency_trace, u"latency-trace");
+    args.getIntValue(latency_trace_size, u"latency-trace-size", DEFAULT_LATENCY_TRACE_SIZE);
+    args.getChronoValue(latency_trace_interval, u"latency-trace-interval", DEFAULT_LATENCY_TRACE_INTERVAL);
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
     args.getValue(fixed_bitrate, u"bitrate", 0);
     args.getChronoValue(bitrate_adj, u"bitrate-adjust-interval", DEFAULT_BITRATE_INTERVAL);
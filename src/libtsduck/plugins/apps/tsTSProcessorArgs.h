@@ -30,6 +30,11 @@ namespace ts {
         UString           app_name {};              //!< Application name, for help messages.
         bool              ignore_jt = false;        //!< Ignore "joint termination" options in plugins.
         bool              log_plugin_index = false; //!< Log plugin index with plugin name.
+        bool              instrumentation = false;  //!< Collect instrumentation data in all plugin executors.
+        fs::path          instrumentation_json {};  //!< JSON file where the instrumentation data are saved at end of processing.
+        fs::path          latency_trace {};         //!< Chrome trace JSON file for packet-path latency tracing, empty if none.
+        size_t            latency_trace_size = DEFAULT_LATENCY_TRACE_SIZE; //!< Maximum number of events in the latency trace buffer.
+        cn::milliseconds  latency_trace_interval = DEFAULT_LATENCY_TRACE_INTERVAL; //!< Latency trace sampling interval per plugin.
         size_t            ts_buffer_size = DEFAULT_BUFFER_SIZE; //!< Size in bytes of the global TS packet buffer.
         size_t            max_flush_pkt = 0;        //!< Max processed packets before flush.
         size_t            max_input_pkt = 0;        //!< Max packets per input operation.
@@ -60,6 +65,8 @@ namespace ts {
         static constexpr PacketCounter DEFAULT_INIT_BITRATE_PKT_INTERVAL = 1000;  //!< Default initial bitrate reevaluation interval, in packets.
         static constexpr cn::milliseconds DEFAULT_BITRATE_INTERVAL = cn::milliseconds(5000);  //!< Default bitrate adjustment interval, in milliseconds.
         static constexpr cn::milliseconds DEFAULT_CONTROL_TIMEOUT = cn::milliseconds(5000);   //!< Default control command reception timeout, in milliseconds.
+        static constexpr size_t DEFAULT_LATENCY_TRACE_SIZE = 100000;              //!< Default maximum number of events in the latency trace buffer.
+        static constexpr cn::milliseconds DEFAULT_LATENCY_TRACE_INTERVAL = cn::milliseconds(10);  //!< Default latency trace sampling interval per plugin.
 
         //!
         //! Constructor.
@@ -151,11 +151,37 @@ ts::BitRateConfidence ts::AbstractDatagramInputPlugin::getBitrateConfidence()
 }
 
 
+//----------------------------------------------------------------------------
+// Default implementation: no datagram is immediately available.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramInputPlugin::receiveDatagramNoWait(uint8_t*, size_t, size_t& ret_size, cn::microseconds&, TimeSource&)
+{
+    ret_size = 0;
+    return false;
+}
+
+
 //----------------------------------------------------------------------------
 // Input method
 //----------------------------------------------------------------------------
 
 size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    // Wait for the first datagram. Then, fill the buffer with the datagrams which are immediately
+    // available, if the subclass supports it. This reduces the number of receive() calls at high bitrates.
+    size_t count = receivePackets(buffer, pkt_data, max_packets, true);
+    while (count > 0 && count < max_packets) {
+        const size_t more = receivePackets(buffer + count, pkt_data == nullptr ? nullptr : pkt_data + count, max_packets - count, false);
+        if (more == 0) {
+            break;
+        }
+        count += more;
+    }
+    return count;
+}
+
+size_t ts::AbstractDatagramInputPlugin::receivePackets(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets, bool wait)
 {
     cn::microseconds timestamp = cn::microseconds(-1);
     TimeSource timesource = TimeSource::UNDEFINED;
@@ -169,7 +195,9 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
 
         // Wait for a datagram message
         size_t insize = 0;
-        if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize, timestamp, timesource)) {
+        if (wait ? !receiveDatagram(_inbuf.data(), _inbuf.size(), insize, timestamp, timesource) :
+                   !receiveDatagramNoWait(_inbuf.data(), _inbuf.size(), insize, timestamp, timesource))
+        {
             return 0;
         }
 
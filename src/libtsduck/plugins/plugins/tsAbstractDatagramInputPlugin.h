@@ -83,6 +83,20 @@ namespace ts {
         //!
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource) = 0;
 
+        //!
+        //! Receive a datagram message, only if one is immediately available, without waiting.
+        //! After receiving a datagram with receiveDatagram(), the datagrams which are immediately
+        //! available are received using this method, in the same input buffer of packets.
+        //! The default implementation returns false, meaning one datagram per input buffer.
+        //! @param [out] buffer Address of the buffer for the received message.
+        //! @param [in] buffer_size Size in bytes of the reception buffer.
+        //! @param [out] ret_size Size in bytes of the received message. Will never be larger than @a buffer_size.
+        //! @param [out] timestamp Receive timestamp in micro-seconds or -1 if not available.
+        //! @param [out] timesource Type of timestamp.
+        //! @return True when a datagram was received, false when no datagram is immediately available or on error.
+        //!
+        virtual bool receiveDatagramNoWait(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource);
+
     private:
         // Order of priority for input timestamps. SYSTEM means lower layer from subclass (UDP, SRT, etc).
         enum TimePriority {RTP_SYSTEM_TSP, SYSTEM_RTP_TSP, RTP_TSP, SYSTEM_TSP, TSP_ONLY};
@@ -110,5 +124,8 @@ namespace ts {
         size_t        _packet_size = 0;     // Packet size (188 or 204).
         ByteBlock     _inbuf {};            // Input buffer
         TSPacketMetadataVector _mdata {};   // Metadata for packets in _inbuf
+
+        // Receive packets from the input buffer or from one new datagram, waiting for it or not.
+        size_t receivePackets(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets, bool wait);
     };
 }
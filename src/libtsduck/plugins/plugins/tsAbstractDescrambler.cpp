@@ -12,6 +12,9 @@
 // Stack usage required by this module in the ECM deciphering thread.
 #define ECM_THREAD_STACK_OVERHEAD (16  * 1024)
 
+// Default packet window size when descrambling by batches of packets.
+#define DEFAULT_PACKET_WINDOW 1024
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -55,6 +58,21 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     help(u"swap-cw",
         u"Swap even and odd control words from the ECM's. "
         u"Useful when a crazy ECMG inadvertently swapped the CW before generating the ECM.");
+
+    option(u"threads", 0, UNSIGNED);
+    help(u"threads",
+         u"Number of additional threads which descramble packets in parallel with the plugin thread. "
+         u"Implies descrambling by batches of packets, see --packet-window. "
+         u"The default is zero, meaning that all packets are descrambled by the plugin thread.");
+
+    option(u"packet-window", 0, POSITIVE);
+    help(u"packet-window",
+         u"Descramble packets by batches, inside a window of the specified number of packets. "
+         u"In each window, the packets which use the same control words are descrambled at once, "
+         u"grouped by parity, and distributed over the threads when --threads is specified. "
+         u"The packets are never reordered. "
+         u"By default, each packet is individually descrambled, unless --threads is specified, "
+         u"in which case the default window size is " + UString::Decimal(DEFAULT_PACKET_WINDOW) + u" packets.");
 }
 
 
@@ -69,6 +87,9 @@ bool ts::AbstractDescrambler::getOptions()
     _service.set(value(u""));
     _synchronous = present(u"synchronous") || !tsp->realtime();
     _swap_cw = present(u"swap-cw");
+    getIntValue(_threads, u"threads", 0);
+    getIntValue(_window_size, u"packet-window", DEFAULT_PACKET_WINDOW);
+    _batch_mode = _threads > 0 || present(u"packet-window");
     getIntValues(_pids, u"pid");
     if (!duck.loadArgs(*this) || !_scrambling.loadArgs(duck, *this)) {
         return false;
@@ -123,11 +144,19 @@ bool ts::AbstractDescrambler::start()
     _scrambled_streams.clear();
     _demux.reset();
 
+    _batch.clear();
+    _failed_pkts.clear();
+
     // Initialize the scrambling engine.
     if (!_scrambling.start()) {
         return false;
     }
 
+    // Start the descrambling threads, if any.
+    if (!_pool.start(_threads)) {
+        return false;
+    }
+
     // In asynchronous mode, create a thread for ECM processing
     if (_need_ecm && !_synchronous) {
         _stop_thread = false;
@@ -159,6 +188,7 @@ bool ts::AbstractDescrambler::stop()
         _ecm_thread.waitForTermination();
     }
 
+    _pool.stop();
     _scrambling.stop();
     return true;
 }
@@ -172,6 +202,11 @@ void ts::AbstractDescrambler::handlePMT(const PMT& pmt, PID)
 {
     debug(u"PMT: service 0x%X, %d elementary streams", pmt.service_id, pmt.streams.size());
 
+    // The scrambling type may change, descramble pending packets with the previous one.
+    if (!flushAllBatches()) {
+        _abort = true;
+    }
+
     // Default scrambling is DVB-CSA2.
     uint8_t scrambling_type = SCRAMBLING_DVB_CSA2;
 
@@ -355,6 +390,17 @@ void ts::AbstractDescrambler::processECM(ECMStream& estream)
         debug(u"odd CW:  %s", UString::Dump(cw_odd.cw, UString::SINGLE_LINE));
     }
 
+    // In asynchronous mode, compute the key schedules of new CW's in this thread, not in the packet
+    // processing one. The CW's in the ECM stream are only modified by this thread, no mutex needed.
+    if (ok && !_synchronous) {
+        if (!cw_even.cw.empty() && cw_even.cw != estream.cw_even.cw && cw_even.scrambling == estream.scrambling.scramblingType()) {
+            estream.scrambling.prepareCW(cw_even.cw, SC_EVEN_KEY);
+        }
+        if (!cw_odd.cw.empty() && cw_odd.cw != estream.cw_odd.cw && cw_odd.scrambling == estream.scrambling.scramblingType()) {
+            estream.scrambling.prepareCW(cw_odd.cw, SC_ODD_KEY);
+        }
+    }
+
     // In asynchronous mode, relock the mutex.
     if (!_synchronous) {
         _mutex.lock();
@@ -452,7 +498,7 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     // If there is a user-specified list of PID's, we don't manage a service
     // and there is nothing else to do.
     if (_pids.any()) {
-        return !_pids.test(pid) || _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return !_pids.test(pid) || descramble(_scrambling, _batch, pkt) ? TSP_OK : TSP_END;
     }
 
     // Filter sections to locate the service and grab ECM's.
@@ -474,7 +520,7 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
     // Without ECM's, we descramble using fixed control words.
     if (!_need_ecm) {
-        return _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return descramble(_scrambling, _batch, pkt) ? TSP_OK : TSP_END;
     }
 
     // Get PID context. If the PID is not known as a scrambled PID,
@@ -504,6 +550,11 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     if ((scv == SC_EVEN_KEY && pecm->new_cw_even) || (scv == SC_ODD_KEY && pecm->new_cw_odd)) {
 
         // A new CW was deciphered.
+        // In batch mode, the pending packets of this ECM stream use the previous CW.
+        if (!flushBatch(pecm->scrambling, pecm->batch)) {
+            return TSP_END;
+        }
+
         // In asynchronous mode, the CW are accessed under mutex protection.
         if (!_synchronous) {
             _mutex.lock();
@@ -527,5 +578,100 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     }
 
     // Descramble the packet payload.
-    return pecm->scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+    return descramble(pecm->scrambling, pecm->batch, pkt) ? TSP_OK : TSP_END;
+}
+
+
+//----------------------------------------------------------------------------
+// Get requested window size, called between start() and first packet.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::getPacketWindowSize()
+{
+    // Without batch mode, use individual packet mode.
+    return _batch_mode ? _window_size : 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method, used in batch mode.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::processPacketWindow(TSPacketWindow& win)
+{
+    // Analyze all packets using processPacket(). The packets to descramble are
+    // accumulated in batches, one per set of control words.
+    size_t count = ProcessorPlugin::processPacketWindow(win);
+
+    // Descramble all remaining batches in the window.
+    flushAllBatches();
+
+    // In case of descrambling error, stop before the first packet of the first failed batch.
+    if (!_failed_pkts.empty()) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* mdata = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            if (win.get(i, pkt, mdata) && std::find(_failed_pkts.begin(), _failed_pkts.end(), pkt) != _failed_pkts.end()) {
+                count = i;
+                break;
+            }
+        }
+        _failed_pkts.clear();
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble a packet, immediately or later in batch mode.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::descramble(TSScrambling& scrambling, std::vector<TSPacket*>& batch, TSPacket& pkt)
+{
+    if (_batch_mode) {
+        batch.push_back(&pkt);
+        return true;
+    }
+    else {
+        return scrambling.decrypt(pkt);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble a batch of packets with the same control words.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::flushBatch(TSScrambling& scrambling, std::vector<TSPacket*>& batch)
+{
+    if (batch.empty()) {
+        return true;
+    }
+
+    // Remember the first packet of the batch, in window order, in case of error.
+    TSPacket* const first = batch.front();
+
+    // Without fixed CW, the two parities use independent keys. The packets are independently
+    // descrambled in place, their order in the batch does not matter. Group them by parity
+    // to get the largest possible multi-packet cipher calls. With fixed control words, the
+    // order of parity changes selects the key and shall be preserved.
+    if (!scrambling.hasFixedCW()) {
+        std::stable_partition(batch.begin(), batch.end(), [](const TSPacket* p) { return p->getScrambling() == SC_EVEN_KEY; });
+    }
+
+    const bool success = _pool.decrypt(scrambling, batch.data(), batch.size());
+    if (!success) {
+        _failed_pkts.push_back(first);
+    }
+    batch.clear();
+    return success;
+}
+
+bool ts::AbstractDescrambler::flushAllBatches()
+{
+    bool success = flushBatch(_scrambling, _batch);
+    for (auto& it : _ecm_streams) {
+        success = flushBatch(it.second->scrambling, it.second->batch) && success;
+    }
+    return success;
 }
@@ -16,6 +16,7 @@
 #include "tsSection.h"
 #include "tsServiceDiscovery.h"
 #include "tsTSScrambling.h"
+#include "tsTSScramblingPool.h"
 #include "tsThread.h"
 
 namespace ts {
@@ -37,6 +38,8 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     protected:
         //!
@@ -202,6 +205,7 @@ namespace ts {
             CWData        cw_even {};           // Last valid CW (even)
             CWData        cw_odd {};            // Last valid CW (odd)
             // -- end of protected area --
+            std::vector<TSPacket*> batch {};    // Packets to descramble in current packet window (batch mode).
         };
 
         using ECMStreamPtr = std::shared_ptr<ECMStream>;
@@ -234,12 +238,24 @@ namespace ts {
         // Analyze a list of descriptors from the PMT, looking for ECM PID's
         void analyzeDescriptors(const DescriptorList& dlist, std::set<PID>& ecm_pids, uint8_t& scrambling);
 
+        // Descramble a packet using a descrambler, immediately or later in batch mode.
+        bool descramble(TSScrambling& scrambling, std::vector<TSPacket*>& batch, TSPacket& pkt);
+
+        // Descramble a batch of packets with the same descrambler (same control words).
+        bool flushBatch(TSScrambling& scrambling, std::vector<TSPacket*>& batch);
+
+        // Descramble all pending batches of packets.
+        bool flushAllBatches();
+
         // Abstract descrambler private data.
         bool                    _use_service = false;         // Descramble a service (ie. not a specific list of PID's).
         bool                    _need_ecm = false;            // We need to get control words from ECM's.
         bool                    _abort = false;               // Error, abort asap.
         bool                    _synchronous = false;         // Synchronous ECM deciphering.
         bool                    _swap_cw = false;             // Swap even/odd CW from ECM.
+        bool                    _batch_mode = false;          // Descramble packets by batches, in a packet window.
+        size_t                  _threads = 0;                 // Number of additional descrambling threads.
+        size_t                  _window_size = 0;             // Packet window size in batch mode.
         TSScrambling            _scrambling {*this};          // Default descrambling (used with fixed control words).
         PIDSet                  _pids {};                     // Explicit PID's to descramble.
         ServiceDiscovery        _service {duck, this};        // Service to descramble (by name, id or none).
@@ -247,6 +263,9 @@ namespace ts {
         SectionDemux            _demux {duck, nullptr, this}; // Section demux to extract ECM's.
         ECMStreamMap            _ecm_streams {};              // ECM streams, indexed by PID.
         ScrambledStreamMap      _scrambled_streams {};        // Scrambled streams, indexed by PID.
+        TSScramblingPool        _pool {*this};                // Pool of descrambling threads.
+        std::vector<TSPacket*>  _batch {};                    // Packets to descramble with _scrambling (batch mode).
+        std::vector<TSPacket*>  _failed_pkts {};              // First packets of batches which failed to be descrambled.
         std::mutex              _mutex {};                    // Exclusive access to protected areas
         std::condition_variable _ecm_to_do {};                // Notify thread to process ECM.
         ECMThread               _ecm_thread {this};           // Thread which deciphers ECM's.
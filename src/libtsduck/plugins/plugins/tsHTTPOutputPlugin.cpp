@@ -9,10 +9,14 @@
 #include "tsHTTPOutputPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsVersionInfo.h"
+#include "tsNullReport.h"
+#include "tsReportBuffer.h"
 
 TS_REGISTER_OUTPUT_PLUGIN(u"http", ts::HTTPOutputPlugin);
 
-#define SERVER_BACKLOG  1  // One connection at a time
+#define SERVER_BACKLOG      1  // One connection at a time
+#define CONCURRENT_BACKLOG 16  // Pending connections in concurrent mode
+#define MIN_MAX_LAG      1024  // Minimum value for --max-lag
 
 
 //----------------------------------------------------------------------------
@@ -24,8 +28,9 @@ ts::HTTPOutputPlugin::HTTPOutputPlugin(TSP* tsp_) :
 {
     setIntro(u"The implemented HTTP server is rudimentary. "
              u"No SSL/TLS is supported, only the http: protocol is accepted.\n\n"
-             u"Only one client is accepted at a time. "
-             u"By default, tsp terminates if the client disconnects (see option --multiple-clients).\n\n"
+             u"By default, only one client is accepted at a time and "
+             u"tsp terminates if the client disconnects (see option --multiple-clients). "
+             u"With option --max-clients, several clients are concurrently served.\n\n"
              u"The request \"GET /\" returns the transport stream content. "
              u"All other requests are considered as invalid (see option --ignore-bad-request). "
              u"There is no Content-Length response header since the size of the returned TS is unknown. "
@@ -39,6 +44,21 @@ ts::HTTPOutputPlugin::HTTPOutputPlugin(TSP* tsp_) :
     help(u"ignore-bad-request",
          u"Ignore invalid HTTP requests and unconditionally send the transport stream.");
 
+    option(u"max-clients", 0, POSITIVE);
+    help(u"max-clients",
+         u"Maximum number of concurrent clients. The default is one client at a time. "
+         u"With more than one client, all connected clients receive the same transport stream. "
+         u"The packets are never blocked by the clients: "
+         u"they are dropped when no client is connected and a client which is too slow is disconnected (see option --max-lag). "
+         u"The server continues after the disconnection of any client, as with option --multiple-clients.");
+
+    option(u"max-lag", 0, POSITIVE);
+    help(u"max-lag",
+         u"With --max-clients, specify the maximum lag of a client in TS packets. "
+         u"A client which is late by more than this number of packets is disconnected. "
+         u"This is also the size of the buffer of packets which is shared by all clients. "
+         u"The default is " + UString::Decimal(DEFAULT_MAX_LAG) + u" packets.");
+
     option(u"multiple-clients", 'm');
     help(u"multiple-clients",
          u"Specifies that the server handle multiple clients, one after the other. "
@@ -52,7 +72,7 @@ ts::HTTPOutputPlugin::HTTPOutputPlugin(TSP* tsp_) :
     help(u"server",
          u"Specifies the local TCP port on which the plugin listens for incoming HTTP connections. "
          u"This option is mandatory. "
-         u"This plugin accepts only one HTTP connection at a time. "
+         u"Without --max-clients, this plugin accepts only one HTTP connection at a time. "
          u"When present, the optional address shall specify a local IP address or host name. "
          u"By default, the server listens on all local interfaces.");
 }
@@ -69,6 +89,12 @@ bool ts::HTTPOutputPlugin::getOptions()
     _ignore_bad_request = present(u"ignore-bad-request");
     getSocketValue(_server_address, u"server");
     getIntValue(_tcp_buffer_size, u"buffer-size");
+    getIntValue(_max_clients, u"max-clients", 1);
+    getIntValue(_max_lag, u"max-lag", DEFAULT_MAX_LAG);
+    if (_max_lag < MIN_MAX_LAG) {
+        error(u"--max-lag must be at least %d packets", MIN_MAX_LAG);
+        return false;
+    }
     return true;
 }
 
@@ -85,11 +111,23 @@ bool ts::HTTPOutputPlugin::start()
     if (!_server.reusePort(_reuse_port, *this) ||
         (_tcp_buffer_size > 0 && !_server.setSendBufferSize(_tcp_buffer_size, *this)) ||
         !_server.bind(_server_address, *this) ||
-        !_server.listen(SERVER_BACKLOG, *this))
+        !_server.listen(concurrent() ? CONCURRENT_BACKLOG : SERVER_BACKLOG, *this))
     {
         _server.close(*this);
         return false;
     }
+
+    // In concurrent mode, the clients are accepted in a separate thread.
+    if (concurrent()) {
+        _ring.resize(_max_lag);
+        _write_index = 0;
+        _terminate = false;
+        if (!_acceptor.start()) {
+            error(u"cannot start client acceptor thread");
+            _server.close(*this);
+            return false;
+        }
+    }
     return true;
 }
 
@@ -100,6 +138,28 @@ bool ts::HTTPOutputPlugin::start()
 
 bool ts::HTTPOutputPlugin::stop()
 {
+    if (concurrent()) {
+        // Request termination to all threads.
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _terminate = true;
+            _got_packets.notify_all();
+            // Interrupt clients which wait for a request or send data.
+            for (const auto& cl : _clients) {
+                if (!cl->done) {
+                    cl->conn.disconnect(NULLREP);
+                }
+            }
+        }
+        // Closing the server socket interrupts the acceptor thread.
+        _server.close(*this);
+        _acceptor.waitForTermination();
+        // Deallocating a client waits for the termination of its thread.
+        _clients.clear();
+        _ring.clear();
+        return true;
+    }
+
     if (_client.isConnected()) {
         _client.disconnect(*this);
     }
@@ -117,6 +177,10 @@ bool ts::HTTPOutputPlugin::stop()
 
 bool ts::HTTPOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
 {
+    if (concurrent()) {
+        return sendConcurrent(buffer, packet_count);
+    }
+
     // Loop over multiple clients if necessary.
     for (;;) {
         // Establish one client connection, if none is connected.
@@ -131,7 +195,7 @@ bool ts::HTTPOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata*
             verbose(u"client connected from %s", client_address);
 
             // Initialize the session, process request, send response headers.
-            if (startSession()) {
+            if (startSession(_client)) {
                 // Session initialized, we can start sending data.
                 break;
             }
@@ -163,12 +227,12 @@ bool ts::HTTPOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata*
 // Send a response header.
 //----------------------------------------------------------------------------
 
-bool ts::HTTPOutputPlugin::sendResponseHeader(const std::string& line)
+bool ts::HTTPOutputPlugin::sendResponseHeader(TCPConnection& client, const std::string& line)
 {
     debug(u"response header: %s", line);
     std::string data(line);
     data += "\r\n";
-    return _client.send(data.data(), data.size(), *this);
+    return client.send(data.data(), data.size(), *this);
 }
 
 
@@ -176,7 +240,7 @@ bool ts::HTTPOutputPlugin::sendResponseHeader(const std::string& line)
 // Process request headers, send response headers.
 //----------------------------------------------------------------------------
 
-bool ts::HTTPOutputPlugin::startSession()
+bool ts::HTTPOutputPlugin::startSession(TCPConnection& client)
 {
     UString request;
     UString header(1, SPACE); // Need an initial non-empty value
@@ -189,7 +253,7 @@ bool ts::HTTPOutputPlugin::startSession()
         const size_t previous = data.size();
         size_t ret_size = 0;
         data.resize(previous + 512);
-        if (!_client.receive(data.data() + previous, data.size() - previous, ret_size, nullptr, *this)) {
+        if (!client.receive(data.data() + previous, data.size() - previous, ret_size, nullptr, *this)) {
             return false; // receive error
         }
         data.resize(previous + ret_size);
@@ -221,17 +285,193 @@ bool ts::HTTPOutputPlugin::startSession()
 
     if (!valid && !_ignore_bad_request) {
         error(u"invalid client request: %s", request);
-        sendResponseHeader(is_get ? "HTTP/1.1 404 Not Found" : "HTTP/1.1 400 Bad Request");
-        sendResponseHeader("");
+        sendResponseHeader(client, is_get ? "HTTP/1.1 404 Not Found" : "HTTP/1.1 400 Bad Request");
+        sendResponseHeader(client, "");
         return false;
     }
     else {
         // Send the HTTP response headers.
-        sendResponseHeader("HTTP/1.1 200 OK");
-        sendResponseHeader("Server: TSDuck/" TS_VERSION_STRING);
-        sendResponseHeader("Content-Type: video/mp2t");
-        sendResponseHeader("Connection: close");
-        sendResponseHeader("");
+        sendResponseHeader(client, "HTTP/1.1 200 OK");
+        sendResponseHeader(client, "Server: TSDuck/" TS_VERSION_STRING);
+        sendResponseHeader(client, "Content-Type: video/mp2t");
+        sendResponseHeader(client, "Connection: close");
+        sendResponseHeader(client, "");
         return true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Send packets in concurrent mode.
+//----------------------------------------------------------------------------
+
+bool ts::HTTPOutputPlugin::sendConcurrent(const TSPacket* buffer, size_t packet_count)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Packets which are older than this index will be overwritten.
+    const uint64_t end_index = _write_index + packet_count;
+    const uint64_t min_index = end_index > _ring.size() ? end_index - _ring.size() : 0;
+
+    // Disconnect the clients which are too late. This interrupts any current send operation.
+    for (const auto& cl : _clients) {
+        if (cl->streaming && !cl->dropped && cl->cursor < min_index) {
+            warning(u"client %s is too slow, disconnecting", cl->address);
+            cl->dropped = true;
+            cl->conn.disconnect(NULLREP);
+        }
+    }
+
+    // The interrupted send operations may still read the packets which are about to be overwritten.
+    // Wait until the dropped clients have left their send operation. The other clients do not read
+    // packets before min_index.
+    _send_done.wait(lock, [this]() {
+        return std::none_of(_clients.begin(), _clients.end(), [](const std::unique_ptr<Client>& cl) { return cl->dropped && cl->sending; });
+    });
+
+    // Copy the packets in the ring. Only the last packets are kept if there are more packets than the ring size.
+    if (packet_count > _ring.size()) {
+        buffer += packet_count - _ring.size();
+        _write_index += packet_count - _ring.size();
+        packet_count = _ring.size();
+    }
+    while (packet_count > 0) {
+        const size_t first = size_t(_write_index % _ring.size());
+        const size_t count = std::min(packet_count, _ring.size() - first);
+        TSPacket::Copy(&_ring[first], buffer, count);
+        buffer += count;
+        packet_count -= count;
+        _write_index += count;
+    }
+
+    // Wake up all clients.
+    _got_packets.notify_all();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Thread accepting new clients in concurrent mode.
+//----------------------------------------------------------------------------
+
+ts::HTTPOutputPlugin::Acceptor::Acceptor(HTTPOutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::HTTPOutputPlugin::Acceptor::~Acceptor()
+{
+    waitForTermination();
+}
+
+void ts::HTTPOutputPlugin::Acceptor::main()
+{
+    _plugin->debug(u"client acceptor thread started");
+
+    // Accept errors are buffered, an error is normal when the server is closed by stop().
+    ReportBuffer<ThreadSafety::None> error(_plugin->maxSeverity());
+
+    for (;;) {
+        // Wait for a new incoming client.
+        auto client = std::make_unique<Client>(_plugin);
+        if (!_plugin->_server.accept(client->conn, client->address, error)) {
+            // Report the error only if the server was not closed by stop().
+            std::lock_guard<std::mutex> lock(_plugin->_mutex);
+            if (!_plugin->_terminate && !error.empty()) {
+                _plugin->error(error.messages());
+            }
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(_plugin->_mutex);
+        if (_plugin->_terminate) {
+            client->conn.disconnect(NULLREP);
+            client->conn.close(NULLREP);
+            break;
+        }
+
+        // Deallocate the completed clients. The destructor waits for the termination of the thread.
+        _plugin->_clients.remove_if([](const std::unique_ptr<Client>& cl) { return cl->done; });
+
+        // Start a thread for the new client, unless there are too many clients.
+        if (_plugin->_clients.size() >= _plugin->_max_clients) {
+            _plugin->warning(u"too many clients, rejecting connection from %s", client->address);
+            client->conn.disconnect(NULLREP);
+            client->conn.close(NULLREP);
+        }
+        else {
+            _plugin->verbose(u"client connected from %s", client->address);
+            if (client->start()) {
+                _plugin->_clients.push_back(std::move(client));
+            }
+            else {
+                _plugin->error(u"cannot start client thread");
+                client->conn.disconnect(NULLREP);
+                client->conn.close(NULLREP);
+            }
+        }
+    }
+
+    _plugin->debug(u"client acceptor thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Client thread in concurrent mode.
+//----------------------------------------------------------------------------
+
+ts::HTTPOutputPlugin::Client::Client(HTTPOutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::HTTPOutputPlugin::Client::~Client()
+{
+    waitForTermination();
+}
+
+void ts::HTTPOutputPlugin::Client::main()
+{
+    // Initialize the session, process request, send response headers.
+    // The client starts with the next packet in the ring.
+    bool ok = _plugin->startSession(conn);
+    std::unique_lock<std::mutex> lock(_plugin->_mutex);
+    cursor = _plugin->_write_index;
+    streaming = ok;
+
+    while (ok) {
+        // Wait for new packets in the ring.
+        _plugin->_got_packets.wait(lock, [this]() { return cursor < _plugin->_write_index || dropped || _plugin->_terminate; });
+        if (dropped || _plugin->_terminate) {
+            break;
+        }
+
+        // Send packets directly from the ring, without holding the mutex. Packets which are currently sent
+        // are not overwritten: a late client is first disconnected and the writer waits until the send
+        // operation is interrupted. Send at most a quarter of the ring at a time, to let the writer move forward.
+        const size_t ring_size = _plugin->_ring.size();
+        const size_t first = size_t(cursor % ring_size);
+        const size_t count = std::min({size_t(_plugin->_write_index - cursor), ring_size - first, ring_size / 4});
+        const TSPacket* const data = &_plugin->_ring[first];
+        sending = true;
+        lock.unlock();
+        ok = conn.send(data, count * PKT_SIZE, NULLREP);
+        lock.lock();
+        sending = false;
+        if (dropped) {
+            _plugin->_send_done.notify_all();
+        }
+        cursor += count;
+    }
+
+    if (!dropped && !_plugin->_terminate) {
+        _plugin->verbose(u"client %s disconnected", address);
+    }
+
+    // Close the connection while holding the mutex: the other threads may disconnect it.
+    // Then, tell the acceptor that this client can be deallocated.
+    streaming = false;
+    conn.disconnect(NULLREP);
+    conn.close(NULLREP);
+    done = true;
+}
@@ -15,6 +15,7 @@
 #include "tsOutputPlugin.h"
 #include "tsTCPServer.h"
 #include "tsTCPConnection.h"
+#include "tsThread.h"
 
 namespace ts {
     //!
@@ -32,21 +33,81 @@ namespace ts {
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
 
     private:
+        // Default maximum lag of a client in concurrent mode, in TS packets.
+        static constexpr size_t DEFAULT_MAX_LAG = 100'000;
+
+        // A client thread in concurrent mode. It sends packets from the shared ring of packets.
+        class Client : public Thread
+        {
+            TS_NOBUILD_NOCOPY(Client);
+        public:
+            // Constructor & destructor.
+            Client(HTTPOutputPlugin* plugin);
+            virtual ~Client() override;
+
+            // Public fields, protected by the mutex of the plugin.
+            TCPConnection   conn {};              // Connection to the client.
+            IPSocketAddress address {};           // Client address.
+            bool            streaming = false;    // The client receives packets, its cursor is valid.
+            bool            dropped = false;      // The client was disconnected by the plugin.
+            bool            sending = false;      // The thread sends packets from the ring, starting at cursor.
+            bool            done = false;         // The thread is completed.
+            uint64_t        cursor = 0;           // Index of next packet to send to the client.
+
+        protected:
+            virtual void main() override;
+        private:
+            HTTPOutputPlugin* _plugin;
+        };
+
+        // Thread accepting new clients in concurrent mode.
+        class Acceptor : public Thread
+        {
+            TS_NOBUILD_NOCOPY(Acceptor);
+        public:
+            // Constructor & destructor.
+            Acceptor(HTTPOutputPlugin* plugin);
+            virtual ~Acceptor() override;
+        protected:
+            virtual void main() override;
+        private:
+            HTTPOutputPlugin* _plugin;
+        };
+
         // Command line options:
         IPSocketAddress _server_address {};
         bool            _reuse_port = false;
         bool            _multiple_clients = false;
         bool            _ignore_bad_request = false;
         size_t          _tcp_buffer_size = 0;
+        size_t          _max_clients = 1;
+        size_t          _max_lag = DEFAULT_MAX_LAG;
 
         // Working data:
         TCPServer     _server {};
         TCPConnection _client {};
 
+        // Working data in concurrent mode. All clients share one ring of packets, each one with its own cursor.
+        // The packet at index i (since start) is stored in _ring[i % _ring.size()].
+        Acceptor                 _acceptor {this};
+        std::mutex               _mutex {};          // Protect all following fields and the clients.
+        std::condition_variable  _got_packets {};    // Signaled when packets are added or on termination.
+        std::condition_variable  _send_done {};      // Signaled when a dropped client no longer sends from the ring.
+        std::vector<TSPacket>    _ring {};           // Ring of packets.
+        uint64_t                 _write_index = 0;   // Index of next packet to write in the ring.
+        bool                     _terminate = false; // Terminate all threads.
+        std::list<std::unique_ptr<Client>> _clients {};
+
+        // Concurrent mode, with several clients at a time.
+        bool concurrent() const { return _max_clients > 1; }
+
+        // Send packets in concurrent mode.
+        bool sendConcurrent(const TSPacket* buffer, size_t packet_count);
+
         // Process request headers from new client, send response headers.
-        bool startSession();
+        bool startSession(TCPConnection& client);
 
         // Send a response header.
-        bool sendResponseHeader(const std::string& line);
+        bool sendResponseHeader(TCPConnection& client, const std::string& line);
     };
 }
@@ -24,6 +24,23 @@ ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
 {
     // Add UDP receiver common options.
     _sock_args.defineArgs(*this, true, true);
+
+    option(u"receive-threads", 0, INTEGER, 0, 1, 0, 64);
+    help(u"receive-threads",
+         u"Receive the UDP datagrams in the specified number of separate threads. "
+         u"Each thread uses its own socket and queues the received datagrams. "
+         u"The datagrams from all threads are merged in order of arrival time. "
+         u"With more than one thread, the reception must be unicast and the reuse port socket option must be set. "
+         u"The system then distributes the incoming flows among the sockets (SO_REUSEPORT on Linux). "
+         u"Note that all datagrams from one given source are received by the same socket. "
+         u"By default, the datagrams are received in the plugin thread.");
+
+    option(u"receive-queue-size", 0, POSITIVE);
+    help(u"receive-queue-size",
+         u"With --receive-threads, specify the maximum number of received datagrams "
+         u"which are queued by each receive thread. When the queue of a thread is full, "
+         u"the incoming datagrams are dropped. "
+         u"The default is " + UString::Decimal(DEFAULT_RECEIVE_QUEUE) + u" datagrams.");
 }
 
 
@@ -34,8 +51,22 @@ ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
 bool ts::IPInputPlugin::getOptions()
 {
     // Get command line arguments for superclass and socket.
-    const bool ok = AbstractDatagramInputPlugin::getOptions() && _sock_args.loadArgs(duck, *this, _sock.parameters().receive_timeout);
+    bool ok = AbstractDatagramInputPlugin::getOptions() && _sock_args.loadArgs(duck, *this, _sock.parameters().receive_timeout);
     _sock.setParameters(_sock_args);
+    getIntValue(_receive_threads, u"receive-threads", 0);
+    getIntValue(_receive_queue, u"receive-queue-size", DEFAULT_RECEIVE_QUEUE);
+
+    // With several sockets, each one shall receive a distinct part of the traffic.
+    if (ok && _receive_threads > 1) {
+        if (_sock_args.destination.hasAddress()) {
+            error(u"multicast reception is not possible with more than one receive thread");
+            ok = false;
+        }
+        if (!_sock_args.reuse_port) {
+            error(u"--no-reuse-port is not possible with more than one receive thread");
+            ok = false;
+        }
+    }
     return ok;
 }
 
@@ -46,8 +77,8 @@ bool ts::IPInputPlugin::getOptions()
 
 bool ts::IPInputPlugin::start()
 {
-    // Initialize superclass and UDP socket.
-    return AbstractDatagramInputPlugin::start() && _sock.open(*this);
+    // Initialize superclass and UDP socket or receive threads.
+    return AbstractDatagramInputPlugin::start() && (_receive_threads > 0 ? startReceivers() : _sock.open(*this));
 }
 
 
@@ -58,6 +89,7 @@ bool ts::IPInputPlugin::start()
 bool ts::IPInputPlugin::stop()
 {
     _sock.close(*this);
+    stopReceivers();
     return AbstractDatagramInputPlugin::stop();
 }
 
@@ -70,6 +102,11 @@ bool ts::IPInputPlugin::abortInput()
 {
     debug(u"aborting IP input");
     _sock.close(*this);
+    _terminate = true;
+    for (const auto& rec : _receivers) {
+        rec->sock.close(*this);
+    }
+    wakeUp(true);
     return true;
 }
 
@@ -82,6 +119,8 @@ bool ts::IPInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
 {
     if (timeout > cn::milliseconds::zero()) {
         _sock.setReceiveTimeoutArg(timeout);
+        // With receive threads, the timeout applies to the wait for queued datagrams.
+        _sock_args.receive_timeout = timeout;
     }
     return true;
 }
@@ -93,8 +132,175 @@ bool ts::IPInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
 
 bool ts::IPInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource)
 {
+    timesource = TimeSource::KERNEL; // could be HARDWARE if generated by NIC, but no way to know
+
+    // Direct reception in the plugin thread.
+    if (_receive_threads == 0) {
+        IPSocketAddress sender;
+        IPSocketAddress destination;
+        return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *this, &timestamp);
+    }
+
+    for (;;) {
+        // Get the oldest datagram in the queues of all receive threads.
+        Receiver* next = nullptr;
+        Datagram* dg = nullptr;
+        for (const auto& rec : _receivers) {
+            Datagram* d = rec->queue.usedElement();
+            if (d != nullptr && (dg == nullptr || d->order < dg->order)) {
+                next = rec.get();
+                dg = d;
+            }
+        }
+        if (dg != nullptr) {
+            ret_size = std::min(dg->data.size(), buffer_size);
+            MemCopy(buffer, dg->data.data(), ret_size);
+            timestamp = dg->timestamp;
+            next->queue.release();
+            return true;
+        }
+
+        // No datagram, stop when a receive thread has terminated (error or abort).
+        for (const auto& rec : _receivers) {
+            if (rec->ended) {
+                return false;
+            }
+        }
+
+        // Wait for a datagram. The receive threads check _waiting after queueing a datagram.
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting = true;
+        bool ready = true;
+        if (_sock_args.receive_timeout > cn::milliseconds::zero()) {
+            ready = _received.wait_for(lock, _sock_args.receive_timeout, [this]() { return readyToReceive(); });
+        }
+        else {
+            _received.wait(lock, [this]() { return readyToReceive(); });
+        }
+        _waiting = false;
+        if (!ready) {
+            error(u"receive timeout");
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a datagram is available or no more datagram will arrive.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::readyToReceive()
+{
+    if (_terminate) {
+        return true;
+    }
+    for (const auto& rec : _receivers) {
+        if (rec->ended || rec->queue.usedElement() != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Wake up the plugin thread if it waits for datagrams.
+//----------------------------------------------------------------------------
+
+void ts::IPInputPlugin::wakeUp(bool always)
+{
+    // Avoid the mutex in the common case where the plugin thread is busy.
+    if (always || _waiting) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _received.notify_one();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start and stop the receive threads.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::startReceivers()
+{
+    stopReceivers();
+    _terminate = false;
+
+    // The receive timeout applies to the wait for queued datagrams, not to the sockets.
+    UDPReceiverArgs args(_sock_args);
+    args.receive_timeout = cn::milliseconds(-1);
+
+    for (size_t i = 0; i < _receive_threads; ++i) {
+        _receivers.push_back(std::make_unique<Receiver>(this));
+        Receiver& rec(*_receivers.back());
+        rec.sock.setParameters(args);
+        rec.queue.resize(_receive_queue);
+        if (!rec.sock.open(*this) || !rec.start()) {
+            stopReceivers();
+            return false;
+        }
+    }
+    verbose(u"receiving UDP datagrams in %d threads", _receivers.size());
+    return true;
+}
+
+void ts::IPInputPlugin::stopReceivers()
+{
+    _terminate = true;
+    uint64_t overflow = 0;
+    for (const auto& rec : _receivers) {
+        // Closing the socket aborts a pending receive operation.
+        rec->sock.close(*this);
+        rec->waitForTermination();
+        overflow += rec->overflow;
+    }
+    if (overflow > 0) {
+        warning(u"%'d UDP datagrams dropped, receive queue overflow, consider using --receive-queue-size", overflow);
+    }
+    _receivers.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Receive thread.
+//----------------------------------------------------------------------------
+
+ts::IPInputPlugin::Receiver::Receiver(IPInputPlugin* plugin) :
+    Thread(ThreadAttributes().setPriority(ThreadAttributes::GetHighPriority())),
+    sock(*plugin),
+    _plugin(plugin)
+{
+}
+
+ts::IPInputPlugin::Receiver::~Receiver()
+{
+    waitForTermination();
+}
+
+void ts::IPInputPlugin::Receiver::main()
+{
+    ByteBlock buffer(IP_MAX_PACKET_SIZE);
     IPSocketAddress sender;
     IPSocketAddress destination;
-    timesource = TimeSource::KERNEL; // could be HARDWARE if generated by NIC, but no way to know
-    return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *this, &timestamp);
+    size_t size = 0;
+    cn::microseconds timestamp {};
+
+    while (!_plugin->_terminate && sock.receive(buffer.data(), buffer.size(), size, sender, destination, _plugin->tsp, *_plugin, &timestamp)) {
+        Datagram* dg = queue.freeElement();
+        if (dg == nullptr) {
+            // Queue full, the plugin thread is too slow, drop the datagram.
+            overflow++;
+            continue;
+        }
+        // The datagram buffer keeps its allocated size from previous usage.
+        dg->data.assign(buffer.begin(), buffer.begin() + size);
+        dg->timestamp = timestamp;
+        dg->order = timestamp >= cn::microseconds::zero() ? timestamp : cn::duration_cast<cn::microseconds>(cn::system_clock::now().time_since_epoch());
+        queue.publish();
+        _plugin->wakeUp(false);
+    }
+
+    ended = true;
+    _plugin->wakeUp(true);
 }
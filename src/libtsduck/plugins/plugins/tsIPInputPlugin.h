@@ -14,6 +14,8 @@
 #pragma once
 #include "tsAbstractDatagramInputPlugin.h"
 #include "tsUDPReceiver.h"
+#include "tsLockFreeRing.h"
+#include "tsThread.h"
 
 namespace ts {
     //!
@@ -36,7 +38,57 @@ namespace ts {
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource) override;
 
     private:
+        static constexpr size_t DEFAULT_RECEIVE_QUEUE = 4096;  // Default number of datagrams per receive thread.
+
+        // Command line options.
         UDPReceiverArgs _sock_args {};
+        size_t          _receive_threads = 0;    // Number of receive threads, zero means receive in the plugin thread.
+        size_t          _receive_queue = DEFAULT_RECEIVE_QUEUE;
+
+        // Reception in the plugin thread.
         UDPReceiver     _sock {*tsp};
+
+        // A datagram in the queue of a receive thread.
+        class Datagram
+        {
+        public:
+            ByteBlock        data {};          // Datagram content.
+            cn::microseconds timestamp {-1};   // Kernel receive timestamp, -1 if unavailable.
+            cn::microseconds order {};         // Arrival time, used to merge the queues of all receive threads.
+        };
+
+        // A receive thread, with its own socket and lock-free queue of received datagrams.
+        class Receiver : public Thread
+        {
+            TS_NOBUILD_NOCOPY(Receiver);
+        public:
+            Receiver(IPInputPlugin* plugin);
+            virtual ~Receiver() override;
+            UDPReceiver              sock;
+            LockFreeRing<Datagram>   queue {};
+            std::atomic<bool>        ended {false};   // The thread has terminated.
+            std::atomic<uint64_t>    overflow {0};    // Number of datagrams dropped because the queue was full.
+        protected:
+            virtual void main() override;
+        private:
+            IPInputPlugin* _plugin;
+        };
+
+        // Reception in receive threads. The plugin thread is the only consumer of all queues.
+        std::vector<std::unique_ptr<Receiver>> _receivers {};
+        std::atomic<bool>       _waiting {false};     // The plugin thread is waiting for datagrams.
+        std::atomic<bool>       _terminate {false};   // Terminate all receive threads.
+        std::mutex              _mutex {};            // Used only to wait for datagrams.
+        std::condition_variable _received {};         // Signaled when a datagram is queued or a receive thread terminates.
+
+        // Start and stop the receive threads.
+        bool startReceivers();
+        void stopReceivers();
+
+        // Wake up the plugin thread if it waits for datagrams.
+        void wakeUp(bool always);
+
+        // Check if a datagram is available or no more datagram will arrive.
+        bool readyToReceive();
     };
 }
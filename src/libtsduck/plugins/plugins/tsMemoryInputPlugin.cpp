@@ -12,6 +12,9 @@
 
 TS_REGISTER_INPUT_PLUGIN(u"memory", ts::MemoryInputPlugin);
 
+// Default number of packets in a shared memory ring.
+#define DEFAULT_RING_SIZE 16384
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -30,6 +33,22 @@ ts::MemoryInputPlugin::MemoryInputPlugin(TSP* tsp_) :
          u"The event data is an instance of PluginEventData pointing to the input buffer. "
          u"The application shall handle the event, waiting for input packets as long as necessary. "
          u"Returning zero packet (or not handling the event) means end if input.");
+
+    option(u"shared-memory", 's', STRING);
+    help(u"shared-memory", u"name",
+         u"Receive packets from a ring buffer in the specified named shared memory segment, "
+         u"instead of signalling plugin events. "
+         u"The application, in the same process or in another process, writes the packets directly "
+         u"in the shared memory. The segment is created if it does not exist yet. "
+         u"The layout of the segment is described in the documentation of the C++ class SharedMemoryRing. "
+         u"The end of input is reached when the application signals the end of stream in the ring.");
+
+    option(u"ring-size", 'r', POSITIVE);
+    help(u"ring-size", u"count",
+         u"With --shared-memory, specify the number of TS packets in the ring buffer when the plugin creates the segment. "
+         u"The value is rounded up to the next power of 2. "
+         u"The default is " + UString::Decimal(DEFAULT_RING_SIZE) + u" packets. "
+         u"When the segment already exists, its size is defined by its creator.");
 }
 
 
@@ -40,6 +59,52 @@ ts::MemoryInputPlugin::MemoryInputPlugin(TSP* tsp_) :
 bool ts::MemoryInputPlugin::getOptions()
 {
     getIntValue(_event_code, u"event-code");
+    getValue(_shm_name, u"shared-memory");
+    getIntValue(_ring_size, u"ring-size", DEFAULT_RING_SIZE);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start / stop methods.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryInputPlugin::start()
+{
+    return _shm_name.empty() || _ring.open(_shm_name, PKT_SIZE, _ring_size, *this);
+}
+
+bool ts::MemoryInputPlugin::stop()
+{
+    if (_ring.isOpen()) {
+        _ring.closeConsumer();
+        _ring.close();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Set receive timeout from tsp.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
+{
+    if (timeout > cn::milliseconds::zero()) {
+        _timeout = timeout;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Input abort method.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryInputPlugin::abortInput()
+{
+    // In event mode, the input is in the hands of the application.
+    _ring.abort();
     return true;
 }
 
@@ -50,6 +115,15 @@ bool ts::MemoryInputPlugin::getOptions()
 
 size_t ts::MemoryInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets)
 {
+    // In shared memory mode, copy packets from the ring.
+    if (_ring.isOpen()) {
+        const size_t count = _ring.read(buffer, max_packets, _timeout);
+        if (count == 0 && !_ring.producerClosed()) {
+            error(u"no packet received from shared memory %s", _shm_name);
+        }
+        return count;
+    }
+
     // Prepare an event data block pointing to the input buffer.
     PluginEventData data(buffer->b, 0, PKT_SIZE * max_packets);
     tsp->signalPluginEvent(_event_code, &data);
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsInputPlugin.h"
+#include "tsSharedMemoryRing.h"
 
 namespace ts {
     //!
@@ -25,9 +26,17 @@ namespace ts {
     public:
         // Implementation of plugin API
         virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool setReceiveTimeout(cn::milliseconds timeout) override;
+        virtual bool abortInput() override;
         virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
 
     private:
-        uint32_t _event_code = 0;
+        uint32_t         _event_code = 0;
+        UString          _shm_name {};    // Shared memory segment name, empty in event mode.
+        size_t           _ring_size = 0;  // Number of packets in the ring, when created by the plugin.
+        cn::milliseconds _timeout = cn::milliseconds::max();  // Receive timeout in shared memory mode.
+        SharedMemoryRing _ring {};        // Packet ring in shared memory mode.
     };
 }
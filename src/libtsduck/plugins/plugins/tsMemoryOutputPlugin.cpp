@@ -12,6 +12,12 @@
 
 TS_REGISTER_OUTPUT_PLUGIN(u"memory", ts::MemoryOutputPlugin);
 
+// Default number of packets in a shared memory ring.
+#define DEFAULT_RING_SIZE 16384
+
+// When the shared memory ring is full, check the termination of tsp at this interval.
+#define ABORT_CHECK_INTERVAL cn::milliseconds(100)
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -29,6 +35,23 @@ ts::MemoryOutputPlugin::MemoryOutputPlugin(TSP* tsp_) :
          u"Signal a plugin event with the specified code each time the plugin output packets. "
          u"The event data is an instance of PluginEventData pointing to the output packets. "
          u"If an event handler sets the error indicator in the event data, the transmission is aborted.");
+
+    option(u"shared-memory", 's', STRING);
+    help(u"shared-memory", u"name",
+         u"Send packets to a ring buffer in the specified named shared memory segment, "
+         u"instead of signalling plugin events. "
+         u"The application, in the same process or in another process, reads the packets directly "
+         u"from the shared memory. The segment is created if it does not exist yet. "
+         u"The layout of the segment is described in the documentation of the C++ class SharedMemoryRing. "
+         u"When the ring is full, the plugin waits for the application to read packets. "
+         u"If the application closes its side of the ring, the transmission is aborted.");
+
+    option(u"ring-size", 'r', POSITIVE);
+    help(u"ring-size", u"count",
+         u"With --shared-memory, specify the number of TS packets in the ring buffer when the plugin creates the segment. "
+         u"The value is rounded up to the next power of 2. "
+         u"The default is " + UString::Decimal(DEFAULT_RING_SIZE) + u" packets. "
+         u"When the segment already exists, its size is defined by its creator.");
 }
 
 
@@ -39,6 +62,28 @@ ts::MemoryOutputPlugin::MemoryOutputPlugin(TSP* tsp_) :
 bool ts::MemoryOutputPlugin::getOptions()
 {
     getIntValue(_event_code, u"event-code");
+    getValue(_shm_name, u"shared-memory");
+    getIntValue(_ring_size, u"ring-size", DEFAULT_RING_SIZE);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start / stop methods.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryOutputPlugin::start()
+{
+    return _shm_name.empty() || _ring.open(_shm_name, PKT_SIZE, _ring_size, *this);
+}
+
+bool ts::MemoryOutputPlugin::stop()
+{
+    if (_ring.isOpen()) {
+        // Signal the end of stream. The application can still read the remaining packets.
+        _ring.closeProducer();
+        _ring.close();
+    }
     return true;
 }
 
@@ -49,6 +94,29 @@ bool ts::MemoryOutputPlugin::getOptions()
 
 bool ts::MemoryOutputPlugin::send(const TSPacket* packets, const TSPacketMetadata* metadata, size_t packet_count)
 {
+    // In shared memory mode, copy packets in the ring.
+    if (_ring.isOpen()) {
+        while (packet_count > 0) {
+            if (_ring.consumerClosed()) {
+                error(u"the application has closed the shared memory %s", _shm_name);
+                return false;
+            }
+            uint8_t* data = nullptr;
+            const size_t count = std::min(_ring.writeBuffer(data), packet_count);
+            if (count > 0) {
+                TSPacket::Copy(data, packets, count);
+                _ring.commitWrite(count);
+                packets += count;
+                packet_count -= count;
+            }
+            else if (!_ring.waitWrite(ABORT_CHECK_INTERVAL) && tsp->aborting()) {
+                // The ring is full and tsp is terminating.
+                return false;
+            }
+        }
+        return true;
+    }
+
     // Prepare an event data block pointing to the output packets.
     PluginEventData data(packets->b, PKT_SIZE * packet_count);
     tsp->signalPluginEvent(_event_code, &data);
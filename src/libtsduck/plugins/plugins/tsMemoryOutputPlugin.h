@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsOutputPlugin.h"
+#include "tsSharedMemoryRing.h"
 
 namespace ts {
     //!
@@ -25,9 +26,14 @@ namespace ts {
     public:
         // Implementation of plugin API
         virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
 
     private:
-        uint32_t _event_code = 0;
+        uint32_t         _event_code = 0;
+        UString          _shm_name {};    // Shared memory segment name, empty in event mode.
+        size_t           _ring_size = 0;  // Number of packets in the ring, when created by the plugin.
+        SharedMemoryRing _ring {};        // Packet ring in shared memory mode.
     };
 }
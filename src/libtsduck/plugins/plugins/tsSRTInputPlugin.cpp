@@ -72,6 +72,12 @@ bool ts::SRTInputPlugin::start()
 
 bool ts::SRTInputPlugin::stop()
 {
+    if (verbose()) {
+        SRTStatistics stats;
+        if (_sock.getStatistics(stats, *this)) {
+            verbose(stats.receiveSummary());
+        }
+    }
     _sock.close(*this);
     return AbstractDatagramInputPlugin::stop();
 }
@@ -97,3 +103,9 @@ bool ts::SRTInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, si
     timesource = TimeSource::SRT;
     return _sock.receive(buffer, buffer_size, ret_size, timestamp, *this);
 }
+
+bool ts::SRTInputPlugin::receiveDatagramNoWait(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource)
+{
+    timesource = TimeSource::SRT;
+    return _sock.receiveNoWait(buffer, buffer_size, ret_size, timestamp, *this);
+}
@@ -61,6 +61,7 @@ bool ts::SRTOutputPlugin::getOptions()
     getSocketValue(rendezvous, u"rendezvous");
     _multiple = present(u"multiple");
     getChronoValue(_restart_delay, u"restart-delay");
+    _msg_count = _batch_count = 0;
 
     return _sock.setAddresses(listener, rendezvous, IPAddress(), *this) &&
            _sock.loadArgs(duck, *this) &&
@@ -92,6 +93,13 @@ bool ts::SRTOutputPlugin::start()
 bool ts::SRTOutputPlugin::stop()
 {
     _datagram.close(tsp->bitrate(), false, *this);
+    if (verbose()) {
+        SRTStatistics stats;
+        if (_sock.getStatistics(stats, *this)) {
+            verbose(stats.sendSummary());
+        }
+    }
+    debug(u"sent %'d SRT messages in %'d batches", _msg_count, _batch_count);
     _sock.close(*this);
     return true;
 }
@@ -107,6 +115,31 @@ bool ts::SRTOutputPlugin::send(const TSPacket* packets, const TSPacketMetadata*
 }
 
 
+//----------------------------------------------------------------------------
+// After a send error, wait for another receiver if necessary.
+//----------------------------------------------------------------------------
+
+bool ts::SRTOutputPlugin::reconnect(Report& report)
+{
+    if (!_sock.peerDisconnected()) {
+        // Actual error, not a clean disconnection from the receiver, do not retry, even with --multiple.
+        return false;
+    }
+    report.verbose(u"receiver disconnected%s", _multiple ? u", waiting for another one" : u"");
+    if (!_multiple) {
+        // No multiple sessions, terminate here.
+        return false;
+    }
+    // Multiple sessions, close socket and re-open to acquire another receiver.
+    _datagram.close(tsp->bitrate(), true, *this);
+    _sock.close(*this);
+    if (_restart_delay > cn::milliseconds::zero()) {
+        std::this_thread::sleep_for(_restart_delay);
+    }
+    return start();
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of TSDatagramOutputHandlerInterface: send one datagram.
 //----------------------------------------------------------------------------
@@ -117,26 +150,43 @@ bool ts::SRTOutputPlugin::sendDatagram(const void* address, size_t size, Report&
     for (;;) {
         // Send the datagram.
         if (_sock.send(address, size, report)) {
+            _msg_count++;
+            _batch_count++;
             return true;
         }
         // Send error.
-        if (!_sock.peerDisconnected()) {
-            // Actual error, not a clean disconnection from the receiver, do not retry, even with --multiple.
+        if (!reconnect(report)) {
             return false;
         }
-        report.verbose(u"receiver disconnected%s", _multiple ? u", waiting for another one" : u"");
-        if (!_multiple) {
-            // No multiple sessions, terminate here.
-            return false;
-        }
-        // Multiple sessions, close socket and re-open to acquire another receiver.
-        _datagram.close(tsp->bitrate(), true, *this);
-        _sock.close(*this);
-        if (_restart_delay > cn::milliseconds::zero()) {
-            std::this_thread::sleep_for(_restart_delay);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of TSDatagramOutputHandlerInterface: send several datagrams.
+//----------------------------------------------------------------------------
+
+bool ts::SRTOutputPlugin::sendDatagrams(const void* address, size_t size, size_t count, Report& report)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(address);
+
+    // Loop on restart with multiple sessions.
+    while (count > 0) {
+        // Send all messages at once.
+        const size_t previous = _sock.totalSentBytes();
+        if (_sock.sendMessages(data, size, count, report)) {
+            _msg_count += count;
+            _batch_count++;
+            return true;
         }
-        if (!start()) {
+        // Send error. Skip the messages which were sent before the error.
+        const size_t sent = size == 0 ? 0 : std::min(count, (_sock.totalSentBytes() - previous) / size);
+        _msg_count += sent;
+        data += sent * size;
+        count -= sent;
+        if (!reconnect(report)) {
             return false;
         }
     }
+    return true;
 }
@@ -37,8 +37,14 @@ namespace ts {
         cn::milliseconds _restart_delay {};  // If _multiple, wait before reconnecting.
         TSDatagramOutput _datagram {TSDatagramOutputOptions::ALLOW_RS204, this}; // Buffering TS packets.
         SRTSocket        _sock {};           // Outgoing SRT socket.
+        PacketCounter    _msg_count = 0;     // Number of sent SRT messages.
+        PacketCounter    _batch_count = 0;   // Number of batches of SRT messages.
+
+        // After a send error, check if the receiver disconnected and wait for another one if necessary.
+        bool reconnect(Report& report);
 
         // Implementation of TSDatagramOutputHandlerInterface.
         virtual bool sendDatagram(const void* address, size_t size, Report& report) override;
+        virtual bool sendDatagrams(const void* address, size_t size, size_t count, Report& report) override;
     };
 }
@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryInputPlugin.h"
+#include "tsPluginRepository.h"
+
+TS_REGISTER_INPUT_PLUGIN(u"shm", ts::SharedMemoryInputPlugin);
+
+// Default number of packets in the ring.
+#define DEFAULT_RING_SIZE 16384
+
+// Each element in the ring is a serialized metadata, followed by a TS packet (same as --format duck).
+#define ELEMENT_SIZE (TSPacketMetadata::SERIALIZATION_SIZE + PKT_SIZE)
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryInputPlugin::SharedMemoryInputPlugin(TSP* tsp_) :
+    InputPlugin(tsp_, u"Receive TS packets from another process through shared memory", u"[options] name")
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"name",
+         u"Name of the shared memory segment. "
+         u"The segment is shared with an output plugin \"shm\" in another tsp process. "
+         u"It is created by the first process which opens it.");
+
+    option(u"ring-size", 'r', POSITIVE);
+    help(u"ring-size", u"count",
+         u"Number of TS packets in the ring buffer when this plugin creates the segment. "
+         u"The value is rounded up to the next power of 2. "
+         u"The default is " + UString::Decimal(DEFAULT_RING_SIZE) + u" packets. "
+         u"When the segment already exists, its size is defined by its creator.");
+}
+
+
+//----------------------------------------------------------------------------
+// Get command line options.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getIntValue(_ring_size, u"ring-size", DEFAULT_RING_SIZE);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start / stop methods.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::start()
+{
+    if (!_ring.open(_name, ELEMENT_SIZE, _ring_size, *this)) {
+        return false;
+    }
+    verbose(u"shared memory %s, %'d packets, %s", _name, _ring.capacity(), _ring.isOwner() ? u"created" : u"existing");
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::stop()
+{
+    // Tell the producer that nobody reads the ring any longer.
+    _ring.closeConsumer();
+    _ring.close();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Set receive timeout from tsp.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
+{
+    if (timeout > cn::milliseconds::zero()) {
+        _timeout = timeout;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Input abort method.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::abortInput()
+{
+    _ring.abort();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive packets method.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemoryInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets)
+{
+    if (!_ring.waitRead(_timeout)) {
+        // Timeout, abort or end of stream.
+        if (!_ring.producerClosed()) {
+            error(u"no packet received from shared memory %s", _name);
+        }
+        return 0;
+    }
+
+    // Get packets and metadata directly from the shared memory.
+    const uint8_t* data = nullptr;
+    const size_t count = std::min(_ring.readBuffer(data), max_packets);
+    for (size_t i = 0; i < count; ++i) {
+        metadata[i].deserialize(data, TSPacketMetadata::SERIALIZATION_SIZE);
+        buffer[i].copyFrom(data + TSPacketMetadata::SERIALIZATION_SIZE);
+        data += ELEMENT_SIZE;
+    }
+    _ring.commitRead(count);
+    return count;
+}
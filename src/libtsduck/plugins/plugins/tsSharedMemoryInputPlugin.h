@@ -0,0 +1,42 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Shared memory input plugin for tsp.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsInputPlugin.h"
+#include "tsSharedMemoryRing.h"
+
+namespace ts {
+    //!
+    //! Shared memory input plugin for tsp.
+    //! Receive packets and their metadata from another process through a ring in shared memory.
+    //! @ingroup libtsduck plugin
+    //!
+    class TSDUCKDLL SharedMemoryInputPlugin: public InputPlugin
+    {
+        TS_PLUGIN_CONSTRUCTORS(SharedMemoryInputPlugin);
+    public:
+        // Implementation of plugin API
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool setReceiveTimeout(cn::milliseconds timeout) override;
+        virtual bool abortInput() override;
+        virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
+
+    private:
+        UString          _name {};        // Shared memory segment name.
+        size_t           _ring_size = 0;  // Number of packets in the ring, when created by the plugin.
+        cn::milliseconds _timeout = cn::milliseconds::max();  // Receive timeout.
+        SharedMemoryRing _ring {};        // Packet ring.
+    };
+}
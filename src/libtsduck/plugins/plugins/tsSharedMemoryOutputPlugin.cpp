@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryOutputPlugin.h"
+#include "tsPluginRepository.h"
+
+TS_REGISTER_OUTPUT_PLUGIN(u"shm", ts::SharedMemoryOutputPlugin);
+
+// Default number of packets in the ring.
+#define DEFAULT_RING_SIZE 16384
+
+// When the ring is full, check the termination of tsp at this interval.
+#define ABORT_CHECK_INTERVAL cn::milliseconds(100)
+
+// Each element in the ring is a serialized metadata, followed by a TS packet (same as --format duck).
+#define ELEMENT_SIZE (TSPacketMetadata::SERIALIZATION_SIZE + PKT_SIZE)
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryOutputPlugin::SharedMemoryOutputPlugin(TSP* tsp_) :
+    OutputPlugin(tsp_, u"Send TS packets to another process through shared memory", u"[options] name")
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"name",
+         u"Name of the shared memory segment. "
+         u"The segment is shared with an input plugin \"shm\" in another tsp process. "
+         u"It is created by the first process which opens it.");
+
+    option(u"drop", 'd');
+    help(u"drop",
+         u"Drop packets when the ring buffer is full. "
+         u"By default, the plugin waits until the other process reads packets (back-pressure). "
+         u"Use this option when the other process shall not slow down this one, "
+         u"for instance a monitoring process.");
+
+    option(u"ring-size", 'r', POSITIVE);
+    help(u"ring-size", u"count",
+         u"Number of TS packets in the ring buffer when this plugin creates the segment. "
+         u"The value is rounded up to the next power of 2. "
+         u"The default is " + UString::Decimal(DEFAULT_RING_SIZE) + u" packets. "
+         u"When the segment already exists, its size is defined by its creator.");
+}
+
+
+//----------------------------------------------------------------------------
+// Get command line options.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryOutputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getIntValue(_ring_size, u"ring-size", DEFAULT_RING_SIZE);
+    _drop = present(u"drop");
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start / stop methods.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryOutputPlugin::start()
+{
+    _dropped = 0;
+    if (!_ring.open(_name, ELEMENT_SIZE, _ring_size, *this)) {
+        return false;
+    }
+    verbose(u"shared memory %s, %'d packets, %s", _name, _ring.capacity(), _ring.isOwner() ? u"created" : u"existing");
+    return true;
+}
+
+bool ts::SharedMemoryOutputPlugin::stop()
+{
+    if (_dropped > 0) {
+        verbose(u"%'d packets dropped, ring buffer full", _dropped);
+    }
+
+    // Signal the end of stream. The other process can still read the remaining packets.
+    _ring.closeProducer();
+    _ring.close();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send packets method.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryOutputPlugin::send(const TSPacket* packets, const TSPacketMetadata* metadata, size_t packet_count)
+{
+    while (packet_count > 0) {
+
+        if (_ring.consumerClosed()) {
+            error(u"the receiving process has closed the shared memory %s", _name);
+            return false;
+        }
+
+        // Get the contiguous free area in the shared memory.
+        uint8_t* data = nullptr;
+        size_t count = _ring.writeBuffer(data);
+        if (count == 0) {
+            if (_drop) {
+                _dropped += packet_count;
+                return true;
+            }
+            // Back-pressure: wait for the other process to read packets, unless tsp is terminating.
+            if (!_ring.waitWrite(ABORT_CHECK_INTERVAL) && tsp->aborting()) {
+                return false;
+            }
+            continue;
+        }
+
+        // Write packets and metadata directly in the shared memory.
+        count = std::min(count, packet_count);
+        for (size_t i = 0; i < count; ++i) {
+            metadata[i].serialize(data, TSPacketMetadata::SERIALIZATION_SIZE);
+            packets[i].copyTo(data + TSPacketMetadata::SERIALIZATION_SIZE);
+            data += ELEMENT_SIZE;
+        }
+        _ring.commitWrite(count);
+        packets += count;
+        metadata += count;
+        packet_count -= count;
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Shared memory output plugin for tsp.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsOutputPlugin.h"
+#include "tsSharedMemoryRing.h"
+
+namespace ts {
+    //!
+    //! Shared memory output plugin for tsp.
+    //! Send packets and their metadata to another process through a ring in shared memory.
+    //! @ingroup libtsduck plugin
+    //!
+    class TSDUCKDLL SharedMemoryOutputPlugin: public OutputPlugin
+    {
+        TS_PLUGIN_CONSTRUCTORS(SharedMemoryOutputPlugin);
+    public:
+        // Implementation of plugin API
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+
+    private:
+        UString          _name {};        // Shared memory segment name.
+        size_t           _ring_size = 0;  // Number of packets in the ring, when created by the plugin.
+        bool             _drop = false;   // Drop packets when the ring is full instead of waiting.
+        PacketCounter    _dropped = 0;    // Number of dropped packets.
+        SharedMemoryRing _ring {};        // Packet ring.
+    };
+}
@@ -101,6 +101,15 @@ ts::hls::InputPlugin::InputPlugin(TSP* tsp_) :
          u"When the URL is a master playlist, select a content the resolution of which has a "
          u"lower height than the specified maximum.");
 
+    option(u"prefetch", 0, POSITIVE);
+    help(u"prefetch", u"count",
+         u"Number of media segments which are downloaded in parallel, ahead of the current one. "
+         u"With high-latency servers, this increases the throughput. "
+         u"The media segments are downloaded in memory and passed to the next plugin in playlist order. "
+         u"The playlist is reloaded in parallel with the downloads. "
+         u"By default, the media segments are downloaded one after the other and "
+         u"the packets are passed to the next plugin as they are received.");
+
     option(u"save-files", 0, DIRECTORY);
     help(u"save-files",
          u"Specify a directory where all downloaded files, media segments and playlists, are saved "
@@ -146,7 +155,8 @@ bool ts::hls::InputPlugin::isRealTime()
 bool ts::hls::InputPlugin::getOptions()
 {
     _url.setURL(value(u""));
-    const UString saveDirectory(value(u"save-files"));
+    getValue(_saveDirectory, u"save-files");
+    getIntValue(_prefetch, u"prefetch");
     getIntValue(_maxSegmentCount, u"segment-count");
     getValue(_minRate, u"min-bitrate");
     getValue(_maxRate, u"max-bitrate");
@@ -207,8 +217,8 @@ bool ts::hls::InputPlugin::getOptions()
     }
 
     // Automatically save media segments and playlists.
-    setAutoSaveDirectory(saveDirectory);
-    _playlist.setAutoSaveDirectory(saveDirectory);
+    setAutoSaveDirectory(_saveDirectory);
+    _playlist.setAutoSaveDirectory(_saveDirectory);
 
     return true;
 }
@@ -220,6 +230,8 @@ bool ts::hls::InputPlugin::getOptions()
 
 bool ts::hls::InputPlugin::start()
 {
+    _terminate = false;
+
     // Load the HLS playlist, can be a master playlist or a media playlist.
     _playlist.clear();
     if (!_playlist.loadURL(_url.toString(), false, webArgs, hls::PlayListType::UNKNOWN, *this)) {
@@ -351,8 +363,8 @@ bool ts::hls::InputPlugin::start()
 
     _segmentCount = 0;
 
-    // Invoke superclass.
-    return AbstractHTTPInputPlugin::start();
+    // With --prefetch, the segments are downloaded by the prefetch threads. Otherwise, invoke superclass.
+    return _prefetch > 0 ? startPrefetch() : AbstractHTTPInputPlugin::start();
 }
 
 
@@ -362,7 +374,10 @@ bool ts::hls::InputPlugin::start()
 
 bool ts::hls::InputPlugin::stop()
 {
-    // Invoke superclass first.
+    // Terminate prefetch threads, if any, and invoke superclass.
+    if (_prefetch > 0) {
+        stopPrefetch();
+    }
     const bool stopped = AbstractHTTPInputPlugin::stop();
 
     // Then delete the cookie file. Must be done after complete stop to avoid recreation.
@@ -371,10 +386,10 @@ bool ts::hls::InputPlugin::stop()
 
 
 //----------------------------------------------------------------------------
-// Called by AbstractHTTPInputPlugin to open an URL.
+// Get the next media segment, reload the playlist when necessary.
 //----------------------------------------------------------------------------
 
-bool ts::hls::InputPlugin::openURL(WebRequest& request)
+bool ts::hls::InputPlugin::nextSegment(MediaSegment& seg)
 {
     // Check if the playlist is completed
     bool completed =
@@ -389,7 +404,7 @@ bool ts::hls::InputPlugin::openURL(WebRequest& request)
     if (!completed && _playlist.segmentCount() < 2 && _playlist.isUpdatable()) {
 
         // Reload the playlist, ignore errors, continue to play next segments.
-        _playlist.reload(false, webArgs, *this);
+        reloadPlaylist(false);
 
         // If the playlist is still empty, this means that we have read all segments before the server
         // could produce new segments. For live streams, this is possible because new segments
@@ -398,9 +413,11 @@ bool ts::hls::InputPlugin::openURL(WebRequest& request)
 
         while (_playlist.segmentCount() == 0 && Time::CurrentUTC() <= _playlist.terminationUTC() && !tsp->aborting()) {
             // The wait between two retries is half the target duration of a segment, with a minimum of 2 seconds.
-            std::this_thread::sleep_for(std::max(cn::seconds(2), _playlist.targetDuration() / 2));
+            if (!waitForRetry(std::max(cn::seconds(2), _playlist.targetDuration() / 2))) {
+                break;
+            }
             // This time, we stop on reload error.
-            if (!_playlist.reload(false, webArgs, *this)) {
+            if (!reloadPlaylist(false)) {
                 break;
             }
         }
@@ -415,12 +432,278 @@ bool ts::hls::InputPlugin::openURL(WebRequest& request)
     }
 
     // Remove first segment from the playlist.
-    hls::MediaSegment seg;
     _playlist.popFirstSegment(seg);
     _segmentCount++;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Reload the playlist. With --prefetch, the download threads copy the cookies
+// file of the playlist. It must not be modified during the copy.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::reloadPlaylist(bool strict)
+{
+    std::lock_guard<std::mutex> lock(_cookies_mutex);
+    return _playlist.reload(strict, webArgs, *this);
+}
+
+
+//----------------------------------------------------------------------------
+// Wait some time, unless the plugin is terminated.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::waitForRetry(cn::milliseconds duration)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return !_segment_consumed.wait_for(lock, duration, [this]() { return _terminate; });
+}
+
+
+//----------------------------------------------------------------------------
+// Called by AbstractHTTPInputPlugin to open an URL.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::openURL(WebRequest& request)
+{
+    hls::MediaSegment seg;
+    if (!nextSegment(seg)) {
+        return false;
+    }
 
     // Open the segment.
     debug(u"downloading segment %s", seg.urlString());
     request.enableCookies(webArgs.cookiesFile);
     return request.open(seg.urlString());
 }
+
+
+//----------------------------------------------------------------------------
+// Input method.
+//----------------------------------------------------------------------------
+
+size_t ts::hls::InputPlugin::receive(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets)
+{
+    // Without --prefetch, the segments are directly received by the superclass.
+    if (_prefetch == 0) {
+        return AbstractHTTPInputPlugin::receive(buffer, metadata, max_packets);
+    }
+
+    for (;;) {
+        // Deliver packets from the current segment. A truncated packet at end of segment is dropped.
+        if (_current != nullptr) {
+            const size_t count = std::min(max_packets, (_current->data.size() - _current_offset) / PKT_SIZE);
+            if (count > 0) {
+                TSPacket::Copy(buffer, _current->data.data() + _current_offset, count);
+                _current_offset += count * PKT_SIZE;
+                return count;
+            }
+            _current.reset();
+        }
+
+        // Wait for the next segment to be downloaded, in playlist order.
+        std::unique_lock<std::mutex> lock(_mutex);
+        _segment_done.wait(lock, [this]() {
+            return _terminate || (_segments.empty() && _feed_completed) || (!_segments.empty() && _segments.front()->done);
+        });
+        if (_terminate || _segments.empty()) {
+            // Interrupted or end of playlist.
+            return 0;
+        }
+        _current = _segments.front();
+        _current_offset = 0;
+        _segments.pop_front();
+        _segment_consumed.notify_all();
+        if (!_current->success) {
+            // Same as without --prefetch, a segment which cannot be downloaded terminates the session.
+            return 0;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Abort the input operation currently in progress.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::abortInput()
+{
+    if (_prefetch > 0) {
+        abortPrefetch();
+    }
+    return AbstractHTTPInputPlugin::abortInput();
+}
+
+
+//----------------------------------------------------------------------------
+// Start / stop the prefetch threads.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::startPrefetch()
+{
+    _segments.clear();
+    _current.reset();
+    _current_offset = 0;
+    _feed_completed = false;
+    _terminate = false;
+
+    // One download thread per prefetched segment. The list of threads can be concurrently accessed by abortInput().
+    for (size_t i = 0; i < _prefetch; ++i) {
+        auto dl = std::make_unique<Downloader>(this);
+        const bool started = dl->start();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _downloaders.push_back(std::move(dl));
+        }
+        if (!started) {
+            error(u"cannot start download thread");
+            stopPrefetch();
+            return false;
+        }
+    }
+    if (!_feeder.start()) {
+        error(u"cannot start playlist thread");
+        stopPrefetch();
+        return false;
+    }
+    return true;
+}
+
+void ts::hls::InputPlugin::abortPrefetch()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _terminate = true;
+    _segment_queued.notify_all();
+    _segment_done.notify_all();
+    _segment_consumed.notify_all();
+    for (const auto& dl : _downloaders) {
+        dl->request.abort();
+    }
+}
+
+void ts::hls::InputPlugin::stopPrefetch()
+{
+    abortPrefetch();
+    _feeder.waitForTermination();
+
+    // Deallocating a download thread waits for its termination, which needs the mutex.
+    std::vector<std::unique_ptr<Downloader>> downloaders;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        downloaders.swap(_downloaders);
+    }
+    downloaders.clear();
+    _segments.clear();
+    _current.reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Thread which feeds the list of segments to download from the playlist.
+//----------------------------------------------------------------------------
+
+ts::hls::InputPlugin::Feeder::Feeder(InputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::hls::InputPlugin::Feeder::~Feeder()
+{
+    waitForTermination();
+}
+
+void ts::hls::InputPlugin::Feeder::main()
+{
+    for (;;) {
+        // Wait until a segment can be prefetched.
+        {
+            std::unique_lock<std::mutex> lock(_plugin->_mutex);
+            _plugin->_segment_consumed.wait(lock, [this]() { return _plugin->_terminate || _plugin->_segments.size() < _plugin->_prefetch; });
+            if (_plugin->_terminate) {
+                break;
+            }
+        }
+
+        // Get next segment, reload the playlist if necessary, without holding the mutex.
+        hls::MediaSegment seg;
+        const bool got_segment = _plugin->nextSegment(seg);
+
+        std::lock_guard<std::mutex> lock(_plugin->_mutex);
+        if (!got_segment) {
+            _plugin->_feed_completed = true;
+            _plugin->_segment_done.notify_all();
+            break;
+        }
+        auto next = std::make_shared<Segment>();
+        next->url = seg.urlString();
+        _plugin->_segments.push_back(next);
+        _plugin->_segment_queued.notify_one();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Thread which downloads segments.
+//----------------------------------------------------------------------------
+
+ts::hls::InputPlugin::Downloader::Downloader(InputPlugin* plugin) :
+    request(*plugin),
+    _plugin(plugin),
+    _cookies_file(TempFile(u".cookies"))
+{
+}
+
+ts::hls::InputPlugin::Downloader::~Downloader()
+{
+    waitForTermination();
+    fs::remove(_cookies_file, &ErrCodeReport());
+}
+
+void ts::hls::InputPlugin::Downloader::main()
+{
+    std::unique_lock<std::mutex> lock(_plugin->_mutex);
+    for (;;) {
+        // Wait for the first segment which is not yet downloaded.
+        SegmentPtr seg;
+        _plugin->_segment_queued.wait(lock, [this, &seg]() {
+            for (const auto& s : _plugin->_segments) {
+                if (!s->started) {
+                    seg = s;
+                    break;
+                }
+            }
+            return _plugin->_terminate || seg != nullptr;
+        });
+        if (_plugin->_terminate) {
+            break;
+        }
+        seg->started = true;
+
+        // Download the segment without holding the mutex.
+        lock.unlock();
+        _plugin->debug(u"downloading segment %s", seg->url);
+        request.setArgs(_plugin->webArgs);
+        request.setAutoRedirect(true);
+        {
+            // Get the authentication tokens from the playlist, in the private cookies file of this thread.
+            std::lock_guard<std::mutex> cookies_lock(_plugin->_cookies_mutex);
+            if (fs::exists(_plugin->webArgs.cookiesFile)) {
+                fs::copy_file(_plugin->webArgs.cookiesFile, _cookies_file, fs::copy_options::overwrite_existing, &ErrCodeReport(*_plugin, u"error copying", _plugin->webArgs.cookiesFile));
+            }
+        }
+        request.enableCookies(_cookies_file);
+        const bool success = request.downloadBinaryContent(seg->url, seg->data);
+
+        // Automatically save media segments when requested. Display errors but do not fail, this is just auto save.
+        const UString name(BaseName(URL(request.finalURL()).getPath()));
+        if (success && !_plugin->_saveDirectory.empty() && !name.empty()) {
+            seg->data.saveToFile(_plugin->_saveDirectory + fs::path::preferred_separator + name, _plugin);
+        }
+
+        lock.lock();
+        seg->success = success;
+        seg->done = true;
+        _plugin->_segment_done.notify_all();
+    }
+}
@@ -15,6 +15,7 @@
 #include "tsAbstractHTTPInputPlugin.h"
 #include "tshlsPlayList.h"
 #include "tsURL.h"
+#include "tsThread.h"
 
 namespace ts {
     namespace hls {
@@ -34,6 +35,8 @@ namespace ts {
             virtual bool start() override;
             virtual bool stop() override;
             virtual bool isRealTime() override;
+            virtual bool abortInput() override;
+            virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
 
         protected:
             // Implementation of AbstractHTTPInputPlugin
@@ -60,10 +63,82 @@ namespace ts {
             UString  _altName {};
             UString  _altGroupId {};
             UString  _altLanguage {};
+            UString  _saveDirectory {};
+            size_t   _prefetch = 0;
 
             // Working data:
             size_t   _segmentCount = 0;
             PlayList _playlist {};
+
+            // With --prefetch, several media segments are downloaded in parallel into memory.
+            // The segments are delivered in playlist order.
+            class Segment
+            {
+            public:
+                UString   url {};            // Segment URL.
+                ByteBlock data {};           // Segment content, when downloaded.
+                bool      started = false;   // Download started.
+                bool      done = false;      // Download completed.
+                bool      success = false;   // Download successful.
+            };
+            using SegmentPtr = std::shared_ptr<Segment>;
+
+            // Thread which feeds the list of segments to download from the playlist.
+            // The playlist is reloaded in this thread, in parallel with the downloads.
+            class Feeder : public Thread
+            {
+                TS_NOBUILD_NOCOPY(Feeder);
+            public:
+                Feeder(InputPlugin* plugin);
+                virtual ~Feeder() override;
+            protected:
+                virtual void main() override;
+            private:
+                InputPlugin* _plugin;
+            };
+
+            // Thread which downloads segments. Each thread uses its own cookies file, which is
+            // initialized from the cookies file of the playlist before each download.
+            class Downloader : public Thread
+            {
+                TS_NOBUILD_NOCOPY(Downloader);
+            public:
+                Downloader(InputPlugin* plugin);
+                virtual ~Downloader() override;
+                WebRequest request;  // Web request for the current segment, can be aborted.
+            protected:
+                virtual void main() override;
+            private:
+                InputPlugin* _plugin;
+                fs::path     _cookies_file;
+            };
+
+            Feeder                   _feeder {this};
+            std::mutex               _cookies_mutex {};       // Protect the cookies file of the playlist during reload and copy.
+            std::mutex               _mutex {};               // Protect all following fields.
+            std::vector<std::unique_ptr<Downloader>> _downloaders {};
+            std::condition_variable  _segment_queued {};      // Signaled when a segment is added.
+            std::condition_variable  _segment_done {};        // Signaled when a segment is downloaded.
+            std::condition_variable  _segment_consumed {};    // Signaled when a segment is consumed.
+            std::deque<SegmentPtr>   _segments {};            // Segments to deliver, in playlist order.
+            bool                     _feed_completed = false; // No more segment in the playlist.
+            bool                     _terminate = false;      // Terminate all threads.
+            SegmentPtr               _current {};             // Segment being delivered, owned by the plugin thread.
+            size_t                   _current_offset = 0;     // Next byte to deliver in _current.
+
+            // Check if the playlist is completed, reload it when necessary. Return false when completed.
+            bool nextSegment(MediaSegment& seg);
+
+            // Wait some time, unless the plugin is terminated. Return false when terminated.
+            bool waitForRetry(cn::milliseconds duration);
+
+            // Reload the playlist, under the protection of _cookies_mutex.
+            bool reloadPlaylist(bool strict);
+
+            // Start/abort/stop the prefetch threads.
+            bool startPrefetch();
+            void abortPrefetch();
+            void stopPrefetch();
         };
     }
 }
@@ -10,12 +10,18 @@
 #include "tsPluginRepository.h"
 #include "tsOneShotPacketizer.h"
 #include "tsErrCodeReport.h"
+#include "tsNullReport.h"
+#include "tsReportBuffer.h"
+#include "tsVersionInfo.h"
 #include "tsPESPacket.h"
 #include "tsPAT.h"
 #include "tsPMT.h"
 
 TS_REGISTER_OUTPUT_PLUGIN(u"hls", ts::hls::OutputPlugin);
 
+#define HTTP_BACKLOG        16  // Pending connections on the embedded HTTP server
+#define HTTP_MAX_REQUEST  8192  // Maximum size of request headers on the embedded HTTP server
+
 
 //----------------------------------------------------------------------------
 // Output constructor
@@ -46,6 +52,14 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"Using this option, all packets before all starting conditions are dropped. "
          u"Note that subsequent output segments always start with a copy of the last PAT and PMT.");
 
+    option(u"async-write");
+    help(u"async-write",
+         u"Write the media segments and the playlist in a separate thread. "
+         u"Each media segment is built in memory. When it is complete, the segment file is written, "
+         u"the playlist is updated and the obsolete segments are deleted in the background. "
+         u"This avoids stalling the processing chain at segment boundaries on slow storage or network file systems. "
+         u"See also option --max-queued-segments.");
+
     option(u"custom-tag", 'c', STRING, 0, UNLIMITED_COUNT);
     help(u"custom-tag", u"'string'",
          u"Specify a custom tag to add in the playlist files. "
@@ -69,6 +83,17 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"When --fixed-segment-size is specified, the --duration parameter is only "
          u"used as a hint in the playlist file.");
 
+    option(u"http-server", 0, IPSOCKADDR_OA);
+    help(u"http-server",
+         u"With --live and --playlist, start a rudimentary embedded HTTP server on the specified local TCP port. "
+         u"The server sends the playlist and the media segments which are still referenced in the playlist "
+         u"or kept with --live-extra-segments. The content of these segments is retained in memory, "
+         u"the server never reads the segment files. "
+         u"The resource name of the playlist is its file name. The resource names of the media segments are "
+         u"their URI in the playlist, relative to the playlist. "
+         u"When present, the optional address shall specify a local IP address or host name. "
+         u"By default, the server listens on all local interfaces.");
+
     option(u"intra-close", 'i');
     help(u"intra-close",
          u"Start new segments on the start of an intra-coded image (I-Frame) of the reference video PID. "
@@ -99,6 +124,12 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"The extra segments were recently referenced in the playlist and can be downloaded by clients after their removal from the playlist. "
          u"The default is " + UString::Decimal(DEFAULT_LIVE_EXTRA_DEPTH) + u" segments.");
 
+    option(u"max-queued-segments", 0, POSITIVE);
+    help(u"max-queued-segments",
+         u"With --async-write, specify the maximum number of completed segments which are waiting to be written. "
+         u"When this number is reached, the output is suspended until one segment is written. "
+         u"The default is " + UString::Decimal(DEFAULT_MAX_QUEUED) + u" segments.");
+
     option<cn::seconds>(u"max-extra-duration", 'm');
     help(u"max-extra-duration",
          u"With --intra-close, specify the maximum additional duration in seconds after which "
@@ -161,6 +192,9 @@ bool ts::hls::OutputPlugin::getOptions()
     getIntValue(_initialMediaSeq, u"start-media-sequence", 0);
     getIntValues(_closeLabels, u"label-close");
     getValues(_customTags, u"custom-tag");
+    _asyncWrite = present(u"async-write");
+    getIntValue(_maxQueuedSegments, u"max-queued-segments", DEFAULT_MAX_QUEUED);
+    getSocketValue(_httpAddress, u"http-server");
 
     if (present(u"event")) {
         _playlistType = hls::PlayListType::EVENT;
@@ -186,6 +220,11 @@ bool ts::hls::OutputPlugin::getOptions()
         return false;
     }
 
+    if (useHTTPServer() && (_liveDepth == 0 || _playlistFile.empty())) {
+        error(u"option --http-server requires --live and --playlist");
+        return false;
+    }
+
     return true;
 }
 
@@ -224,11 +263,32 @@ bool ts::hls::OutputPlugin::start()
     if (_segmentFile.isOpen()) {
         _segmentFile.close(*this);
     }
+    _segmentOpen = false;
+    _segmentPackets.clear();
     if (!_playlistFile.empty()) {
         _playlist.reset(_playlistType, _playlistFile);
         _playlist.setTargetDuration(_targetDuration, *this);
         _playlist.setMediaSequence(_initialMediaSeq, *this);
     }
+
+    // Start the embedded HTTP server.
+    if (useHTTPServer() && !startHTTPServer()) {
+        return false;
+    }
+
+    // Start the writer thread.
+    if (_asyncWrite) {
+        _jobs.clear();
+        _writerTerminate = false;
+        _writeError = false;
+        if (!_writer.start()) {
+            error(u"cannot start segment writer thread");
+            if (useHTTPServer()) {
+                stopHTTPServer();
+            }
+            return false;
+        }
+    }
     return true;
 }
 
@@ -239,8 +299,25 @@ bool ts::hls::OutputPlugin::start()
 
 bool ts::hls::OutputPlugin::stop()
 {
-    // Simply close the current segment (and generate the corresponding playlist).
-    return closeCurrentSegment(true);
+    // Close the current segment (and generate the corresponding playlist).
+    bool ok = closeCurrentSegment(true);
+
+    // Wait for all segments to be written.
+    if (_asyncWrite) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _writerTerminate = true;
+            _jobQueued.notify_all();
+        }
+        _writer.waitForTermination();
+        ok = ok && !_writeError;
+    }
+
+    // Stop the embedded HTTP server.
+    if (useHTTPServer()) {
+        stopHTTPServer();
+    }
+    return ok;
 }
 
 
@@ -258,9 +335,14 @@ bool ts::hls::OutputPlugin::createNextSegment()
     // Generate a new segment file name.
     const UString fileName(_nameGenerator.newFileName());
 
-    // Create the segment file.
+    // Create the segment file. With --async-write, the segment is built in memory and written later.
     verbose(u"creating media segment %s", fileName);
-    if (!_segmentFile.open(fileName, TSFile::WRITE | TSFile::SHARED, *this)) {
+    _segmentPackets.clear();
+    if (_asyncWrite) {
+        _segmentOpen = true;
+        _segmentName = fileName;
+    }
+    else if (!_segmentFile.open(fileName, TSFile::WRITE | TSFile::SHARED, *this)) {
         return false;
     }
 
@@ -287,16 +369,31 @@ bool ts::hls::OutputPlugin::createNextSegment()
 bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
 {
     // If no segment file is open, there is nothing to do.
-    if (!_segmentFile.isOpen()) {
+    if (!segmentIsOpen()) {
         return true;
     }
 
     // Get the segment file name and size (to be inserted in the playlist).
-    const UString segName(_segmentFile.getFileName());
-    const PacketCounter segPackets = _segmentFile.writePacketsCount();
+    const UString segName(_asyncWrite ? _segmentName : UString(_segmentFile.getFileName()));
+    const PacketCounter segPackets = segmentPacketCount();
+
+    // With --async-write or --http-server, the content of the segment was built in memory.
+    SegmentContent content;
+    if (_asyncWrite || useHTTPServer()) {
+        auto packets = std::make_shared<TSPacketVector>();
+        packets->swap(_segmentPackets);
+        content = packets;
+    }
 
+    // With --async-write, the segment, the playlist and the deletions are passed to the writer thread.
+    WriteJob job;
+    if (_asyncWrite) {
+        job.segmentName = segName;
+        job.packets = content;
+        _segmentOpen = false;
+    }
     // Close the TS file.
-    if (!_segmentFile.close(*this)) {
+    else if (!_segmentFile.close(*this)) {
         return false;
     }
 
@@ -352,8 +449,17 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
             _playlist.addCustomTag(u"EXT-X-INDEPENDENT-SEGMENTS");
         }
 
+        // Publish the new segment and the updated playlist on the embedded HTTP server.
+        if (useHTTPServer()) {
+            publishSegment(_playlist.segment(_playlist.segmentCount() - 1).relative_uri, content);
+        }
+
         // Write the playlist file.
-        if (!_playlist.saveFile(UString(), *this)) {
+        if (_asyncWrite) {
+            job.hasPlaylist = true;
+            job.playlist = _playlist;
+        }
+        else if (!SavePlayList(_playlist, _playlistFile, *this)) {
             return false;
         }
 
@@ -365,33 +471,375 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
         //   is already open (the file actually disappears when the file is closed).
     }
 
-    // Keep a list of segments we fail to delete (maybe because they are locked by the Web server).
-    UStringList failedDelete;
-
-    // On live streams, purge obsolete segment files.
+    // On live streams, collect obsolete segment files.
+    UStringList obsolete;
     while (_liveDepth > 0 && _liveSegmentFiles.size() > _liveDepth + _liveExtraDepth) {
-
         // Remove name of the file to delete from the list of active segment.
-        const UString name(_liveSegmentFiles.front());
+        obsolete.push_back(_liveSegmentFiles.front());
         _liveSegmentFiles.pop_front();
+    }
+
+    if (_asyncWrite) {
+        job.obsoleteFiles.swap(obsolete);
+        return queueJob(std::move(job));
+    }
+
+    // Purge obsolete segment files.
+    DeleteFiles(obsolete, *this);
+
+    // Re-insert segments we failed to delete at head of list so that we will retry to delete them next time.
+    if (!obsolete.empty()) {
+        _liveSegmentFiles.insert(_liveSegmentFiles.begin(), obsolete.begin(), obsolete.end());
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Delete obsolete segment files.
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::DeleteFiles(UStringList& files, Report& report)
+{
+    // Keep a list of segments we fail to delete (maybe because they are locked by the Web server).
+    UStringList failedDelete;
 
-        // Delete the segment file.
-        verbose(u"deleting obsolete segment file %s", name);
-        if (!fs::remove(name, &ErrCodeReport(*this, u"error deleting", name)) && fs::exists(name)) {
+    for (const auto& name : files) {
+        report.verbose(u"deleting obsolete segment file %s", name);
+        if (!fs::remove(name, &ErrCodeReport(report, u"error deleting", name)) && fs::exists(name)) {
             // Failed to delete, keep it to retry later.
             failedDelete.push_back(name);
         }
     }
+    files.swap(failedDelete);
+}
 
-    // Re-insert segments we failed to delete at head of list so that we will retry to delete them next time.
-    if (!failedDelete.empty()) {
-        _liveSegmentFiles.insert(_liveSegmentFiles.begin(), failedDelete.begin(), failedDelete.end());
+
+//----------------------------------------------------------------------------
+// Save a playlist in a temporary file first, then rename it.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::SavePlayList(const hls::PlayList& playlist, const fs::path& name, Report& report)
+{
+    const UString tmp_name(UString(name) + u".tmp");
+    if (!playlist.saveFile(tmp_name, report)) {
+        fs::remove(tmp_name, &ErrCodeReport());
+        return false;
+    }
+    bool success = true;
+    fs::rename(tmp_name, name, &ErrCodeReport(success, report, u"error renaming", tmp_name));
+    if (!success) {
+        fs::remove(tmp_name, &ErrCodeReport());
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Queue a write job for the writer thread (with --async-write).
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::queueJob(WriteJob&& job)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Wait until the queue is not full. The first job in the queue is being written.
+    _jobDone.wait(lock, [this]() { return _writeError || _jobs.size() < _maxQueuedSegments; });
+    if (_writeError) {
+        return false;
+    }
+    _jobs.push_back(std::move(job));
+    _jobQueued.notify_all();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Thread which writes segments and playlists (with --async-write).
+//----------------------------------------------------------------------------
+
+ts::hls::OutputPlugin::Writer::Writer(OutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::hls::OutputPlugin::Writer::~Writer()
+{
+    waitForTermination();
+}
+
+void ts::hls::OutputPlugin::Writer::main()
+{
+    std::unique_lock<std::mutex> lock(_plugin->_mutex);
+    for (;;) {
+        // Wait for a job. On termination, write all pending jobs first.
+        _plugin->_jobQueued.wait(lock, [this]() { return _plugin->_writerTerminate || !_plugin->_jobs.empty(); });
+        if (_plugin->_jobs.empty()) {
+            break;
+        }
+
+        // The job remains in the queue while it is written, without holding the mutex.
+        // The plugin thread only appends jobs to the list, the first one is not modified.
+        const WriteJob& job(_plugin->_jobs.front());
+        lock.unlock();
+        const bool ok = writeJob(job);
+        lock.lock();
+
+        _plugin->_jobs.pop_front();
+        if (!ok) {
+            _plugin->_writeError = true;
+        }
+        _plugin->_jobDone.notify_all();
+    }
+}
+
+bool ts::hls::OutputPlugin::Writer::writeJob(const WriteJob& job)
+{
+    // Write the segment file in one operation.
+    TSFile file;
+    if (!file.open(job.segmentName, TSFile::WRITE | TSFile::SHARED, *_plugin) ||
+        !file.writePackets(job.packets->data(), nullptr, job.packets->size(), *_plugin) ||
+        !file.close(*_plugin))
+    {
+        return false;
     }
 
+    // Then publish the playlist, now that the new segment is complete.
+    if (job.hasPlaylist && !SavePlayList(job.playlist, _plugin->_playlistFile, *_plugin)) {
+        return false;
+    }
+
+    // Finally purge obsolete segment files, including those we previously failed to delete.
+    _failedDelete.insert(_failedDelete.end(), job.obsoleteFiles.begin(), job.obsoleteFiles.end());
+    DeleteFiles(_failedDelete, *_plugin);
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Start and stop the embedded HTTP server (with --http-server).
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::startHTTPServer()
+{
+    _httpTerminate = false;
+    _httpPlayListName = u"/" + UString(_playlistFile.filename());
+    _httpPlayList.clear();
+    _httpSegments.clear();
+    _httpSegmentNames.clear();
+
+    if (!_httpServer.open(_httpAddress.generation(), *this)) {
+        return false;
+    }
+    if (!_httpServer.reusePort(true, *this) || !_httpServer.bind(_httpAddress, *this) || !_httpServer.listen(HTTP_BACKLOG, *this)) {
+        _httpServer.close(*this);
+        return false;
+    }
+    if (!_httpAcceptor.start()) {
+        error(u"cannot start HTTP server thread");
+        _httpServer.close(*this);
+        return false;
+    }
+    return true;
+}
+
+void ts::hls::OutputPlugin::stopHTTPServer()
+{
+    // Interrupt clients which wait for a request or send data.
+    {
+        std::lock_guard<std::mutex> lock(_httpMutex);
+        _httpTerminate = true;
+        for (const auto& cl : _httpClients) {
+            if (!cl->done) {
+                cl->conn.disconnect(NULLREP);
+            }
+        }
+    }
+    // Closing the server socket interrupts the acceptor thread.
+    _httpServer.close(*this);
+    _httpAcceptor.waitForTermination();
+    // Deallocating a client waits for the termination of its thread.
+    _httpClients.clear();
+    _httpSegments.clear();
+    _httpSegmentNames.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Publish a new segment and the updated playlist (with --http-server).
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::publishSegment(const UString& uri, const SegmentContent& content)
+{
+    // Build the new playlist text outside the mutex.
+    const std::string playlist(_playlist.textContent(*this).toUTF8());
+    const UString name(u"/" + uri);
+
+    std::lock_guard<std::mutex> lock(_httpMutex);
+    _httpPlayList = playlist;
+    _httpSegments[name] = content;
+    _httpSegmentNames.push_back(name);
+
+    // Keep the same segments as on disk: the live ones and the extra ones.
+    while (_httpSegmentNames.size() > _liveDepth + _liveExtraDepth) {
+        _httpSegments.erase(_httpSegmentNames.front());
+        _httpSegmentNames.pop_front();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Thread accepting new clients of the embedded HTTP server.
+//----------------------------------------------------------------------------
+
+ts::hls::OutputPlugin::HTTPAcceptor::HTTPAcceptor(OutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::hls::OutputPlugin::HTTPAcceptor::~HTTPAcceptor()
+{
+    waitForTermination();
+}
+
+void ts::hls::OutputPlugin::HTTPAcceptor::main()
+{
+    _plugin->debug(u"HTTP server thread started");
+
+    // Accept errors are buffered, an error is normal when the server is closed by stop().
+    ReportBuffer<ThreadSafety::None> error(_plugin->maxSeverity());
+
+    for (;;) {
+        // Wait for a new incoming client.
+        auto client = std::make_unique<HTTPClient>(_plugin);
+        if (!_plugin->_httpServer.accept(client->conn, client->address, error)) {
+            // Report the error only if the server was not closed by stop().
+            std::lock_guard<std::mutex> lock(_plugin->_httpMutex);
+            if (!_plugin->_httpTerminate && !error.empty()) {
+                _plugin->error(error.messages());
+            }
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(_plugin->_httpMutex);
+        if (_plugin->_httpTerminate) {
+            client->conn.disconnect(NULLREP);
+            client->conn.close(NULLREP);
+            break;
+        }
+
+        // Deallocate the completed clients. The destructor waits for the termination of the thread.
+        _plugin->_httpClients.remove_if([](const std::unique_ptr<HTTPClient>& cl) { return cl->done; });
+
+        // Start a thread for the new client, unless there are too many clients.
+        if (_plugin->_httpClients.size() >= MAX_HTTP_CLIENTS) {
+            _plugin->warning(u"too many HTTP clients, rejecting connection from %s", client->address);
+            client->conn.disconnect(NULLREP);
+            client->conn.close(NULLREP);
+        }
+        else if (client->start()) {
+            _plugin->debug(u"HTTP client connected from %s", client->address);
+            _plugin->_httpClients.push_back(std::move(client));
+        }
+        else {
+            _plugin->error(u"cannot start HTTP client thread");
+            client->conn.disconnect(NULLREP);
+            client->conn.close(NULLREP);
+        }
+    }
+
+    _plugin->debug(u"HTTP server thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Client thread of the embedded HTTP server.
+//----------------------------------------------------------------------------
+
+ts::hls::OutputPlugin::HTTPClient::HTTPClient(OutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::hls::OutputPlugin::HTTPClient::~HTTPClient()
+{
+    waitForTermination();
+}
+
+void ts::hls::OutputPlugin::HTTPClient::main()
+{
+    // Read the request headers, until an empty line. Only the first line, the request, is used.
+    std::string headers;
+    bool ok = true;
+    while (ok && headers.find("\r\n\r\n") == std::string::npos && headers.find("\n\n") == std::string::npos) {
+        char buffer[512];
+        size_t ret_size = 0;
+        ok = headers.size() < HTTP_MAX_REQUEST && conn.receive(buffer, sizeof(buffer), ret_size, nullptr, NULLREP);
+        headers.append(buffer, ok ? ret_size : 0);
+    }
+
+    if (ok) {
+        // Expected request: "GET /resource HTTP/1.1", ignore the query part of the resource.
+        UString request(UString::FromUTF8(headers.substr(0, headers.find('\n'))));
+        request.trim();
+        _plugin->debug(u"HTTP request from %s: %s", address, request);
+        UStringVector fields;
+        request.split(fields, u' ', true, true);
+        const bool is_get = fields.size() >= 3 && fields[0] == u"GET" && fields[2].starts_with(u"HTTP/");
+        UString resource(fields.size() >= 2 ? fields[1] : UString());
+        resource.resize(std::min(resource.size(), resource.find(u'?')));
+
+        // Get the requested content. The segment content is sent without holding the mutex.
+        std::string playlist;
+        SegmentContent segment;
+        if (is_get) {
+            std::lock_guard<std::mutex> lock(_plugin->_httpMutex);
+            if (resource == _plugin->_httpPlayListName) {
+                playlist = _plugin->_httpPlayList;
+            }
+            else {
+                const auto it = _plugin->_httpSegments.find(resource);
+                if (it != _plugin->_httpSegments.end()) {
+                    segment = it->second;
+                }
+            }
+        }
+
+        if (!is_get) {
+            sendResponse("400 Bad Request", "", nullptr, 0);
+        }
+        else if (segment != nullptr) {
+            sendResponse("200 OK", "video/mp2t", segment->data(), segment->size() * PKT_SIZE);
+        }
+        else if (!playlist.empty()) {
+            sendResponse("200 OK", "application/vnd.apple.mpegurl", playlist.data(), playlist.size());
+        }
+        else {
+            sendResponse("404 Not Found", "", nullptr, 0);
+        }
+    }
+
+    // Close the connection while holding the mutex: the plugin thread may disconnect it.
+    // Then, tell the acceptor that this client can be deallocated.
+    std::lock_guard<std::mutex> lock(_plugin->_httpMutex);
+    conn.disconnect(NULLREP);
+    conn.close(NULLREP);
+    done = true;
+}
+
+bool ts::hls::OutputPlugin::HTTPClient::sendResponse(const std::string& status, const std::string& type, const void* data, size_t size)
+{
+    _plugin->debug(u"HTTP response to %s: %s", address, status);
+    std::string header("HTTP/1.1 " + status + "\r\nServer: TSDuck/" TS_VERSION_STRING "\r\n");
+    if (!type.empty()) {
+        header += "Content-Type: " + type + "\r\n";
+    }
+    header += "Content-Length: " + std::to_string(size) + "\r\nConnection: close\r\n\r\n";
+    return conn.send(header.data(), header.size(), NULLREP) && (size == 0 || conn.send(data, size, NULLREP));
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of TableHandlerInterface.
 //----------------------------------------------------------------------------
@@ -477,8 +925,11 @@ bool ts::hls::OutputPlugin::writePackets(const TSPacket* pkt, size_t packetCount
             }
         }
 
-        // Write the packet in the segment file.
-        if (!_segmentFile.writePackets(p, nullptr, 1, *this)) {
+        // Write the packet in the segment file and/or in memory.
+        if (_asyncWrite || useHTTPServer()) {
+            _segmentPackets.push_back(*p);
+        }
+        if (!_asyncWrite && !_segmentFile.writePackets(p, nullptr, 1, *this)) {
             return false;
         }
     }
@@ -531,7 +982,7 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
             bool renewOnPUSI = false;
             if (_fixedSegmentSize > 0) {
                 // Each segment shall have a fixed size.
-                renewNow = _segmentFile.writePacketsCount() >= _fixedSegmentSize;
+                renewNow = segmentPacketCount() >= _fixedSegmentSize;
             }
             else if (!_segClosePending) {
                 if (pktData->hasAnyLabel(_closeLabels)) {
@@ -540,7 +991,7 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
                 }
                 else if (_pcrAnalyzer.bitrateIsValid()) {
                     // The segment file shall be closed when the estimated duration exceeds the target duration.
-                    const cn::milliseconds segDuration = PacketInterval(_pcrAnalyzer.bitrate188(), _segmentFile.writePacketsCount());
+                    const cn::milliseconds segDuration = PacketInterval(_pcrAnalyzer.bitrate188(), segmentPacketCount());
                     _segClosePending = segDuration >= _targetDuration;
                     // With --intra-close, force renew on next PES packet if extra duration is exceeded.
                     renewOnPUSI = segDuration >= _targetDuration + _maxExtraDuration;
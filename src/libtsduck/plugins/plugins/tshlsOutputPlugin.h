@@ -20,6 +20,9 @@
 #include "tsFileNameGenerator.h"
 #include "tshlsPlayList.h"
 #include "tsStreamType.h"
+#include "tsTCPServer.h"
+#include "tsTCPConnection.h"
+#include "tsThread.h"
 
 namespace ts {
     namespace hls {
@@ -27,10 +30,12 @@ namespace ts {
         //! HTTP Live Streaming (HLS) output plugin for tsp.
         //! @ingroup libtsduck plugin
         //!
-        //! The output plugin generates playlists and media segments on local files
-        //! only. It can also purge obsolete media segments and regenerate live
-        //! playlists. To setup a complete HLS server, it is necessary to setup an
-        //! external HTTP server such as Apache which simply serves these files.
+        //! The output plugin generates playlists and media segments on local files.
+        //! It can also purge obsolete media segments and regenerate live playlists.
+        //! To setup a complete HLS server, it is necessary to setup an external HTTP
+        //! server such as Apache which simply serves these files. Alternatively, with
+        //! live playlists, a rudimentary embedded HTTP server can serve the playlist
+        //! and the current media segments from memory.
         //!
         class TSDUCKDLL OutputPlugin: public ts::OutputPlugin, private TableHandlerInterface
         {
@@ -60,6 +65,9 @@ namespace ts {
             size_t             _initialMediaSeq = 0;        // Initial media sequence value.
             UStringVector      _customTags {};              // Additional custom tags.
             TSPacketLabelSet   _closeLabels {};             // Close segment on packets with any of these labels.
+            bool               _asyncWrite = false;         // Write segments and playlists in a separate thread.
+            size_t             _maxQueuedSegments = 0;      // With --async-write, maximum number of segments to write.
+            IPSocketAddress    _httpAddress {};             // With --http-server, local address of the embedded HTTP server.
 
             // Working data.
             FileNameGenerator  _nameGenerator {};           // Generate the segment file names.
@@ -72,6 +80,9 @@ namespace ts {
             bool               _segStarted = false;         // Generation of output segments has started.
             bool               _segClosePending = false;    // Close the current segment when possible.
             TSFile             _segmentFile {};             // Output segment file.
+            bool               _segmentOpen = false;        // With --async-write, a segment is being built in memory.
+            UString            _segmentName {};             // With --async-write, name of the current segment.
+            TSPacketVector     _segmentPackets {};          // With --async-write or --http-server, content of the current segment.
             UStringList        _liveSegmentFiles {};        // List of current segments in a live stream.
             hls::PlayList      _playlist {};                // Generated playlist.
             PCRAnalyzer        _pcrAnalyzer {1, 4};         // PCR analyzer to compute bitrates. Minimum required: 1 PID, 4 PCR.
@@ -82,6 +93,112 @@ namespace ts {
             static constexpr cn::seconds DEFAULT_OUT_LIVE_DURATION = cn::seconds(5);  // Default segment target duration for output live streams.
             static constexpr cn::seconds DEFAULT_EXTRA_DURATION    = cn::seconds(2);  // Default segment extra duration when intra image is not found.
             static constexpr size_t      DEFAULT_LIVE_EXTRA_DEPTH  = 1;               // Default additional segments to keep in live streams.
+            static constexpr size_t      DEFAULT_MAX_QUEUED        = 4;               // Default maximum number of segments to write with --async-write.
+            static constexpr size_t      MAX_HTTP_CLIENTS          = 64;              // Maximum number of concurrent clients with --http-server.
+
+            // Content of a completed segment, shared by the writer thread and the embedded HTTP server.
+            using SegmentContent = std::shared_ptr<const TSPacketVector>;
+
+            // With --async-write, each completed segment is a write job for the writer thread.
+            class WriteJob
+            {
+            public:
+                UString        segmentName {};        // Segment file name.
+                SegmentContent packets {};            // Segment content.
+                bool           hasPlaylist = false;   // The playlist shall be written after the segment.
+                hls::PlayList  playlist {};           // Updated playlist, including this segment.
+                UStringList    obsoleteFiles {};      // Obsolete segment files to delete after the playlist.
+            };
+
+            // Thread which writes segments and playlists with --async-write.
+            class Writer : public Thread
+            {
+                TS_NOBUILD_NOCOPY(Writer);
+            public:
+                Writer(OutputPlugin* plugin);
+                virtual ~Writer() override;
+            protected:
+                virtual void main() override;
+            private:
+                OutputPlugin* _plugin;
+                UStringList   _failedDelete {};  // Segment files we failed to delete, retry later.
+                bool writeJob(const WriteJob& job);
+            };
+
+            Writer                  _writer {this};
+            std::mutex              _mutex {};                // Protect all following fields.
+            std::condition_variable _jobQueued {};            // Signaled when a job is queued or on termination.
+            std::condition_variable _jobDone {};              // Signaled when a job is completed.
+            std::list<WriteJob>     _jobs {};                 // Jobs to write, the first one is being written.
+            bool                    _writerTerminate = false; // Terminate the writer after the last job.
+            bool                    _writeError = false;      // A write error occurred in the writer thread.
+
+            // Queue a write job, wait if the queue is full. Return false on previous write error.
+            bool queueJob(WriteJob&& job);
+
+            // A client thread of the embedded HTTP server. It sends one resource and disconnects.
+            class HTTPClient : public Thread
+            {
+                TS_NOBUILD_NOCOPY(HTTPClient);
+            public:
+                HTTPClient(OutputPlugin* plugin);
+                virtual ~HTTPClient() override;
+                TCPConnection   conn {};        // Connection to the client.
+                IPSocketAddress address {};     // Client address.
+                bool            done = false;   // The thread is completed, protected by the mutex of the plugin.
+            protected:
+                virtual void main() override;
+            private:
+                OutputPlugin* _plugin;
+                bool sendResponse(const std::string& status, const std::string& type, const void* data, size_t size);
+            };
+
+            // Thread accepting new clients of the embedded HTTP server.
+            class HTTPAcceptor : public Thread
+            {
+                TS_NOBUILD_NOCOPY(HTTPAcceptor);
+            public:
+                HTTPAcceptor(OutputPlugin* plugin);
+                virtual ~HTTPAcceptor() override;
+            protected:
+                virtual void main() override;
+            private:
+                OutputPlugin* _plugin;
+            };
+
+            // Working data of the embedded HTTP server. The plugin thread publishes the playlist and
+            // the segments, the client threads send them. The content of a segment is never modified,
+            // the client threads send it without holding the mutex.
+            TCPServer                         _httpServer {};
+            HTTPAcceptor                      _httpAcceptor {this};
+            std::mutex                        _httpMutex {};             // Protect all following fields and the clients.
+            bool                              _httpTerminate = false;    // Terminate all server threads.
+            UString                           _httpPlayListName {};      // Resource name of the playlist.
+            std::string                       _httpPlayList {};          // Content of the playlist, in UTF-8.
+            std::map<UString, SegmentContent> _httpSegments {};          // Retained segments, indexed by resource name.
+            UStringList                       _httpSegmentNames {};      // Resource names of retained segments, oldest first.
+            std::list<std::unique_ptr<HTTPClient>> _httpClients {};
+
+            // Check if the embedded HTTP server is used.
+            bool useHTTPServer() const { return _httpAddress.hasPort(); }
+
+            // Start and stop the embedded HTTP server.
+            bool startHTTPServer();
+            void stopHTTPServer();
+
+            // Publish a new segment and the updated playlist on the embedded HTTP server.
+            void publishSegment(const UString& uri, const SegmentContent& content);
+
+            // Check if a segment is currently open and get its size in packets.
+            bool segmentIsOpen() const { return _asyncWrite ? _segmentOpen : _segmentFile.isOpen(); }
+            PacketCounter segmentPacketCount() const { return _asyncWrite ? _segmentPackets.size() : _segmentFile.writePacketsCount(); }
+
+            // Delete obsolete segment files. The files which cannot be deleted remain in the list.
+            static void DeleteFiles(UStringList& files, Report& report);
+
+            // Save a playlist in a temporary file first, then rename it. This way, a client which
+            // reads the playlist at the same time never gets a truncated or partially written file.
+            static bool SavePlayList(const hls::PlayList& playlist, const fs::path& name, Report& report);
 
             // Create the next segment file (also close the previous one if necessary).
             bool createNextSegment();
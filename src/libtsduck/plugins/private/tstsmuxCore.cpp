@@ -205,6 +205,7 @@ void ts::tsmux::Core::main()
 
     // Keep track of terminated input plugins.
     _terminated_inputs.clear();
+    _scheduler.reset(_inputs.size());
 
     // Next input plugin to read from.
     size_t input_index = 0;
@@ -212,8 +213,10 @@ void ts::tsmux::Core::main()
     // Reset output packet counter.
     _output_packets = 0;
 
-    TSPacket pkt;
-    TSPacketMetadata pkt_data;
+    // Output packets are sent by batches.
+    TSPacketVector packets(_opt.maxOutputPackets);
+    TSPacketMetadataVector packets_data(_opt.maxOutputPackets);
+    size_t batch_count = 0;
 
     // Loop until we are instructed to stop. Each iteration is a muxing period at the defined cadence.
     while (!_terminate) {
@@ -231,6 +234,8 @@ void ts::tsmux::Core::main()
         // Loop on packets to send during this time interval.
         while (!_terminate && packet_count > 0) {
 
+            TSPacket& pkt(packets[batch_count]);
+            TSPacketMetadata& pkt_data(packets_data[batch_count]);
             pkt_data.reset();
 
             // This section selects packets to insert. Initially, the insertion strategy was very basic.
@@ -252,7 +257,7 @@ void ts::tsmux::Core::main()
                 // Got an SDT packet.
                 next_sdt_packet += sdt_interval;
             }
-            else if (getInputPacket(input_index, pkt, pkt_data)) {
+            else if (_opt.schedule ? scheduleInputPacket(input_index, pkt, pkt_data) : getInputPacket(input_index, pkt, pkt_data)) {
                 // Got a packet from an input plugin.
             }
             else if (_eit_pzer.getNextPacket(pkt)) {
@@ -264,14 +269,18 @@ void ts::tsmux::Core::main()
                 pkt_data.setNullified(true);
             }
 
-            // Output that packet.
-            if (!_output.send(&pkt, &pkt_data, 1)) {
-                _log.error(u"output plugin terminated on error, aborting");
-                _terminate = true;
-            }
-            else {
-                _output_packets++;
-                packet_count--;
+            // The packet is now part of the output stream.
+            _output_packets++;
+            packet_count--;
+            batch_count++;
+
+            // Output the batch of packets when full, at the end of the time interval or when the last input terminates.
+            if (batch_count >= packets.size() || packet_count == 0 || _terminate) {
+                if (!_output.send(packets.data(), packets_data.data(), batch_count)) {
+                    _log.error(u"output plugin terminated on error, aborting");
+                    _terminate = true;
+                }
+                batch_count = 0;
             }
         }
 
@@ -281,6 +290,18 @@ void ts::tsmux::Core::main()
         }
     }
 
+    // Report scheduling statistics.
+    if (_opt.schedule) {
+        for (const auto& input : _inputs) {
+            input->reportStatistics();
+        }
+    }
+
+    // When all input plugins have naturally terminated, send the last packets before terminating the output.
+    if (_terminated_inputs.size() >= _inputs.size()) {
+        _output.flush();
+    }
+
     // Make sure all plugins, input and output, terminates.
     // It termination was externally triggerd, all plugins are already terminating.
     // But if all inputs have naturally terminated, we must terminate the output thread.
@@ -305,11 +326,7 @@ bool ts::tsmux::Core::getInputPacket(size_t& input_index, TSPacket& pkt, TSPacke
 
         // Keep track of terminated input plugins.
         if (!success && _inputs[input_index]->isTerminated()) {
-            _terminated_inputs.insert(input_index);
-            if (_terminated_inputs.size() >= _inputs.size()) {
-                // All input plugins are now terminated. Request global termination.
-                _terminate = true;
-            }
+            setTerminatedInput(input_index);
         }
 
         // Point to next plugin.
@@ -320,6 +337,55 @@ bool ts::tsmux::Core::getInputPacket(size_t& input_index, TSPacket& pkt, TSPacke
 }
 
 
+//----------------------------------------------------------------------------
+// Get the most urgent packet from all input plugins.
+//----------------------------------------------------------------------------
+
+bool ts::tsmux::Core::scheduleInputPacket(size_t& input_index, TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    // Declare the inputs with a packet which can be inserted now to the scheduler.
+    // Inputs are checked starting at the rotating index to share the output between inputs with equal deadlines.
+    _scheduler.startSelection();
+    for (size_t count = 0; count < _inputs.size(); ++count) {
+        const size_t index = (input_index + count) % _inputs.size();
+        Input* const input = _inputs[index];
+        if (input->ready()) {
+            _scheduler.addCandidate(index, input->nextHasPCR());
+        }
+        else if (input->isTerminated()) {
+            setTerminatedInput(index);
+        }
+    }
+
+    // Point to next plugin for next round.
+    input_index = (input_index + 1) % _inputs.size();
+
+    const size_t selected = _scheduler.selected();
+    if (selected != NPOS && !_terminate) {
+        _inputs[selected]->takePacket(pkt, pkt_data);
+        _scheduler.packetInserted(selected, _output_packets, _bitrate);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Keep track of a terminated input plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsmux::Core::setTerminatedInput(size_t input_index)
+{
+    _terminated_inputs.insert(input_index);
+    if (_terminated_inputs.size() >= _inputs.size()) {
+        // All input plugins are now terminated. Request global termination.
+        _terminate = true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Try to extract a UTC time from a TDT or TOT in one TS packet.
 //----------------------------------------------------------------------------
@@ -401,10 +467,17 @@ ts::tsmux::Core::Input::Input(Core& core, size_t index) :
     _eit_demux(_core._duck, nullptr, this),
     _pcr_merger(_core._duck),
     _nit(),
+    _has_next(false),
     _next_insertion(0),
     _next_packet(),
     _next_metadata(),
-    _pid_clocks()
+    _bitrate(0),
+    _ref_pid(PID_NULL),
+    _ref_pcr(INVALID_PCR),
+    _ref_count(0),
+    _null_count(0),
+    _pid_clocks(),
+    _pid_buffers()
 {
     // Filter all global PSI/SI for merging in output PSI.
     _demux.addPID(PID_PAT);
@@ -435,52 +508,130 @@ ts::tsmux::Core::Input::Input(Core& core, size_t index) :
 
 bool ts::tsmux::Core::Input::getPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    // If there is a waiting packet, either return that packet or nothing.
-    if (_next_insertion > 0) {
-        if (_next_insertion <= _core._output_packets) {
-            // It is now time to return that packet.
-            _core._log.debug(u"input #%d, PID %n, output packet %'d, restarting insertion", _plugin_index, _next_packet.getPID(), _core._output_packets);
-            _next_insertion = 0;
-            pkt = _next_packet;
-            pkt_data = _next_metadata;
-            adjustPCR(pkt);
-            return true;
+    if (ready()) {
+        takePacket(pkt, pkt_data);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the next input packet can be inserted now in the output stream.
+//----------------------------------------------------------------------------
+
+bool ts::tsmux::Core::Input::ready()
+{
+    // Get packets from the input executor thread, non-blocking, until one shall be inserted.
+    while (!_has_next && !_terminated) {
+        size_t ret_count = 0;
+        _terminated = !_input.getPackets(&_next_packet, &_next_metadata, 1, ret_count, false);
+        if (_terminated || ret_count == 0) {
+            return false;
         }
-        else {
-            // Not yet time to release a packet from that input stream.
+        _has_next = receivePacket();
+    }
+
+    // If there is a waiting packet, check if it is time to insert it.
+    if (!_has_next || _next_insertion > _core._output_packets) {
+        return false;
+    }
+
+    // With scheduling, the packet must not overflow the transport buffer of its PID.
+    if (_core._opt.schedule) {
+        const auto buf = _pid_buffers.find(_next_packet.getPID());
+        if (buf != _pid_buffers.end() && !buf->second.model.canInsert(_core._output_packets, _core._bitrate)) {
             return false;
         }
     }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the packet which was checked by ready().
+//----------------------------------------------------------------------------
+
+void ts::tsmux::Core::Input::takePacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    if (_next_insertion > 0) {
+        _core._log.debug(u"input #%d, PID %n, output packet %'d, restarting insertion", _plugin_index, _next_packet.getPID(), _core._output_packets);
+        _next_insertion = 0;
+    }
+    _has_next = false;
+    pkt = _next_packet;
+    pkt_data = _next_metadata;
+
+    // Adjust the PCR at the actual insertion point of the packet.
+    adjustPCR(pkt);
 
-    // Get one packet from the input executor thread, non-blocking.
-    size_t ret_count = 0;
-    _terminated = _terminated || !_input.getPackets(&pkt, &pkt_data, 1, ret_count, false);
-    if (_terminated || ret_count == 0) {
+    // Fill the transport buffer of the PID.
+    if (_core._opt.schedule) {
+        _pid_buffers[pkt.getPID()].model.insert(_core._output_packets, _core._bitrate);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process a new input packet. Return true if the packet shall be inserted.
+//----------------------------------------------------------------------------
+
+bool ts::tsmux::Core::Input::receivePacket()
+{
+    const PID pid = _next_packet.getPID();
+
+    // With scheduling, input null packets are removed. They are replaced by useful packets from other inputs.
+    if (pid == PID_NULL && _core._opt.schedule) {
+        _null_count++;
         return false;
     }
-    const PID pid = pkt.getPID();
 
     // Feed the two PSI/SI demux.
-    _demux.feedPacket(pkt);
-    _eit_demux.feedPacket(pkt);
+    _demux.feedPacket(_next_packet);
+    _eit_demux.feedPacket(_next_packet);
 
     // If this is TDT/TOT PID, check if we need to pass it.
     if (pid == PID_TDT && _core._time_input_index == NPOS) {
         // Time PID not yet selected. If we find a time here, we will use that plugin.
         Time utc;
-        if (_core.getUTC(utc, pkt)) {
+        if (_core.getUTC(utc, _next_packet)) {
             // From now on, we will use that input plugin as time reference.
             _core._time_input_index = _plugin_index;
             _core._log.verbose(u"using input #%d as TDT/TOT reference", _plugin_index);
         }
     }
 
+    // Don't return packets from predefined PID's, they are separately regenerated.
+    if (pid <= PID_DVB_LAST && (pid != PID_TDT || _core._time_input_index != _plugin_index)) {
+        // Without scheduling, the clocks of the input are tracked in all packets, as they are received.
+        if (!_core._opt.schedule) {
+            adjustPCR(_next_packet);
+        }
+        return false;
+    }
+
+    // With scheduling, estimate the bitrates of the input and its PID's between two PCR's.
+    if (_core._opt.schedule) {
+        _ref_count++;
+        _pid_buffers[pid].input_count++;
+        if (_next_packet.hasPCR()) {
+            if (_ref_pid == PID_NULL) {
+                _ref_pid = pid;
+            }
+            if (pid == _ref_pid) {
+                updateBitrates(_next_packet.getPCR());
+            }
+        }
+    }
+
     // If the packet contains a PCR, check if it is time to insert it in the output.
     // PCR packets are inserted at the same (or similar) PCR interval as in the orginal stream.
-    if (pkt.hasPCR()) {
+    if (_next_packet.hasPCR()) {
         const auto clock = _pid_clocks.find(pid);
         if (clock != _pid_clocks.end()) {
-            const uint64_t packet_pcr = pkt.getPCR();
+            const uint64_t packet_pcr = _next_packet.getPCR();
             if (packet_pcr < clock->second.pcr_value && !WrapUpPCR(clock->second.pcr_value, packet_pcr)) {
                 const uint64_t back = DiffPCR(packet_pcr, clock->second.pcr_value);
                 _core._log.verbose(u"input #%d, PID %n, late packet by PCR %'d, %'!s", _plugin_index, pid, back, cn::duration_cast<cn::milliseconds>(PCR(back)));
@@ -501,20 +652,56 @@ bool ts::tsmux::Core::Input::getPacket(TSPacket& pkt, TSPacketMetadata& pkt_data
                         // This packet will be inserted later.
                         _core._log.debug(u"input #%d, PID %n, output packet %'d, delay packet by %'d packets", _plugin_index, pid, _core._output_packets, target_packet - _core._output_packets);
                         _next_insertion = target_packet;
-                        _next_packet = pkt;
-                        _next_metadata = pkt_data;
-                        return false;
                     }
                 }
             }
         }
     }
+    return true;
+}
 
-    // Adjust and remember PCR values and position.
-    adjustPCR(pkt);
 
-    // Don't return packets from predefined PID's, they are separately regenerated.
-    return pid > PID_DVB_LAST || (pid == PID_TDT && _core._time_input_index == _plugin_index);
+//----------------------------------------------------------------------------
+// Update the bitrate estimations on a PCR in the reference PID.
+//----------------------------------------------------------------------------
+
+void ts::tsmux::Core::Input::updateBitrates(uint64_t pcr)
+{
+    // Measure only when the PCR progression is valid, less than one second.
+    const uint64_t previous = _ref_pcr;
+    _ref_pcr = pcr;
+    const bool valid = previous != INVALID_PCR && pcr > previous && pcr - previous < SYSTEM_CLOCK_FREQ;
+    const PCR duration(valid ? pcr - previous : 0);
+
+    // The packets are counted from the previous PCR packet, included, to the current one, excluded.
+    // The current PCR packet is the first one of the next interval.
+    if (valid) {
+        // The bitrate of the input is smoothed.
+        const BitRate bitrate = PacketBitRate(_ref_count - 1, duration);
+        _bitrate = _bitrate == 0 ? bitrate : (7 * _bitrate + bitrate) / 8;
+        _core._scheduler.setBitRate(_plugin_index, _bitrate);
+    }
+    _ref_count = 1;
+
+    // Update the leak rate of each transport buffer from the bitrate of its PID.
+    for (auto& it : _pid_buffers) {
+        PIDBuffer& buf(it.second);
+        if (valid) {
+            const PacketCounter count = it.first == _ref_pid ? buf.input_count - 1 : buf.input_count;
+            buf.model.setPIDBitRate(PacketBitRate(count, duration));
+        }
+        buf.input_count = it.first == _ref_pid ? 1 : 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report statistics at the end of the processing.
+//----------------------------------------------------------------------------
+
+void ts::tsmux::Core::Input::reportStatistics() const
+{
+    _core._log.verbose(u"input #%d, estimated bitrate: %'d b/s, removed null packets: %'d", _plugin_index, _bitrate, _null_count);
 }
 
 
@@ -20,6 +20,8 @@
 #include "tsSectionDemux.h"
 #include "tsCyclingPacketizer.h"
 #include "tsPCRMerger.h"
+#include "tsDeadlineScheduler.h"
+#include "tsTransportBufferModel.h"
 #include "tsPAT.h"
 #include "tsCAT.h"
 #include "tsSDT.h"
@@ -86,6 +88,15 @@ namespace ts {
                 PIDClock(uint64_t value = INVALID_PCR, PacketCounter packet = 0) : pcr_value(value), pcr_packet(packet) {}
             };
 
+            // Transport buffer (TB) of a PID in the output stream, as modelled in the T-STD of ISO/IEC 13818-1.
+            // A packet of the PID is inserted only when it does not overflow the buffer.
+            class PIDBuffer
+            {
+            public:
+                TransportBufferModel model {};   // Transport buffer model.
+                PacketCounter input_count = 0;   // Number of input packets since last rate measurement.
+            };
+
             // Core private members.
             const PluginEventHandlerRegistry& _handlers;
             Report&             _log;                      // Asynchronous log report.
@@ -111,6 +122,7 @@ namespace ts {
             std::list<SectionPtr>     _eits {};            // List of EIT sections to insert.
             std::map<PID,Origin>      _pid_origin {};      // Map of PID's to original input stream.
             std::map<uint16_t,Origin> _service_origin {};  // Map of service ids to original input stream.
+            DeadlineScheduler         _scheduler {_opt.inputs.size()};  // Scheduler of input packets (with --schedule).
 
             // Implementation of Thread.
             virtual void main() override;
@@ -119,6 +131,14 @@ namespace ts {
             // Update the plugin index. Return false if all input plugins were tried without success.
             bool getInputPacket(size_t& input_index, TSPacket& pkt, TSPacketMetadata& pkt_data);
 
+            // Get the most urgent packet from all input plugins, according to the bitrate of each input and
+            // the transport buffer of each PID. Update the plugin index for the next round. Return false if
+            // no packet can be inserted now.
+            bool scheduleInputPacket(size_t& input_index, TSPacket& pkt, TSPacketMetadata& pkt_data);
+
+            // Keep track of a terminated input plugin. Request global termination when all inputs are terminated.
+            void setTerminatedInput(size_t input_index);
+
             // Try to extract a UTC time from a TDT or TOT in one TS packet.
             bool getUTC(Time& utc, const TSPacket& pkt);
 
@@ -158,6 +178,19 @@ namespace ts {
                 // Get one input packet. Return false when none is immediately available.
                 bool getPacket(TSPacket& pkt, TSPacketMetadata& pkt_data);
 
+                // Check if the next input packet can be inserted now in the output stream.
+                // Get a new packet from the input executor thread when necessary.
+                bool ready();
+
+                // Get the packet which was checked by ready().
+                void takePacket(TSPacket& pkt, TSPacketMetadata& pkt_data);
+
+                // Scheduling: check if the next packet contains a PCR.
+                bool nextHasPCR() const { return _has_next && _next_packet.hasPCR(); }
+
+                // Report statistics at the end of the processing.
+                void reportStatistics() const;
+
             private:
                 Core&            _core;           // Reference to the parent Core.
                 const size_t     _plugin_index;   // Input plugin index.
@@ -169,10 +202,23 @@ namespace ts {
                 SectionDemux     _eit_demux;      // Demux for EIT's.
                 PCRMerger        _pcr_merger;     // Adjust PCR in input packets to be synchronized with the output stream.
                 NIT              _nit;            // NIT waiting to be merged.
+                bool             _has_next;       // There is a packet in _next_packet.
                 PacketCounter    _next_insertion; // Insertion point of next packet.
                 TSPacket         _next_packet;    // Next packet to insert if already received but not yet inserted.
                 TSPacketMetadata _next_metadata;  // Associated metadata.
-                std::map<PID,PIDClock> _pid_clocks;  // Output clock of each input PID.
+                BitRate          _bitrate;        // Scheduling: estimated bitrate of the inserted packets, zero if unknown.
+                PID              _ref_pid;        // Scheduling: reference PCR PID for bitrate estimation.
+                uint64_t         _ref_pcr;        // Scheduling: last PCR value in reference PID.
+                PacketCounter    _ref_count;      // Scheduling: number of inserted input packets since last reference PCR.
+                PacketCounter    _null_count;     // Number of removed input null packets.
+                std::map<PID,PIDClock>  _pid_clocks;   // Output clock of each input PID.
+                std::map<PID,PIDBuffer> _pid_buffers;  // Scheduling: transport buffer of each input PID.
+
+                // Process a new packet in _next_packet. Return true if the packet shall be inserted.
+                bool receivePacket();
+
+                // Update the bitrate estimations on a PCR in the reference PID.
+                void updateBitrates(uint64_t pcr);
 
                 // Adjust the PCR of a packet before insertion.
                 void adjustPCR(TSPacket& pkt);
@@ -59,37 +59,48 @@ void ts::tsmux::InputExecutor::terminate()
 
 bool ts::tsmux::InputExecutor::getPackets(TSPacket* pkt, TSPacketMetadata* mdata, size_t max_count, size_t& ret_count, bool blocking)
 {
-    // In blocking mode, loop until there is some packet in the buffer.
-    std::unique_lock<std::recursive_mutex> lock(_mutex);
-    while (!_terminate && blocking && _packets_count == 0) {
-        _got_packets.wait(lock);
+    ret_count = 0;
+    size_t head = _head.load(std::memory_order_seq_cst);
+    size_t tail = _tail.load(std::memory_order_seq_cst);
+
+    // In blocking mode, wait until there is some packet in the buffer.
+    if (blocking && head == tail && !_terminate) {
+        std::unique_lock<std::recursive_mutex> lock(_mutex);
+        _wait_packets = true;
+        while (!_terminate && (tail = _tail.load(std::memory_order_seq_cst)) == (head = _head.load(std::memory_order_seq_cst))) {
+            _got_packets.wait(lock);
+        }
+        _wait_packets = false;
     }
 
-    // Return error if the input is terminated _and_ there is no more packet to read.
-    if (_terminate && _packets_count == 0) {
-        ret_count = 0;
-        return false;
+    // In case of lossy input, the plugin thread may drop older packets while we copy them.
+    // The copy is valid only if the head index did not move in the meantime. Otherwise, retry.
+    for (;;) {
+        // Number of packets to copy from the buffer, up to the end of the circular buffer.
+        const size_t first = head % _buffer_size;
+        ret_count = std::min(std::min(max_count, tail - head), _buffer_size - first);
+        if (ret_count == 0) {
+            break;
+        }
+        TSPacket::Copy(pkt, &_packets[first], ret_count);
+        TSPacketMetadata::Copy(mdata, &_metadata[first], ret_count);
+        if (_head.compare_exchange_strong(head, head + ret_count, std::memory_order_seq_cst)) {
+            break;
+        }
+        // The head index was moved by the plugin thread, it is now in head.
+        tail = _tail.load(std::memory_order_seq_cst);
     }
 
-    // Fill what can be filled from the buffer. We are still under the mutex protection.
-    assert(_packets_count <= _buffer_size);
-
-    // Number of packets to copy from the buffer:
-    ret_count = std::min(std::min(max_count, _packets_count), _buffer_size - _packets_first);
-
-    // Copy packets if there are some.
+    // Release the free space. Wake up the plugin thread only if it waits for it.
     if (ret_count > 0) {
-        TSPacket::Copy(pkt, &_packets[_packets_first], ret_count);
-        TSPacketMetadata::Copy(mdata, &_metadata[_packets_first], ret_count);
-        _packets_first = (_packets_first + ret_count) % _buffer_size;
-        _packets_count -= ret_count;
-
-        // Signal that there are some free space.
-        // The mutex was initially locked for the _got_packets condition because we needed to wait
-        // for that condition but we can also use it to signal the _got_freespace condition.
-        _got_freespace.notify_all();
+        if (_wait_freespace.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            _got_freespace.notify_all();
+        }
     }
-    return true;
+
+    // Return error if the input is terminated _and_ there is no more packet to read.
+    return ret_count > 0 || !_terminate;
 }
 
 
@@ -105,46 +116,50 @@ void ts::tsmux::InputExecutor::main()
     while (!_terminate) {
 
         // Wait for free space to be available in the input buffer.
-        size_t first = 0;
-        size_t count = 0;
-        {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_seq_cst);
+        if (tail - head >= _buffer_size && _opt.lossyInput) {
+            // In case of lossy input, drop older packets when the buffer is full, never wait for the core thread.
+            // If the core thread concurrently read packets, there is now free space anyway.
+            const size_t dropped = std::min(_opt.lossyReclaim, _buffer_size);
+            _head.compare_exchange_strong(head, head + dropped, std::memory_order_seq_cst);
+            continue;
+        }
+        else if (tail - head >= _buffer_size) {
+            // Wait for free space in the buffer. The core thread wakes us up only if we declared that we wait.
             std::unique_lock<std::recursive_mutex> lock(_mutex);
-            // In case of lossy input, drop oldest packets when the buffer is full.
-            if (_opt.lossyInput && _packets_count >= _buffer_size) {
-                const size_t dropped = std::min(_opt.lossyReclaim, _buffer_size);
-                _packets_first = (_packets_first + dropped) % _buffer_size;
-                _packets_count -= dropped;
-            }
-            // Wait for free space in the buffer.
-            while (!_terminate && _packets_count >= _buffer_size) {
+            _wait_freespace = true;
+            while (!_terminate && tail - (head = _head.load(std::memory_order_seq_cst)) >= _buffer_size) {
                 _got_freespace.wait(lock);
             }
-            // We can use this contiguous free area at the end of already received packets.
-            first = (_packets_first + _packets_count) % _buffer_size;
-            count = std::min(_buffer_size - _packets_count, _buffer_size - first);
+            _wait_freespace = false;
+            continue;
         }
 
+        // We can use this contiguous free area at the end of already received packets.
+        const size_t first = tail % _buffer_size;
+        size_t count = std::min(_buffer_size - (tail - head), _buffer_size - first);
+
         // Read some packets.
-        if (!_terminate) {
-            count = _input->receive(&_packets[first], &_metadata[first], std::min(count, _opt.maxInputPackets));
-            if (count > 0) {
-                // Packets successfully received.
-                std::unique_lock<std::recursive_mutex> lock(_mutex);
-                _packets_count += count;
-                // Signal that there are some new packets in the buffer.
+        count = _input->receive(&_packets[first], &_metadata[first], std::min(count, _opt.maxInputPackets));
+        if (count > 0) {
+            // Packets successfully received, publish them. Wake up the core thread only if it waits for them.
+            _tail.store(tail + count, std::memory_order_seq_cst);
+            if (_wait_packets.load(std::memory_order_seq_cst)) {
+                std::lock_guard<std::recursive_mutex> lock(_mutex);
                 _got_packets.notify_all();
             }
-            else if (_opt.inputOnce) {
-                // Terminates when the input plugin terminates or fails.
-                _terminate = true;
-            }
-            else {
-                // Restart when the plugin terminates or fails.
-                verbose(u"restarting input plugin '%s' after end of stream or failure", pluginName());
-                _input->stop();
-                while (!_terminate && !_input->start()) {
-                    std::this_thread::sleep_for(_opt.inputRestartDelay);
-                }
+        }
+        else if (_opt.inputOnce) {
+            // Terminates when the input plugin terminates or fails.
+            _terminate = true;
+        }
+        else {
+            // Restart when the plugin terminates or fails.
+            verbose(u"restarting input plugin '%s' after end of stream or failure", pluginName());
+            _input->stop();
+            while (!_terminate && !_input->start()) {
+                std::this_thread::sleep_for(_opt.inputRestartDelay);
             }
         }
     }
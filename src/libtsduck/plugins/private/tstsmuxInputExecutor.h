@@ -62,6 +62,16 @@ namespace ts {
             InputPlugin* _input;         // Plugin API.
             const size_t _pluginIndex;   // Index of this input plugin.
 
+            // The packet buffer is a lock-free ring between the plugin thread (producer) and the core thread (consumer).
+            // The indexes are free-running counters, the index in the buffer is the counter modulo the buffer size.
+            // The mutex and the conditions are used only when one thread waits for the other one.
+            static constexpr size_t CACHE_LINE_SIZE = 64;
+            // In case of lossy input, the plugin thread drops older packets itself, using a compare-and-swap on the head index.
+            alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head {0};  // Next packet to read, modified by the core thread (and by the plugin thread in lossy mode).
+            alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail {0};  // Next packet to write, modified by the plugin thread only.
+            std::atomic_bool    _wait_packets {false};     // The core thread waits for packets.
+            std::atomic_bool    _wait_freespace {false};   // The plugin thread waits for free space.
+
             // Implementation of Thread.
             virtual void main() override;
         };
@@ -76,6 +76,17 @@ bool ts::tsmux::OutputExecutor::send(const TSPacket* pkt, const TSPacketMetadata
 }
 
 
+//----------------------------------------------------------------------------
+// Wait until all packets in the output buffer are sent.
+//----------------------------------------------------------------------------
+
+void ts::tsmux::OutputExecutor::flush()
+{
+    std::unique_lock<std::recursive_mutex> lock(_mutex);
+    _got_freespace.wait(lock, [this]() { return _terminate || _packets_count == 0; });
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked in the context of the output plugin thread.
 //----------------------------------------------------------------------------
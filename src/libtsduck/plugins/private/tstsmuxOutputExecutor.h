@@ -48,6 +48,11 @@ namespace ts {
             //!
             bool send(const TSPacket* pkt, const TSPacketMetadata* mdata, size_t count);
 
+            //!
+            //! Wait until all packets in the output buffer are sent or the output is terminated.
+            //!
+            void flush();
+
             // Implementation of TSP.
             virtual size_t pluginIndex() const override;
 
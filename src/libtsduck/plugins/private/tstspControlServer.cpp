@@ -49,6 +49,7 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, std
     _reference.setCommandLineHandler(this, &ControlServer::executeSuspend, u"suspend");
     _reference.setCommandLineHandler(this, &ControlServer::executeResume, u"resume");
     _reference.setCommandLineHandler(this, &ControlServer::executeRestart, u"restart");
+    _reference.setCommandLineHandler(this, &ControlServer::executeStatistics, u"statistics");
 }
 
 ts::tsp::ControlServer::~ControlServer()
@@ -319,3 +320,34 @@ ts::CommandStatus ts::tsp::ControlServer::executeRestart(const UString& command,
     }
     return CommandStatus::SUCCESS;
 }
+
+
+//----------------------------------------------------------------------------
+// Statistics command.
+//----------------------------------------------------------------------------
+
+ts::CommandStatus ts::tsp::ControlServer::executeStatistics(const UString& command, Args& args)
+{
+    if (!_options.instrumentation) {
+        args.error(u"instrumentation is not enabled, use tsp option --instrumentation");
+        return CommandStatus::ERROR;
+    }
+
+    statisticsOnePlugin(0, u'I', _input, args);
+    size_t index = 1;
+    for (size_t i = 0; i < _plugins.size(); ++i) {
+        statisticsOnePlugin(index++, u'P', _plugins[i], args);
+    }
+    statisticsOnePlugin(index, u'O', _output, args);
+    return CommandStatus::SUCCESS;
+}
+
+void ts::tsp::ControlServer::statisticsOnePlugin(size_t index, UChar type, PluginExecutor* plugin, Report& report)
+{
+    PluginExecutor::Telemetry tel;
+    plugin->getTelemetry(tel);
+    report.info(u"%2d: %c %s: %s", index, type, plugin->pluginName(), tel.summary());
+    if (report.verbose() && tel.latency.count() > 0) {
+        report.info(u"    latency (us): %s", tel.latency.summary());
+    }
+}
@@ -80,6 +80,8 @@ namespace ts {
             CommandStatus executeResume(const UString&, Args&);
             CommandStatus executeSuspendResume(bool state, Args&);
             CommandStatus executeRestart(const UString&, Args&);
+            CommandStatus executeStatistics(const UString&, Args&);
+            void statisticsOnePlugin(size_t index, UChar type, PluginExecutor* plugin, Report& report);
         };
     }
 }
@@ -288,6 +288,7 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
 
 size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
 {
+    const size_t first_index = index; // Index of first received packet in buffer
     size_t pkt_done = 0;              // Number of received packets in buffer
     size_t pkt_remain = max_packets;  // Remaining number of packets to read
 
@@ -350,6 +351,11 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
             }
         }
     }
+
+    // With latency tracing, record the ingress time of all received packets.
+    if (_trace != nullptr && pkt_done > 0) {
+        _trace->setIngressTime(first_index, pkt_done, monotonic_time::clock::now());
+    }
     return pkt_done;
 }
 
@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tstspLatencyTrace.h"
+#include "tsjsonObject.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::LatencyTrace::LatencyTrace(size_t capacity, size_t plugin_count, size_t buffer_size, cn::milliseconds interval) :
+    _origin(monotonic_time::clock::now()),
+    _interval(interval),
+    _ingress(std::max<size_t>(1, buffer_size)),
+    _events(std::max<size_t>(1, capacity)),
+    _names(plugin_count)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Set the name of a plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyTrace::setPluginName(size_t index, const UString& name)
+{
+    if (index >= _names.size()) {
+        _names.resize(index + 1);
+    }
+    _names[index] = name;
+}
+
+
+//----------------------------------------------------------------------------
+// Set the ingress time of received packets.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyTrace::setIngressTime(size_t first, size_t count, monotonic_time time)
+{
+    // The input executor always receives packets in a contiguous area of the buffer.
+    first %= _ingress.size();
+    count = std::min(count, _ingress.size() - first);
+    std::fill(_ingress.begin() + first, _ingress.begin() + first + count, time);
+}
+
+
+//----------------------------------------------------------------------------
+// Record a checkpoint when a plugin passes packets to the next one.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyTrace::checkpoint(size_t index, bool output, monotonic_time ingress, size_t count, monotonic_time now)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // On output, record the end-to-end residence time of the sampled packet.
+    if (output) {
+        _residence.feed(cn::duration_cast<cn::microseconds>(now - ingress).count());
+    }
+
+    // Drop the oldest event when the ring is full.
+    if (_count == _events.size()) {
+        _first = (_first + 1) % _events.size();
+        _count--;
+        _overwritten++;
+    }
+
+    Event& ev(_events[(_first + _count++) % _events.size()]);
+    ev.start = std::min(ingress, now);
+    ev.end = now;
+    ev.plugin = uint32_t(index);
+    ev.packets = uint32_t(count);
+}
+
+
+//----------------------------------------------------------------------------
+// Save the trace in Chrome trace JSON format.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::LatencyTrace::save(const fs::path& filename, Report& report) const
+{
+    // Time stamps in the Chrome trace format are microseconds, possibly with a fractional part.
+    const auto micro = [this](monotonic_time t) { return double(cn::duration_cast<cn::nanoseconds>(t - _origin).count()) / 1000.0; };
+
+    json::Object root;
+    root.add(u"displayTimeUnit", u"ms");
+
+    // One thread track per plugin, in the order of the chain.
+    for (size_t i = 0; i < _names.size(); ++i) {
+        json::Value& meta(root.query(u"traceEvents[]", true));
+        meta.add(u"name", u"thread_name");
+        meta.add(u"ph", u"M");
+        meta.add(u"pid", 1);
+        meta.add(u"tid", i);
+        meta.query(u"args", true).add(u"name", UString::Format(u"%d: %s", i, _names[i]));
+        json::Value& order(root.query(u"traceEvents[]", true));
+        order.add(u"name", u"thread_sort_index");
+        order.add(u"ph", u"M");
+        order.add(u"pid", 1);
+        order.add(u"tid", i);
+        order.query(u"args", true).add(u"sort_index", i);
+    }
+
+    // Checkpoint events: one "complete" event per passed batch.
+    for (size_t i = 0; i < _count; ++i) {
+        const Event& ev(_events[(_first + i) % _events.size()]);
+        json::Value& jev(root.query(u"traceEvents[]", true));
+        jev.add(u"name", ev.plugin < _names.size() ? _names[ev.plugin] : UString::Decimal(ev.plugin));
+        jev.add(u"cat", u"tsp");
+        jev.add(u"ph", u"X");
+        jev.add(u"pid", 1);
+        jev.add(u"tid", ev.plugin);
+        jev.add(u"ts", micro(ev.start));
+        jev.add(u"dur", micro(ev.end) - micro(ev.start));
+        jev.query(u"args", true).add(u"packets", ev.packets);
+    }
+
+    // Additional non-event data.
+    json::Value& other(root.query(u"otherData", true));
+    other.add(u"overwritten-events", _overwritten);
+    json::Value& res(other.query(u"residence-us", true));
+    res.add(u"samples", _residence.count());
+    res.add(u"min", _residence.minimum());
+    res.add(u"max", _residence.maximum());
+    res.add(u"mean", _residence.mean());
+    res.add(u"p50", _residence.percentile(50.0));
+    res.add(u"p99", _residence.percentile(99.0));
+    res.add(u"p99.9", _residence.percentile(99.9));
+
+    return root.save(filename, 0, true, report);
+}
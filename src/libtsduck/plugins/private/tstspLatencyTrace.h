@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Packet-path latency trace buffer.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsLogHistogram.h"
+#include "tsReport.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Packet-path latency trace buffer for tsp.
+        //! This class is internal to the TSDuck library and cannot be called by applications.
+        //! @ingroup libtsduck plugin
+        //!
+        //! The input executor records the ingress time of each received packet in a table which is
+        //! indexed by the position of the packet in the global packet buffer. This table is allocated
+        //! only when latency tracing is enabled, the packet metadata are unchanged.
+        //!
+        //! Each plugin executor samples the packets it passes to the next one, at most once per sampling
+        //! interval. A sample is a checkpoint event: the plugin index, the number of passed packets and the
+        //! ingress time of the first packet in the batch. The duration of the event is consequently the age
+        //! of the batch when it leaves the plugin. The samples of the output executor are additionally
+        //! recorded in a histogram of end-to-end residence time.
+        //!
+        //! The events are stored in a fixed-size ring buffer. When it is full, the oldest events
+        //! are overwritten. The buffer is finally saved in Chrome trace JSON format, which can be
+        //! loaded in chrome://tracing or https://ui.perfetto.dev. Each plugin is a thread track.
+        //!
+        //! The ingress times are accessed without synchronization: each entry is only accessed by
+        //! the executor which currently owns the corresponding packet in the global buffer.
+        //! The events are protected by an internal mutex, not the tsp global mutex.
+        //!
+        class LatencyTrace
+        {
+            TS_NOBUILD_NOCOPY(LatencyTrace);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] capacity Maximum number of events in the trace buffer.
+            //! @param [in] plugin_count Number of plugins in the chain.
+            //! @param [in] buffer_size Size of the global packet buffer, in packets.
+            //! @param [in] interval Minimum interval between two checkpoints of the same plugin.
+            //!
+            LatencyTrace(size_t capacity, size_t plugin_count, size_t buffer_size, cn::milliseconds interval);
+
+            //!
+            //! Set the name of a plugin, as displayed in the trace.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] index Plugin index in the chain.
+            //! @param [in] name Plugin name.
+            //!
+            void setPluginName(size_t index, const UString& name);
+
+            //!
+            //! Get the minimum interval between two checkpoints of the same plugin.
+            //! @return The sampling interval.
+            //!
+            cn::milliseconds interval() const { return _interval; }
+
+            //!
+            //! Set the ingress time of received packets.
+            //! Called by the input executor, which owns the corresponding packets.
+            //! @param [in] first Index of first received packet in the global buffer.
+            //! @param [in] count Number of contiguous received packets.
+            //! @param [in] time Ingress time of the packets.
+            //!
+            void setIngressTime(size_t first, size_t count, monotonic_time time);
+
+            //!
+            //! Get the ingress time of a packet.
+            //! Called by the executor which owns the corresponding packet.
+            //! @param [in] index Index of the packet in the global buffer.
+            //! @return The ingress time of the packet.
+            //!
+            monotonic_time ingressTime(size_t index) const { return _ingress[index % _ingress.size()]; }
+
+            //!
+            //! Record a checkpoint when a plugin passes packets to the next one.
+            //! This method is thread-safe.
+            //! @param [in] index Plugin index in the chain.
+            //! @param [in] output True if the plugin is the output plugin.
+            //! @param [in] ingress Ingress time of the first passed packet.
+            //! @param [in] count Number of passed packets.
+            //! @param [in] now Time of transfer of the packets.
+            //!
+            void checkpoint(size_t index, bool output, monotonic_time ingress, size_t count, monotonic_time now);
+
+            //!
+            //! Get the distribution of sampled end-to-end residence time of packets.
+            //! Must be executed after termination of all executor threads.
+            //! @return A constant reference to the histogram of residence times in microseconds.
+            //!
+            const LogHistogram& residence() const { return _residence; }
+
+            //!
+            //! Save the trace in Chrome trace JSON format.
+            //! Must be executed after termination of all executor threads.
+            //! @param [in] filename Output file name. If empty or "-", write on standard output.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool save(const fs::path& filename, Report& report) const;
+
+        private:
+            // One checkpoint event, 24 bytes.
+            struct Event
+            {
+                monotonic_time start {};      // Ingress time of the first packet in the batch.
+                monotonic_time end {};        // Time when the batch is passed.
+                uint32_t       plugin = 0;    // Plugin index.
+                uint32_t       packets = 0;   // Number of packets in the batch.
+            };
+
+            const monotonic_time        _origin;               // Time origin of the trace.
+            const cn::milliseconds      _interval;             // Sampling interval per plugin.
+            std::vector<monotonic_time> _ingress;              // Ingress time, indexed by position in the global buffer.
+            std::mutex                  _mutex {};             // Protect the following fields.
+            std::vector<Event>          _events {};            // Ring buffer of events, fixed size.
+            size_t                      _first = 0;            // Index of oldest event.
+            size_t                      _count = 0;            // Number of events in the ring.
+            uint64_t                    _overwritten = 0;      // Number of overwritten events.
+            UStringVector               _names {};             // Plugin names.
+            LogHistogram                _residence {};         // Sampled end-to-end residence time in microseconds.
+        };
+    }
+}
@@ -8,6 +8,7 @@
 
 #include "tstspPluginExecutor.h"
 #include "tsPluginRepository.h"
+#include "tsSysUtils.h"
 
 
 //----------------------------------------------------------------------------
@@ -23,7 +24,8 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
                                         Report* report) :
 
     JointTermination(options, type, pl_options, attributes, global_mutex, report),
-    _handlers(handlers)
+    _handlers(handlers),
+    _instrumented(options.instrumentation)
 {
     // Preset common default options.
     if (plugin() != nullptr) {
@@ -107,6 +109,11 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer*         buffer,
     _br_confidence = br_confidence;
     _tsp_bitrate = bitrate;
     _tsp_bitrate_confidence = br_confidence;
+
+    // Initial packets in the buffer of a packet processor or output plugin are received now.
+    if (_instrumented && plugin()->type() != PluginType::INPUT) {
+        addLatencyMark(pkt_cnt, monotonic_time::clock::now());
+    }
 }
 
 
@@ -120,8 +127,22 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", count, bitrate, input_end, aborted);
 
+    // Time of transfer of the packets, for instrumentation and latency tracing, read before acquiring the global mutex.
+    const bool instrument = _instrumented && count > 0;
+    const bool trace = _trace != nullptr && count > 0;
+    const monotonic_time now = instrument || trace ? monotonic_time::clock::now() : monotonic_time();
+
+    // Latency tracing samples the first passed packet, at most once per sampling interval. The passed packets
+    // are still owned by this plugin until the global mutex is acquired, their ingress time is read now.
+    monotonic_time ingress {};
+    const bool trace_sample = trace && now >= _trace_next;
+    if (trace_sample) {
+        ingress = _trace->ingressTime(_pkt_first);
+        _trace_next = now + _trace->interval();
+    }
+
     // We access data under the protection of the global mutex.
-    std::lock_guard<std::recursive_mutex> lock(_global_mutex);
+    std::unique_lock<std::recursive_mutex> lock(_global_mutex);
 
     // Update our buffer: we remove the first 'count' packets from the beginning of our slice of the buffer.
     _pkt_first = (_pkt_first + count) % _buffer->count();
@@ -131,6 +152,13 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
     PluginExecutor* next = ringNext<PluginExecutor>();
     next->_pkt_cnt += count;
 
+    // The latency mark must be recorded in the next plugin before it can pass these packets.
+    // Packets which are passed by the output plugin are free buffer space for the input plugin
+    // and are not used to evaluate latency.
+    if (instrument && plugin()->type() != PluginType::OUTPUT) {
+        next->addLatencyMark(count, now);
+    }
+
     // Propagate bitrate and end of input flag to next processor.
     next->_bitrate = bitrate;
     next->_br_confidence = br_confidence;
@@ -153,6 +181,15 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
         ringPrevious<PluginExecutor>()->_to_do.notify_one();
     }
 
+    // Accumulate instrumentation data and latency checkpoint, outside the global mutex.
+    lock.unlock();
+    if (instrument) {
+        accountPassedPackets(count, now);
+    }
+    if (trace_sample) {
+        _trace->checkpoint(pluginIndex(), plugin()->type() == PluginType::OUTPUT, ingress, count, now);
+    }
+
     // Return false when the current processor shall stop.
     return !input_end && !aborted;
 }
@@ -174,6 +211,15 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
         min_pkt_cnt = _buffer->count();
     }
 
+    // Collect time and CPU time for instrumentation before acquiring the global mutex.
+    monotonic_time wait_start {};
+    cn::microseconds cpu_time {};
+    bool cpu_valid = false;
+    if (_instrumented) {
+        wait_start = monotonic_time::clock::now();
+        cpu_valid = GetThreadCpuTime(cpu_time);
+    }
+
     // We access data under the protection of the global mutex.
     std::unique_lock<std::recursive_mutex> lock(_global_mutex);
 
@@ -221,11 +267,154 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     // there is no propagation of packets from output back to input.
     aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
 
+    // Accumulate waiting time and buffer occupancy, outside the global mutex.
+    const size_t buffer_occupancy = _pkt_cnt;
+    lock.unlock();
+    if (_instrumented) {
+        const monotonic_time wait_end = monotonic_time::clock::now();
+        std::lock_guard<std::mutex> tel_lock(_tel_mutex);
+        if (_tel_start == monotonic_time()) {
+            _tel_start = wait_start;
+        }
+        else {
+            // Time spent since the previous return from waitWork() was used to process packets.
+            _telemetry.process_time += wait_start - _tel_last_wait;
+        }
+        if (cpu_valid) {
+            _telemetry.cpu_time = cpu_time;
+        }
+        _tel_last_wait = wait_end;
+        _telemetry.wait_time += wait_end - wait_start;
+        _telemetry.elapsed = wait_end - _tel_start;
+        _telemetry.buffer_samples++;
+        _telemetry.buffer_total += buffer_occupancy;
+        _telemetry.buffer_max = std::max(_telemetry.buffer_max, buffer_occupancy);
+    }
+
     log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
         min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout);
 }
 
 
+//----------------------------------------------------------------------------
+// Instrumentation helpers.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::addLatencyMark(size_t count, monotonic_time now)
+{
+    if (count > 0) {
+        std::lock_guard<std::mutex> lock(_tel_mutex);
+        _tel_received += count;
+        if (_tel_marks_count < _tel_marks.size()) {
+            LatencyMark& mark(_tel_marks[(_tel_marks_first + _tel_marks_count++) % _tel_marks.size()]);
+            mark.packets = _tel_received;
+            mark.time = now;
+        }
+        else {
+            // Ring is full, extend the newest mark.
+            _tel_marks[(_tel_marks_first + _tel_marks_count - 1) % _tel_marks.size()].packets = _tel_received;
+        }
+    }
+}
+
+void ts::tsp::PluginExecutor::accountPassedPackets(size_t count, monotonic_time now)
+{
+    std::lock_guard<std::mutex> lock(_tel_mutex);
+    _telemetry.packets += count;
+    if (_tel_start != monotonic_time()) {
+        _telemetry.elapsed = now - _tel_start;
+    }
+    if (plugin()->type() != PluginType::INPUT) {
+        // Consume the latency marks which are covered by the passed packets.
+        while (_tel_marks_count > 0 && _tel_measured < _telemetry.packets) {
+            LatencyMark& mark(_tel_marks[_tel_marks_first]);
+            const PacketCounter last = std::min(mark.packets, _telemetry.packets);
+            _telemetry.latency.feed(cn::duration_cast<cn::microseconds>(now - mark.time).count(), last - _tel_measured);
+            _tel_measured = last;
+            if (last == mark.packets) {
+                _tel_marks_first = (_tel_marks_first + 1) % _tel_marks.size();
+                _tel_marks_count--;
+            }
+        }
+    }
+}
+
+void ts::tsp::PluginExecutor::resetLatencyMarks()
+{
+    // After a restart, the packets which are still in the buffer are considered as received now.
+    // The duration of the restart is accounted neither as latency, nor as processing time.
+    const monotonic_time now = monotonic_time::clock::now();
+    std::lock_guard<std::mutex> lock(_tel_mutex);
+    _tel_marks_first = 0;
+    _tel_marks_count = 0;
+    _tel_measured = _telemetry.packets;
+    if (plugin()->type() != PluginType::INPUT && _tel_received > _tel_measured) {
+        _tel_marks[0].packets = _tel_received;
+        _tel_marks[0].time = now;
+        _tel_marks_count = 1;
+    }
+    if (_tel_start != monotonic_time()) {
+        _tel_last_wait = now;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get a snapshot of the instrumentation data of the plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::getTelemetry(Telemetry& telemetry) const
+{
+    std::lock_guard<std::mutex> lock(_tel_mutex);
+    telemetry = _telemetry;
+}
+
+double ts::tsp::PluginExecutor::Telemetry::packetsPerSecond() const
+{
+    return elapsed <= cn::nanoseconds::zero() ? 0.0 : double(packets) * 1.0e9 / double(elapsed.count());
+}
+
+double ts::tsp::PluginExecutor::Telemetry::bufferMean() const
+{
+    return buffer_samples == 0 ? 0.0 : double(buffer_total) / double(buffer_samples);
+}
+
+ts::UString ts::tsp::PluginExecutor::Telemetry::summary() const
+{
+    UString line(UString::Format(u"packets: %'d, pkt/s: %.1f, cpu: %'d ms, wait: %'d ms, process: %'d ms, buffer: mean %.1f, max %'d",
+                                 packets, packetsPerSecond(),
+                                 cn::duration_cast<cn::milliseconds>(cpu_time).count(),
+                                 cn::duration_cast<cn::milliseconds>(wait_time).count(),
+                                 cn::duration_cast<cn::milliseconds>(process_time).count(),
+                                 bufferMean(), buffer_max));
+    if (latency.count() > 0) {
+        line.format(u", latency (us): p50 %'d, p99 %'d, p99.9 %'d, max %'d",
+                    latency.percentile(50.0), latency.percentile(99.0), latency.percentile(99.9), latency.maximum());
+    }
+    return line;
+}
+
+void ts::tsp::PluginExecutor::Telemetry::toJSON(json::Value& obj) const
+{
+    obj.add(u"packets", packets);
+    obj.add(u"packets-per-second", packetsPerSecond());
+    obj.add(u"elapsed-us", cn::duration_cast<cn::microseconds>(elapsed).count());
+    obj.add(u"cpu-us", cpu_time.count());
+    obj.add(u"wait-us", cn::duration_cast<cn::microseconds>(wait_time).count());
+    obj.add(u"process-us", cn::duration_cast<cn::microseconds>(process_time).count());
+    obj.query(u"buffer", true).add(u"mean", bufferMean());
+    obj.query(u"buffer", true).add(u"max", buffer_max);
+    json::Value& lat(obj.query(u"latency-us", true));
+    lat.add(u"samples", latency.count());
+    lat.add(u"min", latency.minimum());
+    lat.add(u"max", latency.maximum());
+    lat.add(u"mean", latency.mean());
+    lat.add(u"p50", latency.percentile(50.0));
+    lat.add(u"p99", latency.percentile(99.0));
+    lat.add(u"p99.9", latency.percentile(99.9));
+}
+
+
 //----------------------------------------------------------------------------
 // Description of a restart operation (constructor).
 //----------------------------------------------------------------------------
@@ -367,6 +556,11 @@ bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
     _restart = false;
     _restart_data.reset();
 
+    // Pending latency marks predate the restart.
+    if (_instrumented) {
+        resetLatencyMarks();
+    }
+
     debug(u"restarted plugin %s, status: %s", pluginName(), success);
     return success;
 }
@@ -17,6 +17,9 @@
 #include "tsTSProcessorArgs.h"
 #include "tsPluginEventHandlerRegistry.h"
 #include "tsPlugin.h"
+#include "tsLogHistogram.h"
+#include "tsjsonValue.h"
+#include "tstspLatencyTrace.h"
 
 namespace ts {
     namespace tsp {
@@ -78,6 +81,13 @@ namespace ts {
             //!
             void setRealTimeForAll(bool on) { _use_realtime = on; }
 
+            //!
+            //! Set the latency trace buffer (see tsp option --latency-trace).
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] trace Address of the latency trace buffer. Null when latency tracing is disabled.
+            //!
+            void setLatencyTrace(LatencyTrace* trace) { _trace = trace; }
+
             //!
             //! This method sets the current packet processor in an abort state.
             //!
@@ -120,6 +130,54 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Instrumentation data of a plugin executor (see tsp option --instrumentation).
+            //!
+            class Telemetry
+            {
+            public:
+                PacketCounter    packets = 0;         //!< Number of packets passed to the next plugin.
+                cn::nanoseconds  elapsed {};          //!< Elapsed time between the first and the last activity of the plugin thread.
+                cn::microseconds cpu_time {};         //!< Cumulated CPU time of the plugin thread.
+                cn::nanoseconds  wait_time {};        //!< Cumulated time waiting in waitWork() for packets (or free buffer space for the input plugin).
+                cn::nanoseconds  process_time {};     //!< Cumulated time outside waitWork(), processing packets.
+                uint64_t         buffer_samples = 0;  //!< Number of samples of the buffer occupancy, one per return of waitWork().
+                uint64_t         buffer_total = 0;    //!< Sum of all samples of the buffer occupancy, in packets.
+                size_t           buffer_max = 0;      //!< Maximum buffer occupancy, in packets.
+                LogHistogram     latency {};          //!< Per-packet latency through the plugin, in microseconds.
+
+                //!
+                //! Get the mean packet rate of the plugin.
+                //! @return The mean number of packets per second.
+                //!
+                double packetsPerSecond() const;
+
+                //!
+                //! Get the mean buffer occupancy.
+                //! @return The mean number of packets which are available to the plugin when it returns from waitWork().
+                //!
+                double bufferMean() const;
+
+                //!
+                //! Format a one-line summary of the instrumentation data.
+                //! @return A one-line summary.
+                //!
+                UString summary() const;
+
+                //!
+                //! Add the instrumentation data in a JSON object.
+                //! @param [in,out] obj The JSON object to update.
+                //!
+                void toJSON(json::Value& obj) const;
+            };
+
+            //!
+            //! Get a snapshot of the instrumentation data of the plugin.
+            //! This method can be called from any thread. All fields are zero when instrumentation is disabled.
+            //! @param [out] telemetry Receive the instrumentation data.
+            //!
+            void getTelemetry(Telemetry& telemetry) const;
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -128,6 +186,7 @@ namespace ts {
             PacketBuffer*         _buffer = nullptr;    //!< Description of shared packet buffer.
             PacketMetadataBuffer* _metadata = nullptr;  //!< Description of shared packet metadata buffer.
             volatile bool         _suspended = false;   //!< The plugin is suspended / resumed.
+            LatencyTrace*         _trace = nullptr;     //!< Latency trace buffer, null when latency tracing is disabled.
 
             //!
             //! Pass processed packets to the next packet processor.
@@ -212,6 +271,38 @@ namespace ts {
             bool              _restart = false;    // Restart the plugin asap using _restart_data
             RestartDataPtr    _restart_data {};    // How to restart the plugin
 
+            // Next time of latency trace checkpoint, used only in passPackets().
+            monotonic_time    _trace_next {};
+
+            // Instrumentation data, under the protection of _tel_mutex, not the global mutex. The time and CPU
+            // time are collected outside any mutex. When both mutexes are needed, the global one is acquired first.
+            // To evaluate the latency of packets through a plugin, the previous plugin records a "mark" each
+            // time it passes packets to this one: the cumulated number of received packets and the time.
+            // When this plugin passes packets to its successor, the marks which are covered by these packets
+            // are consumed and the latency is recorded. The marks are stored in a fixed-size ring buffer.
+            // When the ring is full, the newest mark is extended, slightly overestimating the latency.
+            struct LatencyMark
+            {
+                PacketCounter  packets = 0;        // Cumulated number of received packets, after this mark.
+                monotonic_time time {};            // Time of reception.
+            };
+            static constexpr size_t MAX_LATENCY_MARKS = 256;
+            const bool        _instrumented;       // Instrumentation is enabled.
+            mutable std::mutex _tel_mutex {};      // Protect instrumentation data.
+            Telemetry         _telemetry {};       // Accumulated instrumentation data.
+            monotonic_time    _tel_start {};       // First activity of the plugin thread.
+            monotonic_time    _tel_last_wait {};   // Last return from waitWork().
+            PacketCounter     _tel_received = 0;   // Cumulated number of packets received from the previous plugin.
+            PacketCounter     _tel_measured = 0;   // Cumulated number of packets with a measured latency.
+            size_t            _tel_marks_first = 0;  // Index of oldest latency mark.
+            size_t            _tel_marks_count = 0;  // Number of latency marks.
+            std::array<LatencyMark, MAX_LATENCY_MARKS> _tel_marks {};
+
+            // Instrumentation helpers, acquire _tel_mutex.
+            void addLatencyMark(size_t count, monotonic_time now);
+            void accountPassedPackets(size_t count, monotonic_time now);
+            void resetLatencyMarks();
+
             // Description of a restart operation.
             class RestartData
             {
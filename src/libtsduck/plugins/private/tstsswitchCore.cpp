@@ -150,12 +150,11 @@ void ts::tsswitch::Core::nextInput()
 void ts::tsswitch::Core::previousInput()
 {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    setInputLocked((_curPlugin > 0 ? _curPlugin : _inputs.size()) - 1, false);
+    setInputLocked((_curPlugin > 0 ? _curPlugin.load() : _inputs.size()) - 1, false);
 }
 
 size_t ts::tsswitch::Core::currentInput()
 {
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
     return _curPlugin;
 }
 
@@ -170,7 +169,7 @@ void ts::tsswitch::Core::setInputLocked(size_t index, bool abortCurrent)
         _log.warning(u"invalid input index %d", index);
     }
     else if (index != _curPlugin) {
-        _log.debug(u"switch input %d to %d", _curPlugin, index);
+        _log.debug(u"switch input %d to %d", _curPlugin.load(), index);
 
         // The processing depends on the switching mode.
         if (_opt.delayedSwitch) {
@@ -234,11 +233,28 @@ void ts::tsswitch::Core::handleWatchDogTimeout(WatchDog& watchdog)
     std::lock_guard<std::recursive_mutex> lock(_mutex);
     const size_t next = (_curPlugin + 1) % _inputs.size();
     // Verbose message under mutex is not a good idea when option --synchronous-log is set.
-    _log.verbose(u"receive timeout, switching to next plugin (#%d to #%d)", _curPlugin, next);
+    _log.verbose(u"receive timeout, switching to next plugin (#%d to #%d)", _curPlugin.load(), next);
     setInputLocked(next, true);
 }
 
 
+//----------------------------------------------------------------------------
+// Restart or suspend the receive timeout (with mutex already held).
+//----------------------------------------------------------------------------
+
+void ts::tsswitch::Core::restartTimeout()
+{
+    _receiveWatchDog.restart();
+    _timeoutRunning = true;
+}
+
+void ts::tsswitch::Core::suspendTimeout()
+{
+    _receiveWatchDog.suspend();
+    _timeoutRunning = false;
+}
+
+
 //----------------------------------------------------------------------------
 // Names of actions for debug messages.
 //----------------------------------------------------------------------------
@@ -299,6 +315,7 @@ void ts::tsswitch::Core::enqueue(const Action& action, bool highPriority)
     else {
         _actions.push_back(action);
     }
+    _actionsPending = true;
 }
 
 
@@ -357,7 +374,7 @@ void ts::tsswitch::Core::execute(const Action& event)
             case STOP: {
                 if (action.index == _curPlugin) {
                     // Automatically stop the receive timeout when we stop the current plugin.
-                    _receiveWatchDog.suspend();
+                    suspendTimeout();
                 }
                 _inputs[action.index]->stopInput();
                 break;
@@ -370,11 +387,11 @@ void ts::tsswitch::Core::execute(const Action& event)
                 break;
             }
             case RESTART_TIMEOUT: {
-                _receiveWatchDog.restart();
+                restartTimeout();
                 break;
             }
             case SUSPEND_TIMEOUT: {
-                _receiveWatchDog.suspend();
+                suspendTimeout();
                 break;
             }
             case NOTIF_CURRENT: {
@@ -384,6 +401,8 @@ void ts::tsswitch::Core::execute(const Action& event)
             case SET_CURRENT: {
                 _eventDispatcher.signalNewInput(_curPlugin, action.index);
                 _curPlugin = action.index;
+                // The new current input plugin may already have packets to output.
+                _gotInput.notify_all();
                 break;
             }
             case WAIT_STARTED:
@@ -394,6 +413,7 @@ void ts::tsswitch::Core::execute(const Action& event)
                 if (it == _events.end()) {
                     // Event not found, cannot execute further, keep the action in queue and retry later.
                     _log.debug(u"not ready, waiting: %s", action);
+                    _actionsPending = true;
                     return;
                 }
                 // Clear the event.
@@ -410,6 +430,7 @@ void ts::tsswitch::Core::execute(const Action& event)
         // Command executed, dequeue it.
         _actions.pop_front();
     }
+    _actionsPending = false;
 }
 
 
@@ -421,25 +442,33 @@ bool ts::tsswitch::Core::getOutputArea(size_t& pluginIndex, TSPacket*& first, TS
 {
     assert(pluginIndex < _inputs.size());
 
-    // Loop on _gotInput condition until the current input plugin has something to output.
-    std::unique_lock<std::recursive_mutex> lock(_mutex);
+    // Loop until the current input plugin has something to output.
     for (;;) {
+        // Tell the output plugin which input plugin is used.
+        pluginIndex = _curPlugin;
+
+        // Return false when the application terminates.
         if (_terminate) {
             first = nullptr;
             count = 0;
+            return false;
         }
-        else {
-            _inputs[_curPlugin]->getOutputArea(first, data, count);
+
+        // Get packets from the buffer of the current input plugin, without global mutex. If the current input plugin
+        // changes in the meantime, these are the last packets of the previous one, as if the output was slightly faster.
+        _inputs[pluginIndex]->getOutputArea(first, data, count);
+        if (count > 0) {
+            return true;
         }
-        // Return when there is something to output in current plugin or the application terminates.
-        if (count > 0 || _terminate) {
-            // Tell the output plugin which input plugin is used.
-            pluginIndex = _curPlugin;
-            // Return false when the application terminates.
-            return !_terminate;
+
+        // Nothing to output, sleep on _gotInput condition. The input plugins notify the condition only
+        // when _outputWaiting is set. Therefore, check the current input again after setting it.
+        std::unique_lock<std::recursive_mutex> lock(_mutex);
+        _outputWaiting = true;
+        if (!_terminate && !_inputs[_curPlugin]->hasOutput()) {
+            _gotInput.wait(lock);
         }
-        // Otherwise, sleep on _gotInput condition.
-        _gotInput.wait(lock);
+        _outputWaiting = false;
     }
 }
 
@@ -475,7 +504,7 @@ bool ts::tsswitch::Core::inputStarted(size_t pluginIndex, bool success)
 
     // Start the receive timeout, if any, when the current input is started.
     if (pluginIndex == _curPlugin) {
-        _receiveWatchDog.restart();
+        restartTimeout();
     }
 
     // Return false when the application terminates.
@@ -489,11 +518,41 @@ bool ts::tsswitch::Core::inputStarted(size_t pluginIndex, bool success)
 
 bool ts::tsswitch::Core::inputReceived(size_t pluginIndex)
 {
+    // Fast path in the normal flow of packets, without global mutex: there is no pending action (possibly
+    // waiting for input) and no automatic switch back to the primary input. If an action is enqueued in the
+    // meantime, it will be executed on the next reception of packets.
+    const size_t current = _curPlugin;
+    if (!_actionsPending && (pluginIndex != _opt.primaryInput || current == _opt.primaryInput)) {
+        if (pluginIndex == current) {
+            // Restart the receive timeout, if any, when the current input receives packets.
+            if (_opt.receiveTimeout > cn::milliseconds::zero()) {
+                _receiveWatchDog.restart();
+                // A switch may have started since _curPlugin and _actionsPending were read and the restart may
+                // have overridden a suspension of the timeout. In that case, resynchronize the watchdog.
+                if (_actionsPending || _curPlugin != current) {
+                    std::lock_guard<std::recursive_mutex> lock(_mutex);
+                    if (pluginIndex == _curPlugin) {
+                        restartTimeout();
+                    }
+                    else if (!_timeoutRunning) {
+                        _receiveWatchDog.suspend();
+                    }
+                }
+            }
+            // Wake up output plugin only if it is sleeping, waiting for packets to output.
+            if (_outputWaiting) {
+                std::lock_guard<std::recursive_mutex> lock(_mutex);
+                _gotInput.notify_all();
+            }
+        }
+        return !_terminate;
+    }
+
     std::lock_guard<std::recursive_mutex> lock(_mutex);
 
     // Restart the receive timeout, if any, when the current input receives packets.
     if (pluginIndex == _curPlugin) {
-        _receiveWatchDog.restart();
+        restartTimeout();
     }
 
     // Execute all commands if waiting on this event. This may change the current input.
@@ -502,7 +561,7 @@ bool ts::tsswitch::Core::inputReceived(size_t pluginIndex)
     // If input is detected on the primary input and the current plugin is not this one
     // after executing all actions, then automatically switch to it.
     if (pluginIndex == _opt.primaryInput && _curPlugin != _opt.primaryInput) {
-        _log.verbose(u"received data, switching back to primary input plugin (#%d to #%d)", _curPlugin, _opt.primaryInput);
+        _log.verbose(u"received data, switching back to primary input plugin (#%d to #%d)", _curPlugin.load(), _opt.primaryInput);
         // Remove all pending actions.
         _log.debug(u"clearing action queue, %s events canceled", _actions.size());
         _actions.clear();
@@ -175,16 +175,23 @@ namespace ts {
             EventDispatcher             _eventDispatcher;   // External event dispatcher.
             WatchDog                    _receiveWatchDog;   // Handle reception timeout.
             std::recursive_mutex        _mutex {};          // Global mutex, protect access to all subsequent fields.
-            std::condition_variable_any _gotInput {};       // Signaled each time an input plugin reports new packets.
-            size_t                      _curPlugin = 0;     // Index of current input plugin.
+            std::condition_variable_any _gotInput {};       // Signaled when the output plugin waits and an input plugin reports new packets.
+            std::atomic<size_t>         _curPlugin {0};     // Index of current input plugin, modified under mutex, read without mutex in the packet flow.
+            std::atomic_bool            _terminate {false}; // Terminate complete processing.
+            std::atomic_bool            _outputWaiting {false};  // The output plugin sleeps on _gotInput.
+            std::atomic_bool            _actionsPending {false}; // The action queue is not empty.
             size_t                      _curCycle = 0;      // Current input cycle number.
-            volatile bool               _terminate = false; // Terminate complete processing.
+            bool                        _timeoutRunning = false; // The receive timeout was restarted and not suspended since.
             ActionQueue                 _actions {};        // Sequential queue list of actions to execute.
             ActionSet                   _events {};         // Pending events, waiting to be cleared.
 
             // Names of actions for debug messages.
             static const Names _actionNames;
 
+            // Restart or suspend the receive timeout (with mutex already held).
+            void restartTimeout();
+            void suspendTimeout();
+
             // Change input plugin with mutex already held.
             void setInputLocked(size_t index, bool abortCurrent);
 
@@ -94,8 +94,9 @@ bool ts::tsswitch::InputExecutor::abortInput()
 
 void ts::tsswitch::InputExecutor::setCurrent(bool isCurrent)
 {
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
     _isCurrent = isCurrent;
+    // In --fast-switch mode, a full input which is no longer current shall start to drop packets.
+    wakeInput();
 }
 
 
@@ -111,6 +112,21 @@ void ts::tsswitch::InputExecutor::terminateInput()
 }
 
 
+//----------------------------------------------------------------------------
+// Wake up the input thread if it is waiting for the output plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsswitch::InputExecutor::wakeInput()
+{
+    // The input thread sets _inputWaiting before checking the buffer and then sleeps under
+    // the mutex. Locking the mutex here guarantees that the notification is not lost.
+    if (_inputWaiting) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _todo.notify_one();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Get some packets to output.
 // Indirectly called from the output plugin when it needs some packets.
@@ -118,12 +134,25 @@ void ts::tsswitch::InputExecutor::terminateInput()
 
 void ts::tsswitch::InputExecutor::getOutputArea(ts::TSPacket*& first, TSPacketMetadata*& data, size_t& count)
 {
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
-    first = &_buffer[_outFirst];
-    data = &_metadata[_outFirst];
-    count = std::min(_outCount, _buffer.size() - _outFirst);
-    _outputInUse = count > 0;
-    _todo.notify_one();
+    // Reserve the head of the buffer. The input thread owns it only during the short time
+    // when it drops older packets in --fast-switch mode. Simply retry in that case.
+    for (int owner = HEAD_FREE; !_headOwner.compare_exchange_strong(owner, HEAD_OUTPUT); owner = HEAD_FREE) {
+        assert(owner == HEAD_INPUT);
+        std::this_thread::yield();
+    }
+
+    // The output area is limited by the end of the buffer.
+    const uint64_t head = _head;
+    const size_t index = size_t(head % _buffer.size());
+    first = &_buffer[index];
+    data = &_metadata[index];
+    count = size_t(std::min<uint64_t>(_tail - head, _buffer.size() - index));
+
+    // Release the head of the buffer when there is nothing to output.
+    if (count == 0) {
+        _headOwner = HEAD_FREE;
+        wakeInput();
+    }
 }
 
 
@@ -134,12 +163,31 @@ void ts::tsswitch::InputExecutor::getOutputArea(ts::TSPacket*& first, TSPacketMe
 
 void ts::tsswitch::InputExecutor::freeOutput(size_t count)
 {
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
-    assert(count <= _outCount);
-    _outFirst = (_outFirst + count) % _buffer.size();
-    _outCount -= count;
-    _outputInUse = false;
-    _todo.notify_one();
+    assert(_headOwner == HEAD_OUTPUT);
+    assert(count <= _tail - _head);
+    _head += count;
+    _headOwner = HEAD_FREE;
+    wakeInput();
+}
+
+
+//----------------------------------------------------------------------------
+// In --fast-switch mode, try to drop older packets when the buffer is full.
+//----------------------------------------------------------------------------
+
+bool ts::tsswitch::InputExecutor::dropOlderPackets()
+{
+    // Fail if the output plugin is still sending packets from the head of the buffer.
+    int owner = HEAD_FREE;
+    if (!_headOwner.compare_exchange_strong(owner, HEAD_INPUT)) {
+        return false;
+    }
+    // Free at most --max-input-packets, up to the end of the buffer.
+    const uint64_t head = _head;
+    const size_t index = size_t(head % _buffer.size());
+    _head = head + std::min<uint64_t>({_opt.maxInputPackets, _buffer.size() - index, _tail - head});
+    _headOwner = HEAD_FREE;
+    return true;
 }
 
 
@@ -158,9 +206,6 @@ void ts::tsswitch::InputExecutor::main()
         debug(u"waiting for input session");
         {
             std::unique_lock<std::recursive_mutex> lock(_mutex);
-            // Reset input buffer.
-            _outFirst = 0;
-            _outCount = 0;
             // Wait for start or terminate.
             while (!_startRequest && !_terminated) {
                 _todo.wait(lock);
@@ -190,45 +235,39 @@ void ts::tsswitch::InputExecutor::main()
         }
 
         // Loop on incoming packets.
+        const size_t bufSize = _buffer.size();
         for (;;) {
 
-            // Input area (first packet index and packet count).
-            size_t inFirst = 0;
-            size_t inCount = 0;
+            // The tail of the buffer is modified by this thread only.
+            const uint64_t tail = _tail;
 
-            // Initial sequence under mutex protection.
-            {
-                // Wait for free buffer or stop.
+            // Wait for free buffer or stop. The mutex is used only when the buffer is full.
+            if (_stopRequest || _terminated || tail - _head >= bufSize) {
                 std::unique_lock<std::recursive_mutex> lock(_mutex);
-                while (_outCount >= _buffer.size() && !_stopRequest && !_terminated) {
-                    if (_isCurrent || !_opt.fastSwitch) {
-                        // This is the current input, we must not lose packet.
-                        // Wait for the output thread to free some packets.
+                _inputWaiting = true;
+                while (tail - _head >= bufSize && !_stopRequest && !_terminated) {
+                    // If this is the current input, we must not lose packet. Wait for the output thread to free some packets.
+                    // If this is not the current input plugin in --fast-switch mode, drop older packets. If the output thread
+                    // is still sending packets from this buffer (just after a switch), wait for the end of this output.
+                    if (_isCurrent || !_opt.fastSwitch || !dropOlderPackets()) {
                         _todo.wait(lock);
                     }
-                    else {
-                        // Not the current input plugin in --fast-switch mode.
-                        // Drop older packets, free at most --max-input-packets.
-                        assert(_outFirst < _buffer.size());
-                        const size_t freeCount = std::min(_opt.maxInputPackets, _buffer.size() - _outFirst);
-                        assert(freeCount <= _outCount);
-                        _outFirst = (_outFirst + freeCount) % _buffer.size();
-                        _outCount -= freeCount;
-                    }
                 }
+                _inputWaiting = false;
                 // Exit input when termination is requested.
                 if (_stopRequest || _terminated) {
-                    debug(u"exiting session: stop request: %s, terminated: %s", _stopRequest, _terminated);
+                    debug(u"exiting session: stop request: %s, terminated: %s", _stopRequest.load(), _terminated.load());
                     break;
                 }
-                // There is some free buffer, compute first index and size of receive area.
-                // The receive area is limited by end of buffer and max input size.
-                inFirst = (_outFirst + _outCount) % _buffer.size();
-                inCount = std::min(_opt.maxInputPackets, std::min(_buffer.size() - _outCount, _buffer.size() - inFirst));
             }
 
-            assert(inFirst < _buffer.size());
-            assert(inFirst + inCount <= _buffer.size());
+            // There is some free buffer, compute first index and size of receive area.
+            // The receive area is limited by end of buffer and max input size.
+            const size_t inFirst = size_t(tail % bufSize);
+            size_t inCount = size_t(std::min<uint64_t>({_opt.maxInputPackets, bufSize - (tail - _head), bufSize - inFirst}));
+
+            assert(inFirst < bufSize);
+            assert(inFirst + inCount <= bufSize);
 
             // Reset packet metadata.
             for (size_t n = inFirst; n < inFirst + inCount; ++n) {
@@ -252,11 +291,8 @@ void ts::tsswitch::InputExecutor::main()
                 }
             }
 
-            // Signal the presence of received packets.
-            {
-                std::lock_guard<std::recursive_mutex> lock(_mutex);
-                _outCount += inCount;
-            }
+            // Publish the received packets to the output thread and signal their presence.
+            _tail = tail + inCount;
             _core.inputReceived(_pluginIndex);
         }
 
@@ -265,13 +301,19 @@ void ts::tsswitch::InputExecutor::main()
             // Wait for the output plugin to release the buffer.
             // In case of normal end of input (no stop, no terminate), wait for all output to be gone.
             std::unique_lock<std::recursive_mutex> lock(_mutex);
-            while (_outputInUse || (_outCount > 0 && !_stopRequest && !_terminated)) {
+            _inputWaiting = true;
+            for (;;) {
+                int owner = HEAD_FREE;
+                if ((!hasOutput() || _stopRequest || _terminated) && _headOwner.compare_exchange_strong(owner, HEAD_INPUT)) {
+                    break;
+                }
                 debug(u"input terminated, waiting for output plugin to release the buffer");
                 _todo.wait(lock);
             }
+            _inputWaiting = false;
             // And reset the output part of the buffer.
-            _outFirst = 0;
-            _outCount = 0;
+            _head = _tail.load();
+            _headOwner = HEAD_FREE;
         }
 
         // End of input session.
@@ -96,25 +96,58 @@ namespace ts {
             //!
             void freeOutput(size_t count);
 
+            //!
+            //! Check if there are packets to output, without reserving them.
+            //! @return True if there are packets to output.
+            //!
+            bool hasOutput() const { return _tail.load() != _head.load(); }
+
             // Implementation of TSP.
             virtual size_t pluginIndex() const override;
 
         private:
+            // Owner of the area of packets at the head of the buffer (values for _headOwner).
+            // The head of the buffer is normally moved by the output plugin only. However, in --fast-switch
+            // mode, a non-current input plugin drops its older packets when its buffer is full. Because this
+            // rarely happens while the output plugin is still using the buffer, an atomic ownership token is
+            // sufficient to protect the head of the buffer, without mutex.
+            enum : int {
+                HEAD_FREE = 0,    // Nobody currently uses the head of the buffer.
+                HEAD_OUTPUT = 1,  // The output plugin sends packets from the head of the buffer.
+                HEAD_INPUT = 2,   // The input plugin drops packets at the head of the buffer.
+            };
+
             InputPlugin*           _input;                // Plugin API.
             const size_t           _pluginIndex;          // Index of this input plugin.
             TSPacketVector         _buffer;               // Packet buffer.
             TSPacketMetadataVector _metadata;             // Packet metadata.
+            std::atomic_bool       _isCurrent {false};    // This plugin is the current input one.
+
+            // The packet buffer is a single-producer single-consumer ring. The indexes are free-running counters
+            // of packets, the index of a packet in the buffer is its counter modulo the buffer size. The tail
+            // is written by the input thread only, the head is written by the owner of the head (see above).
+            // Each index is on its own cache line to avoid false sharing between the input and output threads.
+            alignas(64) std::atomic<uint64_t> _head {0};  // Counter of packets which were sent or dropped.
+            alignas(64) std::atomic<uint64_t> _tail {0};  // Counter of packets which were received.
+            alignas(64) std::atomic<int> _headOwner {HEAD_FREE}; // Current owner of the head of the buffer.
+            std::atomic_bool       _inputWaiting {false}; // The input thread sleeps on _todo, waiting for the output plugin.
+
+            // The mutex and the condition are used only for the control of the input session
+            // and when the input thread must sleep, never in the normal flow of packets.
+            // The stop and terminate requests are atomic to be checked without mutex for each received packet.
             std::recursive_mutex   _mutex {};             // Mutex to protect all subsequent fields.
             std::condition_variable_any _todo {};         // Condition to signal something to do.
-            bool                   _isCurrent = false;    // This plugin is the current input one.
-            bool                   _outputInUse = false;  // The output part of the buffer is currently in use by the output plugin.
             bool                   _startRequest = false; // Start input requested.
-            bool                   _stopRequest = false;  // Stop input requested.
-            bool                   _terminated = false;   // Terminate thread.
-            size_t                 _outFirst = 0;         // Index of first packet to output in _buffer.
-            size_t                 _outCount = 0;         // Number of packets to output, not always contiguous, may wrap up.
+            std::atomic_bool       _stopRequest {false};  // Stop input requested.
+            std::atomic_bool       _terminated {false};   // Terminate thread.
             monotonic_time         _start_time {monotonic_time::clock::now()}; // Creation time, initialized with current system time.
 
+            // Wake up the input thread if it is waiting for the output plugin.
+            void wakeInput();
+
+            // In --fast-switch mode, try to drop older packets when the buffer is full. Return false if the head is in use.
+            bool dropOlderPackets();
+
             // Implementation of Thread.
             virtual void main() override;
         };
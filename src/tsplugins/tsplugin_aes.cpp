@@ -55,6 +55,7 @@ namespace ts {
 
         // Working data:
         bool         _abort = false;      // Error (service not found, etc)
+        BlockCipherContext _context {};   // Cipher context for in-place processing
         Service      _service {};         // Service name & id
         SectionDemux _demux {duck, this}; // Section demux
 
@@ -397,21 +398,24 @@ ts::ProcessorPlugin::Status ts::AESPlugin::processPacket(TSPacket& pkt, TSPacket
     }
 
     // Now (de)scramble the packet
-    uint8_t tmp[PKT_SIZE];
-    assert (pl_size < sizeof(tmp));
-    if (_descramble) {
-        if (!_chain->decrypt(pl, pl_size, tmp, pl_size)) {
-            error(u"AES decrypt error");
-            return TSP_END;
-        }
+    bool ok = true;
+    if (_chain->hasContextInPlace()) {
+        // Process the payload in place, without intermediate buffer.
+        void* const msg = pl;
+        ok = _descramble ? _chain->decryptInPlace(_context, &msg, &pl_size, 1) : _chain->encryptInPlace(_context, &msg, &pl_size, 1);
     }
     else {
-        if (!_chain->encrypt(pl, pl_size, tmp, pl_size)) {
-            error(u"AES encrypt error");
-            return TSP_END;
+        uint8_t tmp[PKT_SIZE];
+        assert (pl_size < sizeof(tmp));
+        ok = _descramble ? _chain->decrypt(pl, pl_size, tmp, pl_size) : _chain->encrypt(pl, pl_size, tmp, pl_size);
+        if (ok) {
+            MemCopy(pl, tmp, pl_size);
         }
     }
-    MemCopy(pl, tmp, pl_size);
+    if (!ok) {
+        error(u"AES %s error", _descramble ? u"decrypt" : u"encrypt");
+        return TSP_END;
+    }
 
     // Mark "even key" (there is only one key but we must set something).
     pkt.setScrambling(uint8_t(_descramble ? SC_CLEAR : SC_EVEN_KEY));
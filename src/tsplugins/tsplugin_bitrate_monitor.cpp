@@ -18,6 +18,8 @@
 #include "tsxmlAttribute.h"
 #include "tsTime.h"
 #include "tsSingleDataStatistics.h"
+#include "tsRollingBitRate.h"
+#include "tsTimerWheel.h"
 
 
 //----------------------------------------------------------------------------
@@ -25,7 +27,7 @@
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class BitrateMonitorPlugin: public ProcessorPlugin
+    class BitrateMonitorPlugin: public ProcessorPlugin, private TimerHandlerInterface
     {
         TS_PLUGIN_CONSTRUCTORS(BitrateMonitorPlugin);
     public:
@@ -45,21 +47,6 @@ namespace ts {
         // Type indicating status of current bitrate, regarding allowed range.
         enum RangeStatus {LOWER, IN_RANGE, GREATER};
 
-        // Description of what is received during approximately one second.
-        class Period
-        {
-        public:
-            cn::nanoseconds duration {0};  // Actual duration in nanoseconds.
-            PacketCounter   packets = 0;   // Total number of packets.
-            PacketCounter   non_null = 0;  // Total number of non-null packets.
-
-            // Constructor.
-            Period() = default;
-
-            // Clear content.
-            void clear() { duration = cn::nanoseconds::zero(); packets = non_null = 0; }
-        };
-
         // Command line options.
         bool             _full_ts = false;       // Monitor full TS.
         bool             _summary = false;       // Display a final summary.
@@ -89,13 +76,19 @@ namespace ts {
         cn::seconds         _bitrate_countdown {};    // Countdown to report bitrate.
         cn::seconds         _command_countdown {};    // Countdown to run alarm command.
         RangeStatus         _last_bitrate_status = LOWER; // Status of the last bitrate, regarding allowed range.
+        monotonic_time      _start_time {};           // System time at start.
         monotonic_time      _last_second {};          // System time at last measurement point.
-        bool                _startup = false;         // Measurement in progress.
-        size_t              _periods_index = 0;       // Index for packet number array.
-        std::vector<Period> _periods {};              // Number of packets received during last time window, second per second.
+        PacketCounter       _packets = 0;             // Total number of monitored packets.
+        PacketCounter       _non_null = 0;            // Total number of monitored non-null packets.
+        RollingBitRate<cn::microseconds> _window {};  // Packets received during last time window, second per second.
         TSPacketLabelSet    _labels_next {};          // Set these labels on next packet.
         SingleDataStatistics<int64_t> _stats {};      // Bitrate statistics.
         SingleDataStatistics<int64_t> _net_stats {};  // Non-null bitrate statistics.
+        uint64_t            _timer_id = TimerWheel::INVALID_TIMER; // One-second timer.
+        std::atomic_bool    _second_elapsed {false};  // Set by the timer, the system time must be checked.
+
+        // Implementation of TimerHandlerInterface.
+        virtual void handleTimer(TimerWheel& wheel, uint64_t timer_id) override;
 
         // Compute bitrate. Report any alarm.
         void computeBitrate();
@@ -298,25 +291,29 @@ bool ts::BitrateMonitorPlugin::start()
     cn::milliseconds precision = cn::milliseconds(2);
     SetTimersPrecision(precision);
 
-    // Initialize array packets count.
-    _periods.resize(_window_size);
-    for (auto& p : _periods) {
-        p.clear();
-    }
+    // Initialize the sliding window: start point and end of each one-second period.
+    // Nanoseconds is an unusually large precision which may lead to overflows.
+    // Using seconds is not precise enough. Use microseconds.
+    _window.setWindow(cn::microseconds::zero(), _window_size + 1);
+    _window.feed(cn::microseconds::zero(), 0, 0);
+    _packets = 0;
+    _non_null = 0;
 
-    _periods_index = 0;
     _labels_next.reset();
     _bitrate_countdown = _periodic_bitrate;
     _command_countdown = _periodic_command;
     _last_bitrate_status = IN_RANGE;
-    _last_second = monotonic_time::clock::now();
-    _startup = true;
+    _start_time = _last_second = monotonic_time::clock::now();
     _stats.reset();
     _net_stats.reset();
 
     // We must never wait for packets more than one second.
     tsp->setPacketTimeout(cn::seconds(1));
 
+    // Instead of reading the system time on each packet, check it after each second.
+    _second_elapsed = false;
+    _timer_id = TimerWheel::Shared().startTimer(this, cn::seconds(1), cn::seconds(1));
+
     return true;
 }
 
@@ -327,6 +324,9 @@ bool ts::BitrateMonitorPlugin::start()
 
 bool ts::BitrateMonitorPlugin::stop()
 {
+    TimerWheel::Shared().cancelTimer(_timer_id);
+    _timer_id = TimerWheel::INVALID_TIMER;
+
     if (_summary) {
         const int64_t bitrate = _stats.meanRound();
         const int64_t net_bitrate = _net_stats.meanRound();
@@ -374,21 +374,9 @@ void ts::BitrateMonitorPlugin::jsonLine(const UChar* status, int64_t bitrate, in
 
 void ts::BitrateMonitorPlugin::computeBitrate()
 {
-    // Compute total duration and packets.
-    cn::nanoseconds duration {0};
-    PacketCounter total_pkt_count = 0;
-    PacketCounter non_null_count = 0;
-    for (auto& p : _periods) {
-        duration += p.duration;
-        total_pkt_count += p.packets;
-        non_null_count += p.non_null;
-    }
-
-    // Nanoseconds is an unusually large precision which may lead to overflows.
-    // Using seconds is not precise enough. Use microseconds.
-    const cn::microseconds microsec = cn::duration_cast<cn::microseconds>(duration);
-    const BitRate bitrate = PacketBitRate(total_pkt_count, microsec);
-    const BitRate net_bitrate = PacketBitRate(non_null_count, microsec);
+    // Bitrates over the complete time window.
+    const BitRate bitrate = _window.bitrate();
+    const BitRate net_bitrate = _window.netBitRate();
 
     // Accumulate statistics for the final report.
     if (_summary) {
@@ -490,25 +478,27 @@ void ts::BitrateMonitorPlugin::checkTime()
     // New second : compute the bitrate for the last time window
     if (since_last_second >= cn::seconds(1)) {
 
-        // Exact duration of the last period and restart a new period.
-        _periods[_periods_index].duration = since_last_second;
+        // Exact end of the last period and restart a new period.
+        _window.feed(cn::duration_cast<cn::microseconds>(now - _start_time), _packets, _non_null);
         _last_second = now;
+        _second_elapsed = false;
 
-        // Bitrate computation is done only when the packet counter
-        // array if fully filled (to avoid bad values at startup).
-        if (!_startup) {
+        // Bitrate computation is done only when the time window
+        // is fully filled (to avoid bad values at startup).
+        if (_window.full()) {
             computeBitrate();
         }
+    }
+}
 
-        // update index, and reset packet count.
-        _periods_index = (_periods_index + 1) % _periods.size();
-        _periods[_periods_index].clear();
 
-        // We are no more at startup if the index cycles.
-        if (_startup) {
-            _startup = _periods_index != 0;
-        }
-    }
+//----------------------------------------------------------------------------
+// Invoked by the timer wheel thread after each second.
+//----------------------------------------------------------------------------
+
+void ts::BitrateMonitorPlugin::handleTimer(TimerWheel& wheel, uint64_t timer_id)
+{
+    _second_elapsed = true;
 }
 
 
@@ -534,14 +524,17 @@ ts::ProcessorPlugin::Status ts::BitrateMonitorPlugin::processPacket(TSPacket& pk
 {
     // If packet's PID matches, increment the number of packets received during the current second.
     if (_pids.test(pkt.getPID())) {
-        _periods[_periods_index].packets++;
+        _packets++;
         if (pkt.getPID() != PID_NULL) {
-            _periods[_periods_index].non_null++;
+            _non_null++;
         }
     }
 
-    // Check time and bitrates.
-    checkTime();
+    // Check time and bitrates, only when the timer signaled that a second may have elapsed.
+    // The flag remains set until a new one-second period is actually started.
+    if (_second_elapsed) {
+        checkTime();
+    }
 
     // Set labels according to trigger.
     pkt_data.setLabels(_labels_next);
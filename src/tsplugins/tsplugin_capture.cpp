@@ -0,0 +1,249 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor shared library:
+//  Live capture of UDP/IP traffic on a network interface.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractDatagramInputPlugin.h"
+#include "tsPluginRepository.h"
+#include "tsPcapCapture.h"
+
+
+//----------------------------------------------------------------------------
+// Plugin definition
+//----------------------------------------------------------------------------
+
+namespace ts {
+    class CaptureInputPlugin: public AbstractDatagramInputPlugin
+    {
+        TS_PLUGIN_CONSTRUCTORS(CaptureInputPlugin);
+    public:
+        // Implementation of plugin API
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool abortInput() override;
+        virtual bool setReceiveTimeout(cn::milliseconds timeout) override;
+
+    protected:
+        // Implementation of AbstractDatagramInputPlugin.
+        virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource) override;
+
+    private:
+        // Command line options:
+        UString         _interface {};            // Network interface name.
+        IPSocketAddress _destination {};          // Selected destination UDP socket address.
+        IPSocketAddress _source {};               // Selected source UDP socket address.
+        bool            _multicast = false;       // Use multicast destinations only.
+        bool            _promiscuous = false;     // Set promiscuous mode on the interface.
+        size_t          _block_size = PcapCapture::DEFAULT_BLOCK_SIZE;
+        size_t          _block_count = PcapCapture::DEFAULT_BLOCK_COUNT;
+
+        // Working data:
+        PcapCapture        _capture {};           // Live capture.
+        IPSocketAddress    _actual_dest {};       // Actual destination UDP socket address.
+        IPSocketAddressSet _all_sources {};       // All source addresses.
+    };
+}
+
+TS_REGISTER_INPUT_PLUGIN(u"capture", ts::CaptureInputPlugin);
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::CaptureInputPlugin::CaptureInputPlugin(TSP* tsp_) :
+    AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE,
+                                u"Capture TS packets from UDP/IP traffic on a network interface (Linux only)", u"[options] [interface-name]",
+                                u"kernel", u"Kernel capture time stamp",
+                                TSDatagramInputOptions::REAL_TIME | TSDatagramInputOptions::ALLOW_RS204)
+{
+    _capture.defineArgs(*this);
+
+    option(u"", 0, STRING, 0, 1);
+    help(u"", u"interface-name",
+         u"The name of the network interface on which the traffic is captured, for instance 'eth0'. "
+         u"By default, capture the traffic on all interfaces.");
+
+    option(u"block-count", 0, POSITIVE);
+    help(u"block-count",
+         u"Number of blocks in the capture ring which is shared with the kernel. "
+         u"The default is " + UString::Decimal(PcapCapture::DEFAULT_BLOCK_COUNT) + u" blocks.");
+
+    option(u"block-size", 0, POSITIVE);
+    help(u"block-size",
+         u"Size in bytes of each block in the capture ring which is shared with the kernel. "
+         u"The kernel returns a block of frames when it is full or after a short timeout. "
+         u"The default is " + UString::Decimal(PcapCapture::DEFAULT_BLOCK_SIZE) + u" bytes.");
+
+    option(u"destination", 'd', IPSOCKADDR_OAP);
+    help(u"destination",
+         u"Filter UDP datagrams based on the specified destination socket address. "
+         u"By default or if either the IP address or UDP port is missing, "
+         u"use the destination of the first matching UDP datagram containing TS packets. "
+         u"Then, select only UDP datagrams with this socket address.");
+
+    option(u"multicast-only", 'm');
+    help(u"multicast-only",
+         u"When there is no --destination option, select the first multicast address which is found in a UDP datagram. "
+         u"By default, use the destination address of the first UDP datagram containing TS packets, unicast or multicast.");
+
+    option(u"promiscuous", 'p');
+    help(u"promiscuous",
+         u"Set the network interface in promiscuous mode during the capture. "
+         u"This is required to capture traffic which is not sent to this system, unless the interface is already in promiscuous mode. "
+         u"This option is ignored when capturing on all interfaces.");
+
+    option(u"source", 's', IPSOCKADDR_OAP);
+    help(u"source",
+         u"Filter UDP datagrams based on the specified source socket address. "
+         u"By default, do not filter on source address.");
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options method
+//----------------------------------------------------------------------------
+
+bool ts::CaptureInputPlugin::getOptions()
+{
+    getValue(_interface, u"");
+    getSocketValue(_source, u"source");
+    getSocketValue(_destination, u"destination");
+    _multicast = present(u"multicast-only");
+    _promiscuous = present(u"promiscuous");
+    getIntValue(_block_size, u"block-size", PcapCapture::DEFAULT_BLOCK_SIZE);
+    getIntValue(_block_count, u"block-count", PcapCapture::DEFAULT_BLOCK_COUNT);
+
+    // Get command line arguments for superclass and capture filtering options.
+    return AbstractDatagramInputPlugin::getOptions() && _capture.loadArgs(duck, *this);
+}
+
+
+//----------------------------------------------------------------------------
+// Start method
+//----------------------------------------------------------------------------
+
+bool ts::CaptureInputPlugin::start()
+{
+    _actual_dest = _destination;
+    _all_sources.clear();
+
+    _capture.setRingSize(_block_size, _block_count);
+    _capture.setPromiscuous(_promiscuous);
+
+    // Initialize superclass and capture.
+    bool ok = AbstractDatagramInputPlugin::start() && _capture.openInterface(_interface, *this);
+    if (ok) {
+        _capture.setProtocolFilterUDP();
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::CaptureInputPlugin::stop()
+{
+    const uint64_t dropped = _capture.droppedFrames();
+    if (dropped > 0) {
+        warning(u"%'d frames dropped by the kernel, consider increasing --block-count or --block-size", dropped);
+    }
+    verbose(u"captured %'d frames, %'d IP packets", _capture.packetCount(), _capture.ipPacketCount());
+    _capture.close();
+    return AbstractDatagramInputPlugin::stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Input abort method
+//----------------------------------------------------------------------------
+
+bool ts::CaptureInputPlugin::abortInput()
+{
+    debug(u"aborting network capture");
+    _capture.abort();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Set receive timeout from tsp.
+//----------------------------------------------------------------------------
+
+bool ts::CaptureInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
+{
+    _capture.setReceiveTimeout(timeout);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
+
+bool ts::CaptureInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource)
+{
+    IPPacket ip;
+    VLANIdStack vlans;
+    timesource = TimeSource::KERNEL;
+
+    // Loop on captured IP datagrams until a matching UDP packet is found.
+    for (;;) {
+
+        // Read one IP datagram.
+        if (!_capture.readIP(ip, vlans, timestamp, *this)) {
+            return false;
+        }
+
+        // Get IP addresses and UDP ports.
+        const IPSocketAddress src(ip.source());
+        const IPSocketAddress dst(ip.destination());
+
+        // Filter source or destination socket address if one was specified.
+        if (!src.match(_source) || !dst.match(_actual_dest)) {
+            continue; // not a matching address
+        }
+
+        // If the destination is not yet found, filter multicast addresses if required.
+        if (!_actual_dest.hasAddress() && _multicast && !dst.isMulticast()) {
+            continue; // not a multicast address
+        }
+
+        // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
+        if (!_actual_dest.hasAddress() || !_actual_dest.hasPort()) {
+            // The actual destination is not fully known yet.
+            // We are still waiting for the first UDP datagram containing TS packets.
+            size_t start_index = 0;
+            size_t packet_count = 0;
+            size_t packet_size = 0;
+            if (!TSPacket::Locate(ip.protocolData(), ip.protocolDataSize(), start_index, packet_count, packet_size)) {
+                continue; // no TS packet in this UDP datagram.
+            }
+            // We just found the first UDP datagram with TS packets, now use this destination address all the time.
+            _actual_dest = dst;
+            verbose(u"using UDP destination address %s", dst);
+        }
+
+        // List all source addresses as they appear.
+        if (!_all_sources.contains(src)) {
+            verbose(u"%s UDP source address %s", _all_sources.empty() ? u"using" : u"adding", src);
+            _all_sources.insert(src);
+        }
+
+        // Now we have a valid UDP packet.
+        ret_size = std::min(ip.protocolDataSize(), buffer_size);
+        MemCopy(buffer, ip.protocolData(), ret_size);
+        return true;
+    }
+}
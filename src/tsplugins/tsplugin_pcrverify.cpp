@@ -13,6 +13,7 @@
 
 #include "tsPluginRepository.h"
 #include "tsTime.h"
+#include "tsLogHistogram.h"
 
 
 //----------------------------------------------------------------------------
@@ -41,6 +42,14 @@ namespace ts {
             TimeSource    pcr_timesource = TimeSource::UNDEFINED;  // Source of input time stamp.
         };
 
+        // Distributions of values in one PID, in PCR units.
+        struct PIDHistograms
+        {
+            LogHistogram jitter {};    // PCR jitter, as verified by the plugin.
+            LogHistogram interval {};  // Interval between consecutive PCR's.
+            LogHistogram arrival {};   // PCR-to-arrival jitter, based on input timestamps.
+        };
+
         // Command line options.
         bool    _absolute = false;     // Use PCR absolute value, not micro-second
         bool    _input_synch = false;  // Use input-synchronous verification, base on input timestamps
@@ -48,6 +57,7 @@ namespace ts {
         int64_t _jitter_max = 0;       // Max accepted jitter in PCR units
         int64_t _jitter_unreal = 0;    // Max realistic jitter
         bool    _time_stamp = false;   // Display time stamps
+        bool    _percentiles = false;  // Report percentiles of distributions
         PIDSet  _pid_list {};          // Array of pid values to filter
 
         // Working data.
@@ -55,6 +65,7 @@ namespace ts {
         PacketCounter            _nb_pcr_nok = 0;        // Number of PCR with jitter
         PacketCounter            _nb_pcr_unchecked = 0;  // Number of unchecked PCR (no previous ref)
         std::map<PID,PIDContext> _stats {};              // Per-PID statistics
+        std::map<PID,PIDHistograms> _histograms {};      // Per-PID distributions, with --percentiles
 
         // PCR units per micro-second.
         static constexpr int64_t PCR_PER_MICRO_SEC = int64_t(SYSTEM_CLOCK_FREQ) / cn::microseconds::period::den;
@@ -115,6 +126,14 @@ ts::PCRVerifyPlugin::PCRVerifyPlugin(TSP* tsp_) :
          u"Several -p or --pid options may be specified. "
          u"Without -p or --pid option, PCR's from all PID's are used.");
 
+    option(u"percentiles");
+    help(u"percentiles",
+         u"At end of processing, report the distribution of values in each PID: "
+         u"PCR jitter as verified by this plugin, interval between consecutive PCR's and, "
+         u"when input timestamps are available, PCR-to-arrival jitter. "
+         u"For each distribution, the minimum, maximum, mean, p50, p99 and p99.9 values are reported. "
+         u"The memory usage is constant, regardless of the number of PCR's.");
+
     option(u"time-stamp", 't');
     help(u"time-stamp", u"Display time of each event.");
 }
@@ -132,6 +151,7 @@ bool ts::PCRVerifyPlugin::getOptions()
     getIntValue(_jitter_unreal, u"jitter-unreal", _absolute ? DEFAULT_JITTER_UNREAL : DEFAULT_JITTER_UNREAL_US);
     getValue(_bitrate, u"bitrate", 0);
     _time_stamp = present(u"time-stamp");
+    _percentiles = present(u"percentiles");
     getIntValues(_pid_list, u"pid", true); // all PID's set by default
 
     if (!_absolute) {
@@ -158,6 +178,7 @@ bool ts::PCRVerifyPlugin::start()
     _nb_pcr_nok = 0;
     _nb_pcr_unchecked = 0;
     _stats.clear();
+    _histograms.clear();
     return true;
 }
 
@@ -171,6 +192,21 @@ bool ts::PCRVerifyPlugin::stop()
     // Display PCR summary
     info(u"%'d PCR OK, %'d with jitter > %'d (%'d micro-seconds), %'d unchecked",
          _nb_pcr_ok, _nb_pcr_nok, _jitter_max, _jitter_max / PCR_PER_MICRO_SEC, _nb_pcr_unchecked);
+
+    // Display distributions, using the same units as the jitter.
+    const int64_t divisor = _absolute ? 1 : PCR_PER_MICRO_SEC;
+    const UChar* const unit = _absolute ? u"PCR units" : u"micro-seconds";
+    for (const auto& it : _histograms) {
+        if (it.second.jitter.count() > 0) {
+            info(u"PID %n, PCR jitter (%s): %s", it.first, unit, it.second.jitter.summary(divisor));
+        }
+        if (it.second.interval.count() > 0) {
+            info(u"PID %n, PCR interval (%s): %s", it.first, unit, it.second.interval.summary(divisor));
+        }
+        if (it.second.arrival.count() > 0) {
+            info(u"PID %n, PCR arrival jitter (%s): %s", it.first, unit, it.second.arrival.summary(divisor));
+        }
+    }
     return true;
 }
 
@@ -200,6 +236,18 @@ ts::ProcessorPlugin::Status ts::PCRVerifyPlugin::processPacket(TSPacket& pkt, TS
         // Current bitrate is needed if not --input-synchronous. Use signed 64-bit for jitter computation.
         const int64_t bitrate = (_bitrate != 0 || _input_synch ? _bitrate : tsp->bitrate()).toInt();
 
+        // Collect distributions which do not depend on the verification method.
+        if (_percentiles && pc.pcr_value != INVALID_PCR) {
+            PIDHistograms& hist(_histograms[pid]);
+            const int64_t pcr_diff = int64_t(DiffPCR(pc.pcr_value, next_pc.pcr_value));
+            hist.interval.feed(pcr_diff);
+            if (pc.pcr_timestamp != INVALID_PCR && next_pc.pcr_timestamp != INVALID_PCR &&
+                pc.pcr_timesource == next_pc.pcr_timesource && next_pc.pcr_timestamp >= pc.pcr_timestamp)
+            {
+                hist.arrival.feed(int64_t(next_pc.pcr_timestamp - pc.pcr_timestamp) - pcr_diff);
+            }
+        }
+
         // Compare this PCR with previous one to compute the jitter.
         if (pc.pcr_value == INVALID_PCR) {
             // First PCR in the PID, no previous value to compare with.
@@ -252,6 +300,9 @@ ts::ProcessorPlugin::Status ts::PCRVerifyPlugin::processPacket(TSPacket& pkt, TS
 
             // Absolute value of PCR jitter:
             const int64_t ajit = jitter >= 0 ? jitter : -jitter;
+            if (_percentiles && ajit <= _jitter_unreal) {
+                _histograms[pid].jitter.feed(jitter);
+            }
             if (ajit <= _jitter_max) {
                 _nb_pcr_ok++;
             }
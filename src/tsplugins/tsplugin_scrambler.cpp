@@ -14,6 +14,7 @@
 #include "tsPluginRepository.h"
 #include "tsServiceDiscovery.h"
 #include "tsTSScrambling.h"
+#include "tsTSScramblingPool.h"
 #include "tsByteBlock.h"
 #include "tsCyclingPacketizer.h"
 #include "tsOneShotPacketizer.h"
@@ -26,6 +27,7 @@
 #define DEFAULT_ECM_BITRATE 30000
 #define DEFAULT_ECM_INTER_PACKET  7000  // When bitrate is unknown, use 10 ECM/s for TS @10Mb/s
 #define ASYNC_HANDLER_EXTRA_STACK_SIZE (1024 * 1024)
+#define DEFAULT_PACKET_WINDOW 1024    // Packet window size when scrambling with threads
 
 
 //----------------------------------------------------------------------------
@@ -82,6 +84,8 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // Description of a crypto-period.
@@ -154,6 +158,8 @@ namespace ts {
         PID               _ecm_pid = PID_NULL;          // PID for ECM
         PacketCounter     _partial_scrambling = 0;      // Do not scramble all packets if > 1
         cn::seconds       _clear_period {0};            // Clear period before scrambling commences
+        size_t            _threads = 0;                 // Number of scrambling threads (0 means inline scrambling)
+        size_t            _window_size = 0;             // Packet window size when scrambling with threads
         ECMGClientArgs    _ecmg_args {};                // Parameters for ECMG client
         tlv::Logger       _logger {Severity::Debug, this}; // Message logger for ECMG <=> SCS protocol
         ecmgscs::Protocol      _ecmgscs {};                // ECMG <=> SCS protocol instance.
@@ -182,6 +188,12 @@ namespace ts {
         size_t            _current_ecm = 0;             // Index to current ECM (ECM being broadcast)
         TSScrambling      _scrambling {*this};          // Scrambler
         CyclingPacketizer _pzer_pmt {duck};             // Packetizer for modified PMT
+        TSScramblingPool  _pool {*this};                // Pool of scrambling threads
+        std::vector<TSPacket*> _pending {};             // Packets to scramble in current packet window (with threads)
+        TSPacket*         _failed_pkt = nullptr;        // First packet of a group which failed to be scrambled
+
+        // Scramble all pending packets in the current packet window.
+        bool flushPending();
 
         // Initialize ECM and CP scheduling.
         void initializeScheduling();
@@ -315,6 +327,19 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
          u"mode, the packet processing continues while generating ECM's. This option "
          u"is always on in offline mode.");
 
+    option(u"threads", 0, UNSIGNED);
+    help(u"threads",
+         u"Number of additional threads which scramble packets in parallel with the plugin thread. "
+         u"The packets are scrambled in place by groups, inside the packet window of the plugin, "
+         u"and are never reordered. "
+         u"The default is zero, meaning that each packet is individually scrambled by the plugin thread.");
+
+    option(u"packet-window", 0, POSITIVE);
+    help(u"packet-window",
+         u"With --threads, specify the maximum number of packets which are processed at a time. "
+         u"All scrambled packets in a packet window and in the same crypto-period are distributed over the threads. "
+         u"The default is " + UString::Decimal(DEFAULT_PACKET_WINDOW) + u" packets.");
+
     // ECMG and scrambling options.
     _ecmg_args.defineArgs(*this);
     _scrambling.defineArgs(*this);
@@ -345,6 +370,8 @@ bool ts::ScramblerPlugin::getOptions()
     getIntValue(_ecm_pid, u"pid-ecm", PID_NULL);
     getValue(_ecm_bitrate, u"bitrate-ecm", DEFAULT_ECM_BITRATE);
     getHexaValue(_ca_desc_private, u"private-data");
+    getIntValue(_threads, u"threads", 0);
+    getIntValue(_window_size, u"packet-window", DEFAULT_PACKET_WINDOW);
 
     // Other common parameters.
     if (!_ecmg_args.loadArgs(duck, *this) || !_scrambling.loadArgs(duck, *this)) {
@@ -401,6 +428,8 @@ bool ts::ScramblerPlugin::start()
     _delay_start = cn::milliseconds(0);
     _current_cw = 0;
     _current_ecm = 0;
+    _pending.clear();
+    _failed_pkt = nullptr;
 
     // As long as the bitrate is unknown, delay changes to infinite.
     _pkt_insert_ecm = _pkt_change_cw = _pkt_change_ecm = std::numeric_limits<PacketCounter>::max();
@@ -410,6 +439,14 @@ bool ts::ScramblerPlugin::start()
         return false;
     }
 
+    // Start the scrambling threads, if any.
+    if (!_pool.start(_threads)) {
+        return false;
+    }
+    if (_threads > 0) {
+        _pending.reserve(_window_size);
+    }
+
     // Initialize ECMG.
     if (_need_ecm) {
         if (!_ecmg_args.ecmg_address.hasAddress()) {
@@ -471,7 +508,8 @@ bool ts::ScramblerPlugin::stop()
         _ecmg.disconnect();
     }
 
-    // Terminate the scrambling engine.
+    // Terminate the scrambling threads and engine.
+    _pool.stop();
     _scrambling.stop();
 
     debug(u"scrambled %'d packets in %'d PID's", _scrambled_count, _scrambled_pids.count());
@@ -680,6 +718,11 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
 
 bool ts::ScramblerPlugin::changeCW()
 {
+    // Packets from the previous crypto-period must be scrambled with the previous CW.
+    if (!flushPending()) {
+        return false;
+    }
+
     if (_scrambling.hasFixedCW()) {
         // A list of fixed CW was loaded from a file.
 
@@ -848,8 +891,11 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
         _partial_clear = _partial_scrambling - 1;
     }
 
-    // Scramble the packet payload.
-    if (!_scrambling.encrypt(pkt)) {
+    // Scramble the packet payload. With threads, scramble later, by groups.
+    if (_threads > 0) {
+        _pending.push_back(&pkt);
+    }
+    else if (!_scrambling.encrypt(pkt)) {
         return TSP_END;
     }
     _scrambled_count++;
@@ -858,6 +904,64 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
 }
 
 
+//----------------------------------------------------------------------------
+// Get requested window size, called between start() and first packet.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::getPacketWindowSize()
+{
+    // Without threads, use individual packet mode.
+    return _threads > 0 ? _window_size : 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method, used with scrambling threads.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Analyze all packets using processPacket(). The packets to scramble are
+    // accumulated in _pending and scrambled by groups, one per crypto-period.
+    size_t count = ProcessorPlugin::processPacketWindow(win);
+
+    // Scramble the last group of packets in the window.
+    flushPending();
+
+    // In case of scrambling error, stop before the first packet of the failed group.
+    if (_failed_pkt != nullptr) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* mdata = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            if (win.get(i, pkt, mdata) && pkt == _failed_pkt) {
+                count = i;
+                break;
+            }
+        }
+        _failed_pkt = nullptr;
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Scramble all pending packets in the current packet window.
+//----------------------------------------------------------------------------
+
+bool ts::ScramblerPlugin::flushPending()
+{
+    bool success = true;
+    if (!_pending.empty()) {
+        success = _pool.encrypt(_scrambling, _pending.data(), _pending.size());
+        if (!success && _failed_pkt == nullptr) {
+            _failed_pkt = _pending.front();
+        }
+        _pending.clear();
+    }
+    return success;
+}
+
+
 //----------------------------------------------------------------------------
 // Initialize first crypto period.
 //----------------------------------------------------------------------------
@@ -998,6 +1102,13 @@ void ts::ScramblerPlugin::CryptoPeriod::handleECM(const ecmgscs::ECMResponse& re
 
     _ecm_pkt_index = 0;
 
+    // Compute the key schedule of the CW of this crypto-period in advance. In asynchronous mode,
+    // this is done in the ECMG client thread, not at the crypto-period transition in the packet path.
+    if (!_plugin->_scrambling.prepareCW(_cw_current, _cp_number)) {
+        _plugin->_abort = true;
+        return;
+    }
+
     // Last instruction: set the volatile boolean
     _ecm_ok = true;
 }
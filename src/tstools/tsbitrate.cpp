@@ -33,6 +33,7 @@ namespace {
         bool               use_dts = false;        // Use DTS instead of PCR
         bool               all = false;            // All packets analysis
         bool               full = false;           // Full analysis
+        bool               timing = false;         // Timing distributions analysis
         bool               value_only = false;     // Output value only
         bool               ignore_errors = false;  // Ignore TS errors
         ts::UString        infile {};              // Input file name
@@ -76,6 +77,12 @@ Options::Options(int argc, char *argv[]) :
     option(u"min-pid", 0, INTEGER, 0, 1, 1, ts::PID_MAX);
     help(u"min-pid", u"Minimum number of PID's to get PCR from (default: 1).");
 
+    option(u"timing", 't');
+    help(u"timing",
+         u"Analyze the timing distributions of each PID and add them to the final report: "
+         u"PCR accuracy, PCR interval, PCR-to-arrival jitter (when the input file provides timestamps) "
+         u"and offsets of PTS and DTS from PCR. The file is entirely analyzed (as with --all).");
+
     option(u"value-only", 'v');
     help(u"value-only",
          u"Display only the bitrate value, in bits/seconds, based on "
@@ -85,7 +92,8 @@ Options::Options(int argc, char *argv[]) :
 
     getValue(infile, u"");
     full = present(u"full");
-    all = full || present(u"all");
+    timing = present(u"timing");
+    all = full || timing || present(u"all");
     value_only = present(u"value-only");
     getIntValue(min_pcr, u"min-pcr", 64);
     getIntValue(min_pid, u"min-pid", 1);
@@ -110,6 +118,7 @@ int MainCode(int argc, char *argv[])
     // Configure the PCR analyzer.
     ts::PCRAnalyzer zer(opt.min_pid, opt.min_pcr);
     zer.setIgnoreErrors(opt.ignore_errors);
+    zer.setTimingAnalysis(opt.timing);
     if (opt.use_dts) {
         zer.resetAndUseDTS(opt.min_pid, opt.min_pcr);
     }
@@ -122,7 +131,8 @@ int MainCode(int argc, char *argv[])
 
     // Read all packets in the file and pass them to the PCR analyzer.
     ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0 && (!zer.feedPacket(pkt) || opt.all)) {}
+    ts::TSPacketMetadata mdata;
+    while (file.readPackets(&pkt, &mdata, 1, opt) > 0 && (!zer.feedPacket(pkt, mdata) || opt.all)) {}
     file.close(opt);
 
     // Display results.
@@ -172,5 +182,13 @@ int MainCode(int argc, char *argv[])
         std::cout << std::endl;
     }
 
+    if (opt.timing) {
+        std::cout << std::endl
+                  << "Timing distributions" << std::endl
+                  << "--------------------" << std::endl;
+        zer.reportTiming(std::cout);
+        std::cout << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -13,9 +13,13 @@
 #include "tsMain.h"
 #include "tsDuckContext.h"
 #include "tsPcapStream.h"
+#include "tsPcapFlowIndex.h"
 #include "tsIPPacket.h"
 #include "tsTime.h"
 #include "tsTS.h"
+#include "tsTSPacket.h"
+#include "tsThread.h"
+#include "tsErrCodeReport.h"
 #include "tsBitRate.h"
 #include "tsEMMGMUX.h"
 #include "tsECMGSCS.h"
@@ -41,12 +45,15 @@ namespace {
         ts::PagerArgs         pager {true, true};
         ts::UString           input_file {};
         ts::UString           output_file {};
+        fs::path              extract_dir {};
+        size_t                extract_threads = 0;
         bool                  print_summary = false;
         bool                  list_streams = false;
         bool                  print_intervals = false;
         bool                  dvb_simulcrypt = false;
         bool                  extract_tcp = false;
         bool                  save_tcp = false;
+        bool                  extract_ts = false;
         std::set<uint8_t>     protocols {};
         ts::IPSocketAddress   source_filter {};
         ts::IPSocketAddress   dest_filter {};
@@ -90,6 +97,14 @@ Options::Options(int argc, char *argv[]) :
          u"The two directions of the TCP session are dumped. "
          u"The first TCP session matching the --source and --destination options is selected.");
 
+    option(u"extract-ts-flows", 'x', DIRECTORY);
+    help(u"extract-ts-flows",
+         u"Extract all UDP flows which contain TS packets into separate TS files in the specified directory. "
+         u"The input file is read only once to build an index of all UDP flows. "
+         u"Then, all flows are extracted in parallel, directly from the index. "
+         u"Use --source and --destination to restrict the extracted flows. "
+         u"The input file must be a named file, not the standard input.");
+
     option<cn::microseconds>(u"interval", 'i');
     help(u"interval",
          u"Print a summary of exchanged data by intervals of times in micro-seconds.");
@@ -117,6 +132,11 @@ Options::Options(int argc, char *argv[]) :
     option(u"tcp", 't');
     help(u"tcp", u"Filter TCP packets.");
 
+    option(u"threads", 0, POSITIVE);
+    help(u"threads",
+         u"With --extract-ts-flows, specify the number of threads which extract the flows in parallel. "
+         u"The default is the number of CPU cores.");
+
     option(u"udp", 'u');
     help(u"udp", u"Filter UDP packets.");
 
@@ -128,6 +148,9 @@ Options::Options(int argc, char *argv[]) :
     getValue(input_file, u"");
     getValue(output_file, u"output-tcp-stream");
     save_tcp = present(u"output-tcp-stream");
+    getPathValue(extract_dir, u"extract-ts-flows");
+    extract_ts = present(u"extract-ts-flows");
+    getIntValue(extract_threads, u"threads", std::max<size_t>(1, std::thread::hardware_concurrency()));
     getSocketValue(dest_filter, u"destination");
     getSocketValue(source_filter, u"source");
     getChronoValue(interval, u"interval");
@@ -157,6 +180,12 @@ Options::Options(int argc, char *argv[]) :
     if (dvb_simulcrypt && extract_tcp) {
         error(u"--dvb-simulcrypt and --extract-tcp-stream are mutually exclusive");
     }
+    if (extract_ts && (dvb_simulcrypt || extract_tcp || save_tcp)) {
+        error(u"--extract-ts-flows cannot be used with --dvb-simulcrypt, --extract-tcp-stream, --output-tcp-stream");
+    }
+    if (extract_ts && (input_file.empty() || input_file == u"-")) {
+        error(u"--extract-ts-flows requires a named input file");
+    }
     exitOnError();
 }
 
@@ -795,6 +824,212 @@ bool TCPSessionDump::save()
 }
 
 
+//----------------------------------------------------------------------------
+// Extract all UDP flows containing TS packets, in parallel.
+//----------------------------------------------------------------------------
+
+namespace {
+    class FlowExtraction
+    {
+        TS_NOBUILD_NOCOPY(FlowExtraction);
+    public:
+        // Constructor.
+        FlowExtraction(Options& opt) : _opt(opt) {}
+
+        // Index the file and extract the flows, return true on success, false on error.
+        bool extract(std::ostream&);
+
+    private:
+        // Description of one flow to extract.
+        class FlowJob
+        {
+        public:
+            const ts::PcapFlowIndex::FlowId* id = nullptr;
+            const ts::PcapFlowIndex::Flow*   flow = nullptr;
+            fs::path output {};
+            uint64_t packet_count = 0;
+            bool     success = true;
+        };
+
+        // A thread which extracts flows, until all flows are extracted.
+        class Extractor: public ts::Thread
+        {
+            TS_NOBUILD_NOCOPY(Extractor);
+        public:
+            Extractor(FlowExtraction* parent) : _parent(parent) {}
+            virtual ~Extractor() override { waitForTermination(); }
+        private:
+            FlowExtraction* _parent;
+            virtual void main() override;
+        };
+
+        Options&               _opt;
+        ts::PcapFilter         _file {};
+        ts::PcapFlowIndex      _index {};
+        std::vector<FlowJob>   _jobs {};
+        std::atomic<size_t>    _next_job {0};
+
+        // Extract one flow.
+        void extractFlow(FlowJob& job);
+    };
+}
+
+// Index the file and extract the flows.
+bool FlowExtraction::extract(std::ostream& out)
+{
+    // Open the pcap file in memory-mapped mode, index all UDP flows.
+    _file.setMemoryMap(true);
+    if (!_file.loadArgs(_opt.duck, _opt) || !_file.open(_opt.input_file, _opt)) {
+        return false;
+    }
+    _file.setProtocolFilterUDP();
+    _file.setSourceFilter(_opt.source_filter);
+    _file.setDestinationFilter(_opt.dest_filter);
+    const bool indexed = _index.build(_file, _opt);
+    _file.close();
+    if (!indexed || !_index.openPayloads(_opt)) {
+        return false;
+    }
+
+    // Select all flows with TS packets in the first datagram.
+    for (const auto& it : _index.flows()) {
+        const ts::PcapFlowIndex::FlowId& id(it.first);
+        const ts::PcapFlowIndex::Flow& flow(it.second);
+        const uint8_t* data = nullptr;
+        ts::ByteBlock buffer;
+        size_t start_index = 0;
+        size_t packet_count = 0;
+        size_t packet_size = 0;
+        if (!flow.payloads.empty() &&
+            _index.readPayload(flow.payloads.front(), data, buffer, _opt) &&
+            ts::TSPacket::Locate(data, flow.payloads.front().size, start_index, packet_count, packet_size))
+        {
+            // Build a file name which is valid on all systems.
+            ts::UString name(ts::UString::Format(u"udp_%s_%s", id.destination, id.source));
+            if (!id.vlans.empty()) {
+                name.format(u"_vlan_%s", id.vlans);
+            }
+            for (auto& c : name) {
+                if (!ts::IsAlphaNum(c) && c != u'.' && c != u'-') {
+                    c = u'_';
+                }
+            }
+            _jobs.push_back({&id, &flow, _opt.extract_dir / (name + u".ts")});
+        }
+    }
+    _opt.verbose(u"%'d UDP flows in file, %'d with TS packets", _index.flows().size(), _jobs.size());
+
+    // Create the output directory if necessary.
+    if (!_jobs.empty() && !fs::is_directory(_opt.extract_dir)) {
+        if (!fs::create_directories(_opt.extract_dir, &ts::ErrCodeReport(_opt, u"error creating directory", _opt.extract_dir))) {
+            return false;
+        }
+    }
+
+    // Start the extraction threads. Each thread extracts flows until all flows are done.
+    // If a thread cannot be started, the other threads stop after their current flow and the extraction fails.
+    const size_t thread_count = std::min(_opt.extract_threads, _jobs.size());
+    std::vector<std::unique_ptr<Extractor>> threads;
+    bool started = true;
+    for (size_t i = 0; started && i < thread_count; ++i) {
+        threads.push_back(std::make_unique<Extractor>(this));
+        if (!threads.back()->start()) {
+            _opt.error(u"cannot start flow extraction thread");
+            _next_job = _jobs.size();
+            started = false;
+        }
+    }
+    for (auto& th : threads) {
+        th->waitForTermination();
+    }
+    _index.closePayloads();
+    if (!started) {
+        return false;
+    }
+
+    // Display the list of extracted flows.
+    using Align = ts::TextTable::Align;
+    enum Id {VLAN, SRC, DEST, DGRAMS, PKTS, OUTPUT};
+
+    ts::TextTable table;
+    table.addColumn(VLAN, u"VLAN", Align::LEFT);
+    table.addColumn(SRC, u"Source", Align::LEFT);
+    table.addColumn(DEST, u"Destination", Align::LEFT);
+    table.addColumn(DGRAMS, u"Datagrams", Align::RIGHT);
+    table.addColumn(PKTS, u"TS packets", Align::RIGHT);
+    table.addColumn(OUTPUT, u"Output file", Align::LEFT);
+
+    bool success = true;
+    for (const auto& job : _jobs) {
+        success = success && job.success;
+        table.newLine();
+        table.setCell(VLAN, job.id->vlans.toString());
+        table.setCell(SRC, job.id->source);
+        table.setCell(DEST, job.id->destination);
+        table.setCell(DGRAMS, ts::UString::Decimal(job.flow->payloads.size()));
+        table.setCell(PKTS, ts::UString::Decimal(job.packet_count));
+        table.setCell(OUTPUT, job.output);
+    }
+
+    out << std::endl;
+    table.output(out, ts::TextTable::Headers::TEXT, true, u"", u"  ");
+    out << std::endl;
+    return success;
+}
+
+// Extraction thread.
+void FlowExtraction::Extractor::main()
+{
+    for (;;) {
+        const size_t index = _parent->_next_job++;
+        if (index >= _parent->_jobs.size()) {
+            break;
+        }
+        _parent->extractFlow(_parent->_jobs[index]);
+    }
+}
+
+// Extract one flow.
+void FlowExtraction::extractFlow(FlowJob& job)
+{
+    std::ofstream file(job.output, std::ios::out | std::ios::binary);
+    if (!file) {
+        _opt.error(u"error creating %s", job.output);
+        job.success = false;
+        return;
+    }
+
+    // Write all TS packets from all datagrams, in 188-byte format, dropping any header (RTP, etc.)
+    ts::ByteBlock buffer;
+    size_t packet_size = 0;
+    for (const auto& loc : job.flow->payloads) {
+        const uint8_t* data = nullptr;
+        size_t start_index = 0;
+        size_t packet_count = 0;
+        if (!_index.readPayload(loc, data, buffer, _opt)) {
+            job.success = false;
+            break;
+        }
+        if (ts::TSPacket::Locate(data, loc.size, start_index, packet_count, packet_size)) {
+            if (packet_size == ts::PKT_SIZE) {
+                file.write(reinterpret_cast<const char*>(data + start_index), std::streamsize(packet_count * ts::PKT_SIZE));
+            }
+            else {
+                for (size_t i = 0; i < packet_count; ++i) {
+                    file.write(reinterpret_cast<const char*>(data + start_index + i * packet_size), std::streamsize(ts::PKT_SIZE));
+                }
+            }
+            job.packet_count += packet_count;
+        }
+    }
+    file.close();
+    if (!file) {
+        _opt.error(u"error writing %s", job.output);
+        job.success = false;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Program main code.
 //----------------------------------------------------------------------------
@@ -808,7 +1043,12 @@ int MainCode(int argc, char *argv[])
     // Output device, may be paginated.
     std::ostream& out(opt.save_tcp ? std::cout : opt.pager.output(opt));
 
-    if (opt.extract_tcp) {
+    if (opt.extract_ts) {
+        // Extraction of all TS flows.
+        FlowExtraction fe(opt);
+        status = fe.extract(out);
+    }
+    else if (opt.extract_tcp) {
         // TCP session dump.
         TCPSessionDump tcp(opt);
         status = tcp.dump(out);
@@ -70,6 +70,9 @@ class CryptoTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(IDSA);
     TSUNIT_DECLARE_TEST(SCTE52_2003);
     TSUNIT_DECLARE_TEST(SCTE52_2008);
+    TSUNIT_DECLARE_TEST(InPlaceMessages);
+    TSUNIT_DECLARE_TEST(SharedContext);
+    TSUNIT_DECLARE_TEST(Rekey);
     TSUNIT_DECLARE_TEST(SHA1);
     TSUNIT_DECLARE_TEST(SHA256);
     TSUNIT_DECLARE_TEST(SHA512);
@@ -101,6 +104,8 @@ private:
 
     void testChainingSizes(ts::BlockCipher& algo, int sizes, ...);
 
+    void testInPlaceMessages(ts::BlockCipher& algo, bool set_iv);
+
     void testHash(utest::TSUnitBenchmark& bench,
                   ts::Hash& algo,
                   size_t tv_index,
@@ -108,6 +113,9 @@ private:
                   const char* message,
                   const void* hash,
                   size_t hash_size);
+
+    template <class TV>
+    void testHashMessages(ts::Hash& algo, const TV* tv, size_t tv_count);
 };
 
 TSUNIT_REGISTER(CryptoTest);
@@ -214,6 +222,82 @@ void CryptoTest::testChaining(utest::TSUnitBenchmark& bench,
     testCipher(bench, algo, tv_index, tv_count, key, key_size, plain, plain_size, cipher, cipher_size);
 }
 
+void CryptoTest::testInPlaceMessages(ts::BlockCipher& algo, bool set_iv)
+{
+    // Multi-message encryption must produce the same result as encrypting messages one by one.
+    // Use more messages than interleaved lanes, with sizes up to a TS packet payload.
+    constexpr size_t count = 50;
+    ts::SystemRandomGenerator prng;
+    ts::ByteBlock key(algo.maxKeySize());
+    ts::ByteBlock iv(algo.maxIVSize());
+    TSUNIT_ASSERT(prng.read(key.data(), key.size()));
+    TSUNIT_ASSERT(prng.read(iv.data(), iv.size()));
+    TSUNIT_ASSERT(algo.setKey(key.data(), key.size()));
+    if (set_iv) {
+        TSUNIT_ASSERT(algo.setIV(iv.data(), iv.size()));
+    }
+
+    std::vector<ts::ByteBlock> plain(count), single(count), multi(count);
+    std::vector<void*> messages(count);
+    std::vector<size_t> sizes(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = (i * 37) % (ts::PKT_SIZE - 4 + 1);
+        if (!algo.residueAllowed()) {
+            size -= size % algo.blockSize();
+        }
+        if (size == 0 || size < algo.minMessageSize()) {
+            size = std::max(algo.minMessageSize(), algo.blockSize());
+        }
+        plain[i].resize(size);
+        TSUNIT_ASSERT(prng.read(plain[i].data(), plain[i].size()));
+        single[i] = multi[i] = plain[i];
+        TSUNIT_ASSERT(algo.encrypt(single[i].data(), size, single[i].data(), size));
+        messages[i] = multi[i].data();
+        sizes[i] = size;
+    }
+
+    TSUNIT_ASSERT(algo.encryptInPlace(messages.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(single[i], multi[i]);
+    }
+    TSUNIT_ASSERT(algo.decryptInPlace(messages.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(plain[i], multi[i]);
+    }
+
+    // Same result with the shared key, from several threads, each one with its own context.
+    if (!algo.hasContextInPlace()) {
+        debug() << "CryptoTest::testInPlaceMessages: no context in-place for " << algo.name() << std::endl;
+        return;
+    }
+    constexpr size_t thread_count = 4;
+    std::array<bool, thread_count> success {};
+    std::vector<std::thread> threads;
+    for (size_t ti = 0; ti < thread_count; ++ti) {
+        threads.emplace_back([&, ti]() {
+            const ts::BlockCipher& shared(algo);
+            ts::BlockCipherContext context;
+            std::vector<ts::ByteBlock> data(plain);
+            std::vector<void*> msg(count);
+            for (size_t i = 0; i < count; ++i) {
+                msg[i] = data[i].data();
+            }
+            bool ok = true;
+            for (size_t iter = 0; ok && iter < 20; ++iter) {
+                ok = shared.encryptInPlace(context, msg.data(), sizes.data(), count) && data == single &&
+                     shared.decryptInPlace(context, msg.data(), sizes.data(), count) && data == plain;
+            }
+            success[ti] = ok;
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    for (size_t ti = 0; ti < thread_count; ++ti) {
+        TSUNIT_ASSERT(success[ti]);
+    }
+}
+
 void CryptoTest::testChainingSizes(ts::BlockCipher& algo, int sizes, ...)
 {
     ts::SystemRandomGenerator prng;
@@ -319,6 +403,26 @@ void CryptoTest::testHash(utest::TSUnitBenchmark& bench,
     }
 }
 
+template <class TV>
+void CryptoTest::testHashMessages(ts::Hash& algo, const TV* tv, size_t tv_count)
+{
+    // Hash all test vectors in one operation.
+    std::vector<const void*> messages(tv_count);
+    std::vector<size_t> sizes(tv_count);
+    for (size_t i = 0; i < tv_count; ++i) {
+        messages[i] = tv[i].message;
+        sizes[i] = std::strlen(tv[i].message);
+    }
+    const size_t hsize = algo.hashSize();
+    ts::ByteBlock hashes(tv_count * hsize);
+    TSUNIT_ASSERT(!algo.hashMessages(messages.data(), sizes.data(), tv_count, hashes.data(), hashes.size() - 1));
+    TSUNIT_ASSERT(algo.hashMessages(messages.data(), sizes.data(), tv_count, hashes.data(), hashes.size()));
+    for (size_t i = 0; i < tv_count; ++i) {
+        TSUNIT_EQUAL(sizeof(tv[i].hash), hsize);
+        TSUNIT_ASSERT(ts::MemEqual(tv[i].hash, hashes.data() + i * hsize, hsize));
+    }
+}
+
 TSUNIT_DEFINE_TEST(AES)
 {
     ts::AES128 aes128;
@@ -428,8 +532,9 @@ TSUNIT_DEFINE_TEST(AES_CTR)
 
     bench.report(u"CryptoTest::testAES_CTR");
 
-    testChainingSizes(aes128, 16, 32, 64, 65536, 0);
-    testChainingSizes(aes256, 16, 32, 64, 65536, 0);
+    // CTR accepts a residue after the last complete block.
+    testChainingSizes(aes128, 7, 16, 32, 64, 184, 65536, 0);
+    testChainingSizes(aes256, 7, 16, 32, 64, 184, 65536, 0);
 }
 
 TSUNIT_DEFINE_TEST(AES_CTS1)
@@ -605,6 +710,133 @@ TSUNIT_DEFINE_TEST(IDSA)
     bench.report(u"CryptoTest::testIDSA");
 }
 
+TSUNIT_DEFINE_TEST(InPlaceMessages)
+{
+    ts::DVBCISSA cissa;
+    testInPlaceMessages(cissa, false);
+
+    ts::IDSA idsa;
+    testInPlaceMessages(idsa, false);
+
+    ts::SCTE52_2008 scte;
+    testInPlaceMessages(scte, true);
+
+    ts::CBC<ts::AES128> cbc;
+    testInPlaceMessages(cbc, true);
+
+    ts::CTS2<ts::AES128> cts2;
+    testInPlaceMessages(cts2, true);
+
+    ts::ECB<ts::AES128> ecb;
+    testInPlaceMessages(ecb, false);
+
+    ts::CTR<ts::AES256> ctr;
+    testInPlaceMessages(ctr, true);
+
+    ts::DVBCSA2 csa;
+    testInPlaceMessages(csa, false);
+}
+
+TSUNIT_DEFINE_TEST(SharedContext)
+{
+    ts::AES128 aes;
+    if (!aes.hasContextModes()) {
+        debug() << "CryptoTest::SharedContext: no native ECB and CBC modes, skipped" << std::endl;
+        return;
+    }
+
+    ts::SystemRandomGenerator prng;
+    ts::ByteBlock key1, key2, iv, plain;
+    TSUNIT_ASSERT(prng.readByteBlock(key1, aes.minKeySize()));
+    TSUNIT_ASSERT(prng.readByteBlock(key2, aes.minKeySize()));
+    TSUNIT_ASSERT(prng.readByteBlock(iv, ts::AES128::BLOCK_SIZE));
+    TSUNIT_ASSERT(prng.readByteBlock(plain, 64 * ts::AES128::BLOCK_SIZE));
+
+    // Reference results, using the usual API.
+    ts::ECB<ts::AES128> ecb;
+    ts::CBC<ts::AES128> cbc;
+    ts::ByteBlock ref_ecb(plain.size()), ref_cbc(plain.size());
+    TSUNIT_ASSERT(ecb.setKey(key1.data(), key1.size()));
+    TSUNIT_ASSERT(ecb.encrypt(plain.data(), plain.size(), ref_ecb.data(), ref_ecb.size()));
+    TSUNIT_ASSERT(cbc.setKey(key1.data(), key1.size(), iv.data(), iv.size()));
+    TSUNIT_ASSERT(cbc.encrypt(plain.data(), plain.size(), ref_cbc.data(), ref_cbc.size()));
+
+    // Several threads use the same key, each one with its own context.
+    TSUNIT_ASSERT(aes.setKey(key1.data(), key1.size()));
+    constexpr size_t thread_count = 4;
+    std::array<bool, thread_count> success {};
+    std::vector<std::thread> threads;
+    for (size_t ti = 0; ti < thread_count; ++ti) {
+        threads.emplace_back([&, ti]() {
+            ts::BlockCipherContext context;
+            ts::ByteBlock buf(plain.size());
+            bool ok = true;
+            for (size_t iter = 0; ok && iter < 50; ++iter) {
+                ok = aes.encryptECB(context, plain.data(), plain.size(), buf.data()) && buf == ref_ecb &&
+                     aes.decryptECB(context, buf.data(), buf.size(), buf.data()) && buf == plain &&
+                     aes.encryptCBC(context, iv.data(), plain.data(), plain.size(), buf.data()) && buf == ref_cbc &&
+                     aes.decryptCBC(context, iv.data(), buf.data(), buf.size(), buf.data()) && buf == plain;
+            }
+            success[ti] = ok;
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    for (size_t ti = 0; ti < thread_count; ++ti) {
+        TSUNIT_ASSERT(success[ti]);
+    }
+
+    // After a change of key, an existing context uses the new key.
+    ts::BlockCipherContext context;
+    ts::ByteBlock buf(plain.size());
+    TSUNIT_ASSERT(aes.encryptECB(context, plain.data(), plain.size(), buf.data()));
+    TSUNIT_EQUAL(ref_ecb, buf);
+    TSUNIT_ASSERT(aes.setKey(key2.data(), key2.size()));
+    TSUNIT_ASSERT(ecb.setKey(key2.data(), key2.size()));
+    TSUNIT_ASSERT(ecb.encrypt(plain.data(), plain.size(), ref_ecb.data(), ref_ecb.size()));
+    TSUNIT_ASSERT(aes.encryptECB(context, plain.data(), plain.size(), buf.data()));
+    TSUNIT_EQUAL(ref_ecb, buf);
+
+    // Only complete blocks are accepted.
+    TSUNIT_ASSERT(!aes.encryptECB(context, plain.data(), plain.size() - 1, buf.data()));
+}
+
+TSUNIT_DEFINE_TEST(Rekey)
+{
+    ts::SystemRandomGenerator prng;
+    ts::ByteBlock key1, key2, iv, plain;
+    TSUNIT_ASSERT(prng.readByteBlock(key1, ts::AES128::KEY_SIZE));
+    TSUNIT_ASSERT(prng.readByteBlock(key2, ts::AES128::KEY_SIZE));
+    TSUNIT_ASSERT(prng.readByteBlock(iv, ts::AES128::BLOCK_SIZE));
+    TSUNIT_ASSERT(prng.readByteBlock(plain, 64 * ts::AES128::BLOCK_SIZE));
+
+    // Reference results, using new instances for each key.
+    ts::ByteBlock ref1(plain.size()), ref2(plain.size()), buf(plain.size());
+    {
+        ts::CBC<ts::AES128> cbc;
+        TSUNIT_ASSERT(cbc.setKey(key1.data(), key1.size(), iv.data(), iv.size()));
+        TSUNIT_ASSERT(cbc.encrypt(plain.data(), plain.size(), ref1.data(), ref1.size()));
+    }
+    {
+        ts::CBC<ts::AES128> cbc;
+        TSUNIT_ASSERT(cbc.setKey(key2.data(), key2.size(), iv.data(), iv.size()));
+        TSUNIT_ASSERT(cbc.encrypt(plain.data(), plain.size(), ref2.data(), ref2.size()));
+    }
+
+    // The same instance keeps its cipher contexts when the key changes, in both directions.
+    ts::CBC<ts::AES128> cbc;
+    for (size_t iter = 0; iter < 4; ++iter) {
+        const ts::ByteBlock& key(iter % 2 == 0 ? key1 : key2);
+        const ts::ByteBlock& ref(iter % 2 == 0 ? ref1 : ref2);
+        TSUNIT_ASSERT(cbc.setKey(key.data(), key.size(), iv.data(), iv.size()));
+        TSUNIT_ASSERT(cbc.encrypt(plain.data(), plain.size(), buf.data(), buf.size()));
+        TSUNIT_EQUAL(ref, buf);
+        TSUNIT_ASSERT(cbc.decrypt(buf.data(), buf.size(), buf.data(), buf.size()));
+        TSUNIT_EQUAL(plain, buf);
+    }
+}
+
 TSUNIT_DEFINE_TEST(SCTE52_2003)
 {
     utest::TSUnitBenchmark bench(u"TSUNIT_SCTE52_2003_ITERATIONS");
@@ -647,6 +879,7 @@ TSUNIT_DEFINE_TEST(SHA1)
         const TV_SHA1* tv = tv_sha1 + tvi;
         testHash(bench, sha1, tvi, tv_count, tv->message, tv->hash, sizeof(tv->hash));
     }
+    testHashMessages(sha1, tv_sha1, tv_count);
 
     bench.report(u"CryptoTest::testSHA1");
 }
@@ -663,6 +896,7 @@ TSUNIT_DEFINE_TEST(SHA256)
         const TV_SHA256* tv = tv_sha256 + tvi;
         testHash(bench, sha256, tvi, tv_count, tv->message, tv->hash, sizeof(tv->hash));
     }
+    testHashMessages(sha256, tv_sha256, tv_count);
 
     bench.report(u"CryptoTest::testSHA256");
 }
@@ -679,6 +913,7 @@ TSUNIT_DEFINE_TEST(SHA512)
         const TV_SHA512* tv = tv_sha512 + tvi;
         testHash(bench, sha512, tvi, tv_count, tv->message, tv->hash, sizeof(tv->hash));
     }
+    testHashMessages(sha512, tv_sha512, tv_count);
 
     bench.report(u"CryptoTest::testSHA512");
 }
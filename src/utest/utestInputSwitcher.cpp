@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::InputSwitcher
+//
+//----------------------------------------------------------------------------
+
+#include "tsInputSwitcher.h"
+#include "tsPluginRepository.h"
+#include "tsInputPlugin.h"
+#include "tsOutputPlugin.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class InputSwitcherTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(FastSwitch);
+};
+
+TSUNIT_REGISTER(InputSwitcherTest);
+
+
+//----------------------------------------------------------------------------
+// Test plugins. Each input plugin generates packets in PID 100 + plugin index,
+// with a sequence number at the beginning and at the end of the packet. The
+// output plugin checks that the sequence numbers of each PID strictly increase
+// (packets can be dropped in --fast-switch mode but never reordered) and that
+// no packet was overwritten while being sent.
+//----------------------------------------------------------------------------
+
+namespace {
+    constexpr ts::PID BASE_PID = 100;
+    constexpr size_t MAX_INPUTS = 4;
+    constexpr size_t SEQ_END = ts::PKT_SIZE - 8;
+
+    std::atomic<size_t> output_packets {0};
+    std::atomic<size_t> output_errors {0};
+    std::atomic<size_t> output_switches {0};
+
+    class SequenceInput: public ts::InputPlugin
+    {
+        TS_NOBUILD_NOCOPY(SequenceInput);
+    public:
+        SequenceInput(ts::TSP* t) : ts::InputPlugin(t, u"Test sequence input") {}
+        static ts::InputPlugin* CreateInstance(ts::TSP* t) { return new SequenceInput(t); }
+
+        virtual size_t receive(ts::TSPacket* buffer, ts::TSPacketMetadata* pkt_data, size_t max_packets) override
+        {
+            const ts::PID pid = ts::PID(BASE_PID + tsp->pluginIndex());
+            for (size_t i = 0; i < max_packets; ++i) {
+                buffer[i] = ts::NullPacket;
+                buffer[i].setPID(pid);
+                ts::PutUInt64(buffer[i].b + 4, _seq);
+                ts::PutUInt64(buffer[i].b + SEQ_END, _seq);
+                _seq++;
+            }
+            return max_packets;
+        }
+
+    private:
+        uint64_t _seq = 0;
+    };
+
+    class SequenceOutput: public ts::OutputPlugin
+    {
+        TS_NOBUILD_NOCOPY(SequenceOutput);
+    public:
+        SequenceOutput(ts::TSP* t) : ts::OutputPlugin(t, u"Test sequence output") {}
+        static ts::OutputPlugin* CreateInstance(ts::TSP* t) { return new SequenceOutput(t); }
+
+        virtual bool send(const ts::TSPacket* buffer, const ts::TSPacketMetadata* pkt_data, size_t packet_count) override
+        {
+            for (size_t i = 0; i < packet_count; ++i) {
+                const size_t index = buffer[i].getPID() - BASE_PID;
+                const uint64_t seq = ts::GetUInt64(buffer[i].b + 4);
+                if (index >= MAX_INPUTS || seq != ts::GetUInt64(buffer[i].b + SEQ_END) || (_started[index] && seq <= _last[index])) {
+                    output_errors++;
+                }
+                else {
+                    if (index != _current) {
+                        output_switches++;
+                        _current = index;
+                    }
+                    _started[index] = true;
+                    _last[index] = seq;
+                }
+            }
+            output_packets += packet_count;
+            return true;
+        }
+
+    private:
+        size_t   _current = ts::NPOS;
+        bool     _started[MAX_INPUTS] {};
+        uint64_t _last[MAX_INPUTS] {};
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Stress the input buffers in --fast-switch mode: the non-current inputs drop their
+// older packets while the output thread may still send packets from their buffers.
+TSUNIT_DEFINE_TEST(FastSwitch)
+{
+    ts::PluginRepository::Instance().registerInput(u"utest_seq", SequenceInput::CreateInstance);
+    ts::PluginRepository::Instance().registerOutput(u"utest_seq", SequenceOutput::CreateInstance);
+
+    ts::InputSwitcherArgs opt;
+    opt.appName = u"InputSwitcherTest::testFastSwitch";
+    opt.fastSwitch = true;
+    opt.bufferedPackets = ts::InputSwitcherArgs::MIN_BUFFERED_PACKETS;
+    opt.maxInputPackets = 7;
+    opt.maxOutputPackets = 5;
+    opt.receiveTimeout = cn::seconds(5);
+    opt.inputs.resize(3, ts::PluginOptions(u"utest_seq"));
+    opt.output.set(u"utest_seq");
+
+    output_packets = 0;
+    output_errors = 0;
+    output_switches = 0;
+
+    ts::InputSwitcher switcher(CERR);
+    TSUNIT_ASSERT(switcher.start(opt));
+    for (size_t i = 0; i < 2000; ++i) {
+        switcher.setInput(i % opt.inputs.size());
+        std::this_thread::sleep_for(cn::microseconds(200));
+    }
+    switcher.stop();
+    switcher.waitForTermination();
+
+    debug() << "InputSwitcherTest::testFastSwitch: packets: " << output_packets << ", switches: " << output_switches << ", errors: " << output_errors << std::endl;
+    TSUNIT_ASSERT(output_packets.load() > 0);
+    TSUNIT_ASSERT(output_switches.load() > 1);
+    TSUNIT_EQUAL(0, output_errors.load());
+}
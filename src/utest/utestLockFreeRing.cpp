@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::LockFreeRing
+//
+//----------------------------------------------------------------------------
+
+#include "tsLockFreeRing.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class LockFreeRingTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Basic);
+    TSUNIT_DECLARE_TEST(InPlace);
+    TSUNIT_DECLARE_TEST(Threads);
+};
+
+TSUNIT_REGISTER(LockFreeRingTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Basic)
+{
+    ts::LockFreeRing<int> ring(5);
+    TSUNIT_EQUAL(8, ring.capacity());
+    TSUNIT_ASSERT(ring.empty());
+    TSUNIT_ASSERT(ring.usedElement() == nullptr);
+
+    int value = 0;
+    TSUNIT_ASSERT(!ring.pop(value));
+
+    for (int i = 0; i < 8; ++i) {
+        TSUNIT_ASSERT(ring.push(i));
+    }
+    TSUNIT_EQUAL(8, ring.size());
+    TSUNIT_ASSERT(!ring.push(100));
+    TSUNIT_ASSERT(ring.freeElement() == nullptr);
+
+    // Wrap around the end of the array several times.
+    for (int i = 0; i < 100; ++i) {
+        TSUNIT_ASSERT(ring.pop(value));
+        TSUNIT_EQUAL(i, value);
+        TSUNIT_ASSERT(ring.push(i + 8));
+    }
+    TSUNIT_EQUAL(8, ring.size());
+
+    ring.clear();
+    TSUNIT_ASSERT(ring.empty());
+
+    ring.resize(0);
+    TSUNIT_EQUAL(0, ring.capacity());
+    TSUNIT_ASSERT(!ring.push(1));
+}
+
+TSUNIT_DEFINE_TEST(InPlace)
+{
+    ts::LockFreeRing<std::vector<int>> ring(2);
+
+    std::vector<int>* elem = ring.freeElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    elem->assign({1, 2, 3});
+    TSUNIT_ASSERT(ring.empty());
+    ring.publish();
+    TSUNIT_EQUAL(1, ring.size());
+
+    const std::vector<int>* used = ring.usedElement();
+    TSUNIT_ASSERT(used == elem);
+    TSUNIT_EQUAL(3, used->size());
+    ring.release();
+    TSUNIT_ASSERT(ring.empty());
+}
+
+// Thread for testThreads(): produce consecutive values.
+namespace {
+    class LockFreeRingProducer: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(LockFreeRingProducer);
+    private:
+        ts::LockFreeRing<uint64_t>& _ring;
+        uint64_t _count;
+    public:
+        LockFreeRingProducer(ts::LockFreeRing<uint64_t>& ring, uint64_t count) :
+            utest::TSUnitThread(),
+            _ring(ring),
+            _count(count)
+        {
+        }
+
+        virtual ~LockFreeRingProducer() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            for (uint64_t i = 0; i < _count; ) {
+                if (_ring.push(i)) {
+                    i++;
+                }
+                else {
+                    ts::Thread::Yield();
+                }
+            }
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(Threads)
+{
+    constexpr uint64_t count = 1'000'000;
+    ts::LockFreeRing<uint64_t> ring(64);
+    LockFreeRingProducer producer(ring, count);
+    TSUNIT_ASSERT(producer.start());
+
+    uint64_t expected = 0;
+    while (expected < count) {
+        uint64_t value = 0;
+        if (ring.pop(value)) {
+            TSUNIT_EQUAL(expected, value);
+            expected++;
+        }
+        else {
+            ts::Thread::Yield();
+        }
+    }
+    producer.waitForTermination();
+    TSUNIT_ASSERT(ring.empty());
+}
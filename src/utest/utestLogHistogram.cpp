@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::LogHistogram
+//
+//----------------------------------------------------------------------------
+
+#include "tsLogHistogram.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class LogHistogramTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Empty);
+    TSUNIT_DECLARE_TEST(Small);
+    TSUNIT_DECLARE_TEST(Large);
+    TSUNIT_DECLARE_TEST(Signed);
+    TSUNIT_DECLARE_TEST(Merge);
+};
+
+TSUNIT_REGISTER(LogHistogramTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Empty)
+{
+    ts::LogHistogram hist;
+    TSUNIT_EQUAL(0, hist.count());
+    TSUNIT_EQUAL(0, hist.minimum());
+    TSUNIT_EQUAL(0, hist.maximum());
+    TSUNIT_EQUAL(0, hist.percentile(50.0));
+    TSUNIT_EQUAL(0, hist.percentile(99.9));
+}
+
+TSUNIT_DEFINE_TEST(Small)
+{
+    // Values below 2^(precision+1) are exact.
+    ts::LogHistogram hist;
+    for (int64_t i = 1; i <= 50; ++i) {
+        hist.feed(i);
+    }
+    TSUNIT_EQUAL(50, hist.count());
+    TSUNIT_EQUAL(1, hist.minimum());
+    TSUNIT_EQUAL(50, hist.maximum());
+    TSUNIT_EQUAL(25, hist.percentile(50.0));
+    TSUNIT_EQUAL(50, hist.percentile(99.0));
+    TSUNIT_EQUAL(1, hist.percentile(0.0));
+    TSUNIT_EQUAL(u"samples: 50, min: 1, max: 50, mean: 25.50, p50: 25, p99: 50, p99.9: 50", hist.summary());
+}
+
+TSUNIT_DEFINE_TEST(Large)
+{
+    // Uniform distribution from 1,000 to 1,000,000, check relative error.
+    ts::LogHistogram hist;
+    for (int64_t i = 1; i <= 1000; ++i) {
+        hist.feed(i * 1000);
+    }
+    TSUNIT_EQUAL(1000, hist.count());
+    TSUNIT_EQUAL(1000, hist.minimum());
+    TSUNIT_EQUAL(1'000'000, hist.maximum());
+
+    const int64_t p50 = hist.percentile(50.0);
+    const int64_t p99 = hist.percentile(99.0);
+    const int64_t p999 = hist.percentile(99.9);
+    debug() << "LogHistogramTest::testLarge: " << hist.summary() << std::endl;
+    TSUNIT_ASSERT(std::abs(p50 - 500'000) <= 500'000 / 32);
+    TSUNIT_ASSERT(std::abs(p99 - 990'000) <= 990'000 / 32);
+    TSUNIT_ASSERT(std::abs(p999 - 999'000) <= 999'000 / 32);
+    TSUNIT_ASSERT(p50 <= p99);
+    TSUNIT_ASSERT(p99 <= p999);
+}
+
+TSUNIT_DEFINE_TEST(Signed)
+{
+    ts::LogHistogram hist;
+    for (int64_t i = -100; i <= 100; ++i) {
+        hist.feed(i * 27);
+    }
+    TSUNIT_EQUAL(201, hist.count());
+    TSUNIT_EQUAL(-2700, hist.minimum());
+    TSUNIT_EQUAL(2700, hist.maximum());
+    TSUNIT_EQUAL(0, hist.percentile(50.0));
+    TSUNIT_EQUAL(-2700, hist.percentile(0.0));
+    TSUNIT_ASSERT(hist.percentile(25.0) < 0);
+    TSUNIT_ASSERT(hist.percentile(75.0) > 0);
+    TSUNIT_ASSERT(std::abs(hist.percentile(25.0) + 1350) <= 1350 / 32);
+
+    // Values are clamped in buckets but min and max remain exact.
+    hist.feed(std::numeric_limits<int64_t>::min());
+    TSUNIT_EQUAL(std::numeric_limits<int64_t>::min(), hist.minimum());
+
+    hist.reset();
+    TSUNIT_EQUAL(0, hist.count());
+    TSUNIT_EQUAL(0, hist.percentile(50.0));
+}
+
+TSUNIT_DEFINE_TEST(Merge)
+{
+    ts::LogHistogram h1, h2, h3(3);
+    for (int64_t i = 1; i <= 10; ++i) {
+        h1.feed(i);
+        h2.feed(-i);
+    }
+    TSUNIT_ASSERT(h1.merge(h2));
+    TSUNIT_ASSERT(!h1.merge(h3));
+    TSUNIT_EQUAL(20, h1.count());
+    TSUNIT_EQUAL(-10, h1.minimum());
+    TSUNIT_EQUAL(10, h1.maximum());
+    TSUNIT_EQUAL(-1, h1.percentile(50.0));
+
+    // Weighted samples.
+    h1.feed(100, 180);
+    TSUNIT_EQUAL(200, h1.count());
+    TSUNIT_EQUAL(100, h1.maximum());
+    TSUNIT_EQUAL(100, h1.percentile(50.0));
+    TSUNIT_EQUAL(-1, h1.percentile(5.0));
+}
@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::RollingBitRate
+//
+//----------------------------------------------------------------------------
+
+#include "tsRollingBitRate.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class RollingBitRateTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Samples);
+    TSUNIT_DECLARE_TEST(Window);
+    TSUNIT_DECLARE_TEST(WrapUp);
+    TSUNIT_DECLARE_TEST(PIDs);
+};
+
+TSUNIT_REGISTER(RollingBitRateTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Samples)
+{
+    // Window limited to 3 samples.
+    ts::RollingBitRate<cn::milliseconds> rbr(cn::milliseconds::zero(), 3);
+    TSUNIT_EQUAL(0, rbr.size());
+    TSUNIT_EQUAL(0, rbr.bitrate().toInt());
+
+    rbr.feed(cn::milliseconds(0), 0, 0);
+    TSUNIT_EQUAL(1, rbr.size());
+    TSUNIT_EQUAL(0, rbr.bitrate().toInt());
+
+    // 1000 packets per second = 1,504,000 b/s.
+    rbr.feed(cn::milliseconds(1000), 1000, 500);
+    TSUNIT_EQUAL(2, rbr.size());
+    TSUNIT_ASSERT(!rbr.full());
+    TSUNIT_EQUAL(1000, rbr.packets());
+    TSUNIT_EQUAL(500, rbr.netPackets());
+    TSUNIT_EQUAL(1'504'000, rbr.bitrate().toInt());
+    TSUNIT_EQUAL(752'000, rbr.netBitRate().toInt());
+
+    rbr.feed(cn::milliseconds(2000), 3000, 1000);
+    TSUNIT_ASSERT(rbr.full());
+    TSUNIT_EQUAL(2000, rbr.duration().count());
+    TSUNIT_EQUAL(3000, rbr.packets());
+
+    // Oldest sample is dropped.
+    rbr.feed(cn::milliseconds(3000), 6000, 1500);
+    TSUNIT_EQUAL(3, rbr.size());
+    TSUNIT_EQUAL(2000, rbr.duration().count());
+    TSUNIT_EQUAL(5000, rbr.packets());
+    TSUNIT_EQUAL(3'760'000, rbr.bitrate().toInt());
+
+    rbr.reset();
+    TSUNIT_EQUAL(0, rbr.size());
+    TSUNIT_EQUAL(0, rbr.packets());
+}
+
+TSUNIT_DEFINE_TEST(Window)
+{
+    // Window limited to one second.
+    ts::RollingBitRate<ts::PCR> rbr(cn::seconds(1), 100);
+    for (int i = 0; i <= 20; ++i) {
+        rbr.feed(ts::PCR(i * ts::SYSTEM_CLOCK_FREQ / 10), ts::PacketCounter(i * 100));
+    }
+    TSUNIT_EQUAL(11, rbr.size());
+    TSUNIT_EQUAL(ts::SYSTEM_CLOCK_FREQ, rbr.duration().count());
+    TSUNIT_EQUAL(1000, rbr.packets());
+    TSUNIT_EQUAL(1'504'000, rbr.bitrate().toInt());
+
+    // A time jump drops all previous samples.
+    rbr.feed(ts::PCR(10 * ts::SYSTEM_CLOCK_FREQ), 3000);
+    TSUNIT_EQUAL(1, rbr.size());
+    TSUNIT_EQUAL(0, rbr.bitrate().toInt());
+}
+
+TSUNIT_DEFINE_TEST(WrapUp)
+{
+    // Time base wraps up, like PCR values.
+    ts::RollingBitRate<ts::PCR> rbr(cn::seconds(1), 100, ts::PCR(ts::PCR_SCALE));
+    rbr.feed(ts::PCR(ts::PCR_SCALE - ts::SYSTEM_CLOCK_FREQ / 4), 0);
+    rbr.feed(ts::PCR(ts::SYSTEM_CLOCK_FREQ / 4), 500);
+    TSUNIT_EQUAL(2, rbr.size());
+    TSUNIT_EQUAL(ts::SYSTEM_CLOCK_FREQ / 2, rbr.duration().count());
+    TSUNIT_EQUAL(1'504'000, rbr.bitrate().toInt());
+
+    // A small step backward is not a time jump.
+    rbr.feed(ts::PCR(ts::SYSTEM_CLOCK_FREQ / 8), 600);
+    TSUNIT_EQUAL(3, rbr.size());
+    TSUNIT_EQUAL(3 * ts::SYSTEM_CLOCK_FREQ / 8, rbr.duration().count());
+    TSUNIT_EQUAL(600, rbr.packets());
+}
+
+TSUNIT_DEFINE_TEST(PIDs)
+{
+    // Two PID's with unrelated time bases, each one in its own window.
+    ts::PIDRollingBitRate<ts::PCR> rbr(cn::seconds(1), 100, ts::PCR(ts::PCR_SCALE));
+    TSUNIT_EQUAL(0, rbr.window(100).size());
+    TSUNIT_EQUAL(0, rbr.bitrate(100).toInt());
+
+    // 1000 TS packets per second. PID 100 carries 1/4 of them, PID 200 carries 1/10.
+    for (int i = 0; i <= 10; ++i) {
+        rbr.feed(100, ts::PCR(i * ts::SYSTEM_CLOCK_FREQ / 10), ts::PacketCounter(i * 100), ts::PacketCounter(i * 25));
+        rbr.feed(200, ts::PCR(5000 * ts::SYSTEM_CLOCK_FREQ + i * ts::SYSTEM_CLOCK_FREQ / 10), ts::PacketCounter(i * 100 + 50), ts::PacketCounter(i * 10));
+    }
+    TSUNIT_EQUAL(11, rbr.window(100).size());
+    TSUNIT_EQUAL(11, rbr.window(200).size());
+    TSUNIT_EQUAL(0, rbr.window(300).size());
+    TSUNIT_EQUAL(1'504'000, rbr.bitrate(100).toInt());
+    TSUNIT_EQUAL(1'504'000, rbr.bitrate(200).toInt());
+    TSUNIT_EQUAL(376'000, rbr.netBitRate(100).toInt());
+    TSUNIT_EQUAL(150'400, rbr.netBitRate(200).toInt());
+    TSUNIT_EQUAL(0, rbr.bitrate(ts::PID_NULL + 1).toInt());
+
+    rbr.reset();
+    TSUNIT_EQUAL(0, rbr.window(100).size());
+    TSUNIT_EQUAL(0, rbr.window(200).size());
+}
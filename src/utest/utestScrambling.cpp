@@ -11,6 +11,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsTSScramblingPool.h"
+#include "tsCerrReport.h"
 #include "tsTSPacket.h"
 #include "tsNames.h"
 #include "tsunit.h"
@@ -23,6 +25,8 @@
 class ScramblingTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Scrambling);
+    TSUNIT_DECLARE_TEST(Pool);
+    TSUNIT_DECLARE_TEST(PreparedCW);
 };
 
 TSUNIT_REGISTER(ScramblingTest);
@@ -166,3 +170,92 @@ TSUNIT_DEFINE_TEST(Scrambling)
         TSUNIT_EQUAL(0, ts::MemCompare(pkt.b + header_size, vec->cipher.b + header_size, payload_size));
     }
 }
+
+TSUNIT_DEFINE_TEST(Pool)
+{
+    for (uint8_t type : {ts::SCRAMBLING_DVB_CSA2, ts::SCRAMBLING_DVB_CISSA1, ts::SCRAMBLING_ATIS_IIF_IDSA}) {
+
+        // Same control words in a master instance (used with a pool) and a reference one.
+        ts::TSScrambling master(CERR), ref(CERR);
+        TSUNIT_ASSERT(master.setScramblingType(type));
+        TSUNIT_ASSERT(ref.setScramblingType(type));
+        ts::ByteBlock cw(type == ts::SCRAMBLING_DVB_CSA2 ? 8 : 16);
+        ts::TSScramblingPool pool(CERR);
+        TSUNIT_ASSERT(pool.start(3));
+        TSUNIT_EQUAL(3, pool.threadCount());
+
+        // Several crypto-periods, alternating parities.
+        for (int cp = 0; cp < 3; ++cp) {
+            for (size_t i = 0; i < cw.size(); ++i) {
+                cw[i] = uint8_t(cp * 31 + i * 7 + 3);
+            }
+            TSUNIT_ASSERT(master.setCW(cw, cp));
+            TSUNIT_ASSERT(ref.setCW(cw, cp));
+            TSUNIT_ASSERT(master.setEncryptParity(cp));
+            TSUNIT_ASSERT(ref.setEncryptParity(cp));
+#if !defined(TS_WINDOWS) && !defined(TS_NO_OPENSSL)
+            // The threads of the pool share the keys of the master.
+            TSUNIT_ASSERT(master.canShareKeys());
+#endif
+
+            // Packets with various payload sizes.
+            ts::TSPacketVector plain(300);
+            std::vector<ts::TSPacket*> addr;
+            for (size_t i = 0; i < plain.size(); ++i) {
+                plain[i] = ts::NullPacket;
+                plain[i].setPID(100);
+                plain[i].setPayloadSize(184 - (i % 5) * 13, false);
+                for (size_t j = plain[i].getHeaderSize(); j < ts::PKT_SIZE; ++j) {
+                    plain[i].b[j] = uint8_t(i + j + cp);
+                }
+            }
+            ts::TSPacketVector pkts(plain), expected(plain);
+            for (auto& pkt : pkts) {
+                addr.push_back(&pkt);
+            }
+
+            // Encrypt with the pool, compare with individual encryption.
+            TSUNIT_ASSERT(pool.encrypt(master, addr.data(), addr.size()));
+            for (auto& pkt : expected) {
+                TSUNIT_ASSERT(ref.encrypt(pkt));
+            }
+            TSUNIT_ASSERT(pkts == expected);
+
+            // Decrypt with the pool.
+            TSUNIT_ASSERT(pool.decrypt(master, addr.data(), addr.size()));
+            TSUNIT_ASSERT(pkts == plain);
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(PreparedCW)
+{
+    // Same sequence of CW, prepared in advance or not, shall produce the same result.
+    ts::TSScrambling prepared(CERR), direct(CERR);
+    TSUNIT_ASSERT(prepared.setScramblingType(ts::SCRAMBLING_DVB_CISSA1));
+    TSUNIT_ASSERT(direct.setScramblingType(ts::SCRAMBLING_DVB_CISSA1));
+
+    ts::ByteBlock cw(16);
+    for (int cp = 0; cp < 4; ++cp) {
+        for (size_t i = 0; i < cw.size(); ++i) {
+            cw[i] = uint8_t(cp * 17 + i);
+        }
+        TSUNIT_ASSERT(prepared.prepareCW(cw, cp));
+        TSUNIT_ASSERT(prepared.setEncryptParity(cp));
+        TSUNIT_ASSERT(prepared.setCW(cw, cp));
+        TSUNIT_ASSERT(direct.setEncryptParity(cp));
+        TSUNIT_ASSERT(direct.setCW(cw, cp));
+
+        ts::TSPacket pkt1(ts::NullPacket), pkt2;
+        pkt1.setPID(100);
+        for (size_t i = 4; i < ts::PKT_SIZE; ++i) {
+            pkt1.b[i] = uint8_t(i + cp);
+        }
+        pkt2 = pkt1;
+        TSUNIT_ASSERT(prepared.encrypt(pkt1));
+        TSUNIT_ASSERT(direct.encrypt(pkt2));
+        TSUNIT_ASSERT(pkt1 == pkt2);
+        TSUNIT_ASSERT(prepared.decrypt(pkt1));
+        TSUNIT_ASSERT(!pkt1.isScrambled());
+    }
+}
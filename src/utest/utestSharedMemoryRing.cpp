@@ -0,0 +1,299 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::SharedMemoryRing
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryRing.h"
+#include "tsNullReport.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SharedMemoryRingTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Open);
+    TSUNIT_DECLARE_TEST(Buffers);
+    TSUNIT_DECLARE_TEST(Threads);
+    TSUNIT_DECLARE_TEST(WakeUp);
+#if defined(TS_UNIX)
+    TSUNIT_DECLARE_TEST(Stale);
+#endif
+
+private:
+    // Unique segment name for a test.
+    static ts::UString SegmentName(const ts::UString& suffix);
+};
+
+TSUNIT_REGISTER(SharedMemoryRingTest);
+
+ts::UString SharedMemoryRingTest::SegmentName(const ts::UString& suffix)
+{
+    return ts::UString::Format(u"tsduck-utest-%X-%s", ts::monotonic_time::clock::now().time_since_epoch().count(), suffix);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Open)
+{
+    const ts::UString name(SegmentName(u"open"));
+
+    // The segment does not exist yet.
+    ts::SharedMemoryRing consumer;
+    TSUNIT_ASSERT(!consumer.open(name, 188, 0, NULLREP));
+    TSUNIT_ASSERT(!consumer.isOpen());
+
+    // Create it.
+    ts::SharedMemoryRing producer;
+    TSUNIT_ASSERT(producer.open(name, 188, 100, CERR));
+    TSUNIT_ASSERT(producer.isOpen());
+    TSUNIT_ASSERT(producer.isOwner());
+    TSUNIT_EQUAL(188, producer.elementSize());
+    TSUNIT_EQUAL(128, producer.capacity());
+    TSUNIT_EQUAL(0, producer.size());
+
+    // Open it with a distinct element size.
+    TSUNIT_ASSERT(!consumer.open(name, 204, 0, NULLREP));
+    TSUNIT_ASSERT(!consumer.isOpen());
+
+    // Open it without creation, any element size.
+    TSUNIT_ASSERT(consumer.open(name, 0, 0, CERR));
+    TSUNIT_ASSERT(!consumer.isOwner());
+    TSUNIT_EQUAL(188, consumer.elementSize());
+    TSUNIT_EQUAL(128, consumer.capacity());
+
+    // The name is deleted when the owner closes.
+    producer.close();
+    consumer.close();
+    TSUNIT_ASSERT(!consumer.open(name, 188, 0, NULLREP));
+}
+
+TSUNIT_DEFINE_TEST(Buffers)
+{
+    const ts::UString name(SegmentName(u"buffers"));
+    ts::SharedMemoryRing producer;
+    ts::SharedMemoryRing consumer;
+    TSUNIT_ASSERT(producer.open(name, 4, 8, CERR));
+    TSUNIT_ASSERT(consumer.open(name, 4, 8, CERR));
+    TSUNIT_ASSERT(!consumer.isOwner());
+
+    uint8_t* wbuf = nullptr;
+    const uint8_t* rbuf = nullptr;
+    TSUNIT_EQUAL(8, producer.writeBuffer(wbuf));
+    TSUNIT_EQUAL(0, consumer.readBuffer(rbuf));
+    TSUNIT_ASSERT(!consumer.waitRead(cn::milliseconds(10)));
+
+    // Write 6 elements in place, read 6 elements in place (distinct mappings of the same memory).
+    for (uint32_t i = 0; i < 6; ++i) {
+        ts::PutUInt32(wbuf + 4 * i, i);
+    }
+    producer.commitWrite(6);
+    TSUNIT_EQUAL(6, consumer.size());
+    TSUNIT_ASSERT(consumer.waitRead(cn::milliseconds(10)));
+    TSUNIT_EQUAL(6, consumer.readBuffer(rbuf));
+    TSUNIT_EQUAL(0, ts::GetUInt32(rbuf));
+    TSUNIT_EQUAL(5, ts::GetUInt32(rbuf + 20));
+    consumer.commitRead(6);
+
+    // The free area wraps at the end of the ring.
+    TSUNIT_EQUAL(2, producer.writeBuffer(wbuf));
+    const uint32_t data[5] = {10, 11, 12, 13, 14};
+    TSUNIT_ASSERT(producer.write(data, 5));
+    TSUNIT_EQUAL(5, consumer.size());
+
+    uint32_t out[8];
+    TSUNIT_EQUAL(5, consumer.read(out, 8, cn::milliseconds(10)));
+    TSUNIT_EQUAL(10, out[0]);
+    TSUNIT_EQUAL(14, out[4]);
+
+    // End of stream.
+    producer.closeProducer();
+    TSUNIT_ASSERT(consumer.producerClosed());
+    TSUNIT_EQUAL(0, consumer.read(out, 8, cn::milliseconds(10)));
+
+    // Consumer termination.
+    consumer.closeConsumer();
+    TSUNIT_ASSERT(producer.consumerClosed());
+    TSUNIT_ASSERT(!producer.write(data, 1));
+}
+
+// Thread for testThreads(): write consecutive values.
+namespace {
+    class SharedMemoryRingProducer: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(SharedMemoryRingProducer);
+    private:
+        ts::UString _name;
+        uint32_t    _count;
+    public:
+        SharedMemoryRingProducer(const ts::UString& name, uint32_t count) :
+            utest::TSUnitThread(),
+            _name(name),
+            _count(count)
+        {
+        }
+
+        virtual ~SharedMemoryRingProducer() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            ts::SharedMemoryRing ring;
+            TSUNIT_ASSERT(ring.open(_name, sizeof(uint32_t), 64, CERR));
+            uint32_t values[7];
+            for (uint32_t i = 0; i < _count; ) {
+                size_t n = 0;
+                while (n < 7 && i < _count) {
+                    values[n++] = i++;
+                }
+                TSUNIT_ASSERT(ring.write(values, n));
+            }
+            ring.closeProducer();
+            // Wait until the consumer has read everything before deleting the segment name.
+            while (!ring.consumerClosed()) {
+                std::this_thread::sleep_for(cn::milliseconds(1));
+            }
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(Threads)
+{
+    constexpr uint32_t count = 200'000;
+    const ts::UString name(SegmentName(u"threads"));
+
+    ts::SharedMemoryRing ring;
+    TSUNIT_ASSERT(ring.open(name, sizeof(uint32_t), 64, CERR));
+    SharedMemoryRingProducer producer(name, count);
+    TSUNIT_ASSERT(producer.start());
+
+    uint32_t expected = 0;
+    uint32_t values[10];
+    size_t n = 0;
+    while ((n = ring.read(values, 10)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            TSUNIT_EQUAL(expected, values[i]);
+            expected++;
+        }
+    }
+    TSUNIT_EQUAL(count, expected);
+    TSUNIT_ASSERT(ring.producerClosed());
+    ring.closeConsumer();
+    producer.waitForTermination();
+}
+
+// Thread for testWakeUp(): wait forever for elements.
+namespace {
+    class SharedMemoryRingWaiter: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(SharedMemoryRingWaiter);
+    private:
+        ts::SharedMemoryRing& _ring;
+    public:
+        bool result = true;
+
+        SharedMemoryRingWaiter(ts::SharedMemoryRing& ring) :
+            utest::TSUnitThread(),
+            _ring(ring)
+        {
+        }
+
+        virtual ~SharedMemoryRingWaiter() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            result = _ring.waitRead();
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(WakeUp)
+{
+    // A consumer which waits forever must be awakened by the end of stream or an abort,
+    // even when they occur while it is about to sleep. Repeat to exercise the race.
+    for (int i = 0; i < 200; ++i) {
+        const ts::UString name(SegmentName(ts::UString::Format(u"wakeup-%d", i)));
+        ts::SharedMemoryRing producer;
+        ts::SharedMemoryRing consumer;
+        TSUNIT_ASSERT(producer.open(name, 4, 8, CERR));
+        TSUNIT_ASSERT(consumer.open(name, 4, 8, CERR));
+        SharedMemoryRingWaiter waiter(consumer);
+        TSUNIT_ASSERT(waiter.start());
+        if (i % 2 == 0) {
+            producer.closeProducer();
+        }
+        else {
+            consumer.abort();
+        }
+        waiter.waitForTermination();
+        TSUNIT_ASSERT(!waiter.result);
+    }
+}
+
+#if defined(TS_UNIX)
+TSUNIT_DEFINE_TEST(Stale)
+{
+    const ts::UString name(SegmentName(u"stale"));
+
+    // Previous session: unread elements and end of stream.
+    ts::SharedMemoryRing previous;
+    TSUNIT_ASSERT(previous.open(name, 4, 8, CERR));
+    const uint32_t data[3] = {1, 2, 3};
+    TSUNIT_ASSERT(previous.write(data, 3));
+    previous.closeProducer();
+
+    // Simulate a killed creator: set a non-existent process id in the owner_pid field (offset 20).
+    const std::string path("/" + name.toUTF8());
+    const int fd = ::shm_open(path.c_str(), O_RDWR, 0);
+    TSUNIT_ASSERT(fd >= 0);
+    void* addr = ::mmap(nullptr, ts::SharedMemoryRing::HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    TSUNIT_ASSERT(addr != MAP_FAILED);
+    reinterpret_cast<std::atomic<uint32_t>*>(reinterpret_cast<uint8_t*>(addr) + 20)->store(0x7FFFFFFE);
+    ::munmap(addr, ts::SharedMemoryRing::HEADER_SIZE);
+
+    // The next process takes over the segment and resets the previous session.
+    ts::SharedMemoryRing consumer;
+    TSUNIT_ASSERT(consumer.open(name, 4, 0, CERR));
+    TSUNIT_ASSERT(consumer.isOwner());
+    TSUNIT_EQUAL(0, consumer.size());
+    TSUNIT_ASSERT(!consumer.producerClosed());
+    TSUNIT_ASSERT(!consumer.waitRead(cn::milliseconds(10)));
+
+    // A new producer can use the ring.
+    ts::SharedMemoryRing producer;
+    TSUNIT_ASSERT(producer.open(name, 4, 0, CERR));
+    TSUNIT_ASSERT(!producer.isOwner());
+    TSUNIT_ASSERT(producer.write(data, 3));
+    uint32_t out[8];
+    TSUNIT_EQUAL(3, consumer.read(out, 8, cn::milliseconds(10)));
+    TSUNIT_EQUAL(3, out[2]);
+}
+#endif
@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TimerWheel
+//
+//----------------------------------------------------------------------------
+
+#include "tsTimerWheel.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TimerWheelTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(OneShot);
+    TSUNIT_DECLARE_TEST(Periodic);
+    TSUNIT_DECLARE_TEST(Cancel);
+    TSUNIT_DECLARE_TEST(Order);
+};
+
+TSUNIT_REGISTER(TimerWheelTest);
+
+
+//----------------------------------------------------------------------------
+// A timer handler which records all expirations.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TimerRecorder: public ts::TimerHandlerInterface
+    {
+        TS_NOCOPY(TimerRecorder);
+    public:
+        TimerRecorder() = default;
+
+        class Event
+        {
+        public:
+            uint64_t           id = 0;
+            ts::monotonic_time time {};
+        };
+
+        virtual void handleTimer(ts::TimerWheel& wheel, uint64_t timer_id) override
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _events.push_back({timer_id, ts::monotonic_time::clock::now()});
+            _condition.notify_all();
+        }
+
+        // Wait until a given number of expirations, return false on timeout.
+        bool waitCount(size_t count, cn::milliseconds timeout = cn::seconds(5))
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _condition.wait_for(lock, timeout, [this, count]() { return _events.size() >= count; });
+        }
+
+        std::vector<Event> events() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _events;
+        }
+
+    private:
+        mutable std::mutex      _mutex {};
+        std::condition_variable _condition {};
+        std::vector<Event>      _events {};
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(OneShot)
+{
+    TimerRecorder recorder;
+    ts::TimerWheel wheel;
+    TSUNIT_EQUAL(0, wheel.timerCount());
+
+    const ts::monotonic_time start = ts::monotonic_time::clock::now();
+    const uint64_t id = wheel.startTimer(&recorder, cn::milliseconds(20));
+    TSUNIT_ASSERT(id != ts::TimerWheel::INVALID_TIMER);
+    TSUNIT_ASSERT(recorder.waitCount(1));
+
+    const auto events = recorder.events();
+    TSUNIT_EQUAL(1, events.size());
+    TSUNIT_EQUAL(id, events[0].id);
+    TSUNIT_ASSERT(events[0].time - start >= cn::milliseconds(20));
+    TSUNIT_EQUAL(0, wheel.timerCount());
+    TSUNIT_ASSERT(!wheel.cancelTimer(id));
+    TSUNIT_EQUAL(ts::TimerWheel::INVALID_TIMER, wheel.startTimer(nullptr, cn::milliseconds(20)));
+}
+
+TSUNIT_DEFINE_TEST(Periodic)
+{
+    TimerRecorder recorder;
+    ts::TimerWheel wheel;
+
+    // Use a first delay which is larger than the first level of the wheel.
+    const ts::monotonic_time start = ts::monotonic_time::clock::now();
+    const uint64_t id = wheel.startTimer(&recorder, cn::milliseconds(100), cn::milliseconds(10));
+    TSUNIT_ASSERT(recorder.waitCount(5));
+    TSUNIT_EQUAL(1, wheel.timerCount());
+    TSUNIT_ASSERT(wheel.cancelTimer(id));
+    TSUNIT_EQUAL(0, wheel.timerCount());
+
+    // No more expiration after cancelTimer().
+    const size_t count = recorder.events().size();
+    std::this_thread::sleep_for(cn::milliseconds(50));
+    const auto events = recorder.events();
+    TSUNIT_EQUAL(count, events.size());
+
+    // Expiration times do not drift.
+    for (size_t i = 0; i < events.size(); ++i) {
+        TSUNIT_EQUAL(id, events[i].id);
+        TSUNIT_ASSERT(events[i].time - start >= cn::milliseconds(100) + i * cn::milliseconds(10));
+    }
+}
+
+TSUNIT_DEFINE_TEST(Cancel)
+{
+    TimerRecorder recorder;
+    ts::TimerWheel wheel;
+
+    const uint64_t id1 = wheel.startTimer(&recorder, cn::milliseconds(50));
+    const uint64_t id2 = wheel.startTimer(&recorder, cn::milliseconds(20));
+    TSUNIT_ASSERT(id1 != id2);
+    TSUNIT_EQUAL(2, wheel.timerCount());
+    TSUNIT_ASSERT(wheel.cancelTimer(id1));
+    TSUNIT_ASSERT(!wheel.cancelTimer(id1));
+    TSUNIT_EQUAL(1, wheel.timerCount());
+
+    TSUNIT_ASSERT(recorder.waitCount(1));
+    std::this_thread::sleep_for(cn::milliseconds(80));
+    const auto events = recorder.events();
+    TSUNIT_EQUAL(1, events.size());
+    TSUNIT_EQUAL(id2, events[0].id);
+}
+
+TSUNIT_DEFINE_TEST(Order)
+{
+    TimerRecorder recorder;
+    ts::TimerWheel wheel;
+
+    // Start timers in reverse order of expiration, over several levels of the wheel.
+    constexpr size_t count = 20;
+    std::vector<uint64_t> ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        ids[i] = wheel.startTimer(&recorder, cn::milliseconds(10 * (count - i)));
+    }
+    TSUNIT_ASSERT(recorder.waitCount(count));
+
+    const auto events = recorder.events();
+    TSUNIT_EQUAL(count, events.size());
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(ids[count - 1 - i], events[i].id);
+    }
+}
@@ -0,0 +1,198 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for classes ts::TransportBufferModel and ts::DeadlineScheduler
+//
+//----------------------------------------------------------------------------
+
+#include "tsTransportBufferModel.h"
+#include "tsDeadlineScheduler.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TransportBufferModelTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(LeakRate);
+    TSUNIT_DECLARE_TEST(Level);
+    TSUNIT_DECLARE_TEST(UnknownRate);
+    TSUNIT_DECLARE_TEST(Selection);
+    TSUNIT_DECLARE_TEST(Deadline);
+    TSUNIT_DECLARE_TEST(Share);
+};
+
+TSUNIT_REGISTER(TransportBufferModelTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(LeakRate)
+{
+    ts::TransportBufferModel tb;
+    TSUNIT_EQUAL(0, tb.leakRate().toInt());
+
+    // At least Rxsys.
+    tb.setPIDBitRate(500'000);
+    TSUNIT_EQUAL(1'000'000, tb.leakRate().toInt());
+
+    // 1.2 times the bitrate of the PID, immediate increase.
+    tb.setPIDBitRate(5'000'000);
+    TSUNIT_EQUAL(6'000'000, tb.leakRate().toInt());
+
+    // Slow decrease.
+    tb.setPIDBitRate(1'000'000);
+    TSUNIT_EQUAL(5'400'000, tb.leakRate().toInt());
+
+    tb.reset();
+    TSUNIT_EQUAL(0, tb.leakRate().toInt());
+}
+
+TSUNIT_DEFINE_TEST(Level)
+{
+    // At 1,504,000 b/s, one packet lasts one millisecond.
+    // At a leak rate of 1 Mb/s, 125 bytes leak out during one packet.
+    const ts::BitRate ts_bitrate(1'504'000);
+    ts::TransportBufferModel tb;
+    tb.setPIDBitRate(500'000);
+    TSUNIT_EQUAL(1'000'000, tb.leakRate().toInt());
+
+    TSUNIT_ASSERT(tb.canInsert(0, ts_bitrate));
+    tb.insert(0, ts_bitrate);
+    TSUNIT_EQUAL(188.0, tb.level(0, ts_bitrate));
+    TSUNIT_ASSERT(tb.canInsert(0, ts_bitrate));
+    tb.insert(0, ts_bitrate);
+    TSUNIT_EQUAL(376.0, tb.level(0, ts_bitrate));
+
+    // A third packet would overflow the 512-byte buffer.
+    TSUNIT_ASSERT(!tb.canInsert(0, ts_bitrate));
+    TSUNIT_EQUAL(251.0, tb.level(1, ts_bitrate));
+    TSUNIT_ASSERT(tb.canInsert(1, ts_bitrate));
+    tb.insert(1, ts_bitrate);
+    TSUNIT_EQUAL(439.0, tb.level(1, ts_bitrate));
+    TSUNIT_ASSERT(!tb.canInsert(1, ts_bitrate));
+    TSUNIT_EQUAL(314.0, tb.level(2, ts_bitrate));
+    TSUNIT_ASSERT(tb.canInsert(2, ts_bitrate));
+
+    // Empty after a while.
+    TSUNIT_EQUAL(0.0, tb.level(10, ts_bitrate));
+}
+
+TSUNIT_DEFINE_TEST(UnknownRate)
+{
+    // Without known leak rate, the packets are always accepted and do not fill the buffer.
+    const ts::BitRate ts_bitrate(1'504'000);
+    ts::TransportBufferModel tb;
+    for (ts::PacketCounter i = 0; i < 10; ++i) {
+        TSUNIT_ASSERT(tb.canInsert(0, ts_bitrate));
+        tb.insert(0, ts_bitrate);
+    }
+    TSUNIT_EQUAL(0.0, tb.level(0, ts_bitrate));
+
+    // Once the leak rate is known, the buffer starts empty.
+    tb.setPIDBitRate(500'000);
+    TSUNIT_ASSERT(tb.canInsert(0, ts_bitrate));
+    tb.insert(0, ts_bitrate);
+    TSUNIT_EQUAL(188.0, tb.level(0, ts_bitrate));
+}
+
+TSUNIT_DEFINE_TEST(Selection)
+{
+    ts::DeadlineScheduler sched(3);
+    TSUNIT_EQUAL(3, sched.count());
+
+    // No candidate.
+    sched.startSelection();
+    TSUNIT_EQUAL(ts::NPOS, sched.selected());
+
+    // Equal deadlines, first candidate.
+    sched.startSelection();
+    sched.addCandidate(2, false);
+    sched.addCandidate(0, false);
+    TSUNIT_EQUAL(2, sched.selected());
+
+    // Unknown bitrate: the deadline advances by the number of inputs.
+    sched.packetInserted(2, 0, 1'000'000);
+    TSUNIT_EQUAL(3.0, sched.deadline(2));
+    sched.startSelection();
+    sched.addCandidate(2, false);
+    sched.addCandidate(0, false);
+    TSUNIT_EQUAL(0, sched.selected());
+
+    // A packet with a PCR has priority, whatever its deadline.
+    sched.startSelection();
+    sched.addCandidate(0, false);
+    sched.addCandidate(2, true);
+    sched.addCandidate(1, false);
+    TSUNIT_EQUAL(2, sched.selected());
+
+    // Earliest deadline among packets with a PCR.
+    sched.startSelection();
+    sched.addCandidate(2, true);
+    sched.addCandidate(1, true);
+    TSUNIT_EQUAL(1, sched.selected());
+
+    // Invalid index.
+    sched.startSelection();
+    sched.addCandidate(3, true);
+    TSUNIT_EQUAL(ts::NPOS, sched.selected());
+}
+
+TSUNIT_DEFINE_TEST(Deadline)
+{
+    ts::DeadlineScheduler sched(2);
+    sched.setBitRate(0, 2'500'000);
+    sched.setBitRate(1, 5'000'000);
+
+    // Output at 10 Mb/s: one packet every 4 output packets for input 0, every 2 for input 1.
+    sched.packetInserted(0, 0, 10'000'000);
+    TSUNIT_EQUAL(4.0, sched.deadline(0));
+    sched.packetInserted(0, 1, 10'000'000);
+    TSUNIT_EQUAL(8.0, sched.deadline(0));
+    sched.packetInserted(1, 2, 10'000'000);
+    TSUNIT_EQUAL(4.0, sched.deadline(1));
+
+    // An idle input does not get an advance.
+    sched.packetInserted(1, 100, 10'000'000);
+    TSUNIT_EQUAL(102.0, sched.deadline(1));
+
+    // Unknown output bitrate, equal share.
+    sched.packetInserted(0, 200, 0);
+    TSUNIT_EQUAL(202.0, sched.deadline(0));
+
+    sched.reset(4);
+    TSUNIT_EQUAL(4, sched.count());
+    TSUNIT_EQUAL(0.0, sched.deadline(0));
+    TSUNIT_EQUAL(0.0, sched.deadline(1));
+}
+
+TSUNIT_DEFINE_TEST(Share)
+{
+    // Two inputs always ready, at 3 Mb/s and 1 Mb/s, in a 4 Mb/s output.
+    const ts::BitRate ts_bitrate(4'000'000);
+    ts::DeadlineScheduler sched(2);
+    sched.setBitRate(0, 3'000'000);
+    sched.setBitRate(1, 1'000'000);
+    size_t count[2] {0, 0};
+    for (ts::PacketCounter packet = 0; packet < 4000; ++packet) {
+        sched.startSelection();
+        sched.addCandidate(packet % 2, false);
+        sched.addCandidate((packet + 1) % 2, false);
+        const size_t index = sched.selected();
+        TSUNIT_ASSERT(index < 2);
+        count[index]++;
+        sched.packetInserted(index, packet, ts_bitrate);
+    }
+    debug() << "TransportBufferModelTest::testShare: input 0: " << count[0] << ", input 1: " << count[1] << std::endl;
+    TSUNIT_ASSERT(count[0] >= 2990 && count[0] <= 3010);
+    TSUNIT_ASSERT(count[1] >= 990 && count[1] <= 1010);
+}
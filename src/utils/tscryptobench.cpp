@@ -0,0 +1,474 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+// Throughput benchmark of the cryptographic algorithms which are used on
+// transport streams (test program, not part of TSDuck).
+//
+// Rationale: The unit tests check the correctness of the algorithms and the
+// TSUnit benchmark only accumulates CPU time. This program measures the
+// throughput of each algorithm, in Mb/s and packets/s, using the same APIs
+// as the plugins: one packet at a time, groups of packets and the thread
+// pool of the "scrambler" and "descrambler" plugins. The JSON output can be
+// archived and compared across releases to spot regressions.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMain.h"
+#include "tsArgs.h"
+#include "tsDuckContext.h"
+#include "tsTSScrambling.h"
+#include "tsTSScramblingPool.h"
+#include "tsAES128.h"
+#include "tsCTS1.h"
+#include "tsCRC32.h"
+#include "tsSysInfo.h"
+#include "tsVersionInfo.h"
+#include "tsjsonObject.h"
+TS_MAIN(MainCode);
+
+
+//----------------------------------------------------------------------------
+// List of benchmarked algorithms.
+//----------------------------------------------------------------------------
+
+namespace {
+    // The TS scrambling algorithms use the same names as the TSScrambling options.
+    enum Algorithm {
+        ALGO_DVB_CSA2,
+        ALGO_DVB_CISSA,
+        ALGO_ATIS_IDSA,
+        ALGO_SCTE52,
+        ALGO_AES_CBC,
+        ALGO_AES_CTR,
+        ALGO_AES_CTS,
+        ALGO_CRC32,
+        ALGO_COUNT
+    };
+
+    const ts::Names AlgorithmNames({
+        {u"dvb-csa2",  ALGO_DVB_CSA2},
+        {u"dvb-cissa", ALGO_DVB_CISSA},
+        {u"atis-idsa", ALGO_ATIS_IDSA},
+        {u"scte52",    ALGO_SCTE52},
+        {u"aes-cbc",   ALGO_AES_CBC},
+        {u"aes-ctr",   ALGO_AES_CTR},
+        {u"aes-cts",   ALGO_AES_CTS},
+        {u"crc32",     ALGO_CRC32},
+    });
+
+    // Default values of options.
+    constexpr size_t DEFAULT_BATCH_SIZE = 1024;
+    constexpr cn::milliseconds DEFAULT_DURATION = cn::milliseconds(250);
+    const std::vector<size_t> DEFAULT_PAYLOAD_SIZES {64, ts::PKT_SIZE - 4};
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options
+//----------------------------------------------------------------------------
+
+namespace {
+    class Options: public ts::Args
+    {
+        TS_NOBUILD_NOCOPY(Options);
+    public:
+        Options(int argc, char *argv[]);
+
+        ts::DuckContext     duck {this};
+        std::vector<int>    algorithms {};
+        std::vector<size_t> payload_sizes {};
+        std::vector<size_t> threads {};
+        size_t              batch_size = 0;
+        cn::milliseconds    duration {};
+        bool                json = false;
+        fs::path            json_file {};
+    };
+}
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args(u"Throughput benchmark of TS scrambling algorithms", u"[options]")
+{
+    option(u"algorithm", 'a', AlgorithmNames, 0, UNLIMITED_COUNT);
+    help(u"algorithm", u"name",
+         u"Algorithm to benchmark. Several --algorithm options can be specified. "
+         u"By default, all algorithms are benchmarked.");
+
+    option(u"batch-size", 'b', POSITIVE);
+    help(u"batch-size", u"count",
+         u"Number of packets which are processed in one call with the batch API. "
+         u"This is also the number of packets in the buffer which is repeatedly processed with the single-packet API. "
+         u"The default is " + ts::UString::Decimal(DEFAULT_BATCH_SIZE) + u" packets.");
+
+    option<cn::milliseconds>(u"duration", 'd');
+    help(u"duration",
+         u"Minimum duration of each measurement. "
+         u"The default is " + ts::UString::Chrono(DEFAULT_DURATION) + u".");
+
+    option(u"json", 'j', FILENAME, 0, 1, 0, UNLIMITED_VALUE, true);
+    help(u"json", u"filename",
+         u"Save the results in a JSON file. If the file name is omitted or is '-', the JSON document is "
+         u"written on standard output, instead of the text report.");
+
+    option(u"payload-size", 'p', INTEGER, 0, UNLIMITED_COUNT, 1, ts::PKT_SIZE - 4);
+    help(u"payload-size",
+         u"Size in bytes of the payload of each packet. Several --payload-size options can be specified. "
+         u"With DVB-CSA2, DVB-CISSA, ATIS-IDSA, SCTE-52, AES-CBC and AES-CTR, this is the payload size of TS packets. "
+         u"With AES-CTS and CRC32, this is the size of each message. "
+         u"By default, the payload sizes are 64 and 184 bytes.");
+
+    option(u"threads", 't', INTEGER, 0, UNLIMITED_COUNT, 0, 1024);
+    help(u"threads", u"count",
+         u"Number of additional threads with the batch API. Several --threads options can be specified. "
+         u"The value zero means that all packets are processed by the calling thread. "
+         u"The additional threads use the thread pool of the \"scrambler\" and \"descrambler\" plugins. "
+         u"They are consequently used with DVB-CSA2, DVB-CISSA, ATIS-IDSA, SCTE-52, AES-CBC and AES-CTR only. "
+         u"By default, the measurements are done with zero additional thread and with one thread less than "
+         u"the number of CPU cores.");
+
+    analyze(argc, argv);
+
+    getIntValues(algorithms, u"algorithm");
+    if (algorithms.empty()) {
+        for (int i = 0; i < ALGO_COUNT; ++i) {
+            algorithms.push_back(i);
+        }
+    }
+    getIntValues(payload_sizes, u"payload-size");
+    if (payload_sizes.empty()) {
+        payload_sizes = DEFAULT_PAYLOAD_SIZES;
+    }
+    getIntValues(threads, u"threads");
+    if (threads.empty()) {
+        threads.push_back(0);
+        const size_t cores = std::thread::hardware_concurrency();
+        if (cores > 1) {
+            threads.push_back(cores - 1);
+        }
+    }
+    getIntValue(batch_size, u"batch-size", DEFAULT_BATCH_SIZE);
+    getChronoValue(duration, u"duration", DEFAULT_DURATION);
+    json = present(u"json");
+    getPathValue(json_file, u"json");
+    if (json_file == u"-") {
+        json_file.clear();
+    }
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+// Benchmark class.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Benchmark
+    {
+        TS_NOBUILD_NOCOPY(Benchmark);
+    public:
+        // Constructor.
+        Benchmark(Options& opt);
+
+        // Run all measurements.
+        void run();
+
+        // Save the JSON document, if required.
+        bool save();
+
+    private:
+        Options&                  _opt;
+        std::vector<ts::TSPacket> _packets {};   // Buffer of packets.
+        std::vector<uint8_t*>     _payloads {};  // Address of the payload of each packet.
+        std::vector<size_t>       _sizes {};     // Size of each payload (all identical).
+        ts::json::Object          _root {};      // JSON document.
+
+        // Set the payload size of all packets in the buffer.
+        void setPayloadSize(size_t size);
+
+        // Set the scrambling control value of all packets in the buffer.
+        void setScrambling(uint8_t scv);
+
+        // Benchmark a TS scrambling algorithm or other algorithms, with the current payload size.
+        void runScrambling(int algo);
+        void runCTS(size_t payload_size);
+        void runCRC32();
+
+        // Repeatedly run a processing function on the buffer of packets during the measurement duration.
+        // The reset function is called before each pass and is not included in the measurement.
+        // Return false on processing error.
+        template <class PROCESS, class RESET>
+        bool measure(const ts::UString& algo, const ts::UString& operation, const ts::UString& api, size_t threads, PROCESS process, RESET reset);
+    };
+}
+
+// Constructor.
+Benchmark::Benchmark(Options& opt) :
+    _opt(opt),
+    _packets(opt.batch_size),
+    _payloads(opt.batch_size),
+    _sizes(opt.batch_size)
+{
+    const ts::SysInfo& sys(ts::SysInfo::Instance());
+    _root.add(u"version", ts::VersionInfo::GetVersion(ts::VersionInfo::Format::SHORT));
+    _root.add(u"system", sys.systemName() + u" " + sys.systemVersion());
+    _root.add(u"cpu", sys.cpuName());
+    _root.add(u"cores", std::thread::hardware_concurrency());
+    _root.add(u"batch-size", _opt.batch_size);
+    _root.add(u"duration-ms", _opt.duration.count());
+}
+
+// Set the payload size of all packets in the buffer.
+void Benchmark::setPayloadSize(size_t size)
+{
+    for (size_t i = 0; i < _packets.size(); ++i) {
+        ts::TSPacket& pkt(_packets[i]);
+        pkt.init(0x0100, uint8_t(i & 0x0F), uint8_t(i));
+        pkt.setPayloadSize(size);
+        _payloads[i] = pkt.getPayload();
+        _sizes[i] = pkt.getPayloadSize();
+    }
+}
+
+// Set the scrambling control value of all packets in the buffer.
+void Benchmark::setScrambling(uint8_t scv)
+{
+    for (auto& pkt : _packets) {
+        pkt.setScrambling(scv);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Run all measurements.
+//----------------------------------------------------------------------------
+
+void Benchmark::run()
+{
+    for (int algo : _opt.algorithms) {
+        for (size_t size : _opt.payload_sizes) {
+            setPayloadSize(size);
+            switch (algo) {
+                case ALGO_AES_CTS:
+                    runCTS(size);
+                    break;
+                case ALGO_CRC32:
+                    runCRC32();
+                    break;
+                default:
+                    runScrambling(algo);
+                    break;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Measurement of one processing function.
+//----------------------------------------------------------------------------
+
+template <class PROCESS, class RESET>
+bool Benchmark::measure(const ts::UString& algo, const ts::UString& operation, const ts::UString& api, size_t threads, PROCESS process, RESET reset)
+{
+    // One untimed pass to warm up the caches, key schedules and threads.
+    reset();
+    if (!process()) {
+        _opt.error(u"%s %s error (%s API, %d threads)", algo, operation, api, threads);
+        return false;
+    }
+
+    cn::nanoseconds elapsed {0};
+    size_t passes = 0;
+    do {
+        reset();
+        const ts::monotonic_time start = ts::monotonic_time::clock::now();
+        const bool success = process();
+        elapsed += ts::monotonic_time::clock::now() - start;
+        passes++;
+        if (!success) {
+            _opt.error(u"%s %s error (%s API, %d threads)", algo, operation, api, threads);
+            return false;
+        }
+    } while (elapsed < _opt.duration);
+
+    // Compute throughputs. Mb/s are computed on processed payload bytes.
+    const uint64_t packets = uint64_t(passes) * _packets.size();
+    const size_t payload_size = _sizes.empty() ? 0 : _sizes[0];
+    const double seconds = double(elapsed.count()) / 1e9;
+    const double pps = double(packets) / seconds;
+    const double mbps = pps * double(8 * payload_size) / 1e6;
+
+    if (_opt.json) {
+        ts::json::Value& res(_root.query(u"results[]", true));
+        res.add(u"algorithm", algo);
+        res.add(u"operation", operation);
+        res.add(u"api", api);
+        res.add(u"threads", threads);
+        res.add(u"payload-size", payload_size);
+        res.add(u"packets", packets);
+        res.add(u"seconds", seconds);
+        res.add(u"packets-per-second", pps);
+        res.add(u"mbps", mbps);
+    }
+    if (!_opt.json || !_opt.json_file.empty()) {
+        std::cout << ts::UString::Format(u"%-10s %-8s %-7s threads: %3d, payload: %3d bytes, %12.2f Mb/s, %13'd packets/s",
+                                         algo, operation, api, threads, payload_size, mbps, uint64_t(pps))
+                  << std::endl;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Benchmark a TS scrambling algorithm.
+//----------------------------------------------------------------------------
+
+void Benchmark::runScrambling(int algo)
+{
+    // Configure the scrambling engine with the same options as the plugins.
+    const ts::UString name(AlgorithmNames.name(algo));
+    ts::Args args(ts::UString(), ts::UString(), ts::Args::NO_EXIT_ON_ERROR | ts::Args::NO_CONFIG_FILE);
+    ts::TSScrambling master(_opt);
+    master.defineArgs(args);
+    if (!args.analyze(_opt.appName(), {u"--" + name}, false) || !master.loadArgs(_opt.duck, args)) {
+        _opt.error(u"error configuring %s", name);
+        return;
+    }
+
+    // Arbitrary control word.
+    ts::ByteBlock cw(master.cwSize());
+    for (size_t i = 0; i < cw.size(); ++i) {
+        cw[i] = uint8_t(0x11 * (i + 1));
+    }
+    if (!master.start() || !master.setCW(cw, 0) || !master.setEncryptParity(0)) {
+        _opt.error(u"error setting %s control word", name);
+        return;
+    }
+
+    std::vector<ts::TSPacket*> pkts(_packets.size());
+    for (size_t i = 0; i < _packets.size(); ++i) {
+        pkts[i] = &_packets[i];
+    }
+
+    // Encryption resets the packets in clear before each pass. Decryption does not need actual
+    // encrypted packets, the decryption time does not depend on the content.
+    const auto clear = [this]() { setScrambling(ts::SC_CLEAR); };
+    const auto even = [this]() { setScrambling(ts::SC_EVEN_KEY); };
+
+    // Single-packet API.
+    measure(name, u"encrypt", u"single", 0, [&]() {
+        bool ok = true;
+        for (auto& pkt : _packets) {
+            ok = master.encrypt(pkt) && ok;
+        }
+        return ok;
+    }, clear);
+    measure(name, u"decrypt", u"single", 0, [&]() {
+        bool ok = true;
+        for (auto& pkt : _packets) {
+            ok = master.decrypt(pkt) && ok;
+        }
+        return ok;
+    }, even);
+
+    // Batch API, with various numbers of threads.
+    for (size_t threads : _opt.threads) {
+        ts::TSScramblingPool pool(_opt);
+        if (!pool.start(threads)) {
+            continue;
+        }
+        measure(name, u"encrypt", u"batch", threads, [&]() { return pool.encrypt(master, pkts.data(), pkts.size()); }, clear);
+        measure(name, u"decrypt", u"batch", threads, [&]() { return pool.decrypt(master, pkts.data(), pkts.size()); }, even);
+    }
+    master.stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Benchmark AES-CTS on the packet payloads (as in the "aes" plugin).
+//----------------------------------------------------------------------------
+
+void Benchmark::runCTS(size_t payload_size)
+{
+    const ts::UString name(AlgorithmNames.name(ALGO_AES_CTS));
+    ts::CTS1<ts::AES128> cipher;
+    if (payload_size < cipher.minMessageSize()) {
+        _opt.verbose(u"%s: payload size %d is too short, minimum is %d bytes", name, payload_size, cipher.minMessageSize());
+        return;
+    }
+
+    const ts::ByteBlock key(ts::AES128::KEY_SIZE, 0x5A);
+    const ts::ByteBlock iv(ts::AES128::BLOCK_SIZE, 0x00);
+    if (!cipher.setKey(key, iv)) {
+        _opt.error(u"error setting %s key", name);
+        return;
+    }
+
+    // The single-message API uses a separate output buffer, as the "aes" plugin.
+    uint8_t tmp[ts::PKT_SIZE];
+    const auto nop = []() {};
+
+    measure(name, u"encrypt", u"single", 0, [&]() {
+        bool ok = true;
+        for (size_t i = 0; i < _payloads.size(); ++i) {
+            ok = cipher.encrypt(_payloads[i], _sizes[i], tmp, sizeof(tmp)) && ok;
+        }
+        return ok;
+    }, nop);
+    measure(name, u"decrypt", u"single", 0, [&]() {
+        bool ok = true;
+        for (size_t i = 0; i < _payloads.size(); ++i) {
+            ok = cipher.decrypt(_payloads[i], _sizes[i], tmp, sizeof(tmp)) && ok;
+        }
+        return ok;
+    }, nop);
+
+    // The batch API processes all messages in place.
+    void* const* msgs = reinterpret_cast<void* const*>(_payloads.data());
+    measure(name, u"encrypt", u"batch", 0, [&]() { return cipher.encryptInPlace(msgs, _sizes.data(), _sizes.size()); }, nop);
+    measure(name, u"decrypt", u"batch", 0, [&]() { return cipher.decryptInPlace(msgs, _sizes.data(), _sizes.size()); }, nop);
+}
+
+
+//----------------------------------------------------------------------------
+// Benchmark CRC32 on the packet payloads.
+//----------------------------------------------------------------------------
+
+void Benchmark::runCRC32()
+{
+    // Accumulate the CRC values to prevent the optimizer from removing the computation.
+    uint32_t accumulated = 0;
+    measure(AlgorithmNames.name(ALGO_CRC32), u"compute", u"single", 0, [&]() {
+        for (size_t i = 0; i < _payloads.size(); ++i) {
+            accumulated ^= ts::CRC32(_payloads[i], _sizes[i]).value();
+        }
+        return true;
+    }, []() {});
+    _opt.debug(u"accumulated CRC32: 0x%X", accumulated);
+}
+
+
+//----------------------------------------------------------------------------
+// Save the JSON document, if required.
+//----------------------------------------------------------------------------
+
+bool Benchmark::save()
+{
+    return !_opt.json || _root.save(_opt.json_file, 2, true, _opt);
+}
+
+
+//----------------------------------------------------------------------------
+// Program main code.
+//----------------------------------------------------------------------------
+
+int MainCode(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+    Benchmark bench(opt);
+    bench.run();
+    return bench.save() && !opt.gotErrors() ? EXIT_SUCCESS : EXIT_FAILURE;
+}